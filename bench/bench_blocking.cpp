@@ -0,0 +1,180 @@
+/*
+ * Tsunami Browser - Benchmarks
+ * bench_blocking.cpp - Filter list compilation and per-request matching
+ */
+
+#include "bench_util.h"
+#include "blocking/filter_cache.h"
+#include "blocking/filter_compiler.h"
+#include "blocking/filter_engine.h"
+#include "blocking/public_suffix.h"
+#include <benchmark/benchmark.h>
+#include <QFile>
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace Tsunami;
+
+namespace {
+
+uint32_t corpus_type(const std::string& name) {
+    static const std::map<std::string, uint32_t> types = {
+        {"script", ResourceScript}, {"image", ResourceImage}, {"stylesheet", ResourceStylesheet},
+        {"xhr", ResourceXhr}, {"subdocument", ResourceSubdocument}, {"font", ResourceFont},
+        {"media", ResourceMedia}, {"ping", ResourcePing}
+    };
+    auto it = types.find(name);
+    return it == types.end() ? ResourceOther : it->second;
+}
+
+// Requests as the interceptor hands them to the engine
+std::vector<FilterRequest> corpus_requests() {
+    std::vector<FilterRequest> requests;
+    for (const auto& entry : TsunamiBench::request_corpus()) {
+        std::string_view url = entry.url;
+        size_t begin = url.find("://") + 3;
+        size_t end = url.find_first_of(":/?#", begin);
+        FilterRequest request;
+        request.url = url;
+        request.host = url.substr(begin, end == std::string_view::npos ? url.npos : end - begin);
+        request.site_host = entry.site_host;
+        request.type = corpus_type(entry.type);
+        request.third_party = FilterEngine::is_third_party(request.host, request.site_host);
+        requests.push_back(request);
+    }
+    return requests;
+}
+
+const FilterEngine& engine_with(int rules) {
+    static std::map<int, std::unique_ptr<FilterEngine>> cache;
+    auto& engine = cache[rules];
+    if (!engine) {
+        FilterCompiler compiler;
+        compiler.add_list(TsunamiBench::bundled_filter_lists());
+        compiler.add_list(TsunamiBench::synthetic_filter_list(rules));
+        engine = std::make_unique<FilterEngine>(compiler.compile());
+    }
+    return *engine;
+}
+
+} // namespace
+
+static void BM_FilterCompile(benchmark::State& state) {
+    std::string text = TsunamiBench::synthetic_filter_list(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        FilterCompiler compiler;
+        compiler.add_list(text);
+        CompiledFilters filters = compiler.compile();
+        benchmark::DoNotOptimize(filters.patterns.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FilterCompile)->Arg(1000)->Arg(60000)->Unit(benchmark::kMillisecond);
+
+// What a warm start pays instead of BM_FilterCompile: map the cached image
+// and verify its checksum
+static void BM_FilterCacheMap(benchmark::State& state) {
+    std::string path = TsunamiBench::scratch_dir() + "/filters-" + std::to_string(state.range(0)) + ".bin";
+    {
+        FilterCompiler compiler;
+        compiler.add_list(TsunamiBench::synthetic_filter_list(static_cast<int>(state.range(0))));
+        std::string image = serialize_filters(compiler.compile(), compiler.stats(), 1);
+        QFile out(QString::fromStdString(path));
+        out.open(QIODevice::WriteOnly);
+        out.write(image.data(), static_cast<qint64>(image.size()));
+    }
+
+    for (auto _ : state) {
+        QFile file(QString::fromStdString(path));
+        file.open(QIODevice::ReadOnly);
+        uchar* bytes = file.map(0, file.size());
+        FilterData data;
+        FilterCompileStats stats;
+        bool ok = view_filters({reinterpret_cast<const std::byte*>(bytes), static_cast<size_t>(file.size())},
+                               1, data, stats);
+        benchmark::DoNotOptimize(ok);
+    }
+}
+BENCHMARK(BM_FilterCacheMap)->Arg(1000)->Arg(60000)->Unit(benchmark::kMillisecond);
+
+// Replays the recorded corpus against the bundled lists padded out with
+// synthetic rules; items/s is requests matched per second
+static void BM_FilterMatchCorpus(benchmark::State& state) {
+    const FilterEngine& engine = engine_with(static_cast<int>(state.range(0)));
+    std::vector<FilterRequest> requests = corpus_requests();
+    size_t blocked = 0;
+
+    for (auto _ : state) {
+        for (const FilterRequest& request : requests) {
+            blocked += engine.match(request).blocked;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * requests.size());
+    state.counters["blocked"] = static_cast<double>(blocked) / state.iterations();
+}
+BENCHMARK(BM_FilterMatchCorpus)->Arg(1000)->Arg(60000)->Unit(benchmark::kMicrosecond);
+
+// A miss walks every structure, so it is the slowest path
+static void BM_FilterMatchMiss(benchmark::State& state) {
+    const FilterEngine& engine = engine_with(60000);
+    FilterRequest request;
+    request.url = "https://static.example-shop.com/assets/js/vendor/checkout.3f9a2c1b.min.js?v=20240611";
+    request.host = "static.example-shop.com";
+    request.site_host = "www.example-shop.com";
+    request.type = ResourceScript;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.match(request));
+    }
+}
+BENCHMARK(BM_FilterMatchMiss);
+
+// Third-party checks run per request and per cookie access; items/s is
+// host pairs compared per second
+static void BM_IsCrossSite(benchmark::State& state) {
+    std::vector<FilterRequest> requests = corpus_requests();
+    size_t cross_site = 0;
+
+    for (auto _ : state) {
+        for (const FilterRequest& request : requests) {
+            cross_site += is_cross_site(request.host, request.site_host);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * requests.size());
+    state.counters["cross_site"] = static_cast<double>(cross_site) / state.iterations();
+}
+BENCHMARK(BM_IsCrossSite)->Unit(benchmark::kMicrosecond);
+
+// Hosts with a known eTLD+1, including wildcard rules whose nodes also
+// have children of their own; a wrong answer fails the benchmark
+static void BM_RegistrableDomain(benchmark::State& state) {
+    static const std::pair<const char*, const char*> cases[] = {
+        {"www.example.com", "example.com"},
+        {"www.example.co.uk", "example.co.uk"},
+        {"www.city.kawasaki.jp", "city.kawasaki.jp"},
+        {"a.b.kawasaki.jp", "a.b.kawasaki.jp"},
+        {"www.ck", "www.ck"},
+        {"x.futurecms.at", ""},
+        {"in.futurecms.at", ""},
+        {"shop.a.in.futurecms.at", "shop.a.in.futurecms.at"},
+        {"svc.firenet.ch", ""},
+        {"app.svc.firenet.ch", ""},
+        {"bzz.dapps.earth", ""},
+        {"dapps.earth", "dapps.earth"},
+    };
+    for (const auto& [host, expected] : cases) {
+        if (registrable_domain(host) != expected) {
+            state.SkipWithError((std::string("wrong registrable domain for ") + host).c_str());
+            return;
+        }
+    }
+
+    for (auto _ : state) {
+        for (const auto& [host, expected] : cases) {
+            benchmark::DoNotOptimize(registrable_domain(host));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(cases));
+}
+BENCHMARK(BM_RegistrableDomain);
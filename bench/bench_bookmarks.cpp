@@ -0,0 +1,64 @@
+/*
+ * Tsunami Browser - Benchmarks
+ * bench_bookmarks.cpp - BookmarksManager load and lookups, HTML import
+ */
+
+#include "bench_util.h"
+#include "bookmarks/bookmarks_manager.h"
+#include "bookmark_manager.h"
+#include <benchmark/benchmark.h>
+#include <QString>
+
+using SeaBrowser::BookmarksManager;
+
+static void BM_BookmarksLoad(benchmark::State& state) {
+    auto& bookmarks = BookmarksManager::instance();
+    bookmarks.init(TsunamiBench::bookmarks_db(static_cast<int>(state.range(0))));
+
+    for (auto _ : state) {
+        bookmarks.load();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BookmarksLoad)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+static void BM_BookmarksIsBookmarked(benchmark::State& state) {
+    int rows = static_cast<int>(state.range(0));
+    auto& bookmarks = BookmarksManager::instance();
+    bookmarks.init(TsunamiBench::bookmarks_db(rows));
+
+    // Alternate hits and misses so neither path dominates
+    std::string hit = TsunamiBench::synthetic_url(rows / 2);
+    std::string miss = "https://not-bookmarked.example.org/";
+    bool toggle = false;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bookmarks.is_bookmarked(toggle ? hit : miss));
+        toggle = !toggle;
+    }
+}
+BENCHMARK(BM_BookmarksIsBookmarked)->Arg(1000)->Arg(10000);
+
+static void BM_BookmarksInFolder(benchmark::State& state) {
+    auto& bookmarks = BookmarksManager::instance();
+    bookmarks.init(TsunamiBench::bookmarks_db(static_cast<int>(state.range(0))));
+
+    for (auto _ : state) {
+        auto folder = bookmarks.get_bookmarks_in_folder("Folder 7");
+        benchmark::DoNotOptimize(folder.data());
+    }
+}
+BENCHMARK(BM_BookmarksInFolder)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+static void BM_BookmarksImportHtml(benchmark::State& state) {
+    auto& manager = Tsunami::BookmarkManager::instance();
+    QString path = QString::fromStdString(TsunamiBench::bookmarks_html(static_cast<int>(state.range(0))));
+
+    for (auto _ : state) {
+        manager.importFromHtml(path);
+        state.PauseTiming();
+        manager.loadBookmarks();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BookmarksImportHtml)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
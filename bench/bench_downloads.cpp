@@ -0,0 +1,64 @@
+/*
+ * Tsunami Browser - Benchmarks
+ * bench_downloads.cpp - DownloadsManager state transitions
+ */
+
+#include "bench_util.h"
+#include "downloads/downloads_manager.h"
+#include <benchmark/benchmark.h>
+
+using SeaBrowser::DownloadsManager;
+
+static DownloadsManager& downloads() {
+    static bool initialized = false;
+    auto& manager = DownloadsManager::instance();
+    if (!initialized) {
+        manager.init(TsunamiBench::scratch_dir() + "/downloads.db");
+        initialized = true;
+    }
+    return manager;
+}
+
+static void BM_DownloadsPauseResume(benchmark::State& state) {
+    auto& manager = downloads();
+    std::string id = manager.start_download("https://example.com/file.bin", "bench-pause.bin");
+
+    for (auto _ : state) {
+        manager.pause_download(id);
+        manager.resume_download(id);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+    manager.remove_download(id);
+}
+BENCHMARK(BM_DownloadsPauseResume)->Unit(benchmark::kMicrosecond);
+
+static void BM_DownloadsUpdateProgress(benchmark::State& state) {
+    auto& manager = downloads();
+    std::vector<std::string> ids;
+    for (int i = 0; i < state.range(0); ++i) {
+        ids.push_back(manager.start_download("https://example.com/file" + std::to_string(i), "bench-progress.bin"));
+    }
+
+    uint64_t received = 0;
+    size_t next = 0;
+    for (auto _ : state) {
+        manager.update_progress(ids[next], received, 1 << 30, 1024.0);
+        received += 4096;
+        next = (next + 1) % ids.size();
+    }
+
+    for (const auto& id : ids) manager.remove_download(id);
+}
+BENCHMARK(BM_DownloadsUpdateProgress)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_DownloadsLifecycle(benchmark::State& state) {
+    auto& manager = downloads();
+
+    for (auto _ : state) {
+        std::string id = manager.start_download("https://example.com/archive.zip", "bench-lifecycle.zip");
+        manager.update_progress(id, 512, 1024, 1024.0);
+        manager.complete_download(id);
+        manager.remove_download(id);
+    }
+}
+BENCHMARK(BM_DownloadsLifecycle)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,64 @@
+/*
+ * Tsunami Browser - Benchmarks
+ * bench_favicons.cpp - Favicon store writes and page lookups
+ */
+
+#include "bench_util.h"
+#include "favicons/favicon_store.h"
+#include <benchmark/benchmark.h>
+
+using SeaBrowser::FaviconStore;
+
+namespace {
+
+// A 32x32 PNG is a few hundred bytes to a couple of KB; one per site
+std::string synthetic_icon(int site) {
+    std::string icon(1200, '\0');
+    for (size_t i = 0; i < icon.size(); ++i) {
+        icon[i] = static_cast<char>((site * 131 + i * 7) & 0xff);
+    }
+    return icon;
+}
+
+// synthetic_url() spreads pages over 5000 sites
+FaviconStore& filled_store(int pages) {
+    static int filled = 0;
+    auto& store = FaviconStore::instance();
+    if (filled != pages) {
+        store.init(TsunamiBench::scratch_dir() + "/favicons_" + std::to_string(pages) + ".db");
+        store.clear();
+        for (int i = 0; i < pages; ++i) {
+            store.put(TsunamiBench::synthetic_url(i), synthetic_icon(i % 5000));
+        }
+        filled = pages;
+    }
+    return store;
+}
+
+} // namespace
+
+// Most recorded icons are ones the store already has
+static void BM_FaviconPut(benchmark::State& state) {
+    auto& store = filled_store(static_cast<int>(state.range(0)));
+    int i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(store.put(TsunamiBench::synthetic_url(i), synthetic_icon(i % 5000)));
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FaviconPut)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+// What a history row costs when its icon is not in the decoded cache
+static void BM_FaviconLookupAndLoad(benchmark::State& state) {
+    auto& store = filled_store(static_cast<int>(state.range(0)));
+    std::string image;
+    int i = 0;
+    for (auto _ : state) {
+        uint64_t hash = store.icon_for_page(TsunamiBench::synthetic_url(i % state.range(0)));
+        benchmark::DoNotOptimize(store.load(hash, image));
+        i += 7919;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FaviconLookupAndLoad)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
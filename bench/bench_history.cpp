@@ -0,0 +1,175 @@
+/*
+ * Tsunami Browser - Benchmarks
+ * bench_history.cpp - HistoryManager insert/query throughput, expiry, import, private history, model scrolling and top sites
+ */
+
+#include "bench_util.h"
+#include "history/history_manager.h"
+#include "history/memory_history_store.h"
+#include "history/top_sites.h"
+#include "profile/history_expiry.h"
+#include "ui/history_model.h"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <memory>
+
+using SeaBrowser::HistoryManager;
+using Tsunami::HistoryExpiry;
+
+// Records into a copy, so the shared fixture keeps its row count for the
+// benchmarks that read it
+static void BM_HistoryAddVisit(benchmark::State& state) {
+    auto& history = HistoryManager::instance();
+    std::string copy = TsunamiBench::scratch_dir() + "/history_add.db";
+    std::filesystem::copy_file(TsunamiBench::history_db(static_cast<int>(state.range(0))), copy,
+                               std::filesystem::copy_options::overwrite_existing);
+    history.init(copy);
+
+    int i = 0;
+    for (auto _ : state) {
+        history.add_visit(TsunamiBench::synthetic_url(i), "Benchmark visit");
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistoryAddVisit)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+static void BM_HistoryGetPageRows(benchmark::State& state) {
+    auto& history = HistoryManager::instance();
+    history.init(TsunamiBench::history_db(static_cast<int>(state.range(0))));
+
+    for (auto _ : state) {
+        auto rows = history.get_page_rows(0, 0, 50);
+        benchmark::DoNotOptimize(rows.arena_bytes());
+    }
+    state.SetItemsProcessed(state.iterations() * 50);
+}
+BENCHMARK(BM_HistoryGetPageRows)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+// One retention step: the longest a visit recorded during expiry can wait.
+// Runs on a copy, refilled whenever the expired half is used up.
+static void BM_HistoryExpireStep(benchmark::State& state) {
+    const int rows = static_cast<int>(state.range(0));
+    auto& history = HistoryManager::instance();
+    std::string copy = TsunamiBench::scratch_dir() + "/history_expire.db";
+    HistoryManager::RetentionPolicy policy;
+    policy.max_visits = rows / 2;
+
+    auto refill = [&]() {
+        std::filesystem::copy_file(TsunamiBench::history_db(rows), copy,
+                                   std::filesystem::copy_options::overwrite_existing);
+        history.init(copy);
+        history.begin_expiry(policy);
+    };
+    refill();
+    for (auto _ : state) {
+        auto step = history.expire_step(HistoryExpiry::BATCH_ROWS, HistoryExpiry::VACUUM_PAGES);
+        if (step.done) {
+            state.PauseTiming();
+            refill();
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * HistoryExpiry::BATCH_ROWS);
+}
+BENCHMARK(BM_HistoryExpireStep)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+// Migrating from Chromium: the whole History file merged into an empty
+// history, sites aggregate included
+static void BM_HistoryImportChromium(benchmark::State& state) {
+    const int visits = static_cast<int>(state.range(0));
+    auto& history = HistoryManager::instance();
+    std::string source = TsunamiBench::chromium_history_db(visits);
+    std::string target = TsunamiBench::scratch_dir() + "/history_import.db";
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::filesystem::remove(target);
+        history.init(target);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(history.import_history(source, SeaBrowser::ImportFormat::Chromium, nullptr));
+    }
+    state.SetItemsProcessed(state.iterations() * visits);
+}
+BENCHMARK(BM_HistoryImportChromium)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond)->Iterations(3);
+
+// Private windows: the same visit recorded into the session's arena
+static void BM_MemoryHistoryAddVisit(benchmark::State& state) {
+    SeaBrowser::MemoryHistoryStore history;
+    int i = 0;
+    for (auto _ : state) {
+        history.add_visit(TsunamiBench::synthetic_url(i), "Benchmark visit");
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryHistoryAddVisit);
+
+// Closing the last private window: one arena release for the whole session
+static void BM_MemoryHistoryTeardown(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto history = std::make_unique<SeaBrowser::MemoryHistoryStore>();
+        for (int i = 0; i < state.range(0); ++i) {
+            history->add_visit(TsunamiBench::synthetic_url(i), "Benchmark visit");
+        }
+        state.ResumeTiming();
+        history.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MemoryHistoryTeardown)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+// Scrolls the history window's model one viewport at a time, fetching
+// more rows at the bottom the way QTableView does
+static void BM_HistoryModelScroll(benchmark::State& state) {
+    auto& history = HistoryManager::instance();
+    history.init(TsunamiBench::history_db(static_cast<int>(state.range(0))));
+
+    const int viewport = 40;
+    Tsunami::HistoryModel model;
+    int row = 0;
+    for (auto _ : state) {
+        if (row + viewport >= model.rowCount() && model.canFetchMore(QModelIndex())) {
+            model.fetchMore(QModelIndex());
+        }
+        if (row >= model.rowCount()) row = 0;
+        for (int r = row; r < row + viewport && r < model.rowCount(); ++r) {
+            for (int c = 0; c < Tsunami::HistoryModel::ColumnCount; ++c) {
+                benchmark::DoNotOptimize(model.data(model.index(r, c)));
+            }
+        }
+        row += viewport;
+    }
+    state.counters["rows"] = model.rowCount();
+    state.SetItemsProcessed(state.iterations() * viewport);
+}
+BENCHMARK(BM_HistoryModelScroll)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+// Per-visit cost of keeping the new tab page's top sites current. Visits
+// follow synthetic_url(): 5000 sites, so most never reach the candidates.
+static void BM_TopSitesVisit(benchmark::State& state) {
+    auto& top_sites = SeaBrowser::TopSites::instance();
+    std::vector<long long> counts(5000, 0);
+    SeaBrowser::HistoryEvent event{SeaBrowser::HistoryEvent::Added, {}, {}};
+    long long i = 0;
+    for (auto _ : state) {
+        // Skewed so a few sites dominate, as real browsing does
+        int site = static_cast<int>((i * i) % 5000);
+        event.site.host = "site" + std::to_string(site) + ".example.com";
+        event.site.url = "https://" + event.site.host;
+        event.site.visit_count = ++counts[site];
+        event.site.last_visit = i++;
+        top_sites.on_history_event(event);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TopSitesVisit);
+
+// What a new tab pays for its tiles
+static void BM_TopSitesJson(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SeaBrowser::TopSites::instance().json());
+    }
+}
+BENCHMARK(BM_TopSitesJson);
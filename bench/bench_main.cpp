@@ -0,0 +1,28 @@
+/*
+ * Tsunami Browser - Benchmarks
+ * bench_main.cpp - Headless entry point for tsunami_bench
+ */
+
+#include <benchmark/benchmark.h>
+#include <QApplication>
+#include <QStandardPaths>
+
+int main(int argc, char* argv[]) {
+    // Never open windows or touch the user's real profile
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QStandardPaths::setTestModeEnabled(true);
+
+    QApplication app(argc, argv);
+    app.setApplicationName("Tsunami");
+    app.setOrganizationName("Tsunami");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
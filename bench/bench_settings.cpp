@@ -0,0 +1,61 @@
+/*
+ * Tsunami Browser - Benchmarks
+ * bench_settings.cpp - Settings persistence and settings-driven UI work
+ */
+
+#include "bench_util.h"
+#include "settings/settings.h"
+#include "settings/site_settings.h"
+#include "ui/history_window.h"
+#include <benchmark/benchmark.h>
+
+using Tsunami::Settings;
+
+static void BM_SettingsSave(benchmark::State& state) {
+    auto& settings = Settings::instance();
+    for (auto _ : state) {
+        settings.save();
+    }
+}
+BENCHMARK(BM_SettingsSave)->Unit(benchmark::kMicrosecond);
+
+// Every setter saves and emits settingsChanged to all open windows
+static void BM_SettingsSetterRoundTrip(benchmark::State& state) {
+    auto& settings = Settings::instance();
+    Tsunami::HistoryWindow window;
+    bool dark = settings.getDarkMode();
+
+    for (auto _ : state) {
+        dark = !dark;
+        settings.setDarkMode(dark);
+    }
+}
+BENCHMARK(BM_SettingsSetterRoundTrip)->Unit(benchmark::kMicrosecond);
+
+static void BM_HistoryWindowOpen(benchmark::State& state) {
+    for (auto _ : state) {
+        Tsunami::HistoryWindow window;
+        benchmark::DoNotOptimize(&window);
+    }
+}
+BENCHMARK(BM_HistoryWindowOpen)->Unit(benchmark::kMicrosecond);
+
+// Runs on every navigation; the rule count should not matter
+static void BM_SiteSettingsLookup(benchmark::State& state) {
+    auto& store = Tsunami::SiteSettingsStore::instance();
+    store.clear();
+    Tsunami::SiteSettings rule;
+    rule.images = Tsunami::SiteToggle::Block;
+    for (int i = 0; i < state.range(0); ++i) {
+        store.set("site" + std::to_string(i) + ".example", rule);
+    }
+
+    const std::string hosts[] = {"www.site42.example", "cdn.assets.unlisted.org", "site7.example"};
+    int i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(store.lookup(hosts[i++ % 3]));
+    }
+    state.SetItemsProcessed(state.iterations());
+    store.clear();
+}
+BENCHMARK(BM_SiteSettingsLookup)->Arg(10)->Arg(10000);
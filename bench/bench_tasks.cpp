@@ -0,0 +1,31 @@
+/*
+ * Tsunami Browser - Benchmarks
+ * bench_tasks.cpp - Task manager sampling ticks
+ */
+
+#include "perf/task_sampler.h"
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+#include <vector>
+
+using Tsunami::TaskSample;
+using Tsunami::TaskSampler;
+
+// One sampler tick over N processes; the bench process stands in for each
+// renderer, so the cost is the /proc reads and parsing, not process count
+static void BM_TaskSamplerTick(benchmark::State& state) {
+    const size_t processes = static_cast<size_t>(state.range(0));
+    std::vector<int> pids(processes, static_cast<int>(getpid()));
+    std::vector<TaskSample> samples(processes);
+    TaskSampler sampler;
+    sampler.set_pids(pids.data(), pids.size());
+
+    uint64_t now = 1'000'000'000;
+    for (auto _ : state) {
+        sampler.sample_once(now);
+        now += 1'000'000'000;
+        benchmark::DoNotOptimize(sampler.snapshot(samples.data(), samples.size()));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(processes));
+}
+BENCHMARK(BM_TaskSamplerTick)->Arg(1)->Arg(16)->Arg(64);
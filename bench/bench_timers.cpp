@@ -0,0 +1,48 @@
+/*
+ * Tsunami Browser - Benchmarks
+ * bench_timers.cpp - Timer wheel scheduling and expiry
+ */
+
+#include "reload/timer_wheel.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using Tsunami::TimerWheel;
+
+// What a finished page load costs: drop the tab's deadline, set a new one
+static void BM_TimerWheelRearm(benchmark::State& state) {
+    const int tabs = static_cast<int>(state.range(0));
+    TimerWheel wheel;
+    std::vector<TimerWheel::TimerId> ids(tabs);
+    for (int i = 0; i < tabs; ++i) ids[i] = wheel.schedule(30 + i % 3600, i);
+
+    int i = 0;
+    for (auto _ : state) {
+        int tab = i % tabs;
+        wheel.cancel(ids[tab]);
+        ids[tab] = wheel.schedule(wheel.now() + 30 + tab % 3600, tab);
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimerWheelRearm)->Arg(100)->Arg(10000);
+
+// One simulated hour, one second per tick, every tab reloading each 30-90 s
+static void BM_TimerWheelAdvance(benchmark::State& state) {
+    const int tabs = static_cast<int>(state.range(0));
+    std::vector<uint64_t> expired;
+    for (auto _ : state) {
+        TimerWheel wheel;
+        for (int i = 0; i < tabs; ++i) wheel.schedule(30 + i % 60, i);
+        size_t fired = 0;
+        for (uint64_t now = 1; now <= 3600; ++now) {
+            expired.clear();
+            wheel.advance(now, expired);
+            for (uint64_t key : expired) wheel.schedule(now + 30 + key % 60, key);
+            fired += expired.size();
+        }
+        benchmark::DoNotOptimize(fired);
+    }
+    state.SetItemsProcessed(state.iterations() * 3600);
+}
+BENCHMARK(BM_TimerWheelAdvance)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,234 @@
+/*
+ * Tsunami Browser - Benchmarks
+ * bench_util.cpp - Shared fixtures for the tsunami_bench suite
+ */
+
+#include "bench_util.h"
+#include <QTemporaryDir>
+#include <sqlite3.h>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+
+namespace TsunamiBench {
+
+namespace {
+
+void exec(sqlite3* db, const char* sql) {
+    char* err_msg = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &err_msg) != SQLITE_OK) {
+        std::string error = err_msg ? err_msg : "unknown error";
+        sqlite3_free(err_msg);
+        throw std::runtime_error(error);
+    }
+}
+
+} // namespace
+
+std::string scratch_dir() {
+    static QTemporaryDir dir;
+    return dir.path().toStdString();
+}
+
+std::string synthetic_url(int index) {
+    return "https://site" + std::to_string(index % 5000) + ".example.com/page/" + std::to_string(index);
+}
+
+std::string history_db(int rows) {
+    static std::map<int, std::string> cache;
+    auto it = cache.find(rows);
+    if (it != cache.end()) return it->second;
+
+    std::string path = scratch_dir() + "/history_" + std::to_string(rows) + ".db";
+    sqlite3* db = nullptr;
+    sqlite3_open(path.c_str(), &db);
+    exec(db, "CREATE TABLE IF NOT EXISTS visits ("
+             "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+             "url TEXT NOT NULL, "
+             "title TEXT, "
+             "timestamp INTEGER);");
+    exec(db, "BEGIN;");
+
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_prepare_v2(db, "INSERT INTO visits (url, title, timestamp) VALUES (?, ?, ?);", -1, &stmt, nullptr);
+    long long now = std::time(nullptr);
+    for (int i = 0; i < rows; ++i) {
+        std::string url = synthetic_url(i);
+        std::string title = "Page " + std::to_string(i);
+        sqlite3_bind_text(stmt, 1, url.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, title.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 3, now - (rows - i));
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    exec(db, "COMMIT;");
+    sqlite3_close(db);
+
+    cache[rows] = path;
+    return path;
+}
+
+std::string chromium_history_db(int visits) {
+    static std::map<int, std::string> cache;
+    auto it = cache.find(visits);
+    if (it != cache.end()) return it->second;
+
+    std::string path = scratch_dir() + "/chromium_" + std::to_string(visits) + ".db";
+    sqlite3* db = nullptr;
+    sqlite3_open(path.c_str(), &db);
+    exec(db, "CREATE TABLE urls (id INTEGER PRIMARY KEY, url LONGVARCHAR, title LONGVARCHAR, "
+             "hidden INTEGER DEFAULT 0 NOT NULL);"
+             "CREATE TABLE visits (id INTEGER PRIMARY KEY, url INTEGER NOT NULL, visit_time INTEGER NOT NULL);");
+    exec(db, "BEGIN;");
+
+    const int urls = std::max(1, visits / 20);
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_prepare_v2(db, "INSERT INTO urls (id, url, title) VALUES (?, ?, ?);", -1, &stmt, nullptr);
+    for (int i = 1; i <= urls; ++i) {
+        std::string url = synthetic_url(i);
+        sqlite3_bind_int(stmt, 1, i);
+        sqlite3_bind_text(stmt, 2, url.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, "Imported page", -1, SQLITE_STATIC);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    // Microseconds since 1601, one visit a minute up to now
+    const long long now = (static_cast<long long>(std::time(nullptr)) + 11644473600LL) * 1000000;
+    sqlite3_prepare_v2(db, "INSERT INTO visits (url, visit_time) VALUES (?, ?);", -1, &stmt, nullptr);
+    for (int i = 0; i < visits; ++i) {
+        sqlite3_bind_int(stmt, 1, 1 + i % urls);
+        sqlite3_bind_int64(stmt, 2, now - static_cast<long long>(visits - i) * 60 * 1000000);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    exec(db, "COMMIT;");
+    sqlite3_close(db);
+
+    cache[visits] = path;
+    return path;
+}
+
+std::string bookmarks_db(int rows) {
+    static std::map<int, std::string> cache;
+    auto it = cache.find(rows);
+    if (it != cache.end()) return it->second;
+
+    std::string path = scratch_dir() + "/bookmarks_" + std::to_string(rows) + ".db";
+    sqlite3* db = nullptr;
+    sqlite3_open(path.c_str(), &db);
+    exec(db, "CREATE TABLE IF NOT EXISTS bookmarks ("
+             "id TEXT PRIMARY KEY,"
+             "title TEXT NOT NULL,"
+             "url TEXT NOT NULL,"
+             "folder TEXT DEFAULT 'Other Bookmarks',"
+             "date_added INTEGER"
+             ")");
+    exec(db, "BEGIN;");
+
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_prepare_v2(db, "INSERT INTO bookmarks (id, title, url, folder, date_added) VALUES (?, ?, ?, ?, ?)",
+                       -1, &stmt, nullptr);
+    for (int i = 0; i < rows; ++i) {
+        std::string id = "bm" + std::to_string(i);
+        std::string title = "Bookmark " + std::to_string(i);
+        std::string url = synthetic_url(i);
+        std::string folder = "Folder " + std::to_string(i % 20);
+        sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, title.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, url.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 4, folder.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 5, i);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    exec(db, "COMMIT;");
+    sqlite3_close(db);
+
+    cache[rows] = path;
+    return path;
+}
+
+std::string bookmarks_html(int entries) {
+    std::string path = scratch_dir() + "/bookmarks_" + std::to_string(entries) + ".html";
+    std::ofstream out(path, std::ios::trunc);
+    out << "<!DOCTYPE NETSCAPE-Bookmark-file-1>\n"
+        << "<META HTTP-EQUIV=\"Content-Type\" CONTENT=\"text/html; charset=UTF-8\">\n"
+        << "<TITLE>Bookmarks</TITLE>\n<H1>Bookmarks</H1>\n<DL><p>\n";
+    for (int i = 0; i < entries; ++i) {
+        out << "    <DT><A HREF=\"" << synthetic_url(i) << "\">Bookmark " << i << "</A>\n";
+    }
+    out << "</DL><p>\n";
+    return path;
+}
+
+std::string synthetic_filter_list(int rules) {
+    std::string text = "[Adblock Plus 2.0]\n";
+    for (int i = 0; i < rules; ++i) {
+        std::string n = std::to_string(i);
+        switch (i % 10) {
+        case 0: case 1: case 2: case 3: case 4: case 5:
+            text += "||ads" + n + ".tracker-network.com^\n";
+            break;
+        case 6:
+            text += "/banner" + n + "/ad-*.js\n";
+            break;
+        case 7:
+            text += "-promo" + n + "-\n";
+            break;
+        case 8:
+            text += "||cdn" + n + ".example.net/pixel^$image,third-party\n";
+            break;
+        default:
+            text += "/widget" + n + "?$script,domain=site" + n + ".com|~shop.site" + n + ".com\n";
+            break;
+        }
+    }
+    return text;
+}
+
+std::string bundled_filter_lists() {
+    std::string text;
+    for (const char* name : {"easylist.txt", "easyprivacy.txt"}) {
+        std::ifstream in(std::string(TSUNAMI_SOURCE_DIR) + "/data/filters/" + name);
+        text.append(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        text += '\n';
+    }
+    return text;
+}
+
+const std::vector<CorpusRequest>& request_corpus() {
+    static std::vector<CorpusRequest> corpus = [] {
+        const char* override_path = std::getenv("TSUNAMI_BENCH_CORPUS");
+        std::string path = override_path ? override_path
+                                         : std::string(TSUNAMI_SOURCE_DIR) + "/bench/data/request_corpus.tsv";
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("cannot open request corpus " + path);
+
+        std::vector<CorpusRequest> requests;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            size_t first = line.find('\t');
+            size_t second = line.find('\t', first + 1);
+            if (second == std::string::npos) continue;
+            requests.push_back({line.substr(0, first), line.substr(first + 1, second - first - 1),
+                                line.substr(second + 1)});
+        }
+        return requests;
+    }();
+    return corpus;
+}
+
+} // namespace TsunamiBench
@@ -0,0 +1,44 @@
+/*
+ * Tsunami Browser - Benchmarks
+ * bench_util.h - Shared fixtures for the tsunami_bench suite
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace TsunamiBench {
+
+// Directory that lives for the whole benchmark run
+std::string scratch_dir();
+
+// Databases pre-filled with `rows` synthetic rows in one transaction.
+// Each size is built once per run and reused by every benchmark.
+std::string history_db(int rows);
+std::string bookmarks_db(int rows);
+// A Chromium History file: `visits` visits spread over visits / 20 URLs
+std::string chromium_history_db(int visits);
+
+// Netscape bookmark export containing `entries` links
+std::string bookmarks_html(int entries);
+
+std::string synthetic_url(int index);
+
+// EasyList-shaped rule text: mostly ||host^ rules, then URL patterns,
+// plain substrings and rules carrying options, in roughly upstream ratios
+std::string synthetic_filter_list(int rules);
+
+// The starter lists shipped in data/filters
+std::string bundled_filter_lists();
+
+// Recorded subresource requests: bench/data/request_corpus.tsv unless
+// TSUNAMI_BENCH_CORPUS names another capture in the same format
+struct CorpusRequest {
+    std::string type;
+    std::string site_host;
+    std::string url;
+};
+const std::vector<CorpusRequest>& request_corpus();
+
+} // namespace TsunamiBench
@@ -0,0 +1,36 @@
+#!/bin/bash
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+BUILD_DIR="$PROJECT_DIR/build-bench"
+RESULTS_DIR="$PROJECT_DIR/output/bench"
+
+echo "========================================="
+echo "Tsunami Browser Benchmarks"
+echo "========================================="
+
+echo "[1/3] Configuring with CMake..."
+cmake -S "$PROJECT_DIR" -B "$BUILD_DIR" \
+      -DCMAKE_BUILD_TYPE=Release \
+      -DTSUNAMI_BUILD_BENCHMARKS=ON
+
+echo "[2/3] Building tsunami_bench..."
+cmake --build "$BUILD_DIR" --target tsunami_bench -j"$(nproc)"
+
+echo "[3/3] Running benchmarks..."
+mkdir -p "$RESULTS_DIR"
+COMMIT="$(git -C "$PROJECT_DIR" rev-parse --short HEAD 2>/dev/null || echo unknown)"
+RESULT_FILE="$RESULTS_DIR/$COMMIT.json"
+
+QT_QPA_PLATFORM=offscreen "$BUILD_DIR/tsunami_bench" \
+    --benchmark_out="$RESULT_FILE" \
+    --benchmark_out_format=json \
+    "$@"
+
+echo ""
+echo "Results: $RESULT_FILE"
+echo ""
+echo "To compare two commits (compare.py ships with Google Benchmark):"
+echo "  compare.py benchmarks $RESULTS_DIR/<old>.json $RESULT_FILE"
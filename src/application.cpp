@@ -6,6 +6,23 @@
 #include "application.h"
 #include "browser_window.h"
 #include "settings/settings.h"
+#include "settings/chromium_flags.h"
+#include "scheme_handler.h"
+#include "startup_pipeline.h"
+#include "single_instance.h"
+#include "blocking/content_blocker.h"
+#include "blocking/https_upgrade_cache.h"
+#include "settings/site_settings.h"
+#include "favicons/favicon_service.h"
+#include "thumbnails/thumbnail_cache.h"
+#include "profile/profile_manager.h"
+#include "profile/cache_manager.h"
+#include "profile/history_expiry.h"
+#include "update_manager.h"
+#include "history/history_manager.h"
+#include "history/top_sites.h"
+#include "bookmarks/bookmarks_manager.h"
+#include "downloads/downloads_manager.h"
 #include <QDir>
 #include <QStandardPaths>
 #include <QIcon>
@@ -39,13 +56,47 @@ static QString find_resource(const QString& relative_path) {
     return "";
 }
 
+// Into the active window of the requested kind, or a new one
+static void open_request(const SingleInstance::Request& request) {
+    BrowserWindow* window = request.new_window ? nullptr : BrowserWindow::lastActive(request.private_window);
+    if (!window) {
+        window = new BrowserWindow(nullptr, request.private_window);
+        window->setAttribute(Qt::WA_DeleteOnClose);
+        window->openUrls(request.urls);
+        window->show();
+        return;
+    }
+    window->openUrls(request.urls);
+    if (window->isMinimized()) window->showNormal();
+    window->raise();
+    window->activateWindow();
+}
+
 int Application::run(int argc, char* argv[]) {
+    auto& startup = StartupPipeline::instance();
+    SchemeHandler::registerScheme();
     QApplication app(argc, argv);
     
     app.setApplicationName("Tsunami");
     app.setApplicationVersion("1.0.0");
     app.setOrganizationName("Tsunami");
     app.setOrganizationDomain("tsunami.dev");
+
+    // A browser is already running: hand it the command line and exit
+    // before any settings, databases or Chromium are touched
+    SingleInstance instance;
+    if (!instance.start(app.arguments())) {
+        return 0;
+    }
+    QObject::connect(&instance, &SingleInstance::openRequested, &open_request);
+
+    for (const QString& arg : app.arguments()) {
+        if (arg == "--startup-trace") {
+            startup.enableTrace(QString());
+        } else if (arg.startsWith("--startup-trace=")) {
+            startup.enableTrace(arg.mid(QStringLiteral("--startup-trace=").size()));
+        }
+    }
     
     // Set application icon for all platforms
     QStringList iconPaths;
@@ -64,22 +115,72 @@ int Application::run(int argc, char* argv[]) {
         }
     }
     
-    // Check for first run and show onboarding
-    auto& settings = Settings::instance();
-    if (settings.isFirstRun()) {
-        // Show onboarding/setup page
-        BrowserWindow onboardingWindow;
-        onboardingWindow.show();
-        onboardingWindow.loadUrl(QUrl::fromLocalFile(find_resource("pages/newtab.html")));
-        app.processEvents();
-        return app.exec();
-    }
+    // Settings are on the critical path: the first frame needs the theme.
+    // A first run also shows onboarding from the window constructor.
+    Settings::instance();
+    // Chromium reads its flags when the first profile is created
+    ChromiumFlags::apply(Settings::instance());
+    // Compiles on a worker thread so the lists are ready by the first load
+    ContentBlocker::instance().reload();
+    // A few KB, and the very first navigation may need it
+    HttpsUpgradeCache::instance().init((get_data_dir() + "/https_upgrade_cache.bin").toStdString());
+    // Its hosts are ones the user visited; clearing history forgets them too
+    SeaBrowser::HistoryManager::instance().add_listener([](const SeaBrowser::HistoryEvent& event) {
+        if (event.type == SeaBrowser::HistoryEvent::Cleared) HttpsUpgradeCache::instance().clear();
+    });
+    // Read before the first tab so its first navigation gets its rules
+    SiteSettingsStore::instance().init((get_data_dir() + "/site_settings.bin").toStdString());
+    // Opens on the favicon worker, ahead of any icon lookups queued there
+    FaviconService::instance().init(get_data_dir() + "/favicons.db");
+    ThumbnailCache::instance().init(get_cache_dir() + "/thumbnails");
+    // Paths only; the profile itself is created with the first tab
+    CacheManager::instance().init(get_cache_dir() + "/web", get_data_dir() + "/profile");
+    ProfileManager::instance().init(get_data_dir() + "/profile", get_cache_dir() + "/web");
+    startup.mark(StartupPipeline::ApplicationReady);
     
-    // Create browser window
+    // Show the window first. It creates its first tab on the next event
+    // loop pass, which overlaps WebEngine start-up with the first paint.
+    SingleInstance::Request initial = SingleInstance::parseArguments(app.arguments(), QDir::currentPath());
     BrowserWindow window;
+    if (!initial.private_window) window.openUrls(initial.urls);
+    startup.watchFirstPaint(&window);
     window.show();
+    if (initial.private_window) {
+        initial.new_window = true;
+        open_request(initial);
+    }
+    startup.mark(StartupPipeline::WindowShown);
+    
+    // Nothing below is needed to paint or to type into the URL bar
+    QString dataDir = get_data_dir();
+    startup.defer("startup.historyOpen", [dataDir]() {
+        // Writes the visits the first tab made before this ran
+        SeaBrowser::HistoryManager::instance().init((dataDir + "/history.db").toStdString());
+        // One indexed read of the sites table; visits update it from here on
+        SeaBrowser::TopSites::instance().init();
+    });
+    startup.defer("startup.bookmarksLoad", [dataDir]() {
+        SeaBrowser::BookmarksManager::instance().init((dataDir + "/bookmarks.db").toStdString());
+    });
+    startup.defer("startup.downloadsLoad", [dataDir]() {
+        SeaBrowser::DownloadsManager::instance().init((dataDir + "/downloads.db").toStdString());
+    });
+    startup.defer("startup.cacheMaintenance", []() {
+        CacheManager::instance().startMaintenance();
+    });
+    startup.defer("startup.historyExpiry", []() {
+        HistoryExpiry::instance().start();
+    });
+    startup.defer("startup.updateCheck", [&app]() {
+        UpdateManager* updates = new UpdateManager(&app);
+        updates->checkForUpdates(false);
+    });
     
     int result = app.exec();
+    // Renames the cache away when it is cleared on exit; never deletes here
+    CacheManager::instance().shutdown();
+    // Stops between steps; the rest of the pass runs next start
+    HistoryExpiry::instance().shutdown();
     return result;
 }
 
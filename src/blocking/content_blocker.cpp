@@ -0,0 +1,199 @@
+/*
+ * Tsunami Browser - Content blocking
+ * content_blocker.cpp - Owns the active filter engine and per-page interceptors
+ */
+
+#include "blocking/content_blocker.h"
+#include "blocking/filter_cache.h"
+#include "blocking/request_interceptor.h"
+#include "application.h"
+#include "settings/settings.h"
+#include "perf/trace.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSaveFile>
+#include <QThread>
+#include <QTimer>
+#include <QWebEnginePage>
+#include <iostream>
+
+namespace Tsunami {
+
+namespace {
+
+QString userListDir() {
+    return Application::get_data_dir() + "/filters";
+}
+
+QString listPath(const QString& name) {
+    QString user_list = userListDir() + "/" + name + ".txt";
+    if (QFile::exists(user_list)) return user_list;
+    return Application::get_resource_path("filters/" + name + ".txt");
+}
+
+QString cachePath() {
+    return Application::get_cache_dir() + "/filters.bin";
+}
+
+// Identifies the exact list files an image was compiled from
+quint64 sourceKey(const QStringList& paths) {
+    QByteArray key;
+    for (const QString& path : paths) {
+        QFileInfo info(path);
+        key += path.toUtf8() + '|' + QByteArray::number(info.size()) + '|' +
+               QByteArray::number(info.lastModified().toMSecsSinceEpoch()) + '\n';
+    }
+    return filter_checksum(key.constData(), static_cast<size_t>(key.size()), FILTER_CACHE_VERSION);
+}
+
+// The QFile stays open for as long as the engine references the mapping
+std::shared_ptr<const FilterEngine> mapCache(const QString& path, quint64 key, FilterCompileStats& stats) {
+    auto file = std::make_shared<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly) || file->size() == 0) return nullptr;
+    uchar* bytes = file->map(0, file->size());
+    if (!bytes) return nullptr;
+
+    FilterData data;
+    std::span<const std::byte> image(reinterpret_cast<const std::byte*>(bytes), static_cast<size_t>(file->size()));
+    if (!view_filters(image, key, data, stats)) return nullptr;
+    return std::make_shared<const FilterEngine>(data, std::move(file));
+}
+
+std::shared_ptr<const FilterEngine> compileLists(const QStringList& paths, quint64 key, FilterCompileStats& stats) {
+    FilterCompiler compiler;
+    for (const QString& path : paths) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) continue;
+        QByteArray text = file.readAll();
+        compiler.add_list(std::string_view(text.constData(), static_cast<size_t>(text.size())));
+    }
+    CompiledFilters filters = compiler.compile();
+    stats = compiler.stats();
+
+    QString path = cachePath();
+    std::string image = serialize_filters(filters, stats, key);
+    QSaveFile out(path);
+    if (out.open(QIODevice::WriteOnly) &&
+        out.write(image.data(), static_cast<qint64>(image.size())) == static_cast<qint64>(image.size()) &&
+        out.commit()) {
+        // Serve from the mapping so the heap copy is released
+        if (auto mapped = mapCache(path, key, stats)) return mapped;
+    }
+    return std::make_shared<const FilterEngine>(std::move(filters));
+}
+
+} // namespace
+
+ContentBlocker& ContentBlocker::instance() {
+    static ContentBlocker instance;
+    return instance;
+}
+
+ContentBlocker::ContentBlocker()
+    : QObject(nullptr)
+    , watcher_(new QFileSystemWatcher(this))
+    , reload_timer_(new QTimer(this))
+{
+    connect(&Settings::instance(), &Settings::settingsChanged, this, &ContentBlocker::onSettingsChanged);
+
+    // Editors and downloaders write lists in several steps; settle first
+    reload_timer_->setSingleShot(true);
+    reload_timer_->setInterval(500);
+    connect(reload_timer_, &QTimer::timeout, this, &ContentBlocker::reload);
+    connect(watcher_, &QFileSystemWatcher::fileChanged, reload_timer_, qOverload<>(&QTimer::start));
+    connect(watcher_, &QFileSystemWatcher::directoryChanged, reload_timer_, qOverload<>(&QTimer::start));
+}
+
+QStringList ContentBlocker::enabledLists() const {
+    QStringList lists;
+    Settings& settings = Settings::instance();
+    if (settings.getBlockAds()) lists << "easylist";
+    if (settings.getBlockTrackers()) lists << "easyprivacy";
+    return lists;
+}
+
+void ContentBlocker::onSettingsChanged() {
+    if (enabledLists() != loaded_lists_) {
+        reload();
+    }
+}
+
+void ContentBlocker::watch(const QStringList& paths) {
+    if (!watcher_->files().isEmpty()) watcher_->removePaths(watcher_->files());
+    if (!watcher_->directories().isEmpty()) watcher_->removePaths(watcher_->directories());
+    if (!paths.isEmpty()) watcher_->addPaths(paths);
+    // A user list dropped in later must replace the bundled one
+    if (QDir(userListDir()).exists()) watcher_->addPath(userListDir());
+}
+
+void ContentBlocker::reload() {
+    QStringList lists = enabledLists();
+    QStringList paths;
+    for (const QString& name : lists) {
+        QString path = listPath(name);
+        if (!path.isEmpty()) paths << path;
+    }
+    watch(paths);
+
+    quint64 key = sourceKey(paths);
+    if (lists == loaded_lists_ && key == loaded_key_ && engine_) return;
+    loaded_lists_ = lists;
+    loaded_key_ = key;
+    int generation = ++generation_;
+
+    if (paths.isEmpty()) {
+        activate(nullptr, FilterCompileStats(), false);
+        return;
+    }
+
+    QThread* worker = QThread::create([this, paths, key, generation]() {
+        quint64 start = Tracer::now_ns();
+        FilterCompileStats stats;
+        bool from_cache = true;
+        std::shared_ptr<const FilterEngine> engine = mapCache(cachePath(), key, stats);
+        if (!engine) {
+            from_cache = false;
+            engine = compileLists(paths, key, stats);
+        }
+        TSUNAMI_TRACE_SPAN(from_cache ? "blocking.mapCache" : "blocking.compile", start, Tracer::now_ns());
+
+        QMetaObject::invokeMethod(this, [this, engine, stats, from_cache, generation]() {
+            if (generation != generation_) return;   // Superseded by a newer reload
+            activate(engine, stats, from_cache);
+        }, Qt::QueuedConnection);
+    });
+    connect(worker, &QThread::finished, worker, &QObject::deleteLater);
+    worker->start(QThread::LowPriority);
+}
+
+void ContentBlocker::activate(std::shared_ptr<const FilterEngine> engine, const FilterCompileStats& stats,
+                              bool from_cache) {
+    // Matching never waits: the exchange is a single store, and interceptors
+    // run on this thread, so none is inside match() when the old engine is
+    // released at the end of this scope.
+    active_.store(engine.get(), std::memory_order_release);
+    engine_.swap(engine);
+    stats_ = stats;
+
+    if (engine_) {
+        std::cout << "[Tsunami] Content blocking " << (from_cache ? "mapped" : "compiled") << ": "
+                  << stats.domain_rules << " domain, " << stats.substring_rules << " substring, "
+                  << stats.pattern_rules << " pattern, " << stats.exception_rules << " exception rules"
+                  << std::endl;
+    }
+    emit filtersChanged();
+}
+
+void ContentBlocker::install(QWebEnginePage* page) {
+    if (!page || interceptorFor(page)) return;
+    page->setUrlRequestInterceptor(new RequestInterceptor(page));
+}
+
+RequestInterceptor* ContentBlocker::interceptorFor(QWebEnginePage* page) {
+    return page ? page->findChild<RequestInterceptor*>(QString(), Qt::FindDirectChildrenOnly) : nullptr;
+}
+
+} // namespace Tsunami
@@ -0,0 +1,69 @@
+/*
+ * Tsunami Browser - Content blocking
+ * content_blocker.h - Owns the active filter engine and per-page interceptors
+ */
+
+#pragma once
+
+#include "blocking/filter_compiler.h"
+#include "blocking/filter_engine.h"
+#include <QObject>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+
+class QFileSystemWatcher;
+class QTimer;
+class QWebEnginePage;
+
+namespace Tsunami {
+
+class RequestInterceptor;
+
+// Loads the filter lists enabled in Settings (block_ads_ -> easylist,
+// block_trackers_ -> easyprivacy). A list placed in <data dir>/filters/
+// replaces the bundled starter list.
+//
+// Compiled lists are cached as a binary image in the cache directory and
+// mapped read-only on the next start. Whenever a list file changes, a
+// worker thread recompiles, rewrites the image and hands the new engine to
+// the UI thread, which publishes it with one pointer exchange.
+class ContentBlocker : public QObject {
+    Q_OBJECT
+public:
+    static ContentBlocker& instance();
+
+    // Null until the first load finishes or when blocking is disabled
+    const FilterEngine* engine() const { return active_.load(std::memory_order_acquire); }
+    const FilterCompileStats& stats() const { return stats_; }
+
+    void install(QWebEnginePage* page);
+    static RequestInterceptor* interceptorFor(QWebEnginePage* page);
+
+public slots:
+    void reload();
+
+signals:
+    void filtersChanged();
+
+private slots:
+    void onSettingsChanged();
+
+private:
+    ContentBlocker();
+    QStringList enabledLists() const;
+    void watch(const QStringList& paths);
+    void activate(std::shared_ptr<const FilterEngine> engine, const FilterCompileStats& stats, bool from_cache);
+
+    std::atomic<const FilterEngine*> active_{nullptr};
+    std::shared_ptr<const FilterEngine> engine_;   // Owns *active_
+    FilterCompileStats stats_;
+    QStringList loaded_lists_;
+    quint64 loaded_key_ = 0;
+    int generation_ = 0;
+
+    QFileSystemWatcher* watcher_;
+    QTimer* reload_timer_;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,101 @@
+/*
+ * Tsunami Browser - Content blocking
+ * cookie_policy.cpp - Third-party cookie filter for the profile cookie store
+ */
+
+#include "blocking/cookie_policy.h"
+#include "blocking/filter_data.h"
+#include "blocking/public_suffix.h"
+#include "settings/settings.h"
+#include <QWebEngineCookieStore>
+#include <QWebEngineProfile>
+#include <cstdint>
+
+namespace Tsunami {
+
+namespace {
+
+// 64 sets of 4 ways, least recently used way evicted within a set. A page
+// touches a handful of origins, so this holds every pair that matters
+// while staying a few cache lines per lookup.
+class SiteCache {
+public:
+    bool lookup(uint64_t key, bool& cross_site) {
+        Entry* set = entries_[key % SETS];
+        for (size_t way = 0; way < WAYS; ++way) {
+            if (set[way].key == key) {
+                set[way].last_use = ++clock_;
+                cross_site = set[way].cross_site;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void insert(uint64_t key, bool cross_site) {
+        Entry* set = entries_[key % SETS];
+        Entry* victim = &set[0];
+        for (size_t way = 1; way < WAYS; ++way) {
+            if (set[way].last_use < victim->last_use) victim = &set[way];
+        }
+        *victim = {key, ++clock_, cross_site};
+    }
+
+private:
+    static constexpr size_t SETS = 64;
+    static constexpr size_t WAYS = 4;
+
+    struct Entry {
+        uint64_t key = 0;
+        uint32_t last_use = 0;
+        bool cross_site = false;
+    };
+
+    Entry entries_[SETS][WAYS];
+    uint32_t clock_ = 0;
+};
+
+thread_local SiteCache t_site_cache;
+
+} // namespace
+
+CookiePolicy& CookiePolicy::instance() {
+    static CookiePolicy instance;
+    return instance;
+}
+
+CookiePolicy::CookiePolicy() {
+    Settings& settings = Settings::instance();
+    setBlockThirdParty(settings.getBlockThirdPartyCookies());
+    QObject::connect(&settings, &Settings::settingsChanged, &settings, [this]() {
+        setBlockThirdParty(Settings::instance().getBlockThirdPartyCookies());
+    });
+}
+
+void CookiePolicy::install(QWebEngineProfile* profile) {
+    if (!profile || profile->property("tsunamiCookiePolicy").toBool()) return;
+    profile->setProperty("tsunamiCookiePolicy", true);
+
+    profile->cookieStore()->setCookieFilter([this](const QWebEngineCookieStore::FilterRequest& request) {
+        if (!blockThirdParty()) return true;
+        const QByteArray site = request.firstPartyUrl.host(QUrl::FullyEncoded).toLatin1();
+        const QByteArray origin = request.origin.host(QUrl::FullyEncoded).toLatin1();
+        return allow(std::string_view(site.constData(), static_cast<size_t>(site.size())),
+                     std::string_view(origin.constData(), static_cast<size_t>(origin.size())));
+    });
+}
+
+bool CookiePolicy::allow(std::string_view site_host, std::string_view origin_host) const {
+    if (!blockThirdParty() || site_host.empty() || origin_host.empty()) return true;
+
+    // Zero marks an empty way, so keep real keys odd
+    uint64_t key = (hash_domain(site_host) * 0x9e3779b97f4a7c15ull ^ hash_domain(origin_host)) | 1;
+    bool cross_site = false;
+    if (!t_site_cache.lookup(key, cross_site)) {
+        cross_site = is_cross_site(origin_host, site_host);
+        t_site_cache.insert(key, cross_site);
+    }
+    return !cross_site;
+}
+
+} // namespace Tsunami
@@ -0,0 +1,38 @@
+/*
+ * Tsunami Browser - Content blocking
+ * cookie_policy.h - Third-party cookie filter for the profile cookie store
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string_view>
+
+class QWebEngineProfile;
+
+namespace Tsunami {
+
+// Applies Settings::getBlockThirdPartyCookies() through
+// QWebEngineCookieStore::setCookieFilter. Chromium calls the filter on
+// its IO thread for every cookie read and write, so the check is a
+// lookup in a small per-thread LRU keyed by the (site, origin) host pair,
+// backed by allocation-free public suffix lookups on a miss.
+class CookiePolicy {
+public:
+    static CookiePolicy& instance();
+
+    void install(QWebEngineProfile* profile);
+
+    bool blockThirdParty() const { return block_third_party_.load(std::memory_order_relaxed); }
+    void setBlockThirdParty(bool block) { block_third_party_.store(block, std::memory_order_relaxed); }
+
+    // Thread-safe. Empty hosts (opaque or missing origins) are allowed.
+    bool allow(std::string_view site_host, std::string_view origin_host) const;
+
+private:
+    CookiePolicy();
+
+    std::atomic<bool> block_third_party_{true};
+};
+
+} // namespace Tsunami
@@ -0,0 +1,199 @@
+/*
+ * Tsunami Browser - Content blocking
+ * filter_cache.cpp - Versioned, checksummed on-disk image of compiled filters
+ */
+
+#include "blocking/filter_cache.h"
+#include <cstring>
+
+namespace Tsunami {
+
+namespace {
+
+constexpr char FILTER_CACHE_MAGIC[8] = {'T', 'S', 'U', 'F', 'L', 'T', 'R', '\n'};
+
+enum Section : uint32_t {
+    BlockDomains,
+    BlockDomainsThird,
+    AllowDomains,
+    Patterns,
+    RuleDomains,
+    BlockBloom,
+    BlockHashes,
+    BlockOffsets,
+    BlockRules,
+    BlockUntokened,
+    AllowBloom,
+    AllowHashes,
+    AllowOffsets,
+    AllowRules,
+    AllowUntokened,
+    DocumentBloom,
+    DocumentHashes,
+    DocumentOffsets,
+    DocumentRules,
+    DocumentUntokened,
+    AcNodes,
+    AcEdges,
+    AcRoot,
+    Strings,
+    SectionCount
+};
+
+struct SectionEntry {
+    uint64_t offset;        // From the start of the image
+    uint64_t count;         // Elements, not bytes
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;   // Catches layout changes that forgot the version bump
+    uint64_t source_key;
+    uint64_t payload_size;
+    uint64_t checksum;      // Over everything after the header
+    uint64_t stats[6];
+    SectionEntry sections[SectionCount];
+};
+
+static_assert(sizeof(FileHeader) % 8 == 0, "sections must start 8 byte aligned");
+
+uint64_t rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+template <typename T>
+void append_section(std::string& out, FileHeader& header, Section section, const std::vector<T>& values) {
+    static_assert(alignof(T) <= 8);
+    out.resize((out.size() + 7) & ~size_t(7), '\0');
+    header.sections[section] = {out.size(), values.size()};
+    out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+template <typename T>
+bool view_section(std::span<const std::byte> bytes, const FileHeader& header, Section section,
+                  std::span<const T>& view) {
+    const SectionEntry& entry = header.sections[section];
+    if (entry.offset % alignof(T) || entry.offset < sizeof(FileHeader) || entry.offset > bytes.size()) return false;
+    if (entry.count > (bytes.size() - entry.offset) / sizeof(T)) return false;
+    view = std::span<const T>(reinterpret_cast<const T*>(bytes.data() + entry.offset), entry.count);
+    return true;
+}
+
+bool view_index(std::span<const std::byte> bytes, const FileHeader& header, Section first, TokenIndexView& index) {
+    return view_section(bytes, header, Section(first), index.bloom) &&
+           view_section(bytes, header, Section(first + 1), index.hashes) &&
+           view_section(bytes, header, Section(first + 2), index.offsets) &&
+           view_section(bytes, header, Section(first + 3), index.rules) &&
+           view_section(bytes, header, Section(first + 4), index.untokened) &&
+           index.bloom.size() == TOKEN_BLOOM_BITS / 64 &&
+           index.offsets.size() == index.hashes.size() + 1 &&
+           index.offsets.back() == index.rules.size();
+}
+
+} // namespace
+
+uint64_t filter_checksum(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed ^ (size * 0x9e3779b97f4a7c15ull);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        hash = rotl(hash ^ (word * 0x9e3779b97f4a7c15ull), 31) * 0xc2b2ae3d27d4eb4full;
+    }
+    for (; i < size; ++i) {
+        hash = rotl(hash ^ bytes[i], 11) * 0x9e3779b97f4a7c15ull;
+    }
+    return hash ^ (hash >> 29);
+}
+
+std::string serialize_filters(const CompiledFilters& filters, const FilterCompileStats& stats,
+                              uint64_t source_key) {
+    FileHeader header{};
+    std::memcpy(header.magic, FILTER_CACHE_MAGIC, sizeof(header.magic));
+    header.version = FILTER_CACHE_VERSION;
+    header.header_size = sizeof(FileHeader);
+    header.source_key = source_key;
+    header.stats[0] = stats.domain_rules;
+    header.stats[1] = stats.substring_rules;
+    header.stats[2] = stats.pattern_rules;
+    header.stats[3] = stats.exception_rules;
+    header.stats[4] = stats.skipped_cosmetic;
+    header.stats[5] = stats.skipped_unsupported;
+
+    std::string out(sizeof(FileHeader), '\0');
+    append_section(out, header, BlockDomains, filters.block_domains);
+    append_section(out, header, BlockDomainsThird, filters.block_domains_third);
+    append_section(out, header, AllowDomains, filters.allow_domains);
+    append_section(out, header, Patterns, filters.patterns);
+    append_section(out, header, RuleDomains, filters.rule_domains);
+    append_section(out, header, BlockBloom, filters.block_index.bloom);
+    append_section(out, header, BlockHashes, filters.block_index.hashes);
+    append_section(out, header, BlockOffsets, filters.block_index.offsets);
+    append_section(out, header, BlockRules, filters.block_index.rules);
+    append_section(out, header, BlockUntokened, filters.block_index.untokened);
+    append_section(out, header, AllowBloom, filters.allow_index.bloom);
+    append_section(out, header, AllowHashes, filters.allow_index.hashes);
+    append_section(out, header, AllowOffsets, filters.allow_index.offsets);
+    append_section(out, header, AllowRules, filters.allow_index.rules);
+    append_section(out, header, AllowUntokened, filters.allow_index.untokened);
+    append_section(out, header, DocumentBloom, filters.document_index.bloom);
+    append_section(out, header, DocumentHashes, filters.document_index.hashes);
+    append_section(out, header, DocumentOffsets, filters.document_index.offsets);
+    append_section(out, header, DocumentRules, filters.document_index.rules);
+    append_section(out, header, DocumentUntokened, filters.document_index.untokened);
+    append_section(out, header, AcNodes, filters.ac_nodes);
+    append_section(out, header, AcEdges, filters.ac_edges);
+    append_section(out, header, AcRoot, filters.ac_root);
+    append_section(out, header, Strings, filters.strings);
+    out.resize((out.size() + 7) & ~size_t(7), '\0');
+
+    header.payload_size = out.size() - sizeof(FileHeader);
+    header.checksum = filter_checksum(out.data() + sizeof(FileHeader), header.payload_size);
+    std::memcpy(out.data(), &header, sizeof(FileHeader));
+    return out;
+}
+
+bool view_filters(std::span<const std::byte> bytes, uint64_t source_key,
+                  FilterData& data, FilterCompileStats& stats) {
+    if (bytes.size() < sizeof(FileHeader) || reinterpret_cast<uintptr_t>(bytes.data()) % 8) return false;
+
+    FileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(FileHeader));
+    if (std::memcmp(header.magic, FILTER_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != FILTER_CACHE_VERSION ||
+        header.header_size != sizeof(FileHeader) ||
+        header.source_key != source_key ||
+        header.payload_size != bytes.size() - sizeof(FileHeader)) {
+        return false;
+    }
+    if (filter_checksum(bytes.data() + sizeof(FileHeader), header.payload_size) != header.checksum) return false;
+
+    FilterData view;
+    bool ok = view_section(bytes, header, BlockDomains, view.block_domains) &&
+              view_section(bytes, header, BlockDomainsThird, view.block_domains_third) &&
+              view_section(bytes, header, AllowDomains, view.allow_domains) &&
+              view_section(bytes, header, Patterns, view.patterns) &&
+              view_section(bytes, header, RuleDomains, view.rule_domains) &&
+              view_index(bytes, header, BlockBloom, view.block_index) &&
+              view_index(bytes, header, AllowBloom, view.allow_index) &&
+              view_index(bytes, header, DocumentBloom, view.document_index) &&
+              view_section(bytes, header, AcNodes, view.ac_nodes) &&
+              view_section(bytes, header, AcEdges, view.ac_edges) &&
+              view_section(bytes, header, AcRoot, view.ac_root) &&
+              view_section(bytes, header, Strings, view.strings) &&
+              !view.ac_nodes.empty() && view.ac_root.size() == 256;
+    if (!ok) return false;
+
+    data = view;
+    stats.domain_rules = header.stats[0];
+    stats.substring_rules = header.stats[1];
+    stats.pattern_rules = header.stats[2];
+    stats.exception_rules = header.stats[3];
+    stats.skipped_cosmetic = header.stats[4];
+    stats.skipped_unsupported = header.stats[5];
+    return true;
+}
+
+} // namespace Tsunami
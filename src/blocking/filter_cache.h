@@ -0,0 +1,35 @@
+/*
+ * Tsunami Browser - Content blocking
+ * filter_cache.h - Versioned, checksummed on-disk image of compiled filters
+ */
+
+#pragma once
+
+#include "blocking/filter_compiler.h"
+#include "blocking/filter_data.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace Tsunami {
+
+// Bump whenever FilterData, PatternRule, AcNode or the hashing changes
+constexpr uint32_t FILTER_CACHE_VERSION = 2;
+
+// 64-bit checksum over whole words; also used to fingerprint list sources
+uint64_t filter_checksum(const void* data, size_t size, uint64_t seed = 0);
+
+// The image is a fixed header followed by every FilterData array, each 8
+// byte aligned, in host byte order. Loading it is a bounds check per
+// section: FilterData views point straight into the buffer.
+std::string serialize_filters(const CompiledFilters& filters, const FilterCompileStats& stats,
+                              uint64_t source_key);
+
+// False if the image is truncated, corrupt, from another format version or
+// compiled from different sources. `bytes` must stay mapped for as long as
+// `data` is used.
+bool view_filters(std::span<const std::byte> bytes, uint64_t source_key,
+                  FilterData& data, FilterCompileStats& stats);
+
+} // namespace Tsunami
@@ -0,0 +1,427 @@
+/*
+ * Tsunami Browser - Content blocking
+ * filter_compiler.cpp - Compiles Adblock Plus style filter lists
+ */
+
+#include "blocking/filter_compiler.h"
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <unordered_map>
+
+namespace Tsunami {
+
+namespace {
+
+struct TypeOption {
+    std::string_view name;
+    uint32_t type;
+};
+
+const TypeOption TYPE_OPTIONS[] = {
+    {"script", ResourceScript},
+    {"image", ResourceImage},
+    {"stylesheet", ResourceStylesheet},
+    {"css", ResourceStylesheet},
+    {"xmlhttprequest", ResourceXhr},
+    {"xhr", ResourceXhr},
+    {"subdocument", ResourceSubdocument},
+    {"frame", ResourceSubdocument},
+    {"font", ResourceFont},
+    {"media", ResourceMedia},
+    {"object", ResourceObject},
+    {"ping", ResourcePing},
+    {"websocket", ResourceWebSocket},
+    {"other", ResourceOther}
+};
+
+// Tokens present in nearly every URL make useless index keys
+const std::string_view COMMON_TOKENS[] = {"http", "https", "www", "com"};
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+    return text;
+}
+
+bool is_cosmetic(std::string_view line) {
+    return line.find("##") != std::string_view::npos ||
+           line.find("#@#") != std::string_view::npos ||
+           line.find("#?#") != std::string_view::npos ||
+           line.find("#$#") != std::string_view::npos ||
+           line.find("#%#") != std::string_view::npos;
+}
+
+bool is_host_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '_';
+}
+
+std::string to_lower(std::string_view text) {
+    std::string out(text);
+    for (char& c : out) c = ascii_lower(c);
+    return out;
+}
+
+// Tokens of `pattern` that are guaranteed to appear as a whole token in
+// every URL the pattern matches
+template <typename Fn>
+void for_each_safe_token(std::string_view pattern, uint8_t flags, Fn&& fn) {
+    size_t i = 0;
+    while (i < pattern.size()) {
+        if (!is_token_char(pattern[i])) {
+            ++i;
+            continue;
+        }
+        size_t j = i;
+        while (j < pattern.size() && is_token_char(pattern[j])) ++j;
+
+        bool left = i > 0 ? pattern[i - 1] != '*' : (flags & (PatternAnchorHost | PatternAnchorStart)) != 0;
+        bool right = j < pattern.size() ? pattern[j] != '*' : (flags & PatternAnchorEnd) != 0;
+        std::string_view token = pattern.substr(i, j - i);
+        if (left && right && token.size() >= 2 &&
+            std::find(std::begin(COMMON_TOKENS), std::end(COMMON_TOKENS), token) == std::end(COMMON_TOKENS)) {
+            fn(token);
+        }
+        i = j;
+    }
+}
+
+} // namespace
+
+void FilterCompiler::add_list(std::string_view text) {
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        add_rule(text.substr(0, end));
+        if (end == std::string_view::npos) break;
+        text.remove_prefix(end + 1);
+    }
+}
+
+void FilterCompiler::add_rule(std::string_view line) {
+    line = trim(line);
+    if (line.empty() || line.front() == '!' || line.front() == '[') return;
+
+    if (is_cosmetic(line)) {
+        ++stats_.skipped_cosmetic;
+        return;
+    }
+
+    bool exception = line.substr(0, 2) == "@@";
+    if (exception) line.remove_prefix(2);
+
+    PendingPattern pending{};
+    pending.rule.types = ResourceAllTypes;
+    pending.rule.party = PartyAny;
+
+    std::string_view pattern = line;
+    size_t dollar = line.rfind('$');
+    if (dollar != std::string_view::npos) {
+        pattern = line.substr(0, dollar);
+        PageOptions page = parse_options(line.substr(dollar + 1), pending);
+        if (page == PageOptions::Unsupported) {
+            ++stats_.skipped_unsupported;
+            return;
+        }
+        // Page-wide options only make sense on exceptions. Element hiding
+        // is never applied, so turning it off leaves nothing to do.
+        if (page != PageOptions::None && !exception) {
+            ++stats_.skipped_unsupported;
+            return;
+        }
+        if (page == PageOptions::ElementHiding) {
+            ++stats_.skipped_cosmetic;
+            return;
+        }
+        if (page == PageOptions::Document) pending.rule.flags = PatternDocument;
+    }
+
+    if (pattern.size() >= 2 && pattern.front() == '/' && pattern.back() == '/') {
+        ++stats_.skipped_unsupported;
+        return;
+    }
+
+    uint8_t flags = pending.rule.flags | (exception ? PatternException : 0);
+    if (pattern.substr(0, 2) == "||") {
+        flags |= PatternAnchorHost;
+        pattern.remove_prefix(2);
+    } else if (!pattern.empty() && pattern.front() == '|') {
+        flags |= PatternAnchorStart;
+        pattern.remove_prefix(1);
+    }
+    if (!pattern.empty() && pattern.back() == '|') {
+        flags |= PatternAnchorEnd;
+        pattern.remove_suffix(1);
+    }
+
+    // A wildcard next to an anchor cancels it
+    if (!pattern.empty() && pattern.front() == '*') {
+        flags &= ~(PatternAnchorHost | PatternAnchorStart);
+        while (!pattern.empty() && pattern.front() == '*') pattern.remove_prefix(1);
+    }
+    if (!pattern.empty() && pattern.back() == '*') {
+        flags &= ~PatternAnchorEnd;
+        while (!pattern.empty() && pattern.back() == '*') pattern.remove_suffix(1);
+    }
+
+    bool plain_options = pending.rule.types == ResourceAllTypes &&
+                         pending.include_domains.empty() && pending.exclude_domains.empty();
+    if (pattern.empty() && plain_options) {
+        ++stats_.skipped_unsupported;   // Would match every request
+        return;
+    }
+
+    std::string lowered = to_lower(pattern);
+
+    // ||host^ with at most $third-party becomes a hash set probe
+    if ((flags & ~PatternException) == PatternAnchorHost && plain_options &&
+        lowered.size() > 1 && lowered.back() == '^' &&
+        std::all_of(lowered.begin(), lowered.end() - 1, is_host_char)) {
+        uint64_t hash = hash_domain(std::string_view(lowered).substr(0, lowered.size() - 1));
+        if (!exception && pending.rule.party == PartyAny) {
+            block_domains_.push_back(hash);
+            ++stats_.domain_rules;
+            return;
+        }
+        if (!exception && pending.rule.party == PartyThird) {
+            block_domains_third_.push_back(hash);
+            ++stats_.domain_rules;
+            return;
+        }
+        if (exception && pending.rule.party == PartyAny) {
+            allow_domains_.push_back(hash);
+            ++stats_.exception_rules;
+            return;
+        }
+    }
+
+    // Unanchored literals go into the automaton
+    if (!exception && flags == 0 && plain_options && pending.rule.party == PartyAny &&
+        lowered.find_first_of("*^|") == std::string::npos) {
+        substrings_.push_back(std::move(lowered));
+        ++stats_.substring_rules;
+        return;
+    }
+
+    pending.pattern = std::move(lowered);
+    pending.rule.flags = flags;
+    patterns_.push_back(std::move(pending));
+    if (exception) {
+        ++stats_.exception_rules;
+    } else {
+        ++stats_.pattern_rules;
+    }
+}
+
+FilterCompiler::PageOptions FilterCompiler::parse_options(std::string_view options, PendingPattern& pending) {
+    uint32_t include_types = 0;
+    uint32_t exclude_types = 0;
+    PageOptions page = PageOptions::None;
+
+    while (!options.empty()) {
+        size_t comma = options.find(',');
+        std::string_view option = trim(options.substr(0, comma));
+        options.remove_prefix(comma == std::string_view::npos ? options.size() : comma + 1);
+        if (option.empty()) continue;
+
+        bool negated = option.front() == '~';
+        if (negated) option.remove_prefix(1);
+
+        if (option == "third-party" || option == "3p") {
+            pending.rule.party = negated ? PartyFirst : PartyThird;
+        } else if (option == "first-party" || option == "1p") {
+            pending.rule.party = negated ? PartyThird : PartyFirst;
+        } else if (option == "important") {
+            // Only changes how exceptions apply; treated as a normal rule
+        } else if (option == "document" || option == "doc") {
+            if (negated) return PageOptions::Unsupported;
+            page = PageOptions::Document;
+        } else if (option == "elemhide" || option == "ehide" || option == "generichide" || option == "ghide") {
+            if (negated) return PageOptions::Unsupported;
+            if (page == PageOptions::None) page = PageOptions::ElementHiding;
+        } else if (option.substr(0, 7) == "domain=" && !negated) {
+            std::string_view domains = option.substr(7);
+            while (!domains.empty()) {
+                size_t bar = domains.find('|');
+                std::string_view domain = domains.substr(0, bar);
+                domains.remove_prefix(bar == std::string_view::npos ? domains.size() : bar + 1);
+                if (domain.empty()) continue;
+                if (domain.front() == '~') {
+                    pending.exclude_domains.push_back(hash_domain(domain.substr(1)));
+                } else {
+                    pending.include_domains.push_back(hash_domain(domain));
+                }
+            }
+        } else {
+            auto it = std::find_if(std::begin(TYPE_OPTIONS), std::end(TYPE_OPTIONS),
+                                   [&](const TypeOption& type) { return type.name == option; });
+            if (it == std::end(TYPE_OPTIONS)) return PageOptions::Unsupported;   // popup, csp, redirect, match-case, ...
+            (negated ? exclude_types : include_types) |= it->type;
+        }
+    }
+
+    // Types beside $elemhide are still request exceptions; a $document
+    // exception covers every request the page makes, whatever the types
+    if (page == PageOptions::ElementHiding && include_types) page = PageOptions::None;
+    uint32_t types = include_types && page == PageOptions::None ? include_types : ResourceAllTypes;
+    types &= ~exclude_types;
+    if (!types) return PageOptions::Unsupported;
+    pending.rule.types = types;
+    if (pending.include_domains.size() > 0xffff || pending.exclude_domains.size() > 0xffff) {
+        return PageOptions::Unsupported;
+    }
+    return page;
+}
+
+CompiledFilters FilterCompiler::compile() {
+    CompiledFilters out;
+
+    auto sorted_unique = [](std::vector<uint64_t> values) {
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        return values;
+    };
+    out.block_domains = sorted_unique(block_domains_);
+    out.block_domains_third = sorted_unique(block_domains_third_);
+    out.allow_domains = sorted_unique(allow_domains_);
+
+    std::vector<uint32_t> block_ids;
+    std::vector<uint32_t> allow_ids;
+    std::vector<uint32_t> document_ids;
+    out.patterns.reserve(patterns_.size());
+    for (const PendingPattern& pending : patterns_) {
+        PatternRule rule = pending.rule;
+        rule.pattern_offset = static_cast<uint32_t>(out.strings.size());
+        rule.pattern_length = static_cast<uint16_t>(std::min<size_t>(pending.pattern.size(), 0xffff));
+        out.strings.insert(out.strings.end(), pending.pattern.begin(), pending.pattern.begin() + rule.pattern_length);
+
+        rule.domains_offset = static_cast<uint32_t>(out.rule_domains.size());
+        rule.include_domains = static_cast<uint16_t>(pending.include_domains.size());
+        rule.exclude_domains = static_cast<uint16_t>(pending.exclude_domains.size());
+        out.rule_domains.insert(out.rule_domains.end(), pending.include_domains.begin(), pending.include_domains.end());
+        out.rule_domains.insert(out.rule_domains.end(), pending.exclude_domains.begin(), pending.exclude_domains.end());
+
+        uint32_t id = static_cast<uint32_t>(out.patterns.size());
+        if (rule.flags & PatternDocument) {
+            document_ids.push_back(id);
+        } else {
+            (rule.flags & PatternException ? allow_ids : block_ids).push_back(id);
+        }
+        out.patterns.push_back(rule);
+    }
+
+    build_token_index(block_ids, out.block_index, out);
+    build_token_index(allow_ids, out.allow_index, out);
+    build_token_index(document_ids, out.document_index, out);
+    build_automaton(out);
+    return out;
+}
+
+void FilterCompiler::build_token_index(const std::vector<uint32_t>& rule_ids, TokenIndex& index,
+                                       const CompiledFilters& out) const {
+    auto pattern_of = [&](uint32_t id) {
+        const PatternRule& rule = out.patterns[id];
+        return std::string_view(out.strings.data() + rule.pattern_offset, rule.pattern_length);
+    };
+
+    // Key each rule by its rarest safe token so buckets stay short
+    std::unordered_map<uint32_t, uint32_t> frequency;
+    for (uint32_t id : rule_ids) {
+        for_each_safe_token(pattern_of(id), out.patterns[id].flags,
+                            [&](std::string_view token) { ++frequency[hash_token(token)]; });
+    }
+
+    std::map<uint32_t, std::vector<uint32_t>> buckets;
+    for (uint32_t id : rule_ids) {
+        uint32_t best = 0;
+        uint32_t best_count = 0;
+        size_t best_length = 0;
+        for_each_safe_token(pattern_of(id), out.patterns[id].flags, [&](std::string_view token) {
+            uint32_t hash = hash_token(token);
+            uint32_t count = frequency[hash];
+            if (!best_count || count < best_count || (count == best_count && token.size() > best_length)) {
+                best = hash;
+                best_count = count;
+                best_length = token.size();
+            }
+        });
+        if (best_count) {
+            buckets[best].push_back(id);
+        } else {
+            index.untokened.push_back(id);
+        }
+    }
+
+    index.bloom.assign(TOKEN_BLOOM_BITS / 64, 0);
+    index.hashes.reserve(buckets.size());
+    index.offsets.reserve(buckets.size() + 1);
+    for (const auto& [hash, ids] : buckets) {
+        index.bloom[(hash % TOKEN_BLOOM_BITS) / 64] |= 1ull << (hash % 64);
+        index.hashes.push_back(hash);
+        index.offsets.push_back(static_cast<uint32_t>(index.rules.size()));
+        index.rules.insert(index.rules.end(), ids.begin(), ids.end());
+    }
+    index.offsets.push_back(static_cast<uint32_t>(index.rules.size()));
+}
+
+void FilterCompiler::build_automaton(CompiledFilters& out) const {
+    struct BuildNode {
+        std::map<uint8_t, uint32_t> next;
+        uint32_t fail = 0;
+        uint32_t output = AC_NO_OUTPUT;
+        uint32_t output_link = AC_NO_OUTPUT;
+    };
+    std::vector<BuildNode> trie(1);
+
+    for (uint32_t id = 0; id < substrings_.size(); ++id) {
+        uint32_t node = 0;
+        for (char c : substrings_[id]) {
+            uint8_t byte = static_cast<uint8_t>(c);
+            auto it = trie[node].next.find(byte);
+            if (it == trie[node].next.end()) {
+                trie[node].next[byte] = static_cast<uint32_t>(trie.size());
+                node = static_cast<uint32_t>(trie.size());
+                trie.emplace_back();
+            } else {
+                node = it->second;
+            }
+        }
+        if (trie[node].output == AC_NO_OUTPUT) trie[node].output = id;
+    }
+
+    // Breadth-first so every fail target is finished before it is used
+    std::deque<uint32_t> queue;
+    for (const auto& [byte, child] : trie[0].next) queue.push_back(child);
+    while (!queue.empty()) {
+        uint32_t node = queue.front();
+        queue.pop_front();
+        for (const auto& [byte, child] : trie[node].next) {
+            uint32_t fail = trie[node].fail;
+            while (fail && !trie[fail].next.count(byte)) fail = trie[fail].fail;
+            auto it = trie[fail].next.find(byte);
+            trie[child].fail = (it != trie[fail].next.end() && it->second != child) ? it->second : 0;
+
+            const BuildNode& target = trie[trie[child].fail];
+            trie[child].output_link = target.output != AC_NO_OUTPUT ? trie[child].fail : target.output_link;
+            queue.push_back(child);
+        }
+    }
+
+    out.ac_nodes.reserve(trie.size());
+    for (const BuildNode& node : trie) {
+        AcNode flat{};
+        flat.edge_begin = static_cast<uint32_t>(out.ac_edges.size());
+        flat.edge_count = static_cast<uint32_t>(node.next.size());
+        flat.fail = node.fail;
+        flat.output = node.output;
+        flat.output_link = node.output_link;
+        for (const auto& [byte, child] : node.next) {
+            out.ac_edges.push_back({child, byte, {}});
+        }
+        out.ac_nodes.push_back(flat);
+    }
+
+    out.ac_root.assign(256, 0);
+    for (const auto& [byte, child] : trie[0].next) out.ac_root[byte] = child;
+}
+
+} // namespace Tsunami
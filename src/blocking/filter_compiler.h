@@ -0,0 +1,64 @@
+/*
+ * Tsunami Browser - Content blocking
+ * filter_compiler.h - Compiles Adblock Plus style filter lists
+ */
+
+#pragma once
+
+#include "blocking/filter_data.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Tsunami {
+
+struct FilterCompileStats {
+    size_t domain_rules = 0;        // ||host^ into the hashed domain sets
+    size_t substring_rules = 0;     // Plain substrings into the Aho-Corasick automaton
+    size_t pattern_rules = 0;       // Everything else, token indexed
+    size_t exception_rules = 0;     // $document ones included
+    size_t skipped_cosmetic = 0;    // Element hiding and $elemhide, not applicable to requests
+    size_t skipped_unsupported = 0; // Regex rules and options we cannot honour
+};
+
+// Turns EasyList / EasyPrivacy text into CompiledFilters. Rules are
+// classified into the cheapest structure that can represent them exactly;
+// a rule that would need semantics the matcher does not implement is
+// dropped rather than approximated, so no blocking rule over-blocks.
+// Exceptions that turn blocking off for a whole page ($document) are
+// honoured; only an exception the matcher cannot express (a regex, $popup,
+// ...) is lost.
+class FilterCompiler {
+public:
+    void add_list(std::string_view text);
+    void add_rule(std::string_view line);
+
+    CompiledFilters compile();
+    const FilterCompileStats& stats() const { return stats_; }
+
+private:
+    struct PendingPattern {
+        std::string pattern;
+        PatternRule rule;
+        std::vector<uint64_t> include_domains;
+        std::vector<uint64_t> exclude_domains;
+    };
+
+    // Options that apply to the page a request comes from, not the request
+    enum class PageOptions { None, Document, ElementHiding, Unsupported };
+
+    PageOptions parse_options(std::string_view options, PendingPattern& pending);
+    void build_token_index(const std::vector<uint32_t>& rule_ids, TokenIndex& index,
+                           const CompiledFilters& out) const;
+    void build_automaton(CompiledFilters& out) const;
+
+    std::vector<uint64_t> block_domains_;
+    std::vector<uint64_t> block_domains_third_;
+    std::vector<uint64_t> allow_domains_;
+    std::vector<std::string> substrings_;
+    std::vector<PendingPattern> patterns_;
+    FilterCompileStats stats_;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,182 @@
+/*
+ * Tsunami Browser - Content blocking
+ * filter_data.h - Flat, pointer-free layout of a compiled filter list
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Tsunami {
+
+// Request types a rule can be restricted to ($script, $image, ...)
+enum ResourceType : uint32_t {
+    ResourceOther       = 1u << 0,
+    ResourceScript      = 1u << 1,
+    ResourceImage       = 1u << 2,
+    ResourceStylesheet  = 1u << 3,
+    ResourceXhr         = 1u << 4,
+    ResourceSubdocument = 1u << 5,
+    ResourceFont        = 1u << 6,
+    ResourceMedia       = 1u << 7,
+    ResourceObject      = 1u << 8,
+    ResourcePing        = 1u << 9,
+    ResourceWebSocket   = 1u << 10,
+    ResourceAllTypes    = (1u << 11) - 1
+};
+
+enum PatternFlags : uint8_t {
+    PatternAnchorStart = 1u << 0,   // |http://
+    PatternAnchorHost  = 1u << 1,   // ||example.com
+    PatternAnchorEnd   = 1u << 2,   // .js|
+    PatternException   = 1u << 3,   // @@
+    PatternDocument    = 1u << 4    // @@...$document: matched against the page, not the request
+};
+
+enum PartyMask : uint8_t {
+    PartyAny   = 0,
+    PartyThird = 1,
+    PartyFirst = 2
+};
+
+// Every rule that is not a plain domain or a plain substring. All strings
+// are offsets into FilterData::strings, all domain lists offsets into
+// FilterData::rule_domains, so the table can be written to disk as is.
+struct PatternRule {
+    uint32_t pattern_offset;
+    uint16_t pattern_length;
+    uint8_t flags;
+    uint8_t party;
+    uint32_t types;
+    uint32_t domains_offset;
+    uint16_t include_domains;   // $domain=a.com|b.com
+    uint16_t exclude_domains;   // $domain=~c.com
+};
+
+// Most URL tokens are in no bucket; one bit test rejects them before the
+// binary search over hashes
+constexpr uint32_t TOKEN_BLOOM_BITS = 1u << 16;
+
+// Aho-Corasick automaton over plain substring rules. A node's outgoing
+// edges are a contiguous run of AcEdge sorted by byte; the root, where the
+// scan spends most of its time, also has a dense 256 entry table.
+struct AcNode {
+    uint32_t edge_begin;
+    uint32_t edge_count;
+    uint32_t fail;
+    uint32_t output;            // Rule id ending here, or AC_NO_OUTPUT
+    uint32_t output_link;       // Nearest fail-chain node with an output
+};
+
+struct AcEdge {
+    uint32_t target;
+    uint8_t byte;
+    uint8_t padding[3];
+};
+
+constexpr uint32_t AC_NO_OUTPUT = 0xffffffffu;
+
+// Pattern rules bucketed by one token every URL they can match must contain
+struct TokenIndexView {
+    std::span<const uint64_t> bloom;      // TOKEN_BLOOM_BITS bit filter in front of hashes
+    std::span<const uint32_t> hashes;     // sorted, unique
+    std::span<const uint32_t> offsets;    // hashes[i] -> rules[offsets[i], offsets[i + 1])
+    std::span<const uint32_t> rules;
+    std::span<const uint32_t> untokened;  // Patterns with no usable token, tried on every request
+};
+
+struct TokenIndex {
+    std::vector<uint64_t> bloom;
+    std::vector<uint32_t> hashes;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> rules;
+    std::vector<uint32_t> untokened;
+
+    TokenIndexView view() const { return {bloom, hashes, offsets, rules, untokened}; }
+};
+
+// Read-only view the matcher works on. Nothing in here owns memory.
+struct FilterData {
+    std::span<const uint64_t> block_domains;          // ||host^          sorted
+    std::span<const uint64_t> block_domains_third;    // ||host^$3p       sorted
+    std::span<const uint64_t> allow_domains;          // @@||host^        sorted
+    std::span<const PatternRule> patterns;
+    std::span<const uint64_t> rule_domains;
+    TokenIndexView block_index;
+    TokenIndexView allow_index;                       // @@ exceptions, only consulted after a block
+    TokenIndexView document_index;                    // @@...$document, against the page's URL
+    std::span<const AcNode> ac_nodes;
+    std::span<const AcEdge> ac_edges;
+    std::span<const uint32_t> ac_root;
+    std::span<const char> strings;
+};
+
+// Heap-backed storage produced by FilterCompiler
+struct CompiledFilters {
+    std::vector<uint64_t> block_domains;
+    std::vector<uint64_t> block_domains_third;
+    std::vector<uint64_t> allow_domains;
+    std::vector<PatternRule> patterns;
+    std::vector<uint64_t> rule_domains;
+    TokenIndex block_index;
+    TokenIndex allow_index;
+    TokenIndex document_index;
+    std::vector<AcNode> ac_nodes;
+    std::vector<AcEdge> ac_edges;
+    std::vector<uint32_t> ac_root;
+    std::vector<char> strings;
+
+    FilterData view() const {
+        return {block_domains, block_domains_third, allow_domains, patterns, rule_domains,
+                block_index.view(), allow_index.view(), document_index.view(), ac_nodes, ac_edges, ac_root,
+                strings};
+    }
+};
+
+// Byte classes for the per-character loops of the match path
+struct ByteTable {
+    char lower[256];
+    bool token[256];
+
+    constexpr ByteTable() : lower(), token() {
+        for (int c = 0; c < 256; ++c) {
+            lower[c] = static_cast<char>((c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c);
+            token[c] = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '%';
+        }
+    }
+};
+
+inline constexpr ByteTable BYTE_TABLE{};
+
+inline char ascii_lower(char c) {
+    return BYTE_TABLE.lower[static_cast<uint8_t>(c)];
+}
+
+inline bool is_token_char(char c) {
+    return BYTE_TABLE.token[static_cast<uint8_t>(c)];
+}
+
+// FNV-1a over the lowercased bytes; the same function is used when
+// compiling and when matching so case never has to be normalised up front
+inline uint64_t hash_domain(std::string_view text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : text) {
+        hash ^= static_cast<uint8_t>(ascii_lower(c));
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+inline uint32_t hash_token(std::string_view text) {
+    uint32_t hash = 2166136261u;
+    for (char c : text) {
+        hash ^= static_cast<uint8_t>(ascii_lower(c));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace Tsunami
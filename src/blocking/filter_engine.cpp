@@ -0,0 +1,282 @@
+/*
+ * Tsunami Browser - Content blocking
+ * filter_engine.cpp - Allocation-free request matcher over compiled filters
+ */
+
+#include "blocking/filter_engine.h"
+#include "blocking/public_suffix.h"
+#include <algorithm>
+
+namespace Tsunami {
+
+namespace {
+
+constexpr size_t NO_MATCH = static_cast<size_t>(-1);
+
+// ^ in a filter: anything but a letter, digit or one of _ - . %
+bool is_separator(char c) {
+    return !((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+             c == '_' || c == '-' || c == '.' || c == '%');
+}
+
+// Matches one wildcard-free segment at `pos`; returns the end position
+size_t match_segment_at(std::string_view url, size_t pos, std::string_view segment) {
+    for (size_t i = 0; i < segment.size(); ++i) {
+        size_t at = pos + i;
+        char expected = segment[i];
+        if (at >= url.size()) {
+            // A trailing ^ also matches the end of the address
+            return (expected == '^' && i + 1 == segment.size()) ? url.size() : NO_MATCH;
+        }
+        if (expected == '^') {
+            if (!is_separator(url[at])) return NO_MATCH;
+        } else if (ascii_lower(url[at]) != expected) {
+            return NO_MATCH;
+        }
+    }
+    return pos + segment.size();
+}
+
+size_t find_segment(std::string_view url, size_t from, std::string_view segment) {
+    char first = segment.front();
+    for (size_t pos = from; pos < url.size(); ++pos) {
+        if (first != '^' && ascii_lower(url[pos]) != first) continue;
+        size_t end = match_segment_at(url, pos, segment);
+        if (end != NO_MATCH) return end;
+    }
+    return segment == "^" ? url.size() : NO_MATCH;
+}
+
+bool match_segment_at_end(std::string_view url, size_t from, std::string_view segment) {
+    if (segment.size() <= url.size() && url.size() - segment.size() >= from &&
+        match_segment_at(url, url.size() - segment.size(), segment) == url.size()) {
+        return true;
+    }
+    // Trailing ^ satisfied by the end of the address
+    size_t shorter = segment.size() - 1;
+    return segment.back() == '^' && shorter <= url.size() && url.size() - shorter >= from &&
+           match_segment_at(url, url.size() - shorter, segment) == url.size();
+}
+
+// Leftmost-greedy glob match; * never needs backtracking because each
+// segment only has to occur somewhere after the previous one
+bool match_pattern_from(std::string_view url, size_t start, std::string_view pattern,
+                        bool anchored, bool anchor_end) {
+    size_t pos = start;
+    bool first = true;
+    while (true) {
+        size_t star = pattern.find('*');
+        bool last = star == std::string_view::npos;
+        std::string_view segment = pattern.substr(0, star);
+
+        if (last && anchor_end) {
+            if (first && anchored) return match_segment_at(url, pos, segment) == url.size();
+            return segment.empty() || match_segment_at_end(url, pos, segment);
+        }
+        if (!segment.empty()) {
+            pos = (first && anchored) ? match_segment_at(url, pos, segment) : find_segment(url, pos, segment);
+            if (pos == NO_MATCH) return false;
+        }
+        if (last) return true;
+
+        first = false;
+        pattern.remove_prefix(star + 1);
+    }
+}
+
+} // namespace
+
+FilterEngine::FilterEngine(CompiledFilters filters)
+    : storage_(std::move(filters))
+    , data_(storage_.view())
+{
+}
+
+FilterEngine::FilterEngine(const FilterData& data, std::shared_ptr<const void> backing)
+    : backing_(std::move(backing))
+    , data_(data)
+{
+}
+
+bool FilterEngine::is_third_party(std::string_view host, std::string_view site_host) {
+    return !site_host.empty() && is_cross_site(host, site_host);
+}
+
+FilterEngine::UrlView FilterEngine::url_view(std::string_view url, std::string_view host) {
+    UrlView view{url, 0, 0};
+    size_t scheme = url.find("://");
+    view.host_begin = scheme == std::string_view::npos ? 0 : scheme + 3;
+    view.host_end = std::min(view.host_begin + host.size(), url.size());
+    return view;
+}
+
+MatchResult FilterEngine::match(const FilterRequest& request) const {
+    UrlView url = url_view(request.url, request.host);
+
+    MatchResult result;
+    uint32_t rule = 0;
+    if (match_domain_set(data_.block_domains, request.host) ||
+        (request.third_party && match_domain_set(data_.block_domains_third, request.host))) {
+        result = {true, MatchSource::Domain, 0};
+    } else if (match_automaton(request.url, rule)) {
+        result = {true, MatchSource::Substring, rule};
+    } else if (match_index(data_.block_index, request, url, rule)) {
+        result = {true, MatchSource::Pattern, rule};
+    } else {
+        return result;
+    }
+
+    if (match_domain_set(data_.allow_domains, request.host) ||
+        match_index(data_.allow_index, request, url, rule) ||
+        document_allowed(request)) {
+        return {};
+    }
+    return result;
+}
+
+// @@...$document rules match the page itself, as if it were the request
+bool FilterEngine::document_allowed(const FilterRequest& request) const {
+    const TokenIndexView& index = data_.document_index;
+    if (request.site_url.empty() || (index.rules.empty() && index.untokened.empty())) return false;
+
+    FilterRequest page;
+    page.url = request.site_url;
+    page.host = request.site_host;
+    page.site_host = request.site_host;
+    page.type = ResourceAllTypes;
+    uint32_t rule = 0;
+    return match_index(index, page, url_view(page.url, page.host), rule);
+}
+
+bool FilterEngine::match_domain_set(std::span<const uint64_t> set, std::string_view host) const {
+    if (set.empty()) return false;
+    // Probe the host and every parent domain: a.b.example.com, b.example.com, ...
+    while (!host.empty()) {
+        if (std::binary_search(set.begin(), set.end(), hash_domain(host))) return true;
+        size_t dot = host.find('.');
+        if (dot == std::string_view::npos) break;
+        host.remove_prefix(dot + 1);
+    }
+    return false;
+}
+
+bool FilterEngine::match_automaton(std::string_view url, uint32_t& rule) const {
+    if (data_.ac_nodes.size() <= 1) return false;
+
+    const AcNode* nodes = data_.ac_nodes.data();
+    const AcEdge* edges = data_.ac_edges.data();
+    const uint32_t* root = data_.ac_root.data();
+    uint32_t state = 0;
+    for (char c : url) {
+        uint8_t byte = static_cast<uint8_t>(ascii_lower(c));
+        while (state) {
+            const AcNode& node = nodes[state];
+            const AcEdge* edge = edges + node.edge_begin;
+            const AcEdge* end = edge + node.edge_count;
+            while (edge != end && edge->byte < byte) ++edge;   // Past the root, nodes have few edges
+            if (edge != end && edge->byte == byte) break;
+            state = node.fail;
+        }
+        if (state) {
+            const AcNode& node = nodes[state];
+            const AcEdge* edge = edges + node.edge_begin;
+            while (edge->byte != byte) ++edge;
+            state = edge->target;
+        } else {
+            state = root[byte];
+            if (!state) continue;
+        }
+
+        const AcNode& node = nodes[state];
+        if (node.output != AC_NO_OUTPUT) {
+            rule = node.output;
+            return true;
+        }
+        if (node.output_link != AC_NO_OUTPUT) {
+            rule = nodes[node.output_link].output;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FilterEngine::match_index(const TokenIndexView& index, const FilterRequest& request,
+                               const UrlView& url, uint32_t& rule) const {
+    for (uint32_t id : index.untokened) {
+        if (rule_matches(data_.patterns[id], request, url)) {
+            rule = id;
+            return true;
+        }
+    }
+    if (index.hashes.empty()) return false;
+
+    std::string_view text = url.url;
+    size_t i = 0;
+    while (i < text.size()) {
+        if (!is_token_char(text[i])) {
+            ++i;
+            continue;
+        }
+        size_t j = i;
+        while (j < text.size() && is_token_char(text[j])) ++j;
+
+        uint32_t hash = hash_token(text.substr(i, j - i));
+        i = j;
+        if (!(index.bloom[(hash % TOKEN_BLOOM_BITS) / 64] & (1ull << (hash % 64)))) continue;
+
+        auto it = std::lower_bound(index.hashes.begin(), index.hashes.end(), hash);
+        if (it != index.hashes.end() && *it == hash) {
+            size_t bucket = static_cast<size_t>(it - index.hashes.begin());
+            for (uint32_t k = index.offsets[bucket]; k < index.offsets[bucket + 1]; ++k) {
+                uint32_t id = index.rules[k];
+                if (rule_matches(data_.patterns[id], request, url)) {
+                    rule = id;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool FilterEngine::site_in(std::span<const uint64_t> domains, std::string_view site_host) const {
+    while (!site_host.empty()) {
+        uint64_t hash = hash_domain(site_host);
+        if (std::find(domains.begin(), domains.end(), hash) != domains.end()) return true;
+        size_t dot = site_host.find('.');
+        if (dot == std::string_view::npos) break;
+        site_host.remove_prefix(dot + 1);
+    }
+    return false;
+}
+
+bool FilterEngine::rule_matches(const PatternRule& rule, const FilterRequest& request, const UrlView& url) const {
+    if (!(rule.types & request.type)) return false;
+    if (rule.party == PartyThird && !request.third_party) return false;
+    if (rule.party == PartyFirst && request.third_party) return false;
+
+    if (rule.include_domains || rule.exclude_domains) {
+        std::span<const uint64_t> domains = data_.rule_domains.subspan(rule.domains_offset);
+        if (rule.include_domains && !site_in(domains.first(rule.include_domains), request.site_host)) return false;
+        if (rule.exclude_domains &&
+            site_in(domains.subspan(rule.include_domains, rule.exclude_domains), request.site_host)) return false;
+    }
+
+    std::string_view pattern(data_.strings.data() + rule.pattern_offset, rule.pattern_length);
+    bool anchor_end = rule.flags & PatternAnchorEnd;
+
+    if (rule.flags & PatternAnchorHost) {
+        // ||: start of the host or of any label within it
+        for (size_t pos = url.host_begin; pos < url.host_end; ++pos) {
+            if (pos != url.host_begin && url.url[pos - 1] != '.') continue;
+            if (match_pattern_from(url.url, pos, pattern, true, anchor_end)) return true;
+        }
+        return false;
+    }
+    if (rule.flags & PatternAnchorStart) {
+        return match_pattern_from(url.url, 0, pattern, true, anchor_end);
+    }
+    return match_pattern_from(url.url, 0, pattern, false, anchor_end);
+}
+
+} // namespace Tsunami
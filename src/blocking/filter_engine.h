@@ -0,0 +1,76 @@
+/*
+ * Tsunami Browser - Content blocking
+ * filter_engine.h - Allocation-free request matcher over compiled filters
+ */
+
+#pragma once
+
+#include "blocking/filter_data.h"
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace Tsunami {
+
+struct FilterRequest {
+    std::string_view url;        // Encoded URL without user info
+    std::string_view host;
+    std::string_view site_host;  // Host of the top-level document
+    std::string_view site_url;   // The top-level document, for $document exceptions
+    uint32_t type = ResourceOther;
+    bool third_party = false;
+};
+
+enum class MatchSource : uint8_t {
+    None,
+    Domain,
+    Substring,
+    Pattern
+};
+
+struct MatchResult {
+    bool blocked = false;
+    MatchSource source = MatchSource::None;
+    uint32_t rule = 0;           // Index within the structure named by source
+};
+
+// Matches requests against a compiled list. The cheap structures run
+// first: a hashed probe per host label, one Aho-Corasick pass over the URL,
+// then only the pattern buckets keyed by tokens the URL actually contains.
+// Exceptions are consulted only once something has matched. match() never
+// allocates and is safe to call from any number of threads at once.
+class FilterEngine {
+public:
+    explicit FilterEngine(CompiledFilters filters);
+    // Views into memory owned by `backing`, e.g. a mapped filter cache
+    FilterEngine(const FilterData& data, std::shared_ptr<const void> backing);
+
+    MatchResult match(const FilterRequest& request) const;
+
+    const FilterData& data() const { return data_; }
+
+    // Different registrable domains per the public suffix list
+    static bool is_third_party(std::string_view host, std::string_view site_host);
+
+private:
+    struct UrlView {
+        std::string_view url;
+        size_t host_begin;
+        size_t host_end;
+    };
+
+    static UrlView url_view(std::string_view url, std::string_view host);
+    bool match_domain_set(std::span<const uint64_t> set, std::string_view host) const;
+    bool document_allowed(const FilterRequest& request) const;
+    bool match_automaton(std::string_view url, uint32_t& rule) const;
+    bool match_index(const TokenIndexView& index, const FilterRequest& request,
+                     const UrlView& url, uint32_t& rule) const;
+    bool rule_matches(const PatternRule& rule, const FilterRequest& request, const UrlView& url) const;
+    bool site_in(std::span<const uint64_t> domains, std::string_view site_host) const;
+
+    CompiledFilters storage_;
+    std::shared_ptr<const void> backing_;
+    FilterData data_;
+};
+
+} // namespace Tsunami
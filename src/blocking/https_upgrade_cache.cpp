@@ -0,0 +1,179 @@
+/*
+ * Tsunami Browser - Content blocking
+ * https_upgrade_cache.cpp - Hosts known to fail over HTTPS
+ */
+
+#include "blocking/https_upgrade_cache.h"
+#include "blocking/filter_data.h"
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace Tsunami {
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] = {'T', 'S', 'U', 'H', 'T', 'T', 'P', 'S'};
+constexpr uint32_t CACHE_VERSION = 1;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bloom_bits;
+    uint64_t entry_count;
+};
+
+struct CacheEntry {
+    uint64_t host_hash;
+    int64_t expires;
+};
+
+} // namespace
+
+HttpsUpgradeCache& HttpsUpgradeCache::instance() {
+    static HttpsUpgradeCache instance;
+    return instance;
+}
+
+void HttpsUpgradeCache::init(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = path;
+    load();
+}
+
+// Double hashing: k positions from the two halves of one 64-bit hash
+void HttpsUpgradeCache::bloom_positions(uint64_t hash, uint32_t (&positions)[BLOOM_HASHES]) {
+    uint32_t h1 = static_cast<uint32_t>(hash);
+    uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+    for (int i = 0; i < BLOOM_HASHES; ++i) {
+        positions[i] = (h1 + static_cast<uint32_t>(i) * h2) % BLOOM_BITS;
+    }
+}
+
+void HttpsUpgradeCache::bloom_add(uint64_t hash) {
+    uint32_t positions[BLOOM_HASHES];
+    bloom_positions(hash, positions);
+    for (uint32_t bit : positions) bloom_[bit / 64] |= 1ull << (bit % 64);
+}
+
+bool HttpsUpgradeCache::bloom_test(uint64_t hash) const {
+    uint32_t positions[BLOOM_HASHES];
+    bloom_positions(hash, positions);
+    for (uint32_t bit : positions) {
+        if (!(bloom_[bit / 64] & (1ull << (bit % 64)))) return false;
+    }
+    return true;
+}
+
+bool HttpsUpgradeCache::should_skip(std::string_view host, int64_t now) const {
+    uint64_t hash = hash_domain(host);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!bloom_test(hash)) return false;
+    auto it = expires_.find(hash);
+    return it != expires_.end() && it->second > now;
+}
+
+void HttpsUpgradeCache::record_failure(std::string_view host, int64_t now) {
+    uint64_t hash = hash_domain(host);
+    std::lock_guard<std::mutex> lock(mutex_);
+    expires_[hash] = now + ENTRY_LIFETIME_SECONDS;
+    bloom_add(hash);
+    save();
+}
+
+void HttpsUpgradeCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    expires_.clear();
+    std::fill(bloom_.begin(), bloom_.end(), 0);
+    save();
+}
+
+size_t HttpsUpgradeCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return expires_.size();
+}
+
+void HttpsUpgradeCache::load() {
+    std::ifstream in(path_, std::ios::binary);
+    if (!in) return;
+
+    CacheHeader header{};
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != CACHE_VERSION || header.bloom_bits != BLOOM_BITS) {
+        return;
+    }
+
+    // The count must agree with the file's size before it sizes anything
+    constexpr uint64_t bloom_bytes = BLOOM_BITS / 8;
+    std::error_code error;
+    uint64_t file_size = std::filesystem::file_size(path_, error);
+    if (error || file_size < sizeof(header) + bloom_bytes ||
+        header.entry_count != (file_size - sizeof(header) - bloom_bytes) / sizeof(CacheEntry)) {
+        std::cerr << "[Tsunami] Ignoring corrupt HTTPS upgrade cache " << path_ << std::endl;
+        return;
+    }
+
+    std::vector<uint64_t> bloom(BLOOM_BITS / 64);
+    in.read(reinterpret_cast<char*>(bloom.data()), static_cast<std::streamsize>(bloom.size() * sizeof(uint64_t)));
+
+    std::unordered_map<uint64_t, int64_t> expires;
+    expires.reserve(header.entry_count);
+    for (uint64_t i = 0; i < header.entry_count && in; ++i) {
+        CacheEntry entry;
+        in.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+        if (in) expires[entry.host_hash] = entry.expires;
+    }
+    if (!in) {
+        std::cerr << "[Tsunami] Ignoring truncated HTTPS upgrade cache " << path_ << std::endl;
+        return;
+    }
+
+    bloom_ = std::move(bloom);
+    expires_ = std::move(expires);
+
+    // A Bloom filter cannot forget; rebuild it once entries have expired
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    size_t before = expires_.size();
+    std::erase_if(expires_, [now](const auto& entry) { return entry.second <= now; });
+    if (expires_.size() != before) {
+        std::fill(bloom_.begin(), bloom_.end(), 0);
+        for (const auto& [hash, expires] : expires_) bloom_add(hash);
+        save();
+    }
+}
+
+void HttpsUpgradeCache::save() const {
+    if (path_.empty()) return;
+
+    CacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.bloom_bits = BLOOM_BITS;
+    header.entry_count = expires_.size();
+
+    // Write beside the real file and rename over it, so a crash mid-write
+    // leaves the previous cache intact
+    std::string temp_path = path_ + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) return;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(bloom_.data()),
+                  static_cast<std::streamsize>(bloom_.size() * sizeof(uint64_t)));
+        for (const auto& [hash, expires] : expires_) {
+            CacheEntry entry{hash, expires};
+            out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        }
+        if (!out) return;
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path_, error);
+    if (error) {
+        std::cerr << "[Tsunami] Failed to save HTTPS upgrade cache: " << error.message() << std::endl;
+    }
+}
+
+} // namespace Tsunami
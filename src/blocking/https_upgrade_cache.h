@@ -0,0 +1,53 @@
+/*
+ * Tsunami Browser - Content blocking
+ * https_upgrade_cache.h - Hosts known to fail over HTTPS
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Tsunami {
+
+// HTTPS-only mode upgrades every http:// request unless the host is in this
+// cache. A Bloom filter answers the common "never failed" case with a few
+// bit tests; only its positives reach the exact set, which also carries
+// the expiry. Both are persisted, so a restart does not re-learn anything.
+class HttpsUpgradeCache {
+public:
+    static constexpr uint32_t BLOOM_BITS = 1u << 16;
+    static constexpr int BLOOM_HASHES = 4;
+    static constexpr int64_t ENTRY_LIFETIME_SECONDS = 30 * 24 * 3600;
+
+    static HttpsUpgradeCache& instance();
+
+    void init(const std::string& path);
+
+    // True while `host` has a recent HTTPS failure and must stay on http
+    bool should_skip(std::string_view host, int64_t now) const;
+    void record_failure(std::string_view host, int64_t now);
+    void clear();
+
+    size_t size() const;
+
+private:
+    HttpsUpgradeCache() = default;
+
+    static void bloom_positions(uint64_t hash, uint32_t (&positions)[BLOOM_HASHES]);
+    void bloom_add(uint64_t hash);
+    bool bloom_test(uint64_t hash) const;
+    void load();
+    void save() const;
+
+    std::string path_;
+    std::vector<uint64_t> bloom_ = std::vector<uint64_t>(BLOOM_BITS / 64);
+    std::unordered_map<uint64_t, int64_t> expires_;   // Host hash -> unix time
+    mutable std::mutex mutex_;
+};
+
+} // namespace Tsunami
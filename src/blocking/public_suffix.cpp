@@ -0,0 +1,117 @@
+/*
+ * Tsunami Browser - Content blocking
+ * public_suffix.cpp - eTLD+1 lookups against the compiled public suffix list
+ */
+
+#include "blocking/public_suffix.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace Tsunami {
+
+namespace {
+
+struct PslNode {
+    uint32_t edge_begin;
+    uint32_t edge_count;
+    uint8_t flags;
+};
+
+struct PslEdge {
+    uint32_t label_hash;
+    uint32_t label_offset;
+    uint8_t label_length;
+    uint32_t target;
+};
+
+enum PslFlags : uint8_t {
+    PslSuffix = 1,
+    PslWildcard = 2,
+    PslException = 4
+};
+
+// Generated at build time by tools/psl_compile.cpp
+#include "psl_data.inc"
+
+std::string_view edge_label(const PslEdge& edge) {
+    return std::string_view(reinterpret_cast<const char*>(PSL_LABELS) + edge.label_offset, edge.label_length);
+}
+
+// FNV-1a, as in tools/psl_compile.cpp
+uint32_t label_hash(std::string_view label) {
+    uint32_t hash = 2166136261u;
+    for (char c : label) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// A node's edges are sorted by label hash
+const PslNode* find_child(const PslNode& node, std::string_view label) {
+    const PslEdge* begin = PSL_EDGES + node.edge_begin;
+    const PslEdge* end = begin + node.edge_count;
+    uint32_t hash = label_hash(label);
+    const PslEdge* edge = std::lower_bound(begin, end, hash, [](const PslEdge& e, uint32_t h) {
+        return e.label_hash < h;
+    });
+    for (; edge != end && edge->label_hash == hash; ++edge) {
+        if (edge_label(*edge) == label) return &PSL_NODES[edge->target];
+    }
+    return nullptr;
+}
+
+bool is_ip_literal(std::string_view host) {
+    return host.find(':') != std::string_view::npos ||
+           host.find_first_not_of("0123456789.") == std::string_view::npos;
+}
+
+} // namespace
+
+std::string_view registrable_domain(std::string_view host) {
+    if (!host.empty() && host.back() == '.') host.remove_suffix(1);
+    if (host.empty() || is_ip_literal(host)) return host;
+
+    // Index in `host` where the public suffix starts. The implicit "*"
+    // rule makes the last label a suffix when nothing else matches.
+    size_t last_dot = host.rfind('.');
+    size_t suffix_begin = last_dot == std::string_view::npos ? 0 : last_dot + 1;
+
+    const PslNode* node = &PSL_NODES[PSL_ROOT];
+    size_t label_end = host.size();
+    while (true) {
+        size_t dot = label_end ? host.rfind('.', label_end - 1) : std::string_view::npos;
+        size_t label_begin = dot == std::string_view::npos ? 0 : dot + 1;
+        std::string_view label = host.substr(label_begin, label_end - label_begin);
+
+        const PslNode* child = find_child(*node, label);
+        if (child && (child->flags & PslException)) {
+            // !city.kawasaki.jp: the suffix is the rule minus its first label
+            suffix_begin = label_end + 1;
+            break;
+        }
+        // *.futurecms.at covers in.futurecms.at even where a longer rule
+        // (ex.futurecms.at) gives "in" a node of its own
+        if (node->flags & PslWildcard) suffix_begin = label_begin;
+        if (!child) break;
+        if (child->flags & PslSuffix) suffix_begin = label_begin;
+        node = child;
+
+        if (label_begin == 0) break;
+        label_end = label_begin - 1;
+    }
+
+    if (suffix_begin == 0) return {};   // The host is a public suffix
+    size_t dot = host.rfind('.', suffix_begin - 2);
+    return host.substr(dot == std::string_view::npos ? 0 : dot + 1);
+}
+
+bool is_cross_site(std::string_view host, std::string_view site_host) {
+    std::string_view a = registrable_domain(host);
+    std::string_view b = registrable_domain(site_host);
+    if (a.empty()) a = host;
+    if (b.empty()) b = site_host;
+    return a != b;
+}
+
+} // namespace Tsunami
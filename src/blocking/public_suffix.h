@@ -0,0 +1,23 @@
+/*
+ * Tsunami Browser - Content blocking
+ * public_suffix.h - eTLD+1 lookups against the compiled public suffix list
+ */
+
+#pragma once
+
+#include <string_view>
+
+namespace Tsunami {
+
+// The registrable domain (eTLD+1) of `host`, e.g. "bbc.co.uk" for
+// "news.bbc.co.uk". Empty when the host is itself a public suffix. IP
+// literals are returned unchanged. Walks one label at a time against a
+// table compiled into the binary from public_suffix_list.dat; never
+// allocates. Expects a lowercase ASCII (punycode) host, as QUrl produces.
+std::string_view registrable_domain(std::string_view host);
+
+// Different registrable domains, falling back to the full host for hosts
+// that are public suffixes themselves
+bool is_cross_site(std::string_view host, std::string_view site_host);
+
+} // namespace Tsunami
@@ -0,0 +1,185 @@
+/*
+ * Tsunami Browser - Content blocking
+ * request_interceptor.cpp - Per-page request filtering and blocked counter
+ */
+
+#include "blocking/request_interceptor.h"
+#include "blocking/content_blocker.h"
+#include "blocking/https_upgrade_cache.h"
+#include "settings/settings.h"
+#include "perf/trace.h"
+#include <QDateTime>
+#include <QTimer>
+#include <QWebEngineLoadingInfo>
+#include <QWebEnginePage>
+#include <QWebEngineProfile>
+#include <algorithm>
+#include <string_view>
+
+namespace Tsunami {
+
+namespace {
+
+uint32_t filterType(QWebEngineUrlRequestInfo::ResourceType type) {
+    switch (type) {
+    case QWebEngineUrlRequestInfo::ResourceTypeScript:
+    case QWebEngineUrlRequestInfo::ResourceTypeWorker:
+    case QWebEngineUrlRequestInfo::ResourceTypeSharedWorker:
+    case QWebEngineUrlRequestInfo::ResourceTypeServiceWorker:
+        return ResourceScript;
+    case QWebEngineUrlRequestInfo::ResourceTypeImage:
+    case QWebEngineUrlRequestInfo::ResourceTypeFavicon:
+        return ResourceImage;
+    case QWebEngineUrlRequestInfo::ResourceTypeStylesheet:
+        return ResourceStylesheet;
+    case QWebEngineUrlRequestInfo::ResourceTypeXhr:
+        return ResourceXhr;
+    case QWebEngineUrlRequestInfo::ResourceTypeSubFrame:
+        return ResourceSubdocument;
+    case QWebEngineUrlRequestInfo::ResourceTypeFontResource:
+        return ResourceFont;
+    case QWebEngineUrlRequestInfo::ResourceTypeMedia:
+        return ResourceMedia;
+    case QWebEngineUrlRequestInfo::ResourceTypeObject:
+    case QWebEngineUrlRequestInfo::ResourceTypePluginResource:
+        return ResourceObject;
+    case QWebEngineUrlRequestInfo::ResourceTypePing:
+    case QWebEngineUrlRequestInfo::ResourceTypeCspReport:
+        return ResourcePing;
+    case QWebEngineUrlRequestInfo::ResourceTypeWebSocket:
+        return ResourceWebSocket;
+    default:
+        return ResourceOther;
+    }
+}
+
+// Host part of an encoded URL; IPv6 literals keep their brackets
+std::string_view hostOf(std::string_view url) {
+    size_t begin = url.find("://");
+    if (begin == std::string_view::npos) return {};
+    begin += 3;
+    size_t end = url.find_first_of("/?#", begin);
+    std::string_view authority = url.substr(begin, end == std::string_view::npos ? url.npos : end - begin);
+    if (!authority.empty() && authority.front() == '[') {
+        size_t close = authority.find(']');
+        return authority.substr(0, close == std::string_view::npos ? authority.size() : close + 1);
+    }
+    return authority.substr(0, authority.find(':'));
+}
+
+// Local names and addresses almost never serve HTTPS
+bool isUpgradeable(const QString& host) {
+    if (!host.contains('.') || host.endsWith(".local") || host.endsWith(".localhost")) return false;
+    return std::any_of(host.begin(), host.end(), [](QChar c) { return c != '.' && !c.isDigit(); });
+}
+
+} // namespace
+
+RequestInterceptor::RequestInterceptor(QObject* parent)
+    : QWebEngineUrlRequestInterceptor(parent)
+{
+    if (auto page = qobject_cast<QWebEnginePage*>(parent)) {
+        off_the_record_ = page->profile()->isOffTheRecord();
+        connect(page, &QWebEnginePage::loadingChanged, this, &RequestInterceptor::onLoadingChanged);
+    }
+}
+
+bool RequestInterceptor::upgradeToHttps(QWebEngineUrlRequestInfo& info, bool main_frame) {
+    const QUrl url = info.requestUrl();
+    if (url.scheme() != QLatin1String("http") || !Settings::instance().getHttpsOnly()) return false;
+
+    const QString host = url.host(QUrl::FullyEncoded);
+    if (!isUpgradeable(host) || insecure_hosts_.contains(host)) return false;
+    const QByteArray host_bytes = host.toLatin1();
+    if (HttpsUpgradeCache::instance().should_skip(std::string_view(host_bytes.constData(), host_bytes.size()),
+                                                  QDateTime::currentSecsSinceEpoch())) {
+        return false;
+    }
+
+    QUrl secure = url;
+    secure.setScheme("https");
+    if (secure.port() == 80) secure.setPort(-1);
+    info.redirect(secure);
+    if (main_frame) upgraded_from_ = url;
+    return true;
+}
+
+void RequestInterceptor::onLoadingChanged(const QWebEngineLoadingInfo& info) {
+    if (upgraded_from_.isEmpty() || info.status() == QWebEngineLoadingInfo::LoadStartedStatus) return;
+
+    QUrl original = upgraded_from_;
+    upgraded_from_.clear();
+    if (info.status() != QWebEngineLoadingInfo::LoadFailedStatus || info.url().host() != original.host()) return;
+
+    // DNS and HTTP status errors would fail over http too; only a refused
+    // connection or a bad certificate means the host lacks working HTTPS
+    if (info.errorDomain() != QWebEngineLoadingInfo::ConnectionErrorDomain &&
+        info.errorDomain() != QWebEngineLoadingInfo::CertificateErrorDomain) {
+        return;
+    }
+
+    if (off_the_record_) {
+        insecure_hosts_.insert(original.host(QUrl::FullyEncoded));
+    } else {
+        const QByteArray host = original.host(QUrl::FullyEncoded).toLatin1();
+        HttpsUpgradeCache::instance().record_failure(std::string_view(host.constData(), host.size()),
+                                                     QDateTime::currentSecsSinceEpoch());
+    }
+    if (auto page = qobject_cast<QWebEnginePage*>(parent())) {
+        QTimer::singleShot(0, page, [page, original]() { page->load(original); });
+    }
+}
+
+void RequestInterceptor::interceptRequest(QWebEngineUrlRequestInfo& info) {
+    bool main_frame = info.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeMainFrame;
+
+    // The redirected https:// request comes back through here
+    if (upgradeToHttps(info, main_frame)) return;
+
+    if (main_frame) {
+        if (!upgraded_from_.isEmpty() && info.requestUrl().host() != upgraded_from_.host()) {
+            upgraded_from_.clear();
+        }
+        if (blocked_count_) {
+            blocked_count_ = 0;
+            emit blockedCountChanged(0);
+        }
+        return;
+    }
+
+    const FilterEngine* engine = ContentBlocker::instance().engine();
+    if (!engine) return;
+
+    TSUNAMI_TRACE_SCOPE("blocking.intercept");
+    const QUrl url = info.requestUrl();
+    const QString scheme = url.scheme();
+    if (scheme != QLatin1String("https") && scheme != QLatin1String("http") &&
+        scheme != QLatin1String("wss") && scheme != QLatin1String("ws")) {
+        return;
+    }
+
+    const QUrl first_party = info.firstPartyUrl();
+    if (first_party != site_url_) {
+        site_url_ = first_party;
+        site_encoded_ = first_party.toEncoded(QUrl::RemoveUserInfo | QUrl::RemoveFragment);
+        site_host_ = first_party.host(QUrl::FullyEncoded).toLatin1();
+    }
+
+    // The one copy per request: Chromium hands us a QUrl, the engine wants bytes
+    const QByteArray encoded = url.toEncoded(QUrl::RemoveUserInfo | QUrl::RemoveFragment);
+
+    FilterRequest request;
+    request.url = std::string_view(encoded.constData(), static_cast<size_t>(encoded.size()));
+    request.host = hostOf(request.url);
+    request.site_host = std::string_view(site_host_.constData(), static_cast<size_t>(site_host_.size()));
+    request.site_url = std::string_view(site_encoded_.constData(), static_cast<size_t>(site_encoded_.size()));
+    request.type = filterType(info.resourceType());
+    request.third_party = FilterEngine::is_third_party(request.host, request.site_host);
+
+    if (engine->match(request).blocked) {
+        info.block(true);
+        emit blockedCountChanged(++blocked_count_);
+    }
+}
+
+} // namespace Tsunami
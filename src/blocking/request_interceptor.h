@@ -0,0 +1,49 @@
+/*
+ * Tsunami Browser - Content blocking
+ * request_interceptor.h - Per-page request filtering and blocked counter
+ */
+
+#pragma once
+
+#include <QWebEngineUrlRequestInterceptor>
+#include <QByteArray>
+#include <QSet>
+#include <QUrl>
+
+class QWebEngineLoadingInfo;
+
+namespace Tsunami {
+
+// One per page so each tab keeps its own count. The count restarts with
+// every main-frame navigation. Also performs the HTTPS-only upgrade, and
+// falls back to http when an upgraded navigation cannot connect. Pages of
+// an off-the-record profile remember those hosts only for their lifetime.
+class RequestInterceptor : public QWebEngineUrlRequestInterceptor {
+    Q_OBJECT
+public:
+    explicit RequestInterceptor(QObject* parent = nullptr);
+
+    void interceptRequest(QWebEngineUrlRequestInfo& info) override;
+    int blockedCount() const { return blocked_count_; }
+
+signals:
+    void blockedCountChanged(int count);
+
+private slots:
+    void onLoadingChanged(const QWebEngineLoadingInfo& info);
+
+private:
+    bool upgradeToHttps(QWebEngineUrlRequestInfo& info, bool main_frame);
+
+    int blocked_count_ = 0;
+    QUrl upgraded_from_;   // Original http:// URL of an upgraded navigation
+    bool off_the_record_ = false;
+    QSet<QString> insecure_hosts_;   // Off the record only: kept out of HttpsUpgradeCache
+
+    // Subresources of one document share a first-party URL
+    QUrl site_url_;
+    QByteArray site_encoded_;
+    QByteArray site_host_;
+};
+
+} // namespace Tsunami
@@ -4,6 +4,8 @@
  */
 
 #include "bookmarks_manager.h"
+#include "perf/trace.h"
+#include "storage/result_set.h"
 #include <sqlite3.h>
 #include <iostream>
 #include <algorithm>
@@ -12,6 +14,21 @@
 
 namespace SeaBrowser {
 
+namespace {
+
+// Page order: date_added DESC, then id DESC for bookmarks added in the same second
+bool newer_than(const Bookmark& a, std::time_t date, const std::string& id) {
+    return a.date_added != date ? a.date_added > date : a.id > id;
+}
+
+bool contains_folded(const std::string& text, const std::string& folded_needle) {
+    auto it = std::search(text.begin(), text.end(), folded_needle.begin(), folded_needle.end(),
+                          [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+    return it != text.end();
+}
+
+} // namespace
+
 BookmarksManager& BookmarksManager::instance() {
     static BookmarksManager instance;
     return instance;
@@ -24,6 +41,7 @@ void BookmarksManager::init(const std::string& db_path) {
 }
 
 void BookmarksManager::load() {
+    TSUNAMI_TRACE_SCOPE("bookmarks.load");
     bookmarks_.clear();
     
     sqlite3* db = nullptr;
@@ -50,25 +68,30 @@ void BookmarksManager::load() {
         sqlite3_free(err_msg);
     }
     
-    // Load bookmarks
-    const char* select_sql = "SELECT id, title, url, folder, date_added FROM bookmarks ORDER BY date_added DESC";
+    // Load bookmarks, sized up front so the vector is allocated once
     sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT count(*) FROM bookmarks", -1, &stmt, nullptr) == SQLITE_OK) {
+        for_each_row(stmt, [&](const RowView& row) { bookmarks_.reserve(static_cast<size_t>(row.int64(0))); });
+        sqlite3_finalize(stmt);
+    }
     
+    // Rows written by older builds or other tools may hold NULLs
+    const char* select_sql = "SELECT id, title, url, folder, date_added FROM bookmarks ORDER BY date_added DESC, id DESC";
     if (sqlite3_prepare_v2(db, select_sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            Bookmark bm;
-            bm.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            bm.title = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-            bm.url = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-            bm.folder = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-            bm.date_added = sqlite3_column_int64(stmt, 4);
-            bookmarks_.push_back(bm);
-        }
+        for_each_row(stmt, [&](const RowView& row) {
+            Bookmark& bm = bookmarks_.emplace_back();
+            bm.id = row.text(0);
+            bm.title = row.text(1);
+            bm.url = row.text(2);
+            std::string_view folder = row.text(3);
+            bm.folder = folder.empty() ? std::string_view("Other Bookmarks") : folder;
+            bm.date_added = row.int64(4);
+        });
         sqlite3_finalize(stmt);
     }
     
     sqlite3_close(db);
-    std::cout << "[SeaBrowser] Loaded " << bookmarks_.size() << " bookmarks" << std::endl;
+    notify({BookmarkEvent::Reset, {}});
 }
 
 void BookmarksManager::save() {
@@ -76,6 +99,7 @@ void BookmarksManager::save() {
 }
 
 void BookmarksManager::add_bookmark(const Bookmark& bookmark) {
+    TSUNAMI_TRACE_SCOPE("bookmarks.add");
     sqlite3* db = nullptr;
     if (sqlite3_open(db_path_.c_str(), &db) != SQLITE_OK) {
         std::cerr << "[SeaBrowser] Cannot open bookmarks database" << std::endl;
@@ -100,12 +124,16 @@ void BookmarksManager::add_bookmark(const Bookmark& bookmark) {
     
     sqlite3_close(db);
     
-    // Update cache
-    bookmarks_.push_back(bookmark);
-    std::cout << "[SeaBrowser] Added bookmark: " << bookmark.title << std::endl;
+    // Update cache, keeping page order
+    auto pos = std::find_if(bookmarks_.begin(), bookmarks_.end(), [&](const Bookmark& bm) {
+        return !newer_than(bm, bookmark.date_added, bookmark.id);
+    });
+    bookmarks_.insert(pos, bookmark);
+    notify({BookmarkEvent::Added, bookmark});
 }
 
 void BookmarksManager::delete_bookmark(const std::string& id) {
+    TSUNAMI_TRACE_SCOPE("bookmarks.delete");
     sqlite3* db = nullptr;
     if (sqlite3_open(db_path_.c_str(), &db) != SQLITE_OK) {
         return;
@@ -128,8 +156,9 @@ void BookmarksManager::delete_bookmark(const std::string& id) {
             [&id](const Bookmark& bm) { return bm.id == id; }),
         bookmarks_.end()
     );
-    
-    std::cout << "[SeaBrowser] Deleted bookmark: " << id << std::endl;
+    BookmarkEvent event{BookmarkEvent::Removed, {}};
+    event.bookmark.id = id;
+    notify(event);
 }
 
 void BookmarksManager::update_bookmark(const Bookmark& bookmark) {
@@ -165,6 +194,40 @@ std::vector<std::string> BookmarksManager::get_folders() const {
     return folders;
 }
 
+std::vector<Bookmark> BookmarksManager::get_page(std::time_t before_date, const std::string& before_id,
+                                                size_t limit, const std::string& filter) const {
+    std::vector<Bookmark> page;
+    auto it = bookmarks_.begin();
+    if (!before_id.empty()) {
+        // bookmarks_ is in page order, so the cursor is a binary search away
+        it = std::partition_point(bookmarks_.begin(), bookmarks_.end(), [&](const Bookmark& bm) {
+            return newer_than(bm, before_date, before_id);
+        });
+    }
+    
+    std::string folded = filter;
+    std::transform(folded.begin(), folded.end(), folded.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (; it != bookmarks_.end() && page.size() < limit; ++it) {
+        if (folded.empty() || contains_folded(it->title, folded) || contains_folded(it->url, folded)) {
+            page.push_back(*it);
+        }
+    }
+    return page;
+}
+
+int BookmarksManager::add_listener(BookmarkListener listener) {
+    return listeners_.add(std::move(listener));
+}
+
+void BookmarksManager::remove_listener(int id) {
+    listeners_.remove(id);
+}
+
+void BookmarksManager::notify(const BookmarkEvent& event) {
+    listeners_.notify(event);
+}
+
 bool BookmarksManager::is_bookmarked(const std::string& url) const {
     for (const auto& bm : bookmarks_) {
         if (bm.url == url) {
@@ -194,4 +257,88 @@ void BookmarksManager::toggle_bookmark(const std::string& url, const std::string
     add_bookmark(bm);
 }
 
+long long BookmarksManager::import_bookmarks(const std::vector<Bookmark>& bookmarks) {
+    TSUNAMI_TRACE_SCOPE("bookmarks.import");
+    sqlite3* db = nullptr;
+    if (sqlite3_open(db_path_.c_str(), &db) != SQLITE_OK) {
+        std::cerr << "[SeaBrowser] Cannot open bookmarks database" << std::endl;
+        if (db) sqlite3_close(db);
+        return -1;
+    }
+    
+    const char* insert_sql =
+        "INSERT OR IGNORE INTO bookmarks (id, title, url, folder, date_added) "
+        "SELECT ?1, ?2, ?3, ?4, ?5 WHERE NOT EXISTS (SELECT 1 FROM bookmarks WHERE url = ?3)";
+    long long added = 0;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, insert_sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_exec(db, "BEGIN", nullptr, nullptr, nullptr);
+        for (const Bookmark& bookmark : bookmarks) {
+            sqlite3_bind_text(stmt, 1, bookmark.id.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, bookmark.title.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 3, bookmark.url.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 4, bookmark.folder.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int64(stmt, 5, bookmark.date_added);
+            if (sqlite3_step(stmt) == SQLITE_DONE) added += sqlite3_changes(db);
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_exec(db, "COMMIT", nullptr, nullptr, nullptr);
+    } else {
+        added = -1;
+    }
+    
+    sqlite3_close(db);
+    return added;
+}
+
+long long BookmarksManager::import_firefox_bookmarks(const std::string& places_path) {
+    TSUNAMI_TRACE_SCOPE("bookmarks.importFirefox");
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(db_path_.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI,
+                        nullptr) != SQLITE_OK) {
+        std::cerr << "[SeaBrowser] Cannot open bookmarks database" << std::endl;
+        if (db) sqlite3_close(db);
+        return -1;
+    }
+    
+    long long added = -1;
+    sqlite3_stmt* stmt = nullptr;
+    std::string uri = read_only_uri(places_path);
+    if (sqlite3_prepare_v2(db, "ATTACH DATABASE ? AS source", -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, uri.c_str(), -1, SQLITE_STATIC);
+        int rc = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+        
+        // type 1 is a bookmark; Firefox's root folders get our names.
+        // dateAdded is in microseconds.
+        const char* insert_sql =
+            "INSERT OR IGNORE INTO main.bookmarks (id, title, url, folder, date_added) "
+            "SELECT (b.dateAdded / 1000000) || p.url, COALESCE(NULLIF(b.title, ''), p.url), p.url, "
+            "CASE parent.guid WHEN 'toolbar_____' THEN 'Bookmarks Bar' "
+            "WHEN 'menu________' THEN 'Bookmarks Menu' "
+            "WHEN 'unfiled_____' THEN 'Other Bookmarks' "
+            "WHEN 'mobile______' THEN 'Mobile Bookmarks' "
+            "ELSE COALESCE(NULLIF(parent.title, ''), 'Other Bookmarks') END, "
+            "b.dateAdded / 1000000 "
+            "FROM source.moz_bookmarks b JOIN source.moz_places p ON p.id = b.fk "
+            "LEFT JOIN source.moz_bookmarks parent ON parent.id = b.parent "
+            "WHERE b.type = 1 AND (p.url LIKE 'http://%' OR p.url LIKE 'https://%') "
+            "AND NOT EXISTS (SELECT 1 FROM main.bookmarks m WHERE m.url = p.url) "
+            "GROUP BY p.url";
+        char* err_msg = nullptr;
+        if (rc == SQLITE_DONE && sqlite3_exec(db, insert_sql, nullptr, nullptr, &err_msg) == SQLITE_OK) {
+            added = sqlite3_changes(db);
+        } else {
+            std::cerr << "[SeaBrowser] Cannot import " << places_path << ": "
+                      << (err_msg ? err_msg : sqlite3_errmsg(db)) << std::endl;
+            sqlite3_free(err_msg);
+        }
+        sqlite3_exec(db, "DETACH DATABASE source", nullptr, nullptr, nullptr);
+    }
+    
+    sqlite3_close(db);
+    return added;
+}
+
 } // namespace SeaBrowser
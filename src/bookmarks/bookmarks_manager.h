@@ -5,9 +5,12 @@
 
 #pragma once
 
+#include "import/import_source.h"
+#include "storage/listener_list.h"
 #include <string>
 #include <vector>
 #include <ctime>
+#include <functional>
 
 namespace SeaBrowser {
 
@@ -19,6 +22,14 @@ struct Bookmark {
     std::time_t date_added;
 };
 
+struct BookmarkEvent {
+    enum Type { Added, Removed, Reset };
+    Type type;
+    Bookmark bookmark;   // Set for Added; only the id for Removed
+};
+
+using BookmarkListener = std::function<void(const BookmarkEvent&)>;
+
 class BookmarksManager {
 public:
     static BookmarksManager& instance();
@@ -37,18 +48,39 @@ public:
     std::vector<Bookmark> get_bookmarks_in_folder(const std::string& folder) const;
     std::vector<std::string> get_folders() const;
     
+    // Keyset paging, newest first: bookmarks strictly older than
+    // (before_date, before_id). Pass an empty before_id for the first page.
+    // filter matches title or URL, case-insensitively.
+    std::vector<Bookmark> get_page(std::time_t before_date, const std::string& before_id,
+                                   size_t limit, const std::string& filter = "") const;
+    
+    // Change notifications for views; called on the thread that made the change
+    int add_listener(BookmarkListener listener);
+    void remove_listener(int id);
+    
     // Check if URL is bookmarked
     bool is_bookmarked(const std::string& url) const;
     
     // Toggle bookmark for URL
     void toggle_bookmark(const std::string& url, const std::string& title);
     
+    // Importers write the database only, in one transaction, skipping URLs
+    // already bookmarked, and may run on a worker thread; load() afterwards
+    // on the thread that owns the bookmarks. They return bookmarks added,
+    // or -1 on failure.
+    long long import_bookmarks(const std::vector<Bookmark>& bookmarks);
+    // From places.sqlite, attached read-only, with one INSERT ... SELECT
+    long long import_firefox_bookmarks(const std::string& places_path);
+    
 private:
     BookmarksManager() = default;
     
     std::string db_path_;
-    std::vector<Bookmark> bookmarks_;
+    std::vector<Bookmark> bookmarks_;   // Newest first
     bool initialized_ = false;
+    ListenerList<const BookmarkEvent&> listeners_;
+    
+    void notify(const BookmarkEvent& event);
 };
 
 } // namespace SeaBrowser
@@ -0,0 +1,126 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * bookmarks_bridge.cpp - Paged bookmarks for tsunami://bookmarks
+ */
+
+#include "bookmarks_bridge.h"
+#include "web_view.h"
+#include "bookmarks/bookmarks_manager.h"
+#include <QWebEnginePage>
+#include <QJsonArray>
+#include <QUrl>
+#include <algorithm>
+#include <ctime>
+
+namespace Tsunami {
+
+namespace {
+
+QJsonObject toJson(const SeaBrowser::Bookmark& bookmark) {
+    QJsonObject obj;
+    obj["id"] = QString::fromStdString(bookmark.id);
+    obj["url"] = QString::fromStdString(bookmark.url);
+    obj["title"] = QString::fromStdString(bookmark.title);
+    obj["folder"] = QString::fromStdString(bookmark.folder);
+    obj["dateAdded"] = static_cast<qint64>(bookmark.date_added) * 1000;
+    return obj;
+}
+
+} // namespace
+
+BookmarksBridge::BookmarksBridge(QWebEnginePage* page, QObject* parent)
+    : QObject(parent)
+    , page_(page)
+{
+}
+
+BookmarksBridge::~BookmarksBridge() {
+    if (listener_id_) SeaBrowser::BookmarksManager::instance().remove_listener(listener_id_);
+}
+
+bool BookmarksBridge::isAllowed() const {
+    return page_ && WebView::isInternalUrl(page_->url());
+}
+
+void BookmarksBridge::subscribe() {
+    if (listener_id_) return;
+    listener_id_ = SeaBrowser::BookmarksManager::instance().add_listener(
+        [this](const SeaBrowser::BookmarkEvent& event) { onBookmarkEvent(event); });
+}
+
+QJsonObject BookmarksBridge::fetchPage(const QString& cursor, int count) {
+    QJsonObject result;
+    result["items"] = QJsonArray();
+    result["next"] = QString();
+    if (!isAllowed()) return result;
+    subscribe();
+
+    // Cursor: "<date_added>:<id>"; ids may themselves contain ':'
+    std::time_t before_date = 0;
+    std::string before_id;
+    int colon = cursor.indexOf(':');
+    if (colon > 0) {
+        before_date = static_cast<std::time_t>(cursor.left(colon).toLongLong());
+        before_id = cursor.mid(colon + 1).toStdString();
+    }
+
+    size_t limit = static_cast<size_t>(std::clamp(count, 1, MAX_PAGE_SIZE));
+    auto bookmarks = SeaBrowser::BookmarksManager::instance().get_page(
+        before_date, before_id, limit, filter_.toStdString());
+
+    QJsonArray items;
+    for (const auto& bookmark : bookmarks) items.append(toJson(bookmark));
+    result["items"] = items;
+    if (bookmarks.size() == limit) {
+        const auto& last = bookmarks.back();
+        result["next"] = QString("%1:%2").arg(static_cast<qint64>(last.date_added))
+                                         .arg(QString::fromStdString(last.id));
+    }
+    return result;
+}
+
+void BookmarksBridge::setFilter(const QString& filter) {
+    filter_ = filter.trimmed();
+}
+
+void BookmarksBridge::addBookmark(const QString& url, const QString& title) {
+    if (!isAllowed()) return;
+    QUrl parsed = QUrl::fromUserInput(url);
+    if (!parsed.isValid()) return;
+
+    SeaBrowser::Bookmark bookmark;
+    bookmark.date_added = std::time(nullptr);
+    bookmark.url = parsed.toString().toStdString();
+    bookmark.id = std::to_string(bookmark.date_added) + bookmark.url;
+    bookmark.title = title.isEmpty() ? bookmark.url : title.toStdString();
+    bookmark.folder = "Other Bookmarks";
+    SeaBrowser::BookmarksManager::instance().add_bookmark(bookmark);
+}
+
+void BookmarksBridge::removeBookmark(const QString& id) {
+    if (!isAllowed()) return;
+    SeaBrowser::BookmarksManager::instance().delete_bookmark(id.toStdString());
+}
+
+void BookmarksBridge::onBookmarkEvent(const SeaBrowser::BookmarkEvent& event) {
+    if (!isAllowed()) return;
+    switch (event.type) {
+        case SeaBrowser::BookmarkEvent::Added: {
+            QString url = QString::fromStdString(event.bookmark.url);
+            QString title = QString::fromStdString(event.bookmark.title);
+            if (filter_.isEmpty() || url.contains(filter_, Qt::CaseInsensitive) ||
+                title.contains(filter_, Qt::CaseInsensitive)) {
+                emit itemAdded(toJson(event.bookmark));
+            }
+            break;
+        }
+        case SeaBrowser::BookmarkEvent::Removed:
+            emit itemRemoved(QString::fromStdString(event.bookmark.id));
+            break;
+        case SeaBrowser::BookmarkEvent::Reset:
+            emit reset();
+            break;
+    }
+}
+
+} // namespace Tsunami
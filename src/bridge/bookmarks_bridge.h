@@ -0,0 +1,50 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * bookmarks_bridge.h - Paged bookmarks for tsunami://bookmarks
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QJsonObject>
+#include <QString>
+
+class QWebEnginePage;
+
+namespace SeaBrowser {
+struct BookmarkEvent;
+}
+
+namespace Tsunami {
+
+class BookmarksBridge : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int MAX_PAGE_SIZE = 200;
+
+    explicit BookmarksBridge(QWebEnginePage* page, QObject* parent = nullptr);
+    ~BookmarksBridge() override;
+
+    // Same contract as HistoryBridge::fetchPage
+    Q_INVOKABLE QJsonObject fetchPage(const QString& cursor, int count);
+    Q_INVOKABLE void setFilter(const QString& filter);
+    Q_INVOKABLE void addBookmark(const QString& url, const QString& title);
+    Q_INVOKABLE void removeBookmark(const QString& id);
+
+signals:
+    void itemAdded(const QJsonObject& item);
+    void itemRemoved(const QString& id);
+    void reset();
+
+private:
+    bool isAllowed() const;
+    void subscribe();
+    void onBookmarkEvent(const SeaBrowser::BookmarkEvent& event);
+
+    QPointer<QWebEnginePage> page_;
+    QString filter_;
+    int listener_id_ = 0;
+};
+
+} // namespace Tsunami
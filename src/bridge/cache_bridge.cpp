@@ -0,0 +1,50 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * cache_bridge.cpp - Cache statistics and clearing for tsunami://cache
+ */
+
+#include "cache_bridge.h"
+#include "web_view.h"
+#include "profile/cache_manager.h"
+#include "settings/settings.h"
+#include <QWebEnginePage>
+
+namespace Tsunami {
+
+CacheBridge::CacheBridge(QWebEnginePage* page, QObject* parent)
+    : QObject(parent)
+    , page_(page)
+{
+    connect(&CacheManager::instance(), &CacheManager::statsUpdated, this, [this]() {
+        if (isAllowed()) emit statsChanged(toJson());
+    });
+}
+
+bool CacheBridge::isAllowed() const {
+    return page_ && WebView::isInternalUrl(page_->url());
+}
+
+QJsonObject CacheBridge::toJson() const {
+    const CacheManager::Stats& stats = CacheManager::instance().stats();
+    QJsonObject obj;
+    obj["measured"] = stats.measured;
+    obj["cacheBytes"] = stats.cache_bytes;
+    obj["cacheFiles"] = stats.cache_files;
+    obj["storageBytes"] = stats.storage_bytes;
+    obj["trashBytes"] = stats.trash_bytes;
+    obj["quotaBytes"] = CacheManager::instance().quotaBytes();
+    obj["clearOnExit"] = Settings::instance().getAutoClearCache();
+    return obj;
+}
+
+QJsonObject CacheBridge::getStats() {
+    if (!isAllowed()) return QJsonObject();
+    CacheManager::instance().refreshStats();
+    return toJson();
+}
+
+void CacheBridge::clearCache() {
+    if (isAllowed()) CacheManager::instance().clearCache();
+}
+
+} // namespace Tsunami
@@ -0,0 +1,35 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * cache_bridge.h - Cache statistics and clearing for tsunami://cache
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QJsonObject>
+
+class QWebEnginePage;
+
+namespace Tsunami {
+
+class CacheBridge : public QObject {
+    Q_OBJECT
+public:
+    explicit CacheBridge(QWebEnginePage* page, QObject* parent = nullptr);
+
+    // The last measurement; a fresh one follows through statsChanged
+    Q_INVOKABLE QJsonObject getStats();
+    Q_INVOKABLE void clearCache();
+
+signals:
+    void statsChanged(const QJsonObject& stats);
+
+private:
+    bool isAllowed() const;
+    QJsonObject toJson() const;
+
+    QPointer<QWebEnginePage> page_;
+};
+
+} // namespace Tsunami
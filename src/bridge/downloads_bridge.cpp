@@ -0,0 +1,229 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * downloads_bridge.cpp - Paged downloads list for tsunami://downloads
+ */
+
+#include "downloads_bridge.h"
+#include "web_view.h"
+#include "downloads/downloads_manager.h"
+#include <QWebEnginePage>
+#include <QDesktopServices>
+#include <QFileInfo>
+#include <QTimer>
+#include <QUrl>
+#include <algorithm>
+#include <cmath>
+
+namespace Tsunami {
+
+namespace {
+
+const char* stateName(SeaBrowser::DownloadState state) {
+    switch (state) {
+        case SeaBrowser::DownloadState::InProgress: return "in-progress";
+        case SeaBrowser::DownloadState::Completed: return "completed";
+        case SeaBrowser::DownloadState::Failed: return "failed";
+        case SeaBrowser::DownloadState::Cancelled: return "cancelled";
+        case SeaBrowser::DownloadState::Paused: return "paused";
+    }
+    return "failed";
+}
+
+} // namespace
+
+DownloadsBridge::DownloadsBridge(QWebEnginePage* page, QObject* parent)
+    : QObject(parent)
+    , page_(page)
+{
+}
+
+DownloadsBridge::~DownloadsBridge() {
+    if (listener_id_) SeaBrowser::DownloadsManager::instance().remove_listener(listener_id_);
+}
+
+bool DownloadsBridge::isAllowed() const {
+    return page_ && WebView::isInternalUrl(page_->url());
+}
+
+void DownloadsBridge::subscribe() {
+    if (listener_id_) return;
+    listener_id_ = SeaBrowser::DownloadsManager::instance().add_listener(
+        [this](const SeaBrowser::DownloadEvent& event) { onDownloadEvent(event); });
+}
+
+QJsonObject DownloadsBridge::toJson(const SeaBrowser::Download& download) {
+    QJsonObject obj;
+    obj["id"] = QString::fromStdString(download.id);
+    obj["url"] = QString::fromStdString(download.url);
+    obj["filename"] = QString::fromStdString(download.filename);
+    obj["path"] = QString::fromStdString(download.path);
+    obj["mimeType"] = QString::fromStdString(download.mime_type);
+    obj["state"] = stateName(download.state);
+    obj["totalBytes"] = static_cast<qint64>(download.total_bytes);
+    obj["receivedBytes"] = static_cast<qint64>(download.received_bytes);
+    obj["speed"] = download.speed;
+    obj["startTime"] = static_cast<qint64>(download.start_time) * 1000;
+    obj["endTime"] = static_cast<qint64>(download.end_time) * 1000;
+    obj["error"] = QString::fromStdString(download.error_message);
+    return obj;
+}
+
+QJsonObject DownloadsBridge::fetchPage(const QString& cursor, int count) {
+    QJsonObject result;
+    result["items"] = QJsonArray();
+    result["next"] = QString();
+    if (!isAllowed()) return result;
+    subscribe();
+
+    size_t limit = static_cast<size_t>(std::clamp(count, 1, MAX_PAGE_SIZE));
+    auto downloads = SeaBrowser::DownloadsManager::instance().get_page_after(
+        cursor.toStdString(), limit, filter_.toStdString());
+
+    QJsonArray items;
+    for (const auto& download : downloads) items.append(toJson(download));
+    result["items"] = items;
+    if (downloads.size() == limit) {
+        result["next"] = QString::fromStdString(downloads.back().id);
+    }
+    return result;
+}
+
+void DownloadsBridge::setFilter(const QString& filter) {
+    filter_ = filter.trimmed();
+}
+
+bool DownloadsBridge::matchesFilter(const SeaBrowser::Download& download) const {
+    return filter_.isEmpty() ||
+           QString::fromStdString(download.filename).contains(filter_, Qt::CaseInsensitive) ||
+           QString::fromStdString(download.url).contains(filter_, Qt::CaseInsensitive);
+}
+
+void DownloadsBridge::onDownloadEvent(const SeaBrowser::DownloadEvent& event) {
+    if (!isAllowed()) return;
+    auto& downloads = SeaBrowser::DownloadsManager::instance();
+    switch (event.type) {
+        case SeaBrowser::DownloadEvent::Progress:
+            // Deliberately unfiltered and lookup-free; the page drops ids
+            // it has not loaded
+            if (!progress_subscribed_) return;
+            pending_progress_.insert(QString::fromStdString(event.id),
+                                     {event.received_bytes, event.total_bytes, event.speed});
+            scheduleProgress();
+            break;
+        case SeaBrowser::DownloadEvent::Added:
+        case SeaBrowser::DownloadEvent::Updated: {
+            // The full item supersedes any queued progress for it
+            pending_progress_.remove(QString::fromStdString(event.id));
+            const SeaBrowser::Download* download = downloads.get_download(event.id);
+            if (!download || !matchesFilter(*download)) return;
+            if (event.type == SeaBrowser::DownloadEvent::Added) {
+                emit itemAdded(toJson(*download));
+            } else {
+                emit itemUpdated(toJson(*download));
+            }
+            break;
+        }
+        case SeaBrowser::DownloadEvent::Removed:
+            pending_progress_.remove(QString::fromStdString(event.id));
+            emit itemRemoved(QString::fromStdString(event.id));
+            break;
+        case SeaBrowser::DownloadEvent::Reset:
+            pending_progress_.clear();
+            emit reset();
+            break;
+    }
+}
+
+void DownloadsBridge::setProgressSubscribed(bool subscribed) {
+    if (!isAllowed()) return;
+    subscribe();
+    progress_subscribed_ = subscribed;
+    pending_progress_.clear();
+    progress_ready_ = subscribed;
+    if (!subscribed) return;
+
+    // Anything that moved while the page was hidden goes out in one batch
+    for (const auto& download : SeaBrowser::DownloadsManager::instance().get_active_downloads()) {
+        pending_progress_.insert(QString::fromStdString(download.id),
+                                 {download.received_bytes, download.total_bytes, download.speed});
+    }
+    scheduleProgress();
+}
+
+void DownloadsBridge::requestProgress() {
+    if (!progress_subscribed_) return;
+    progress_ready_ = true;
+    scheduleProgress();
+}
+
+// Deltas reported in the same event loop pass share one batch
+void DownloadsBridge::scheduleProgress() {
+    if (!progress_ready_ || flush_queued_ || pending_progress_.isEmpty()) return;
+    flush_queued_ = true;
+    QTimer::singleShot(0, this, &DownloadsBridge::flushProgress);
+}
+
+void DownloadsBridge::flushProgress() {
+    flush_queued_ = false;
+    if (!progress_ready_ || pending_progress_.isEmpty() || !isAllowed()) return;
+
+    QJsonArray batch;
+    for (auto it = pending_progress_.cbegin(); it != pending_progress_.cend(); ++it) {
+        batch.append(QJsonArray{it.key(), static_cast<qint64>(it->received),
+                                static_cast<qint64>(it->total),
+                                static_cast<qint64>(std::llround(it->speed))});
+    }
+    pending_progress_.clear();
+    progress_ready_ = false;
+    emit progress(batch);
+}
+
+void DownloadsBridge::pause(const QString& id) {
+    if (isAllowed()) SeaBrowser::DownloadsManager::instance().pause_download(id.toStdString());
+}
+
+void DownloadsBridge::resume(const QString& id) {
+    if (isAllowed()) SeaBrowser::DownloadsManager::instance().resume_download(id.toStdString());
+}
+
+void DownloadsBridge::cancel(const QString& id) {
+    if (isAllowed()) SeaBrowser::DownloadsManager::instance().cancel_download(id.toStdString());
+}
+
+void DownloadsBridge::retry(const QString& id) {
+    if (isAllowed()) SeaBrowser::DownloadsManager::instance().retry_download(id.toStdString());
+}
+
+void DownloadsBridge::remove(const QString& id) {
+    if (isAllowed()) SeaBrowser::DownloadsManager::instance().remove_download(id.toStdString());
+}
+
+void DownloadsBridge::clearCompleted() {
+    if (isAllowed()) SeaBrowser::DownloadsManager::instance().clear_completed();
+}
+
+// Paths come from the download record, never from the page
+void DownloadsBridge::openFile(const QString& id) {
+    if (!isAllowed()) return;
+    auto& downloads = SeaBrowser::DownloadsManager::instance();
+    if (const SeaBrowser::Download* download = downloads.get_download(id.toStdString())) {
+        QDesktopServices::openUrl(QUrl::fromLocalFile(QString::fromStdString(download->path)));
+    }
+}
+
+void DownloadsBridge::showInFolder(const QString& id) {
+    if (!isAllowed()) return;
+    auto& downloads = SeaBrowser::DownloadsManager::instance();
+    if (const SeaBrowser::Download* download = downloads.get_download(id.toStdString())) {
+        QDesktopServices::openUrl(QUrl::fromLocalFile(
+            QFileInfo(QString::fromStdString(download->path)).absolutePath()));
+    }
+}
+
+void DownloadsBridge::openDownloadsFolder() {
+    if (!isAllowed()) return;
+    QDesktopServices::openUrl(QUrl::fromLocalFile(
+        QString::fromStdString(SeaBrowser::DownloadsManager::instance().downloads_folder())));
+}
+
+} // namespace Tsunami
@@ -0,0 +1,87 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * downloads_bridge.h - Paged downloads list for tsunami://downloads
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+class QWebEnginePage;
+
+namespace SeaBrowser {
+struct Download;
+struct DownloadEvent;
+}
+
+namespace Tsunami {
+
+class DownloadsBridge : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int MAX_PAGE_SIZE = 200;
+
+    explicit DownloadsBridge(QWebEnginePage* page, QObject* parent = nullptr);
+    ~DownloadsBridge() override;
+
+    // Same contract as HistoryBridge::fetchPage; the cursor is a download id
+    Q_INVOKABLE QJsonObject fetchPage(const QString& cursor, int count);
+    Q_INVOKABLE void setFilter(const QString& filter);
+
+    Q_INVOKABLE void pause(const QString& id);
+    Q_INVOKABLE void resume(const QString& id);
+    Q_INVOKABLE void cancel(const QString& id);
+    Q_INVOKABLE void retry(const QString& id);
+    Q_INVOKABLE void remove(const QString& id);
+    Q_INVOKABLE void clearCompleted();
+    Q_INVOKABLE void openFile(const QString& id);
+    Q_INVOKABLE void showInFolder(const QString& id);
+    Q_INVOKABLE void openDownloadsFolder();
+
+    // Progress is pushed as compact [id, received, total, speed] deltas. A
+    // page subscribes while it is visible and calls requestProgress() once
+    // it has painted the last batch, so it never gets more than one batch
+    // per frame however many downloads are running.
+    Q_INVOKABLE void setProgressSubscribed(bool subscribed);
+    Q_INVOKABLE void requestProgress();
+
+    static QJsonObject toJson(const SeaBrowser::Download& download);
+
+signals:
+    void itemAdded(const QJsonObject& item);
+    void itemUpdated(const QJsonObject& item);
+    void itemRemoved(const QString& id);
+    void reset();
+    void progress(const QJsonArray& batch);
+
+private:
+    struct ProgressDelta {
+        quint64 received;
+        quint64 total;
+        double speed;
+    };
+
+    bool isAllowed() const;
+    void subscribe();
+    void onDownloadEvent(const SeaBrowser::DownloadEvent& event);
+    bool matchesFilter(const SeaBrowser::Download& download) const;
+    void scheduleProgress();
+    void flushProgress();
+
+    QPointer<QWebEnginePage> page_;
+    QString filter_;
+    int listener_id_ = 0;
+
+    // Latest counters per download since the last batch
+    QHash<QString, ProgressDelta> pending_progress_;
+    bool progress_subscribed_ = false;
+    bool progress_ready_ = false;     // The page asked for the next batch
+    bool flush_queued_ = false;
+};
+
+} // namespace Tsunami
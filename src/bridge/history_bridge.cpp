@@ -0,0 +1,113 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * history_bridge.cpp - Paged browsing history for tsunami://history
+ */
+
+#include "history_bridge.h"
+#include "web_view.h"
+#include "history/history_store.h"
+#include "profile/private_session.h"
+#include <QWebEnginePage>
+#include <QJsonArray>
+#include <algorithm>
+
+namespace Tsunami {
+
+namespace {
+
+QJsonObject toJson(const SeaBrowser::HistoryItem& item) {
+    QJsonObject obj;
+    obj["id"] = item.id;
+    obj["url"] = QString::fromStdString(item.url);
+    obj["title"] = QString::fromStdString(item.title);
+    obj["time"] = item.timestamp * 1000;
+    return obj;
+}
+
+} // namespace
+
+HistoryBridge::HistoryBridge(QWebEnginePage* page, QObject* parent)
+    : QObject(parent)
+    , page_(page)
+    , history_(&PrivateSession::historyFor(page))
+{
+}
+
+HistoryBridge::~HistoryBridge() {
+    if (listener_id_) history_->remove_listener(listener_id_);
+}
+
+// Only internal pages may read history
+bool HistoryBridge::isAllowed() const {
+    return page_ && WebView::isInternalUrl(page_->url());
+}
+
+// Every page gets a bridge, so only pages that fetch pay for listening
+void HistoryBridge::subscribe() {
+    if (listener_id_) return;
+    listener_id_ = history_->add_listener(
+        [this](const SeaBrowser::HistoryEvent& event) {
+            QMetaObject::invokeMethod(this, [this, event]() { onHistoryEvent(event); },
+                                      Qt::QueuedConnection);
+        });
+}
+
+QJsonObject HistoryBridge::fetchPage(const QString& cursor, int count) {
+    QJsonObject result;
+    result["items"] = QJsonArray();
+    result["next"] = QString();
+    if (!isAllowed()) return result;
+    subscribe();
+
+    // Cursor: "<timestamp>:<id>" of the last row already shown
+    qint64 before_timestamp = 0;
+    qint64 before_id = 0;
+    int colon = cursor.indexOf(':');
+    if (colon > 0) {
+        before_timestamp = cursor.left(colon).toLongLong();
+        before_id = cursor.mid(colon + 1).toLongLong();
+    }
+
+    int limit = std::clamp(count, 1, MAX_PAGE_SIZE);
+    auto visits = history_->get_page(
+        before_timestamp, before_id, limit, filter_.toStdString());
+
+    QJsonArray items;
+    for (const auto& visit : visits) items.append(toJson(visit));
+    result["items"] = items;
+    if (static_cast<int>(visits.size()) == limit) {
+        result["next"] = QString("%1:%2").arg(visits.back().timestamp).arg(visits.back().id);
+    }
+    return result;
+}
+
+void HistoryBridge::setFilter(const QString& filter) {
+    filter_ = filter.trimmed();
+}
+
+void HistoryBridge::deleteUrl(const QString& url) {
+    if (!isAllowed()) return;
+    history_->delete_history_item(url.toStdString());
+}
+
+void HistoryBridge::clearAll() {
+    if (!isAllowed()) return;
+    history_->clear_history();
+}
+
+void HistoryBridge::onHistoryEvent(const SeaBrowser::HistoryEvent& event) {
+    if (!isAllowed()) return;
+    if (event.type != SeaBrowser::HistoryEvent::Added) {
+        emit reset();
+        return;
+    }
+    QString url = QString::fromStdString(event.item.url);
+    QString title = QString::fromStdString(event.item.title);
+    if (!filter_.isEmpty() && !url.contains(filter_, Qt::CaseInsensitive) &&
+        !title.contains(filter_, Qt::CaseInsensitive)) {
+        return;
+    }
+    emit itemAdded(toJson(event.item));
+}
+
+} // namespace Tsunami
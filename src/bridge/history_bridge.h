@@ -0,0 +1,55 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * history_bridge.h - Paged browsing history for tsunami://history
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QJsonObject>
+#include <QString>
+
+class QWebEnginePage;
+
+namespace SeaBrowser {
+struct HistoryEvent;
+class HistoryStore;
+}
+
+namespace Tsunami {
+
+// Pages pull history one keyset page at a time and get pushed only the
+// changes after that, so no call ever serialises the whole table
+class HistoryBridge : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int MAX_PAGE_SIZE = 200;
+
+    explicit HistoryBridge(QWebEnginePage* page, QObject* parent = nullptr);
+    ~HistoryBridge() override;
+
+    // {"items": [...], "next": cursor}; "next" is empty after the last page.
+    // Pass an empty cursor for the newest visits.
+    Q_INVOKABLE QJsonObject fetchPage(const QString& cursor, int count);
+    // Applies to later fetchPage() calls and pushes
+    Q_INVOKABLE void setFilter(const QString& filter);
+    Q_INVOKABLE void deleteUrl(const QString& url);
+    Q_INVOKABLE void clearAll();
+
+signals:
+    void itemAdded(const QJsonObject& item);   // A new visit matching the filter
+    void reset();                              // Visits were removed; fetch again
+
+private:
+    bool isAllowed() const;
+    void subscribe();
+    void onHistoryEvent(const SeaBrowser::HistoryEvent& event);
+
+    QPointer<QWebEnginePage> page_;
+    SeaBrowser::HistoryStore* history_;   // The private session's for private pages
+    QString filter_;
+    int listener_id_ = 0;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,115 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * memory_bridge.cpp - Per-process memory use for tsunami://memory
+ */
+
+#include "memory_bridge.h"
+#include "web_view.h"
+#include "perf/process_memory.h"
+#include "settings/chromium_flags.h"
+#include "settings/settings.h"
+#include <QApplication>
+#include <QHash>
+#include <QJsonArray>
+#include <QThreadPool>
+#include <QWebEnginePage>
+#include <QWebEngineProfile>
+#include <QWebEngineView>
+#include <algorithm>
+
+namespace Tsunami {
+
+MemoryBridge::MemoryBridge(QWebEnginePage* page, QObject* parent)
+    : QObject(parent)
+    , page_(page)
+{
+}
+
+bool MemoryBridge::isAllowed() const {
+    return page_ && WebView::isInternalUrl(page_->url());
+}
+
+QJsonObject MemoryBridge::getConfiguration() const {
+    QJsonObject obj;
+    if (!isAllowed()) return obj;
+    const Settings& settings = Settings::instance();
+    obj["processModel"] = settings.getProcessModel();
+    obj["rendererProcessLimit"] = settings.getRendererProcessLimit();
+    obj["jsHeapLimitMb"] = settings.getJsHeapLimitMb();
+    obj["chromiumFlags"] = ChromiumFlags::effective();
+    return obj;
+}
+
+void MemoryBridge::refresh() {
+    if (!isAllowed() || refreshing_) return;
+    refreshing_ = true;
+
+    // Tabs are read here, on the UI thread; only /proc is read on the worker
+    QHash<int, QJsonArray> tabs_by_pid;
+    for (QWidget* window : QApplication::topLevelWidgets()) {
+        for (QWebEngineView* view : window->findChildren<QWebEngineView*>()) {
+            QWebEnginePage* page = view->page();
+            qint64 pid = page->renderProcessPid();
+            if (pid <= 0) continue;
+            QJsonObject tab;
+            bool off_the_record = page->profile()->isOffTheRecord();
+            tab["title"] = off_the_record ? QStringLiteral("Private tab") : page->title();
+            tab["url"] = off_the_record ? QString() : page->url().toString();
+            tabs_by_pid[static_cast<int>(pid)].append(tab);
+        }
+    }
+
+    int self = static_cast<int>(QCoreApplication::applicationPid());
+    QPointer<MemoryBridge> bridge(this);
+    QThreadPool::globalInstance()->start([bridge, self, tabs_by_pid]() {
+        std::vector<int> pids = descendant_pids(self);
+        pids.insert(pids.begin(), self);
+
+        std::vector<ProcessMemory> processes;
+        processes.reserve(pids.size());
+        for (int pid : pids) {
+            ProcessMemory memory;
+            if (read_process_memory(pid, memory)) processes.push_back(std::move(memory));
+        }
+        std::sort(processes.begin(), processes.end(),
+                  [](const ProcessMemory& a, const ProcessMemory& b) { return a.pss_bytes > b.pss_bytes; });
+
+        QJsonArray rows;
+        qint64 total_pss = 0;
+        int renderers = 0;
+        for (const ProcessMemory& memory : processes) {
+            QJsonObject row;
+            row["pid"] = memory.pid;
+            row["name"] = QString::fromStdString(memory.name);
+            row["rss"] = static_cast<qint64>(memory.rss_bytes);
+            row["pss"] = static_cast<qint64>(memory.pss_bytes);
+            row["private"] = static_cast<qint64>(memory.private_bytes);
+            row["swap"] = static_cast<qint64>(memory.swap_bytes);
+            if (memory.pid == self) {
+                row["kind"] = QStringLiteral("browser");
+            } else if (tabs_by_pid.contains(memory.pid)) {
+                row["kind"] = QStringLiteral("renderer");
+                row["tabs"] = tabs_by_pid.value(memory.pid);
+                ++renderers;
+            } else {
+                // Zygote, GPU, network and utility processes
+                row["kind"] = QStringLiteral("helper");
+            }
+            total_pss += static_cast<qint64>(memory.pss_bytes);
+            rows.append(row);
+        }
+
+        QJsonObject result;
+        result["processes"] = rows;
+        result["totalPss"] = total_pss;
+        result["rendererCount"] = renderers;
+        result["supported"] = !processes.empty();
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [bridge, result]() {
+            if (!bridge) return;
+            bridge->refreshing_ = false;
+            if (bridge->isAllowed()) emit bridge->snapshot(result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+} // namespace Tsunami
@@ -0,0 +1,39 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * memory_bridge.h - Per-process memory use for tsunami://memory
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QJsonObject>
+
+class QWebEnginePage;
+
+namespace Tsunami {
+
+// Memory of the browser, each renderer and Chromium's helper processes,
+// with the tabs each renderer hosts, so the effect of the process model
+// settings can be seen. /proc is read on a worker thread.
+class MemoryBridge : public QObject {
+    Q_OBJECT
+public:
+    explicit MemoryBridge(QWebEnginePage* page, QObject* parent = nullptr);
+
+    // Process model settings and the flags Chromium actually got
+    Q_INVOKABLE QJsonObject getConfiguration() const;
+    // snapshot() follows
+    Q_INVOKABLE void refresh();
+
+signals:
+    void snapshot(const QJsonObject& snapshot);
+
+private:
+    bool isAllowed() const;
+
+    QPointer<QWebEnginePage> page_;
+    bool refreshing_ = false;
+};
+
+} // namespace Tsunami
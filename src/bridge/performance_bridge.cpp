@@ -0,0 +1,93 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * performance_bridge.cpp - Exposes trace statistics to tsunami://performance
+ */
+
+#include "performance_bridge.h"
+#include "application.h"
+#include "web_view.h"
+#include "perf/trace.h"
+#include <QWebEnginePage>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+
+namespace Tsunami {
+
+PerformanceBridge::PerformanceBridge(QWebEnginePage* page, QObject* parent)
+    : QObject(parent)
+    , page_(page)
+{
+}
+
+// Only internal pages may read traces; they include visited URLs' timings
+bool PerformanceBridge::isAllowed() const {
+    return page_ && WebView::isInternalUrl(page_->url());
+}
+
+QJsonObject PerformanceBridge::getStats() const {
+    QJsonObject obj;
+#ifdef TSUNAMI_TRACING
+    obj["compiledIn"] = true;
+#else
+    obj["compiledIn"] = false;
+#endif
+    if (!isAllowed()) return obj;
+
+    Tracer& tracer = Tracer::instance();
+    obj["enabled"] = tracer.enabled();
+    obj["sampleInterval"] = static_cast<int>(tracer.sample_interval());
+
+    QJsonArray spans;
+    for (const TraceStats& stats : tracer.stats()) {
+        QJsonObject span;
+        span["name"] = QString::fromStdString(stats.name);
+        span["count"] = static_cast<qint64>(stats.count);
+        span["p50"] = stats.p50_us;
+        span["p95"] = stats.p95_us;
+        span["p99"] = stats.p99_us;
+        span["max"] = stats.max_us;
+        spans.append(span);
+    }
+    obj["spans"] = spans;
+    return obj;
+}
+
+QString PerformanceBridge::exportTrace() const {
+    if (!isAllowed()) return QString();
+    return QString::fromStdString(Tracer::instance().export_chrome_json());
+}
+
+QString PerformanceBridge::saveTrace() const {
+    if (!isAllowed()) return QString();
+
+    QDir dir(Application::get_data_dir() + "/traces");
+    if (!dir.exists()) dir.mkpath(".");
+
+    QString path = dir.filePath(QString("trace-%1.json")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")));
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return QString();
+
+    file.write(QByteArray::fromStdString(Tracer::instance().export_chrome_json()));
+    file.close();
+    return path;
+}
+
+void PerformanceBridge::clearTrace() {
+    if (!isAllowed()) return;
+    Tracer::instance().clear();
+}
+
+void PerformanceBridge::setTracingEnabled(bool enabled) {
+    if (!isAllowed()) return;
+    Tracer::instance().set_enabled(enabled);
+}
+
+void PerformanceBridge::setSampleInterval(int interval) {
+    if (!isAllowed()) return;
+    Tracer::instance().set_sample_interval(static_cast<uint32_t>(qMax(1, interval)));
+}
+
+} // namespace Tsunami
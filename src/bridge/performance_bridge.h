@@ -0,0 +1,35 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * performance_bridge.h - Exposes trace statistics to tsunami://performance
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QJsonObject>
+#include <QString>
+
+class QWebEnginePage;
+
+namespace Tsunami {
+
+class PerformanceBridge : public QObject {
+    Q_OBJECT
+public:
+    explicit PerformanceBridge(QWebEnginePage* page, QObject* parent = nullptr);
+
+    Q_INVOKABLE QJsonObject getStats() const;
+    Q_INVOKABLE QString exportTrace() const;
+    Q_INVOKABLE QString saveTrace() const;
+    Q_INVOKABLE void clearTrace();
+    Q_INVOKABLE void setTracingEnabled(bool enabled);
+    Q_INVOKABLE void setSampleInterval(int interval);
+
+private:
+    bool isAllowed() const;
+
+    QPointer<QWebEnginePage> page_;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,214 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * tasks_bridge.cpp - Live per-tab CPU and memory for tsunami://tasks
+ */
+
+#include "tasks_bridge.h"
+#include "web_view.h"
+#include "perf/task_sampler.h"
+#include "reload/crash_recovery.h"
+#include <QApplication>
+#include <QJsonArray>
+#include <QMap>
+#include <QVariant>
+#include <QWebEnginePage>
+#include <QWebEngineProfile>
+#include <QWebEngineView>
+#include <array>
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#endif
+
+namespace Tsunami {
+
+namespace {
+
+constexpr char TAB_ID_PROPERTY[] = "tsunamiTaskId";
+
+// Stable for the life of the view, so the page can act on a row it showed
+int tabId(QWebEngineView* view) {
+    static int next_id = 1;
+    QVariant id = view->property(TAB_ID_PROPERTY);
+    if (id.isValid()) return id.toInt();
+    view->setProperty(TAB_ID_PROPERTY, next_id);
+    return next_id++;
+}
+
+QList<QWebEngineView*> allTabs() {
+    QList<QWebEngineView*> views;
+    for (QWidget* window : QApplication::topLevelWidgets()) {
+        views += window->findChildren<QWebEngineView*>();
+    }
+    return views;
+}
+
+QString lifecycleName(QWebEnginePage::LifecycleState state) {
+    switch (state) {
+    case QWebEnginePage::LifecycleState::Frozen: return QStringLiteral("frozen");
+    case QWebEnginePage::LifecycleState::Discarded: return QStringLiteral("discarded");
+    default: return QStringLiteral("active");
+    }
+}
+
+} // namespace
+
+int TasksBridge::subscribers_ = 0;
+
+TasksBridge::TasksBridge(QWebEnginePage* page, QObject* parent)
+    : QObject(parent)
+    , page_(page)
+{
+    timer_.setInterval(TaskSampler::INTERVAL_MS);
+    connect(&timer_, &QTimer::timeout, this, &TasksBridge::tick);
+}
+
+TasksBridge::~TasksBridge() {
+    setActive(false);
+}
+
+bool TasksBridge::isAllowed() const {
+    return page_ && WebView::isInternalUrl(page_->url());
+}
+
+// Joined on exit with the last static; idle until a tasks page is shown
+TaskSampler& TasksBridge::sampler() {
+    static TaskSampler sampler;
+    return sampler;
+}
+
+void TasksBridge::setActive(bool active) {
+    if (active && !isAllowed()) return;
+    if (active == active_) return;
+    active_ = active;
+    if (active) {
+        if (subscribers_++ == 0) sampler().start();
+        tick();
+        timer_.start();
+    } else {
+        timer_.stop();
+        if (--subscribers_ == 0) sampler().stop();
+    }
+}
+
+void TasksBridge::tick() {
+    if (!isAllowed()) {
+        setActive(false);
+        return;
+    }
+
+    // Renderers in first-seen order, each with the tabs it hosts
+    int self = static_cast<int>(QCoreApplication::applicationPid());
+    std::array<int, TaskSampler::MAX_PROCESSES> pids;
+    size_t pid_count = 0;
+    pids[pid_count++] = self;
+    QMap<int, QJsonArray> tabs_by_pid;
+    QJsonArray unloaded;
+    for (QWebEngineView* view : allTabs()) {
+        QWebEnginePage* page = view->page();
+        bool off_the_record = page->profile()->isOffTheRecord();
+        QJsonObject tab;
+        tab["id"] = tabId(view);
+        tab["title"] = off_the_record ? QStringLiteral("Private tab") : page->title();
+        tab["url"] = off_the_record ? QString() : page->url().toString();
+        tab["state"] = lifecycleName(page->lifecycleState());
+        tab["visible"] = page->isVisible();
+        if (!off_the_record) {
+            CrashRecovery::SiteCrashes crashes = CrashRecovery::instance().siteCrashes(page->url().host());
+            tab["crashes"] = crashes.crashes + crashes.oom_kills;
+        }
+
+        int pid = static_cast<int>(page->renderProcessPid());
+        if (pid <= 0) {
+            unloaded.append(tab);
+            continue;
+        }
+        if (!tabs_by_pid.contains(pid) && pid_count < pids.size()) pids[pid_count++] = pid;
+        tabs_by_pid[pid].append(tab);
+    }
+    sampler().set_pids(pids.data(), pid_count);
+
+    // Samples lag set_pids() by a tick, so rows are matched by pid
+    std::array<TaskSample, TaskSampler::MAX_PROCESSES> samples;
+    size_t sample_count = sampler().snapshot(samples.data(), samples.size());
+
+    QJsonArray rows;
+    double total_cpu = 0;
+    qint64 total_pss = 0;
+    for (size_t i = 0; i < sample_count; ++i) {
+        const TaskSample& sample = samples[i];
+        if (!sample.alive) continue;
+        if (sample.pid != self && !tabs_by_pid.contains(sample.pid)) continue;
+        QJsonObject row;
+        row["pid"] = sample.pid;
+        row["kind"] = sample.pid == self ? QStringLiteral("browser") : QStringLiteral("renderer");
+        row["cpu"] = sample.cpu_percent;
+        row["rss"] = static_cast<qint64>(sample.rss_bytes);
+        row["pss"] = static_cast<qint64>(sample.pss_bytes);
+        if (sample.pid != self) row["tabs"] = tabs_by_pid.value(sample.pid);
+        total_cpu += sample.cpu_percent;
+        total_pss += static_cast<qint64>(sample.pss_bytes);
+        rows.append(row);
+    }
+
+    QJsonObject result;
+    result["processes"] = rows;
+    result["unloaded"] = unloaded;
+    result["totalCpu"] = total_cpu;
+    result["totalPss"] = total_pss;
+#ifdef Q_OS_LINUX
+    result["supported"] = true;
+#else
+    result["supported"] = false;
+#endif
+    emit tasks(result);
+}
+
+QWebEngineView* TasksBridge::findTab(int tab_id) {
+    for (QWebEngineView* view : allTabs()) {
+        QVariant id = view->property(TAB_ID_PROPERTY);
+        if (id.isValid() && id.toInt() == tab_id) return view;
+    }
+    return nullptr;
+}
+
+// Chromium refuses both for a visible page; switching to the tab later
+// brings it back to Active, reloading it if it was discarded
+bool TasksBridge::discardTab(int tab_id) {
+    if (!isAllowed()) return false;
+    QWebEngineView* view = findTab(tab_id);
+    if (!view || view->page() == page_ || view->page()->isVisible()) return false;
+    view->page()->setLifecycleState(QWebEnginePage::LifecycleState::Discarded);
+    return true;
+}
+
+bool TasksBridge::freezeTab(int tab_id) {
+    if (!isAllowed()) return false;
+    QWebEngineView* view = findTab(tab_id);
+    if (!view || view->page() == page_ || view->page()->isVisible()) return false;
+    view->page()->setLifecycleState(QWebEnginePage::LifecycleState::Frozen);
+    return true;
+}
+
+// The tabs it hosts show Chromium's crashed state until reloaded;
+// CrashRecovery is told not to reload them
+bool TasksBridge::endProcess(int pid) {
+    if (!isAllowed() || pid <= 0) return false;
+    QList<QWebEngineView*> hosted;
+    for (QWebEngineView* view : allTabs()) {
+        if (view->page()->renderProcessPid() == pid) {
+            // Not the renderer this page itself runs in
+            if (view->page() == page_) return false;
+            hosted.append(view);
+        }
+    }
+    if (hosted.isEmpty()) return false;
+#ifdef Q_OS_UNIX
+    for (QWebEngineView* view : hosted) view->setProperty(CrashRecovery::ENDED_PROPERTY, true);
+    return ::kill(pid, SIGKILL) == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace Tsunami
@@ -0,0 +1,56 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * tasks_bridge.h - Live per-tab CPU and memory for tsunami://tasks
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QJsonObject>
+#include <QTimer>
+
+class QWebEnginePage;
+class QWebEngineView;
+
+namespace Tsunami {
+
+class TaskSampler;
+
+// The task manager: CPU and memory of the browser and each renderer, with
+// the tabs each renderer hosts, and actions to discard or freeze a
+// background tab or end a renderer. Sampling runs on one TaskSampler
+// thread shared by every open tasks page, and only while one is visible;
+// this side only hands it pids and copies out its last samples.
+class TasksBridge : public QObject {
+    Q_OBJECT
+public:
+    explicit TasksBridge(QWebEnginePage* page, QObject* parent = nullptr);
+    ~TasksBridge() override;
+
+    // From the page's visibility; tasks() follows every second while active
+    Q_INVOKABLE void setActive(bool active);
+
+    // Tab ids come from tasks(); only a tab not on screen can be discarded
+    // or frozen, and only a renderer of one of our tabs can be ended
+    Q_INVOKABLE bool discardTab(int tab_id);
+    Q_INVOKABLE bool freezeTab(int tab_id);
+    Q_INVOKABLE bool endProcess(int pid);
+
+signals:
+    void tasks(const QJsonObject& tasks);
+
+private:
+    bool isAllowed() const;
+    void tick();
+    static TaskSampler& sampler();
+    static QWebEngineView* findTab(int tab_id);
+
+    QPointer<QWebEnginePage> page_;
+    QTimer timer_;
+    bool active_ = false;
+
+    static int subscribers_;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,38 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * top_sites_bridge.cpp - Most visited sites for the new tab page
+ */
+
+#include "top_sites_bridge.h"
+#include "web_view.h"
+#include "history/top_sites.h"
+#include <QWebEnginePage>
+
+namespace Tsunami {
+
+TopSitesBridge::TopSitesBridge(QWebEnginePage* page, QObject* parent)
+    : QObject(parent)
+    , page_(page)
+{
+    // Visits are recorded on whichever thread loaded the page
+    listener_id_ = SeaBrowser::TopSites::instance().add_listener([this]() {
+        QMetaObject::invokeMethod(this, &TopSitesBridge::topSitesChanged, Qt::QueuedConnection);
+    });
+}
+
+TopSitesBridge::~TopSitesBridge() {
+    SeaBrowser::TopSites::instance().remove_listener(listener_id_);
+}
+
+// Browsing history is only for internal pages
+bool TopSitesBridge::isAllowed() const {
+    return page_ && WebView::isInternalUrl(page_->url());
+}
+
+QString TopSitesBridge::getTopSites() const {
+    if (!isAllowed()) return QStringLiteral("[]");
+    auto json = SeaBrowser::TopSites::instance().json();
+    return QString::fromUtf8(json->data(), static_cast<qsizetype>(json->size()));
+}
+
+} // namespace Tsunami
@@ -0,0 +1,35 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * top_sites_bridge.h - Most visited sites for the new tab page
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+class QWebEnginePage;
+
+namespace Tsunami {
+
+class TopSitesBridge : public QObject {
+    Q_OBJECT
+public:
+    explicit TopSitesBridge(QWebEnginePage* page, QObject* parent = nullptr);
+    ~TopSitesBridge() override;
+
+    // The precomputed JSON array from TopSites; no query runs here
+    Q_INVOKABLE QString getTopSites() const;
+
+signals:
+    void topSitesChanged();
+
+private:
+    bool isAllowed() const;
+
+    QPointer<QWebEnginePage> page_;
+    int listener_id_ = 0;
+};
+
+} // namespace Tsunami
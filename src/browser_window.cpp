@@ -16,6 +16,19 @@
 #include "ui/history_window.h"
 #include "ui/extensions_window.h"
 #include "ui/custom_menu.h"
+#include "perf/trace.h"
+#include "startup_pipeline.h"
+#include "ui/theme_engine.h"
+#include "blocking/content_blocker.h"
+#include "blocking/request_interceptor.h"
+#include "favicons/favicon_service.h"
+#include "thumbnails/thumbnail_cache.h"
+#include "reload/auto_reload.h"
+#include "reload/crash_recovery.h"
+#include "settings/site_settings.h"
+#include "profile/profile_manager.h"
+#include "profile/private_session.h"
+#include "import/browser_importer.h"
 #include <QWebEngineView>
 #include <QWebEnginePage>
 #include <QWebEngineHistory>
@@ -34,8 +47,15 @@
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QMessageBox>
+#include <QInputDialog>
+#include <QProgressDialog>
 #include <QDragEnterEvent>
 #include <QMimeData>
+#include <QTimer>
+#include <QTabBar>
+#include <QToolTip>
+#include <QHelpEvent>
+#include <QShortcut>
 #include <iostream>
 #include <algorithm>
 
@@ -43,7 +63,138 @@ using namespace Tsunami;
 
 namespace Tsunami {
 
-BrowserWindow::BrowserWindow(QWidget* parent)
+namespace {
+
+QString buildWindowStyle(bool isDark, const QString& accent) {
+    Q_UNUSED(accent)
+    QString accentColor = "#3b82f6"; // Fixed blue accent color
+    
+    QString bgColor = isDark ? "#030712" : "#b8e0ff"; // Changed from #f8fafc to #ffffff
+    QString titleBg = isDark ? "#0f172a" : "#ffffff";
+    QString inputBg = isDark ? "#1e293b" : "#f1f5f9";
+    QString borderColor = isDark ? "#334155" : "#e2e8f0";
+    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
+    QString tabBg = isDark ? "#0f172a" : "#e2e8f0";
+    QString tabSelected = isDark ? "#030712" : "#ffffff";
+    QString tabHover = isDark ? "#1e293b" : "#cbd5e1";
+    
+    return QString(R"(
+        QWidget#centralWidget { 
+            background-color: %1; 
+        }
+        QWidget#titleBar { 
+            background-color: %2; 
+            border-bottom: 1px solid %3;
+        }
+        QWidget#urlContainer {
+            background-color: %4;
+            border-radius: 16px;
+            border: 1px solid %3;
+        }
+        QWidget#urlContainer:focus-within {
+            border: 2px solid %5;
+        }
+        QToolButton { 
+            background-color: transparent; 
+            border: none; 
+            border-radius: 6px; 
+            padding: 4px; 
+            margin: 2px;
+        }
+        QToolButton:hover { 
+            background-color: rgba(0, 0, 0, 0.1); 
+        }
+        QToolButton:pressed {
+            background-color: rgba(0, 0, 0, 0.15);
+        }
+        QToolButton#closeButton:hover {
+            background-color: #e81123;
+        }
+        QToolButton#closeButton:pressed {
+            background-color: #f1707a;
+        }
+        QToolButton#minButton:hover, QToolButton#maxButton:hover {
+            background-color: rgba(0, 0, 0, 0.1);
+        }
+        QLineEdit#urlBar { 
+            background-color: transparent; 
+            color: %6; 
+            border: none;
+            padding: 4px 8px; 
+            font-size: 13px; 
+        }
+        QLineEdit#urlBar:focus { 
+            outline: none;
+        }
+        QProgressBar { 
+            background-color: transparent; 
+            border: none; 
+        }
+        QProgressBar::chunk { 
+            background-color: %5; 
+        }
+        QTabWidget::pane { 
+            background-color: %1; 
+            border: none; 
+        }
+        QTabBar::tab { 
+            background-color: %7; 
+            color: %6; 
+            padding: 8px 16px; 
+            border: none; 
+            border-radius: 8px 8px 0 0; 
+            margin: 0 2px; 
+            min-width: 100px; 
+        }
+        QTabBar::tab:selected { 
+            background-color: %8; 
+            color: %6; 
+        }
+        QTabBar::tab:hover:!selected { 
+            background-color: %9; 
+            color: %6;
+        }
+    )").arg(bgColor, titleBg, borderColor, inputBg, accentColor, textColor, tabBg, tabSelected, tabHover);
+}
+
+QString buildMenuStyle(bool isDark, const QString& accent) {
+    Q_UNUSED(accent)
+    QString accentColor = "#3b82f6"; // Fixed blue accent color
+    
+    QString bgColor = isDark ? "#0f172a" : "#ffffff";
+    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
+    QString borderColor = isDark ? "#1e293b" : "#e2e8f0";
+    QString selectedBg = isDark ? "#1e293b" : "#f1f5f9";
+    
+    return QString(R"(
+        QMenu {
+            background-color: %1;
+            border: 1px solid %2;
+            border-radius: 8px;
+            padding: 8px;
+        }
+        QMenu::item {
+            color: %3;
+            padding: 8px 24px;
+            border-radius: 4px;
+        }
+        QMenu::item:selected {
+            background-color: %4;
+        }
+        QMenu::item:selected {
+            background-color: %5;
+        }
+        QMenu::separator {
+            background-color: %2;
+            height: 1px;
+            margin: 6px 0px;
+        }
+    )").arg(bgColor, borderColor, textColor, selectedBg, accentColor);
+}
+
+} // namespace
+
+BrowserWindow::BrowserWindow(QWidget* parent, bool private_window)
     : QMainWindow(parent)
     , tab_widget_(nullptr)
     , url_bar_(nullptr)
@@ -59,9 +210,11 @@ BrowserWindow::BrowserWindow(QWidget* parent)
     , min_btn_(nullptr)
     , max_btn_(nullptr)
     , close_btn_(nullptr)
+    , private_(private_window)
     , is_dragging_(false)
 {
-    setWindowTitle("Tsunami");
+    setWindowTitle(private_ ? "Tsunami (Private)" : "Tsunami");
+    if (private_) PrivateSession::instance().attach(this);
     resize(1400, 900);
     setAcceptDrops(true);
     
@@ -71,7 +224,13 @@ BrowserWindow::BrowserWindow(QWidget* parent)
     
     setupUi();
     applyTheme();
-    restoreSession();
+
+    // Zoom is remembered per site
+    new QShortcut(QKeySequence::ZoomIn, this, [this]() { zoomCurrentTab(1); });
+    new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_Equal), this, [this]() { zoomCurrentTab(1); });
+    new QShortcut(QKeySequence::ZoomOut, this, [this]() { zoomCurrentTab(-1); });
+    new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_0), this, [this]() { zoomCurrentTab(0); });
+    new QShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_N), this, [this]() { onNewPrivateWindow(); });
 }
 
 BrowserWindow::~BrowserWindow() {
@@ -80,24 +239,16 @@ BrowserWindow::~BrowserWindow() {
 
 void BrowserWindow::show() {
     QMainWindow::show();
+
+    // Create the first tab after the window is on screen so Chromium
+    // start-up overlaps with the first paint instead of delaying it
+    if (tab_widget_->count() == 0 && pending_urls_.isEmpty()) {
+        QTimer::singleShot(0, this, &BrowserWindow::restoreSession);
+    }
 }
 
 void BrowserWindow::setupUi() {
-    // Set window icon for all platforms (Wayland, X11, Windows)
-    QStringList iconPaths;
-    iconPaths << QCoreApplication::applicationDirPath() + "/data/logo.svg"
-              << QCoreApplication::applicationDirPath() + "/logo.svg"
-              << "data/logo.svg";
-    
-    for (const QString& iconPath : iconPaths) {
-        if (QFile::exists(iconPath)) {
-            QIcon windowIcon(iconPath);
-            if (!windowIcon.isNull()) {
-                setWindowIcon(windowIcon);
-                break;
-            }
-        }
-    }
+    // The window icon is inherited from QApplication::windowIcon()
     
     // Check if first run - show onboarding
     if (Settings::instance().isFirstRun()) {
@@ -123,6 +274,12 @@ void BrowserWindow::setupUi() {
     tab_widget_->setElideMode(Qt::ElideRight);
     connect(tab_widget_, &QTabWidget::tabCloseRequested, this, &BrowserWindow::onCloseTab);
     connect(tab_widget_, &QTabWidget::currentChanged, this, &BrowserWindow::onTabChanged);
+    // Fires before the switch, while the outgoing page is still on screen
+    connect(tab_widget_->tabBar(), &QTabBar::tabBarClicked, this, [this](int index) {
+        if (index != tab_widget_->currentIndex()) captureCurrentTab();
+    });
+    // Hover previews come from the snapshot cache
+    tab_widget_->tabBar()->installEventFilter(this);
     main_layout->addWidget(tab_widget_);
 
     progress_bar_ = new QProgressBar(this);
@@ -133,8 +290,7 @@ void BrowserWindow::setupUi() {
     main_layout->addWidget(progress_bar_);
 
     // Connect to settings changes for instant updates
-    qDebug() << "Connecting settingsChanged signal..." << Qt::endl;
-    connect(&Settings::instance(), &Settings::settingsChanged, this, &BrowserWindow::onSettingsChanged);
+    connect(&ThemeEngine::instance(), &ThemeEngine::themeChanged, this, &BrowserWindow::onThemeChanged);
 
     // Don't create tab here - restoreSession will handle it
 }
@@ -153,9 +309,7 @@ void BrowserWindow::setupTitleBar() {
     title_layout->setContentsMargins(12, 6, 12, 6);
     title_layout->setSpacing(8);
 
-    QString iconPath = QCoreApplication::applicationDirPath() + "/data/icons/";
-    bool isDark = Settings::instance().getDarkMode();
-    QString iconSuffix = isDark ? "-white" : "";
+    ThemeEngine& theme = ThemeEngine::instance();
 
     // Navigation buttons - Left side
     back_btn_ = new QToolButton(title_bar_);
@@ -163,7 +317,7 @@ void BrowserWindow::setupTitleBar() {
     back_btn_->setFixedSize(32, 32);
     back_btn_->setToolTip("Back");
     back_btn_->setAutoRaise(true);
-    back_btn_->setIcon(QIcon(iconPath + "back" + iconSuffix + ".svg"));
+    back_btn_->setIcon(theme.icon("back"));
     back_btn_->setIconSize(QSize(16, 16));
     connect(back_btn_, &QToolButton::clicked, this, &BrowserWindow::onBack);
     title_layout->addWidget(back_btn_);
@@ -173,7 +327,7 @@ void BrowserWindow::setupTitleBar() {
     forward_btn_->setFixedSize(32, 32);
     forward_btn_->setToolTip("Forward");
     forward_btn_->setAutoRaise(true);
-    forward_btn_->setIcon(QIcon(iconPath + "forward" + iconSuffix + ".svg"));
+    forward_btn_->setIcon(theme.icon("forward"));
     forward_btn_->setIconSize(QSize(16, 16));
     connect(forward_btn_, &QToolButton::clicked, this, &BrowserWindow::onForward);
     title_layout->addWidget(forward_btn_);
@@ -183,7 +337,7 @@ void BrowserWindow::setupTitleBar() {
     reload_btn_->setFixedSize(32, 32);
     reload_btn_->setToolTip("Reload");
     reload_btn_->setAutoRaise(true);
-    reload_btn_->setIcon(QIcon(iconPath + "reload" + iconSuffix + ".svg"));
+    reload_btn_->setIcon(theme.icon("reload"));
     reload_btn_->setIconSize(QSize(16, 16));
     connect(reload_btn_, &QToolButton::clicked, this, &BrowserWindow::onReload);
     title_layout->addWidget(reload_btn_);
@@ -193,7 +347,7 @@ void BrowserWindow::setupTitleBar() {
     home_btn_->setFixedSize(32, 32);
     home_btn_->setToolTip("Home");
     home_btn_->setAutoRaise(true);
-    home_btn_->setIcon(QIcon(iconPath + "home" + iconSuffix + ".svg"));
+    home_btn_->setIcon(theme.icon("home"));
     home_btn_->setIconSize(QSize(16, 16));
     connect(home_btn_, &QToolButton::clicked, this, &BrowserWindow::onHome);
     title_layout->addWidget(home_btn_);
@@ -214,7 +368,7 @@ void BrowserWindow::setupTitleBar() {
     security_btn_->setObjectName("securityButton");
     security_btn_->setFixedSize(18, 18);
     security_btn_->setAutoRaise(true);
-    security_btn_->setIcon(QIcon(iconPath + "lock" + iconSuffix + ".svg"));
+    security_btn_->setIcon(theme.icon("lock"));
     security_btn_->setIconSize(QSize(14, 14));
     security_btn_->setToolTip("Secure Connection");
     connect(security_btn_, &QToolButton::clicked, this, &BrowserWindow::onSecurity);
@@ -234,7 +388,7 @@ void BrowserWindow::setupTitleBar() {
     bookmark_btn_->setObjectName("bookmarkButton");
     bookmark_btn_->setFixedSize(18, 18);
     bookmark_btn_->setAutoRaise(true);
-    bookmark_btn_->setIcon(QIcon(iconPath + "star" + iconSuffix + ".svg"));
+    bookmark_btn_->setIcon(theme.icon("star"));
     bookmark_btn_->setIconSize(QSize(14, 14));
     bookmark_btn_->setToolTip("Bookmark this page");
     connect(bookmark_btn_, &QToolButton::clicked, this, &BrowserWindow::onBookmark);
@@ -251,7 +405,7 @@ void BrowserWindow::setupTitleBar() {
     menu_btn_->setFixedSize(32, 32);
     menu_btn_->setToolTip("Menu");
     menu_btn_->setAutoRaise(true);
-    menu_btn_->setIcon(QIcon(iconPath + "menu" + iconSuffix + ".svg"));
+    menu_btn_->setIcon(theme.icon("menu"));
     menu_btn_->setIconSize(QSize(16, 16));
     connect(menu_btn_, &QToolButton::clicked, this, &BrowserWindow::onMenu);
     title_layout->addWidget(menu_btn_);
@@ -264,7 +418,7 @@ void BrowserWindow::setupTitleBar() {
     min_btn_->setFixedSize(30, 30);
     min_btn_->setToolTip("Minimize");
     min_btn_->setAutoRaise(true);
-    min_btn_->setIcon(QIcon(iconPath + "minimize" + iconSuffix + ".svg"));
+    min_btn_->setIcon(theme.icon("minimize"));
     min_btn_->setIconSize(QSize(10, 10));
     connect(min_btn_, &QToolButton::clicked, this, &BrowserWindow::onMinimize);
     title_layout->addWidget(min_btn_);
@@ -274,7 +428,7 @@ void BrowserWindow::setupTitleBar() {
     max_btn_->setFixedSize(30, 30);
     max_btn_->setToolTip("Maximize");
     max_btn_->setAutoRaise(true);
-    max_btn_->setIcon(QIcon(iconPath + "maximize" + iconSuffix + ".svg"));
+    max_btn_->setIcon(theme.icon("maximize"));
     max_btn_->setIconSize(QSize(10, 10));
     connect(max_btn_, &QToolButton::clicked, this, &BrowserWindow::onMaximize);
     title_layout->addWidget(max_btn_);
@@ -284,161 +438,41 @@ void BrowserWindow::setupTitleBar() {
     close_btn_->setFixedSize(30, 30);
     close_btn_->setToolTip("Close");
     close_btn_->setAutoRaise(true);
-    close_btn_->setIcon(QIcon(iconPath + "close" + iconSuffix + ".svg"));
+    close_btn_->setIcon(theme.icon("close"));
     close_btn_->setIconSize(QSize(10, 10));
     connect(close_btn_, &QToolButton::clicked, this, &BrowserWindow::onClose);
     title_layout->addWidget(close_btn_);
 }
 
 void BrowserWindow::applyTheme() {
-    QString accentColor = "#3b82f6"; // Fixed blue accent color
-    
-    bool isDark = Settings::instance().getDarkMode();
-    
-    QString bgColor = isDark ? "#030712" : "#b8e0ff"; // Changed from #f8fafc to #ffffff
-    QString titleBg = isDark ? "#0f172a" : "#ffffff";
-    QString inputBg = isDark ? "#1e293b" : "#f1f5f9";
-    QString borderColor = isDark ? "#334155" : "#e2e8f0";
-    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
-    QString tabBg = isDark ? "#0f172a" : "#e2e8f0";
-    QString tabSelected = isDark ? "#030712" : "#ffffff";
-    QString tabHover = isDark ? "#1e293b" : "#cbd5e1";
-    
-    QString style = QString(R"(
-        QWidget#centralWidget { 
-            background-color: %1; 
-        }
-        QWidget#titleBar { 
-            background-color: %2; 
-            border-bottom: 1px solid %3;
-        }
-        QWidget#urlContainer {
-            background-color: %4;
-            border-radius: 16px;
-            border: 1px solid %3;
-        }
-        QWidget#urlContainer:focus-within {
-            border: 2px solid %5;
-        }
-        QToolButton { 
-            background-color: transparent; 
-            border: none; 
-            border-radius: 6px; 
-            padding: 4px; 
-            margin: 2px;
-        }
-        QToolButton:hover { 
-            background-color: rgba(0, 0, 0, 0.1); 
-        }
-        QToolButton:pressed {
-            background-color: rgba(0, 0, 0, 0.15);
-        }
-        QToolButton#closeButton:hover {
-            background-color: #e81123;
-        }
-        QToolButton#closeButton:pressed {
-            background-color: #f1707a;
-        }
-        QToolButton#minButton:hover, QToolButton#maxButton:hover {
-            background-color: rgba(0, 0, 0, 0.1);
-        }
-        QLineEdit#urlBar { 
-            background-color: transparent; 
-            color: %6; 
-            border: none;
-            padding: 4px 8px; 
-            font-size: 13px; 
-        }
-        QLineEdit#urlBar:focus { 
-            outline: none;
-        }
-        QProgressBar { 
-            background-color: transparent; 
-            border: none; 
-        }
-        QProgressBar::chunk { 
-            background-color: %5; 
-        }
-        QTabWidget::pane { 
-            background-color: %1; 
-            border: none; 
-        }
-        QTabBar::tab { 
-            background-color: %7; 
-            color: %6; 
-            padding: 8px 16px; 
-            border: none; 
-            border-radius: 8px 8px 0 0; 
-            margin: 0 2px; 
-            min-width: 100px; 
-        }
-        QTabBar::tab:selected { 
-            background-color: %8; 
-            color: %6; 
-        }
-        QTabBar::tab:hover:!selected { 
-            background-color: %9; 
-            color: %6;
-        }
-    )").arg(bgColor, titleBg, borderColor, inputBg, accentColor, textColor, tabBg, tabSelected, tabHover);
-    
-    setStyleSheet(style);
+    ThemeEngine::instance().apply(this, "browser.window", buildWindowStyle);
 }
 
 void BrowserWindow::refreshIcons() {
-    QString iconPath = QCoreApplication::applicationDirPath() + "/data/icons/";
-    if (!QDir(iconPath).exists()) {
-        iconPath = QCoreApplication::applicationDirPath() + "/../share/tsunami/data/icons/";
-    }
-    if (!QDir(iconPath).exists()) {
-        iconPath = "/usr/share/tsunami/data/icons/";
-    }
-
-    bool isDark = Settings::instance().getDarkMode();
-    QString iconSuffix = isDark ? "-white" : "";
-
-    QList<QToolButton*> buttons = {
-        back_btn_, forward_btn_, reload_btn_, home_btn_,
-        security_btn_, bookmark_btn_, menu_btn_,
-        min_btn_, max_btn_, close_btn_
-    };
-
-    QStringList iconNames = {
-        "back", "forward", "reload", "home",
-        "lock", "star", "menu",
-        "minimize", "maximize", "close"
-    };
-
-    for (int i = 0; i < buttons.size(); ++i) {
-        if (buttons[i]) {
-            QString fullPath = iconPath + iconNames[i] + iconSuffix + ".svg";
-            if (QFile::exists(fullPath)) {
-                buttons[i]->setIcon(QIcon(fullPath));
-            } else {
-                QString fallbackPath = iconPath + iconNames[i] + ".svg";
-                if (QFile::exists(fallbackPath)) {
-                    buttons[i]->setIcon(QIcon(fallbackPath));
-                }
-            }
-        }
-    }
+    ThemeEngine& theme = ThemeEngine::instance();
+    back_btn_->setIcon(theme.icon("back"));
+    forward_btn_->setIcon(theme.icon("forward"));
+    reload_btn_->setIcon(theme.icon("reload"));
+    home_btn_->setIcon(theme.icon("home"));
+    security_btn_->setIcon(theme.icon("lock"));
+    bookmark_btn_->setIcon(theme.icon("star"));
+    menu_btn_->setIcon(theme.icon("menu"));
+    min_btn_->setIcon(theme.icon("minimize"));
+    max_btn_->setIcon(theme.icon("maximize"));
+    close_btn_->setIcon(theme.icon("close"));
 }
 
-void BrowserWindow::onSettingsChanged() {
-    qDebug() << "Settings changed - applying theme..." << Qt::endl;
-    qDebug() << "Current dark mode:" << Settings::instance().getDarkMode();
-    qDebug() << "Current accent color:" << Settings::instance().getAccentColor();
+void BrowserWindow::onThemeChanged() {
+    TSUNAMI_TRACE_SCOPE("window.onThemeChanged");
     applyTheme();
     refreshIcons();
-    qDebug() << "Theme applied successfully" << Qt::endl;
 }
 
 void BrowserWindow::showOnboarding() {
+    // Runs before the title bar exists; the constructor applies the
+    // chosen theme and setupTitleBar() picks the matching icons
     OnboardingDialog dialog(this);
-    if (dialog.exec() == QDialog::Accepted) {
-        applyTheme();
-        refreshIcons();
-    }
+    dialog.exec();
 }
 
 void BrowserWindow::loadUrl(const QUrl& url) {
@@ -453,8 +487,41 @@ void BrowserWindow::createNewTabWithUrl(const QUrl& url) {
     createNewTab(url);
 }
 
+void BrowserWindow::openUrls(const QList<QUrl>& urls) {
+    if (urls.isEmpty()) return;
+    bool idle = pending_urls_.isEmpty();
+    pending_urls_ += urls;
+    if (idle) QTimer::singleShot(0, this, &BrowserWindow::openPendingUrls);
+}
+
+// Dozens of links can arrive at once; input is handled between passes
+void BrowserWindow::openPendingUrls() {
+    for (int i = 0; i < TABS_PER_PASS && !pending_urls_.isEmpty(); ++i) {
+        createNewTab(pending_urls_.takeFirst());
+    }
+    StartupPipeline::instance().mark(StartupPipeline::FirstTab);
+    if (!pending_urls_.isEmpty()) QTimer::singleShot(0, this, &BrowserWindow::openPendingUrls);
+}
+
+BrowserWindow* BrowserWindow::lastActive(bool private_window) {
+    auto active = qobject_cast<BrowserWindow*>(QApplication::activeWindow());
+    if (active && active->private_ == private_window) return active;
+    for (QWidget* widget : QApplication::topLevelWidgets()) {
+        auto window = qobject_cast<BrowserWindow*>(widget);
+        if (window && window->isVisible() && window->private_ == private_window) return window;
+    }
+    return nullptr;
+}
+
 void BrowserWindow::onNewTab() {
-    createNewTab(QUrl::fromLocalFile(getInternalPagePath("newtab.html")));
+    createNewTab(QUrl(QStringLiteral("tsunami://newtab")));
+}
+
+void BrowserWindow::onNewPrivateWindow() {
+    auto window = new BrowserWindow(nullptr, true);
+    // Deleting it is what lets the private session end
+    window->setAttribute(Qt::WA_DeleteOnClose);
+    window->show();
 }
 
 void BrowserWindow::onCloseTab(int index) {
@@ -472,13 +539,22 @@ void BrowserWindow::onTabChanged(int index) {
     if (view) {
         updateUrlDisplay(view->url());
     }
+    updateBlockedCount();
+}
+
+void BrowserWindow::updateBlockedCount() {
+    auto view = qobject_cast<QWebEngineView*>(tab_widget_->currentWidget());
+    RequestInterceptor* interceptor = view ? ContentBlocker::interceptorFor(view->page()) : nullptr;
+    int blocked = interceptor ? interceptor->blockedCount() : 0;
+    security_btn_->setToolTip(blocked ? QString("Secure Connection - %1 requests blocked").arg(blocked)
+                                      : QString("Secure Connection"));
 }
 
 void BrowserWindow::updateUrlDisplay(const QUrl& url) {
     QString urlStr = url.toString();
     
     // Show friendly name for internal pages
-    if (urlStr.contains("newtab.html")) {
+    if (urlStr == "tsunami://newtab") {
         url_bar_->setText("");
         url_bar_->setPlaceholderText("Search or enter URL...");
     } else if (urlStr.contains("settings.html")) {
@@ -503,6 +579,13 @@ void BrowserWindow::onTitleChanged(const QString& title) {
     }
 }
 
+void BrowserWindow::onIconChanged(const QIcon& icon) {
+    int index = tab_widget_->indexOf(qobject_cast<QWidget*>(sender()));
+    if (index >= 0) {
+        tab_widget_->setTabIcon(index, icon);
+    }
+}
+
 void BrowserWindow::onLoadProgress(int progress) {
     progress_bar_->setValue(progress);
     if (progress == 100) {
@@ -513,25 +596,82 @@ void BrowserWindow::onLoadProgress(int progress) {
 }
 
 void BrowserWindow::onLoadFinished(bool ok) {
+#ifdef TSUNAMI_TRACING
+    if (QObject* view = sender()) {
+        quint64 start = view->property("tsunamiLoadStart").toULongLong();
+        if (start) {
+            TSUNAMI_TRACE_SPAN(ok ? "page.load" : "page.loadFailed", start, TSUNAMI_TRACE_NOW());
+            view->setProperty("tsunamiLoadStart", QVariant());
+        }
+    }
+#endif
+    StartupPipeline::instance().mark(StartupPipeline::Interactive);
     if (!ok) {
         url_bar_->setStyleSheet("QLineEdit#urlBar { border: 1px solid #ef4444; }");
-    } else {
-        applyTheme();
+    } else if (!url_bar_->styleSheet().isEmpty()) {
+        // Only the error border lives on the URL bar; the theme is untouched
+        url_bar_->setStyleSheet(QString());
+    }
+
+    auto view = qobject_cast<QWebEngineView*>(sender());
+    if (ok && view) {
+        QUrl url = view->url();
+        if ((url.scheme() == "http" || url.scheme() == "https") && !WebView::isInternalUrl(url)) {
+            PrivateSession::historyFor(view->page()).add_visit(url.toString().toStdString(),
+                                                               view->title().toStdString());
+            // Give late images and web fonts a moment to paint
+            if (!view->page()->profile()->isOffTheRecord()) {
+                QTimer::singleShot(1000, view, [view]() {
+                    ThumbnailCache::instance().capture(view, view->url());
+                });
+            }
+        }
+    }
+}
+
+void BrowserWindow::captureCurrentTab() {
+    auto view = qobject_cast<QWebEngineView*>(tab_widget_->currentWidget());
+    if (view && !view->page()->profile()->isOffTheRecord()) {
+        ThumbnailCache::instance().capture(view, view->url());
     }
 }
 
 QWebEngineView* BrowserWindow::createNewTab(const QUrl& url) {
+    TSUNAMI_TRACE_SCOPE("window.createNewTab");
     QWebEngineView* view = new QWebEngineView();
+    QWebEngineProfile* profile = private_ ? PrivateSession::instance().profile()
+                                          : ProfileManager::instance().defaultProfile();
+    view->setPage(new QWebEnginePage(profile, view));
+
+#ifdef TSUNAMI_TRACING
+    // Page load milestones: start -> URL committed -> load finished
+    connect(view, &QWebEngineView::loadStarted, view, [view]() {
+        view->setProperty("tsunamiLoadStart", QVariant::fromValue<quint64>(TSUNAMI_TRACE_NOW()));
+    });
+    connect(view, &QWebEngineView::urlChanged, view, [view]() {
+        quint64 start = view->property("tsunamiLoadStart").toULongLong();
+        if (start) TSUNAMI_TRACE_SPAN("page.commit", start, TSUNAMI_TRACE_NOW());
+    });
+#endif
+
     view->setUrl(url);
 
     connect(view, &QWebEngineView::urlChanged, this, &BrowserWindow::onUrlChanged);
     connect(view, &QWebEngineView::titleChanged, this, &BrowserWindow::onTitleChanged);
     connect(view, &QWebEngineView::loadProgress, this, &BrowserWindow::onLoadProgress);
     connect(view, &QWebEngineView::loadFinished, this, &BrowserWindow::onLoadFinished);
+    connect(view, &QWebEngineView::iconChanged, this, &BrowserWindow::onIconChanged);
 
     WebView::setupPage(view->page());
+    if (RequestInterceptor* interceptor = ContentBlocker::interceptorFor(view->page())) {
+        connect(interceptor, &RequestInterceptor::blockedCountChanged, this, &BrowserWindow::updateBlockedCount);
+    }
+    AutoReloadScheduler::instance().watch(view);
+    CrashRecovery::instance().watch(view);
 
-    int index = tab_widget_->addTab(view, "New Tab");
+    captureCurrentTab();
+    // Stored icon until the page reports its own
+    int index = tab_widget_->addTab(view, FaviconService::instance().icon(url), "New Tab");
     tab_widget_->setCurrentIndex(index);
 
     updateUrlDisplay(url);
@@ -548,6 +688,12 @@ void BrowserWindow::onUrlEntered() {
     QString input = url_bar_->text();
     if (input.isEmpty()) return;
 
+    // Internal pages, e.g. tsunami://performance
+    if (input.startsWith("tsunami://")) {
+        loadUrl(QUrl(input));
+        return;
+    }
+
     QUrl url = QUrl::fromUserInput(input);
     if (!url.isValid() || (!input.contains(".") || input.contains(" "))) {
         // Treat as search query
@@ -587,45 +733,16 @@ void BrowserWindow::onReload() {
 void BrowserWindow::onMenu() {
     QMenu* menu = new QMenu(this);
     
-    bool isDark = Settings::instance().getDarkMode();
-    QString accentColor = "#3b82f6"; // Fixed blue accent color
-    
-    QString bgColor = isDark ? "#0f172a" : "#ffffff";
-    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
-    QString borderColor = isDark ? "#1e293b" : "#e2e8f0";
-    QString selectedBg = isDark ? "#1e293b" : "#f1f5f9";
-    
-    menu->setStyleSheet(QString(R"(
-        QMenu {
-            background-color: %1;
-            border: 1px solid %2;
-            border-radius: 8px;
-            padding: 8px;
-        }
-        QMenu::item {
-            color: %3;
-            padding: 8px 24px;
-            border-radius: 4px;
-        }
-        QMenu::item:selected {
-            background-color: %4;
-        }
-        QMenu::item:selected {
-            background-color: %5;
-        }
-        QMenu::separator {
-            background-color: %2;
-            height: 1px;
-            margin: 6px 0px;
-        }
-    )").arg(bgColor, borderColor, textColor, selectedBg, accentColor));
+    menu->setStyleSheet(ThemeEngine::instance().styleSheet("browser.menu", buildMenuStyle));
     
     menu->addAction("New Tab", this, &BrowserWindow::onNewTab);
+    menu->addAction("New Private Window", this, &BrowserWindow::onNewPrivateWindow);
     menu->addAction("Open File...", this, &BrowserWindow::onOpenFile);
     menu->addSeparator();
     menu->addAction("Bookmarks", this, &BrowserWindow::onBookmarks);
     menu->addAction("History", this, &BrowserWindow::onHistory);
     menu->addAction("Downloads", this, &BrowserWindow::onDownloads);
+    menu->addAction("Import from Another Browser...", this, &BrowserWindow::onImportBrowserData);
     menu->addAction("View Page Source", this, &BrowserWindow::onViewPageSource);
     menu->addSeparator();
     menu->addAction("Settings", this, &BrowserWindow::onSettings);
@@ -664,9 +781,43 @@ void BrowserWindow::onClearHistory() {
 void BrowserWindow::onHistory() {
     Tsunami::HistoryWindow* historyWindow = new Tsunami::HistoryWindow(this);
     historyWindow->setAttribute(Qt::WA_DeleteOnClose);
+    connect(historyWindow, &Tsunami::HistoryWindow::urlActivated, this, &BrowserWindow::createNewTabWithUrl);
     historyWindow->show();
 }
 
+void BrowserWindow::onImportBrowserData() {
+    QList<Tsunami::BrowserImporter::Source> sources = Tsunami::BrowserImporter::detectSources();
+    if (sources.isEmpty()) {
+        QMessageBox::information(this, "Import", "No Chrome, Chromium, Brave, Edge or Firefox profile was found.");
+        return;
+    }
+    QStringList names;
+    for (const auto& source : sources) names.append(source.name);
+    bool ok = false;
+    QString choice = QInputDialog::getItem(this, "Import", "Import history and bookmarks from:", names, 0, false, &ok);
+    if (!ok) return;
+    
+    auto* importer = new Tsunami::BrowserImporter(this);
+    auto* progress = new QProgressDialog("Importing history and bookmarks...", "Cancel", 0, 100, this);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+    progress->setMinimumDuration(0);
+    connect(importer, &Tsunami::BrowserImporter::progress, progress, &QProgressDialog::setValue);
+    connect(progress, &QProgressDialog::canceled, importer, &Tsunami::BrowserImporter::cancel);
+    connect(importer, &Tsunami::BrowserImporter::finished, this, [this, importer, progress](qint64 visits, qint64 bookmarks) {
+        progress->close();
+        importer->deleteLater();
+        QMessageBox::information(this, "Import",
+            QString("Imported %1 visits and %2 bookmarks.").arg(visits).arg(bookmarks));
+    });
+    connect(importer, &Tsunami::BrowserImporter::failed, this, [this, importer, progress](const QString& message) {
+        progress->close();
+        importer->deleteLater();
+        QMessageBox::warning(this, "Import", message);
+    });
+    importer->start(sources.at(names.indexOf(choice)));
+}
+
 void BrowserWindow::onBookmarks() {
     Tsunami::BookmarksWindow* bookmarksWindow = new Tsunami::BookmarksWindow(this);
     bookmarksWindow->setAttribute(Qt::WA_DeleteOnClose);
@@ -708,7 +859,7 @@ void BrowserWindow::onFullscreen() {
 void BrowserWindow::onHome() {
     QString homepage = Settings::instance().getHomepage();
     if (homepage.isEmpty() || homepage == "tsunami://newtab") {
-        loadUrl(QUrl::fromLocalFile(getInternalPagePath("newtab.html")));
+        loadUrl(QUrl(QStringLiteral("tsunami://newtab")));
     } else {
         loadUrl(QUrl(homepage));
     }
@@ -726,17 +877,109 @@ void BrowserWindow::onBookmark() {
 
 void BrowserWindow::onSecurity() {
     auto view = qobject_cast<QWebEngineView*>(tab_widget_->currentWidget());
-    if (view) {
-        QUrl url = view->url();
-        QString scheme = url.scheme();
-        if (scheme == "https") {
-            QMessageBox::information(this, "Security", "This is a secure HTTPS connection.");
-        } else if (scheme == "http") {
-            QMessageBox::warning(this, "Security", "This is an insecure HTTP connection.");
-        } else {
-            QMessageBox::information(this, "Security", "Connection information: " + scheme);
+    if (!view) return;
+
+    QUrl url = view->url();
+    QString scheme = url.scheme();
+    RequestInterceptor* interceptor = ContentBlocker::interceptorFor(view->page());
+
+    QMenu* menu = new QMenu(this);
+    menu->setStyleSheet(ThemeEngine::instance().styleSheet("browser.menu", buildMenuStyle));
+    if (scheme == "https") {
+        menu->addAction("This is a secure HTTPS connection")->setEnabled(false);
+    } else if (scheme == "http") {
+        menu->addAction("This is an insecure HTTP connection")->setEnabled(false);
+    } else {
+        menu->addAction("Connection information: " + scheme)->setEnabled(false);
+    }
+    if (interceptor && interceptor->blockedCount()) {
+        menu->addAction(QString("%1 ads and trackers blocked on this page").arg(interceptor->blockedCount()))
+            ->setEnabled(false);
+    }
+
+    QString host = url.host();
+    // Site settings are stored on disk, so private windows only read them
+    if (!host.isEmpty() && !WebView::isInternalUrl(url) && !private_) {
+        auto& store = SiteSettingsStore::instance();
+        std::string site = host.toStdString();
+        SiteSettings effective = store.lookup(site);
+
+        menu->addSeparator();
+        menu->addAction("Site settings for " + host)->setEnabled(false);
+        // What the host gets from its parent domains' rules, or the default
+        size_t dot = site.find('.');
+        SiteSettings inherited = dot == std::string::npos ? SiteSettings{}
+                                                          : store.lookup(std::string_view(site).substr(dot + 1));
+        // Stored only where it differs from what the host would inherit, so
+        // a subdomain can allow what its parent blocks; takes effect on reload
+        auto addToggle = [&](const QString& label, SiteToggle SiteSettings::* field, bool fallback) {
+            QAction* action = menu->addAction(label);
+            action->setCheckable(true);
+            SiteToggle current = effective.*field;
+            action->setChecked(current == SiteToggle::Default ? fallback : current == SiteToggle::Allow);
+            SiteToggle parent = inherited.*field;
+            bool inherited_value = parent == SiteToggle::Default ? fallback : parent == SiteToggle::Allow;
+            connect(action, &QAction::toggled, this, [view, site, field, inherited_value](bool checked) {
+                auto& store = SiteSettingsStore::instance();
+                SiteSettings rule = store.rule(site);
+                rule.*field = checked == inherited_value ? SiteToggle::Default
+                                                         : checked ? SiteToggle::Allow : SiteToggle::Block;
+                store.set(site, rule);
+                view->reload();
+            });
+        };
+        addToggle("JavaScript", &SiteSettings::javascript, true);
+        addToggle("Images", &SiteSettings::images, true);
+        addToggle("Autoplay", &SiteSettings::autoplay, false);
+        addToggle("WebGL", &SiteSettings::webgl, true);
+
+        int zoom = qRound(view->zoomFactor() * 100);
+        if (zoom != Settings::instance().getZoomLevel()) {
+            menu->addAction(QString("Reset zoom (%1%)").arg(zoom), this, [this]() { zoomCurrentTab(0); });
+        }
+        if (!store.rule(site).isDefault()) {
+            menu->addAction("Reset site settings", this, [view, site]() {
+                SiteSettingsStore::instance().set(site, SiteSettings{});
+                view->reload();
+            });
         }
     }
+
+    QPoint pos = security_btn_->mapToGlobal(QPoint(0, security_btn_->height()));
+    menu->exec(pos);
+    delete menu;
+}
+
+void BrowserWindow::zoomCurrentTab(int step) {
+    static const int levels[] = {25, 33, 50, 67, 75, 80, 90, 100, 110, 125, 150, 175, 200, 250, 300, 400, 500};
+    auto view = qobject_cast<QWebEngineView*>(tab_widget_->currentWidget());
+    if (!view) return;
+    QUrl url = view->url();
+    if (url.host().isEmpty() || WebView::isInternalUrl(url)) return;
+
+    int current = qRound(view->zoomFactor() * 100);
+    int zoom = 0;   // 0 drops this site's zoom
+    if (step > 0) {
+        auto next = std::upper_bound(std::begin(levels), std::end(levels), current);
+        zoom = next != std::end(levels) ? *next : levels[std::size(levels) - 1];
+    } else if (step < 0) {
+        auto next = std::lower_bound(std::begin(levels), std::end(levels), current);
+        zoom = next != std::begin(levels) ? *(next - 1) : levels[0];
+    }
+
+    if (private_) {
+        // Not remembered: this tab only, until it navigates
+        int level = zoom ? zoom : Settings::instance().getZoomLevel();
+        view->setZoomFactor(level / 100.0);
+        return;
+    }
+
+    auto& store = SiteSettingsStore::instance();
+    std::string site = url.host().toStdString();
+    SiteSettings rule = store.rule(site);
+    rule.zoom = static_cast<int16_t>(zoom);
+    store.set(site, rule);
+    WebView::applySiteSettings(view->page(), url);
 }
 
 void BrowserWindow::onMinimize() {
@@ -755,24 +998,8 @@ void BrowserWindow::onClose() {
     close();
 }
 
-QString BrowserWindow::getInternalPagePath(const QString& page) {
-    QString appDir = QCoreApplication::applicationDirPath();
-    QStringList searchPaths = {
-        appDir + "/data/pages/" + page,
-        appDir + "/../data/pages/" + page,
-        "/usr/share/tsunami/data/pages/" + page
-    };
-    
-    for (const QString& path : searchPaths) {
-        if (QFile::exists(path)) {
-            return QFileInfo(path).absoluteFilePath();
-        }
-    }
-    
-    return appDir + "/data/pages/" + page;
-}
-
 void BrowserWindow::saveSession() {
+    if (private_) return;
     QSettings settings(QSettings::IniFormat, QSettings::UserScope, "Tsunami", "Browser");
     settings.beginGroup("Session");
     settings.setValue("windowGeometry", saveGeometry());
@@ -793,7 +1020,8 @@ void BrowserWindow::saveSession() {
 void BrowserWindow::restoreSession() {
     // Only create one new tab on startup
     if (tab_widget_->count() == 0) {
-        createNewTab(QUrl::fromLocalFile(getInternalPagePath("newtab.html")));
+        createNewTab(QUrl(QStringLiteral("tsunami://newtab")));
+        StartupPipeline::instance().mark(StartupPipeline::FirstTab);
     }
 }
 
@@ -863,6 +1091,23 @@ void BrowserWindow::dropEvent(QDropEvent* event) {
 }
 
 bool BrowserWindow::eventFilter(QObject* obj, QEvent* event) {
+    if (obj == tab_widget_->tabBar() && event->type() == QEvent::ToolTip) {
+        auto help = static_cast<QHelpEvent*>(event);
+        int index = tab_widget_->tabBar()->tabAt(help->pos());
+        auto view = qobject_cast<QWebEngineView*>(tab_widget_->widget(index));
+        if (view) {
+            QString title = view->title().toHtmlEscaped();
+            QString path = ThumbnailCache::instance().cachedPath(view->url());
+            QString tip = path.isEmpty() ? title
+                : QString("<img src=\"%1\" width=\"%2\" height=\"%3\"><br>%4")
+                      .arg(QUrl::fromLocalFile(path).toString())
+                      .arg(ThumbnailCache::THUMBNAIL_WIDTH * 3 / 4)
+                      .arg(ThumbnailCache::THUMBNAIL_HEIGHT * 3 / 4)
+                      .arg(title);
+            QToolTip::showText(help->globalPos(), tip, tab_widget_->tabBar());
+            return true;
+        }
+    }
     return QMainWindow::eventFilter(obj, event);
 }
 
@@ -6,6 +6,7 @@
 #include <QProgressBar>
 #include <QToolButton>
 #include <QString>
+#include <QList>
 #include <QUrl>
 #include <QWebEngineView>
 #include <QCloseEvent>
@@ -21,19 +22,28 @@ namespace Tsunami {
 class BrowserWindow : public QMainWindow {
     Q_OBJECT
 public:
-    explicit BrowserWindow(QWidget* parent = nullptr);
+    // Private windows browse off the record and record nothing to disk
+    explicit BrowserWindow(QWidget* parent = nullptr, bool private_window = false);
     ~BrowserWindow();
     
     void show();
     void loadUrl(const QUrl& url);
     void createNewTabWithUrl(const QUrl& url);
+    // Opens each as a tab, a few per event loop pass
+    void openUrls(const QList<QUrl>& urls);
+    bool isPrivate() const { return private_; }
+
+    // The active browser window of that kind, else any visible one
+    static BrowserWindow* lastActive(bool private_window);
     
 private slots:
     void onNewTab();
+    void onNewPrivateWindow();
     void onCloseTab(int index);
     void onTabChanged(int index);
     void updateUrlDisplay(const QUrl& url);
     void onTitleChanged(const QString& title);
+    void onIconChanged(const QIcon& icon);
     void onLoadProgress(int progress);
     void onLoadFinished(bool ok);
     void onUrlChanged(const QUrl& url);
@@ -48,6 +58,7 @@ private slots:
     void onHistory();
     void onBookmarks();
     void onDownloads();
+    void onImportBrowserData();
     void onExtensions();
     void onSettings();
     void onAbout();
@@ -59,7 +70,9 @@ private slots:
     void onMaximize();
     void onClose();
     void onViewPageSource();
-    void onSettingsChanged();
+    void onThemeChanged();
+    void updateBlockedCount();
+    void openPendingUrls();
     
 protected:
     void closeEvent(QCloseEvent* event) override;
@@ -73,13 +86,16 @@ protected:
     bool eventFilter(QObject* obj, QEvent* event) override;
     
 private:
+    static constexpr int TABS_PER_PASS = 4;
+
     void setupUi();
     void setupTitleBar();
     void applyTheme();
     void refreshIcons();
     void showOnboarding();
     QWebEngineView* createNewTab(const QUrl& url);
-    QString getInternalPagePath(const QString& page);
+    void captureCurrentTab();
+    void zoomCurrentTab(int step);   // +1 / -1 through the zoom levels, 0 resets
     void saveSession();
     void restoreSession();
     
@@ -99,6 +115,8 @@ private:
     QToolButton* max_btn_;
     QToolButton* close_btn_;
     
+    bool private_;
+    QList<QUrl> pending_urls_;
     bool is_dragging_;
     QPoint drag_position_;
 };
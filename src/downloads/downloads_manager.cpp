@@ -4,6 +4,8 @@
  */
 
 #include "downloads_manager.h"
+#include "perf/trace.h"
+#include "storage/result_set.h"
 #include <sqlite3.h>
 #include <iostream>
 #include <algorithm>
@@ -11,10 +13,31 @@
 #include <sstream>
 #include <filesystem>
 #include <cstdlib>
+#ifdef TSUNAMI_HAVE_GLIB
 #include <glib.h>
+#endif
 
 namespace SeaBrowser {
 
+namespace {
+
+// XDG download directory where GLib is available, otherwise ~/Downloads
+std::string default_download_dir() {
+#ifdef TSUNAMI_HAVE_GLIB
+    const char* download_dir = g_get_user_special_dir(G_USER_DIRECTORY_DOWNLOAD);
+    if (!download_dir) {
+        download_dir = g_get_home_dir();
+    }
+    return download_dir;
+#else
+    const char* home = std::getenv("HOME");
+    if (!home) home = std::getenv("USERPROFILE");
+    return home ? std::string(home) + "/Downloads" : std::string(".");
+#endif
+}
+
+} // namespace
+
 DownloadsManager& DownloadsManager::instance() {
     static DownloadsManager instance;
     return instance;
@@ -27,6 +50,7 @@ void DownloadsManager::init(const std::string& db_path) {
 }
 
 void DownloadsManager::load() {
+    TSUNAMI_TRACE_SCOPE("downloads.load");
     downloads_.clear();
     
     sqlite3* db = nullptr;
@@ -59,34 +83,38 @@ void DownloadsManager::load() {
         sqlite3_free(err_msg);
     }
     
-    // Load downloads
+    // Load downloads, sized up front so the vector is allocated once
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT count(*) FROM downloads", -1, &stmt, nullptr) == SQLITE_OK) {
+        for_each_row(stmt, [&](const RowView& row) { downloads_.reserve(static_cast<size_t>(row.int64(0))); });
+        sqlite3_finalize(stmt);
+    }
+    
+    // path, mime_type and error_message are NULL for downloads that never
+    // got that far
     const char* select_sql = 
         "SELECT id, url, filename, path, mime_type, total_bytes, received_bytes, "
         "state, start_time, end_time, error_message FROM downloads ORDER BY start_time DESC";
-    sqlite3_stmt* stmt = nullptr;
-    
     if (sqlite3_prepare_v2(db, select_sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            Download dl;
-            dl.id = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            dl.url = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-            dl.filename = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-            dl.path = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-            dl.mime_type = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-            dl.total_bytes = sqlite3_column_int64(stmt, 5);
-            dl.received_bytes = sqlite3_column_int64(stmt, 6);
-            dl.state = static_cast<DownloadState>(sqlite3_column_int(stmt, 7));
-            dl.start_time = sqlite3_column_int64(stmt, 8);
-            dl.end_time = sqlite3_column_int64(stmt, 9);
-            const char* error = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 10));
-            if (error) dl.error_message = error;
-            downloads_.push_back(dl);
-        }
+        for_each_row(stmt, [&](const RowView& row) {
+            Download& dl = downloads_.emplace_back();
+            dl.id = row.text(0);
+            dl.url = row.text(1);
+            dl.filename = row.text(2);
+            dl.path = row.text(3);
+            dl.mime_type = row.text(4);
+            dl.total_bytes = row.int64(5);
+            dl.received_bytes = row.int64(6);
+            dl.state = static_cast<DownloadState>(row.int64(7));
+            dl.start_time = row.int64(8);
+            dl.end_time = row.int64(9);
+            dl.error_message = row.text(10);
+        });
         sqlite3_finalize(stmt);
     }
     
     sqlite3_close(db);
-    std::cout << "[SeaBrowser] Loaded " << downloads_.size() << " downloads" << std::endl;
+    notify(DownloadEvent::Reset);
 }
 
 void DownloadsManager::save() {
@@ -94,6 +122,7 @@ void DownloadsManager::save() {
 }
 
 std::string DownloadsManager::start_download(const std::string& url, const std::string& suggested_filename) {
+    TSUNAMI_TRACE_SCOPE("downloads.start");
     Download dl;
     dl.id = generate_id();
     dl.url = url;
@@ -103,11 +132,7 @@ std::string DownloadsManager::start_download(const std::string& url, const std::
     dl.start_time = std::time(nullptr);
     
     // Set download path
-    const char* download_dir = g_get_user_special_dir(G_USER_DIRECTORY_DOWNLOAD);
-    if (!download_dir) {
-        download_dir = g_get_home_dir();
-    }
-    dl.path = std::string(download_dir) + "/" + dl.filename;
+    dl.path = default_download_dir() + "/" + dl.filename;
     
     // Check if file exists and append number if needed
     int counter = 1;
@@ -151,6 +176,7 @@ std::string DownloadsManager::start_download(const std::string& url, const std::
     
     downloads_.insert(downloads_.begin(), dl);
     std::cout << "[SeaBrowser] Started download: " << dl.filename << std::endl;
+    notify(DownloadEvent::Added, dl.id);
     
     return dl.id;
 }
@@ -177,6 +203,8 @@ void DownloadsManager::cancel_download(const std::string& id) {
             }
             sqlite3_close(db);
         }
+        
+        notify(DownloadEvent::Updated, id);
     }
 }
 
@@ -200,6 +228,8 @@ void DownloadsManager::pause_download(const std::string& id) {
             }
             sqlite3_close(db);
         }
+        
+        notify(DownloadEvent::Updated, id);
     }
 }
 
@@ -223,6 +253,8 @@ void DownloadsManager::resume_download(const std::string& id) {
             }
             sqlite3_close(db);
         }
+        
+        notify(DownloadEvent::Updated, id);
     }
 }
 
@@ -257,6 +289,8 @@ void DownloadsManager::retry_download(const std::string& id) {
             }
             sqlite3_close(db);
         }
+        
+        notify(DownloadEvent::Updated, id);
     }
 }
 
@@ -280,6 +314,8 @@ void DownloadsManager::remove_download(const std::string& id) {
             [&id](const Download& dl) { return dl.id == id; }),
         downloads_.end()
     );
+    
+    notify(DownloadEvent::Removed, id);
 }
 
 void DownloadsManager::clear_completed() {
@@ -300,6 +336,8 @@ void DownloadsManager::clear_completed() {
             }),
         downloads_.end()
     );
+    
+    notify(DownloadEvent::Reset);
 }
 
 std::vector<Download> DownloadsManager::get_all_downloads() const {
@@ -326,6 +364,56 @@ Download* DownloadsManager::get_download(const std::string& id) {
     return nullptr;
 }
 
+std::vector<Download> DownloadsManager::get_page(size_t offset, size_t limit) const {
+    if (offset >= downloads_.size()) return {};
+    size_t end = std::min(downloads_.size(), offset + limit);
+    return std::vector<Download>(downloads_.begin() + offset, downloads_.begin() + end);
+}
+
+std::vector<Download> DownloadsManager::get_page_after(const std::string& after_id, size_t limit,
+                                                      const std::string& filter) const {
+    auto it = downloads_.begin();
+    if (!after_id.empty()) {
+        it = std::find_if(downloads_.begin(), downloads_.end(),
+                          [&](const Download& dl) { return dl.id == after_id; });
+        if (it == downloads_.end()) return {};
+        ++it;
+    }
+    
+    std::string folded = filter;
+    std::transform(folded.begin(), folded.end(), folded.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    auto matches = [&folded](const std::string& text) {
+        return std::search(text.begin(), text.end(), folded.begin(), folded.end(), [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == b;
+        }) != text.end();
+    };
+    
+    std::vector<Download> page;
+    for (; it != downloads_.end() && page.size() < limit; ++it) {
+        if (folded.empty() || matches(it->filename) || matches(it->url)) {
+            page.push_back(*it);
+        }
+    }
+    return page;
+}
+
+int DownloadsManager::add_listener(DownloadListener listener) {
+    return listeners_.add(std::move(listener));
+}
+
+void DownloadsManager::remove_listener(int id) {
+    listeners_.remove(id);
+}
+
+void DownloadsManager::notify(DownloadEvent::Type type, const std::string& id) {
+    notify(DownloadEvent{type, id});
+}
+
+void DownloadsManager::notify(const DownloadEvent& event) {
+    listeners_.notify(event);
+}
+
 void DownloadsManager::set_progress_callback(std::function<void(const Download&)> callback) {
     progress_callback_ = callback;
 }
@@ -342,10 +430,13 @@ void DownloadsManager::update_progress(const std::string& id, uint64_t received,
         if (progress_callback_) {
             progress_callback_(*it);
         }
+        
+        notify(DownloadEvent{DownloadEvent::Progress, id, received, total, speed});
     }
 }
 
 void DownloadsManager::complete_download(const std::string& id) {
+    TSUNAMI_TRACE_SCOPE("downloads.complete");
     auto it = std::find_if(downloads_.begin(), downloads_.end(),
         [&id](const Download& dl) { return dl.id == id; });
     
@@ -376,6 +467,8 @@ void DownloadsManager::complete_download(const std::string& id) {
         }
         
         std::cout << "[SeaBrowser] Download completed: " << it->filename << std::endl;
+        
+        notify(DownloadEvent::Updated, id);
     }
 }
 
@@ -410,28 +503,13 @@ void DownloadsManager::fail_download(const std::string& id, const std::string& e
         }
         
         std::cerr << "[SeaBrowser] Download failed: " << it->filename << " - " << error << std::endl;
+        
+        notify(DownloadEvent::Updated, id);
     }
 }
 
-void DownloadsManager::open_file(const std::string& path) {
-    std::string cmd = "xdg-open \"" + path + "\" &";
-    std::system(cmd.c_str());
-}
-
-void DownloadsManager::show_in_folder(const std::string& path) {
-    std::filesystem::path file_path(path);
-    std::string folder = file_path.parent_path().string();
-    std::string cmd = "xdg-open \"" + folder + "\" &";
-    std::system(cmd.c_str());
-}
-
-void DownloadsManager::open_downloads_folder() {
-    const char* download_dir = g_get_user_special_dir(G_USER_DIRECTORY_DOWNLOAD);
-    if (!download_dir) {
-        download_dir = g_get_home_dir();
-    }
-    std::string cmd = "xdg-open \"" + std::string(download_dir) + "\" &";
-    std::system(cmd.c_str());
+std::string DownloadsManager::downloads_folder() const {
+    return default_download_dir();
 }
 
 std::string DownloadsManager::generate_id() {
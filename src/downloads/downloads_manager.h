@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "storage/listener_list.h"
 #include <string>
 #include <vector>
 #include <ctime>
@@ -36,6 +37,18 @@ struct Download {
     std::string error_message;
 };
 
+struct DownloadEvent {
+    enum Type { Added, Updated, Removed, Reset, Progress };
+    Type type;
+    std::string id;     // Empty for Reset
+    // Progress only: the new counters, so listeners need no lookup
+    uint64_t received_bytes = 0;
+    uint64_t total_bytes = 0;
+    double speed = 0;
+};
+
+using DownloadListener = std::function<void(const DownloadEvent&)>;
+
 class DownloadsManager {
 public:
     static DownloadsManager& instance();
@@ -58,16 +71,27 @@ public:
     std::vector<Download> get_active_downloads() const;
     Download* get_download(const std::string& id);
     
+    // Newest first, same order as get_all_downloads()
+    size_t count() const { return downloads_.size(); }
+    std::vector<Download> get_page(size_t offset, size_t limit) const;
+    
+    // Cursor paging for pages: downloads after after_id (empty: from the
+    // newest) whose filename or URL contains filter, case-insensitively
+    std::vector<Download> get_page_after(const std::string& after_id, size_t limit,
+                                         const std::string& filter = "") const;
+    
+    // Change notifications for views; called on the thread that made the change
+    int add_listener(DownloadListener listener);
+    void remove_listener(int id);
+    
     // Progress callback
     void set_progress_callback(std::function<void(const Download&)> callback);
     void update_progress(const std::string& id, uint64_t received, uint64_t total, double speed);
     void complete_download(const std::string& id);
     void fail_download(const std::string& id, const std::string& error);
     
-    // File operations
-    void open_file(const std::string& path);
-    void show_in_folder(const std::string& path);
-    void open_downloads_folder();
+    // Where new downloads are saved; views open files and folders themselves
+    std::string downloads_folder() const;
     
 private:
     DownloadsManager() = default;
@@ -76,7 +100,10 @@ private:
     std::vector<Download> downloads_;
     bool initialized_ = false;
     std::function<void(const Download&)> progress_callback_;
+    ListenerList<const DownloadEvent&> listeners_;
     
+    void notify(DownloadEvent::Type type, const std::string& id = std::string());
+    void notify(const DownloadEvent& event);
     std::string generate_id();
     std::string get_filename_from_url(const std::string& url);
     std::string sanitize_filename(const std::string& filename);
@@ -0,0 +1,233 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * favicon_service.cpp - Favicon capture, storage and decoded icon cache
+ */
+
+#include "favicons/favicon_service.h"
+#include "favicons/favicon_store.h"
+#include "history/history_manager.h"
+#include "perf/trace.h"
+#include <QBuffer>
+#include <QPixmap>
+#include <QPointer>
+#include <QTimer>
+
+namespace Tsunami {
+
+namespace {
+
+QImage decodeIcon(quint64 hash) {
+    std::string bytes;
+    QImage image;
+    if (SeaBrowser::FaviconStore::instance().load(hash, bytes)) {
+        image.loadFromData(reinterpret_cast<const uchar*>(bytes.data()),
+                           static_cast<int>(bytes.size()), "PNG");
+    }
+    return image;
+}
+
+} // namespace
+
+FaviconService& FaviconService::instance() {
+    static FaviconService instance;
+    return instance;
+}
+
+FaviconService::FaviconService()
+    : QObject(nullptr)
+    , icons_(CACHED_ICONS)
+    , page_hashes_(CACHED_PAGES)
+{
+    // One thread keeps SQLite access serial and work in arrival order
+    worker_.setMaxThreadCount(1);
+    worker_.setExpiryTimeout(-1);
+
+    notify_timer_ = new QTimer(this);
+    notify_timer_->setSingleShot(true);
+    notify_timer_->setInterval(50);
+    connect(notify_timer_, &QTimer::timeout, this, &FaviconService::iconsLoaded);
+
+    // Expiry removes visits in many small steps; prune once they settle
+    prune_timer_ = new QTimer(this);
+    prune_timer_->setSingleShot(true);
+    prune_timer_->setInterval(PRUNE_DELAY_MS);
+    connect(prune_timer_, &QTimer::timeout, this, &FaviconService::prune);
+}
+
+FaviconService::~FaviconService() {
+    worker_.waitForDone();
+}
+
+void FaviconService::init(const QString& db_path) {
+    std::string path = db_path.toStdString();
+    worker_.start([path]() {
+        auto& store = SeaBrowser::FaviconStore::instance();
+        store.init(path);
+        store.remove_orphans();
+    });
+
+    if (!history_listener_) {
+        history_listener_ = SeaBrowser::HistoryManager::instance().add_listener(
+            [this](const SeaBrowser::HistoryEvent& event) {
+                QMetaObject::invokeMethod(this, [this, event]() { onHistoryEvent(event); },
+                                          Qt::QueuedConnection);
+            });
+    }
+}
+
+void FaviconService::onHistoryEvent(const SeaBrowser::HistoryEvent& event) {
+    if (event.type == SeaBrowser::HistoryEvent::Cleared) {
+        prune_timer_->stop();
+        page_hashes_.clear();
+        icons_.clear();
+        worker_.start([]() { SeaBrowser::FaviconStore::instance().clear(); });
+    } else if (event.type == SeaBrowser::HistoryEvent::Removed && !event.item.url.empty()) {
+        // A deleted URL takes its page's icon with it
+        QString page = pageKey(QUrl(QString::fromStdString(event.item.url)));
+        page_hashes_.remove(page);
+        worker_.start([page]() {
+            SeaBrowser::FaviconStore::instance().remove_pages({page.toStdString()});
+        });
+    } else if (event.type == SeaBrowser::HistoryEvent::Removed) {
+        // An expiry pass; several in a row are pruned once
+        prune_timer_->start();
+    }
+}
+
+void FaviconService::prune() {
+    if (pruning_) {
+        prune_timer_->start();
+        return;
+    }
+    pruning_ = true;
+    pruneBatch(std::string());
+}
+
+// One batch per task, so icon lookups queued meanwhile are not held up
+// behind the whole pass
+void FaviconService::pruneBatch(const std::string& after) {
+    worker_.start([this, after]() {
+        TSUNAMI_TRACE_SCOPE("favicons.prune");
+        auto& store = SeaBrowser::FaviconStore::instance();
+        std::vector<std::string> pages = store.pages_after(after, PRUNE_BATCH);
+        store.remove_pages(SeaBrowser::HistoryManager::instance().unvisited_sites(pages));
+        if (pages.size() == PRUNE_BATCH) {
+            pruneBatch(pages.back());
+            return;
+        }
+        store.remove_orphans();
+        QMetaObject::invokeMethod(this, [this]() { onPruned(); }, Qt::QueuedConnection);
+    });
+}
+
+void FaviconService::onPruned() {
+    pruning_ = false;
+    // Pruned pages resolve again, to no icon
+    page_hashes_.clear();
+}
+
+QString FaviconService::pageKey(const QUrl& url) {
+    return url.adjusted(QUrl::RemoveFragment).toString();
+}
+
+void FaviconService::record(const QUrl& page_url, const QIcon& icon) {
+    if (icon.isNull() || (page_url.scheme() != "http" && page_url.scheme() != "https")) return;
+    QString page = pageKey(page_url);
+    // The page's icon is already decoded; only the copy is made here
+    QImage image = icon.pixmap(QSize(ICON_SIZE, ICON_SIZE)).toImage();
+
+    worker_.start([this, page, image]() {
+        TSUNAMI_TRACE_SCOPE("favicons.record");
+        QImage scaled = image;
+        if (scaled.width() > ICON_SIZE || scaled.height() > ICON_SIZE) {
+            scaled = scaled.scaled(ICON_SIZE, ICON_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+        QByteArray png;
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::WriteOnly);
+        if (!scaled.save(&buffer, "PNG")) return;
+
+        quint64 hash = SeaBrowser::FaviconStore::instance().put(page.toStdString(), png.toStdString());
+        if (!hash) return;
+        QMetaObject::invokeMethod(this, [this, page, hash, scaled]() {
+            page_hashes_.insert(page, new quint64(hash));
+            if (!icons_.contains(hash)) onDecoded(hash, scaled);
+        }, Qt::QueuedConnection);
+    });
+}
+
+QIcon FaviconService::icon(const QUrl& page_url) {
+    QString page = pageKey(page_url);
+    if (const quint64* hash = page_hashes_.object(page)) {
+        if (!*hash) return QIcon();
+        if (const QIcon* cached = icons_.object(*hash)) return *cached;
+        decode(*hash);
+        return QIcon();
+    }
+    resolve(page);
+    return QIcon();
+}
+
+void FaviconService::resolve(const QString& page) {
+    if (resolving_.contains(page)) return;
+    resolving_.insert(page);
+
+    worker_.start([this, page]() {
+        quint64 hash = SeaBrowser::FaviconStore::instance().icon_for_page(page.toStdString());
+        QMetaObject::invokeMethod(this, [this, page, hash]() {
+            resolving_.remove(page);
+            page_hashes_.insert(page, new quint64(hash));
+            if (!hash) return;
+            // Another page with the same icon may already have decoded it
+            if (icons_.contains(hash)) {
+                notifyLoaded();
+            } else {
+                decode(hash);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void FaviconService::decode(quint64 hash) {
+    if (decoding_.contains(hash)) return;
+    decoding_.insert(hash);
+
+    worker_.start([this, hash]() {
+        TSUNAMI_TRACE_SCOPE("favicons.decode");
+        QImage image = decodeIcon(hash);
+        QMetaObject::invokeMethod(this, [this, hash, image]() {
+            decoding_.remove(hash);
+            onDecoded(hash, image);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void FaviconService::onDecoded(quint64 hash, const QImage& image) {
+    // A failed decode caches a null icon so the row does not retry forever
+    icons_.insert(hash, new QIcon(image.isNull() ? QPixmap() : QPixmap::fromImage(image)));
+    notifyLoaded();
+}
+
+void FaviconService::notifyLoaded() {
+    if (!notify_timer_->isActive()) notify_timer_->start();
+}
+
+void FaviconService::fetchEncoded(const QUrl& page_url, QObject* context,
+                                  std::function<void(const QByteArray&)> done) {
+    QString page = pageKey(page_url);
+    QPointer<QObject> guard(context);
+    worker_.start([this, page, guard, done = std::move(done)]() {
+        auto& store = SeaBrowser::FaviconStore::instance();
+        std::string bytes;
+        if (quint64 hash = store.icon_for_page(page.toStdString())) {
+            store.load(hash, bytes);
+        }
+        QByteArray png = QByteArray::fromStdString(bytes);
+        // Back on the UI thread the context may be gone (cancelled request)
+        QMetaObject::invokeMethod(this, [guard, done, png]() {
+            if (guard) done(png);
+        }, Qt::QueuedConnection);
+    });
+}
+
+} // namespace Tsunami
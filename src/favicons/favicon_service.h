@@ -0,0 +1,87 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * favicon_service.h - Favicon capture, storage and decoded icon cache
+ */
+
+#pragma once
+
+#include <QCache>
+#include <QHash>
+#include <QIcon>
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+#include <QUrl>
+#include <functional>
+#include <string>
+
+class QTimer;
+
+namespace SeaBrowser {
+struct HistoryEvent;
+}
+
+namespace Tsunami {
+
+// Records the icons pages report into FaviconStore
+// and hands decoded icons to the UI. Encoding, decoding and resizing run on
+// a single worker thread; the UI thread only ever reads the two caches:
+// page URL -> icon hash, and icon hash -> QIcon (LRU). Pages sharing an
+// icon share one decode. Clearing the history clears the store, and a
+// deleted URL loses its icon; after an expiry pass pages on sites left with
+// no visit lose theirs, PRUNE_BATCH pages per worker task.
+class FaviconService : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int ICON_SIZE = 32;
+    static constexpr int CACHED_ICONS = 512;
+    static constexpr int CACHED_PAGES = 8192;
+    static constexpr int PRUNE_BATCH = 500;
+    static constexpr int PRUNE_DELAY_MS = 5000;
+
+    static FaviconService& instance();
+
+    void init(const QString& db_path);
+
+    // Called with each icon a page reports through iconChanged()
+    void record(const QUrl& page_url, const QIcon& icon);
+
+    // The cached icon, or a null icon while it loads; iconsLoaded() follows
+    QIcon icon(const QUrl& page_url);
+
+    // PNG bytes for tsunami://favicon, delivered on the UI thread
+    void fetchEncoded(const QUrl& page_url, QObject* context,
+                      std::function<void(const QByteArray&)> done);
+
+signals:
+    // Coalesced: views repaint their decorations once per batch
+    void iconsLoaded();
+
+private:
+    FaviconService();
+    ~FaviconService() override;
+
+    static QString pageKey(const QUrl& url);
+    void resolve(const QString& page);
+    void decode(quint64 hash);
+    void onDecoded(quint64 hash, const QImage& image);
+    void notifyLoaded();
+    void onHistoryEvent(const SeaBrowser::HistoryEvent& event);
+    void prune();
+    void pruneBatch(const std::string& after);
+    void onPruned();
+
+    QThreadPool worker_;
+    QCache<quint64, QIcon> icons_;
+    QCache<QString, quint64> page_hashes_;   // 0: known to have no icon
+    QSet<QString> resolving_;
+    QSet<quint64> decoding_;
+    QTimer* notify_timer_ = nullptr;
+    QTimer* prune_timer_ = nullptr;
+    bool pruning_ = false;
+    int history_listener_ = 0;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,196 @@
+#include "favicon_store.h"
+#include "perf/trace.h"
+#include <iostream>
+#include <filesystem>
+
+namespace SeaBrowser {
+
+FaviconStore& FaviconStore::instance() {
+    static FaviconStore instance;
+    return instance;
+}
+
+FaviconStore::~FaviconStore() {
+    if (db_) {
+        sqlite3_close(db_);
+    }
+}
+
+uint64_t FaviconStore::content_hash(const void* data, size_t size) {
+    // FNV-1a; 0 is reserved for "no icon"
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash ? hash : 1;
+}
+
+void FaviconStore::init(const std::string& db_path) {
+    TSUNAMI_TRACE_SCOPE("favicons.init");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (db_) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+    }
+
+    auto path = std::filesystem::path(db_path).parent_path();
+    if (!std::filesystem::exists(path)) {
+        std::filesystem::create_directories(path);
+    }
+
+    if (sqlite3_open(db_path.c_str(), &db_) != SQLITE_OK) {
+        std::cerr << "Failed to open favicons db: " << sqlite3_errmsg(db_) << std::endl;
+        return;
+    }
+
+    ensure_table();
+}
+
+void FaviconStore::ensure_table() {
+    // Icons are refetched by the next visit if lost, so a crash may drop
+    // the last few writes in exchange for no fsync per icon
+    const char* sql = "PRAGMA journal_mode=WAL;"
+                      "PRAGMA synchronous=NORMAL;"
+                      "CREATE TABLE IF NOT EXISTS icons ("
+                      "hash INTEGER PRIMARY KEY, "
+                      "data BLOB NOT NULL);"
+                      "CREATE TABLE IF NOT EXISTS page_icons ("
+                      "page_url TEXT PRIMARY KEY, "
+                      "icon_hash INTEGER NOT NULL) WITHOUT ROWID;"
+                      "CREATE INDEX IF NOT EXISTS idx_page_icons_hash ON page_icons (icon_hash);";
+
+    char* err_msg = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &err_msg) != SQLITE_OK) {
+        std::cerr << "SQL error: " << err_msg << std::endl;
+        sqlite3_free(err_msg);
+    }
+}
+
+uint64_t FaviconStore::put(const std::string& page_url, const std::string& image) {
+    TSUNAMI_TRACE_SCOPE("favicons.put");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!db_ || image.empty()) return 0;
+
+    uint64_t hash = content_hash(image.data(), image.size());
+    sqlite3_stmt* stmt;
+
+    sqlite3_exec(db_, "BEGIN;", nullptr, nullptr, nullptr);
+    // Identical icons are stored once however many pages use them
+    const char* insert_icon = "INSERT OR IGNORE INTO icons (hash, data) VALUES (?, ?);";
+    if (sqlite3_prepare_v2(db_, insert_icon, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(hash));
+        sqlite3_bind_blob(stmt, 2, image.data(), static_cast<int>(image.size()), SQLITE_STATIC);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+
+    const char* map_page = "INSERT INTO page_icons (page_url, icon_hash) VALUES (?, ?) "
+                           "ON CONFLICT (page_url) DO UPDATE SET icon_hash = excluded.icon_hash;";
+    if (sqlite3_prepare_v2(db_, map_page, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, page_url.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(hash));
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+    sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr);
+
+    return hash;
+}
+
+uint64_t FaviconStore::icon_for_page(const std::string& page_url) {
+    TSUNAMI_TRACE_SCOPE("favicons.lookup");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!db_) return 0;
+
+    const char* sql = "SELECT icon_hash FROM page_icons WHERE page_url = ?;";
+    sqlite3_stmt* stmt;
+    uint64_t hash = 0;
+
+    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, page_url.c_str(), -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            hash = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
+    }
+    return hash;
+}
+
+bool FaviconStore::load(uint64_t hash, std::string& image) {
+    TSUNAMI_TRACE_SCOPE("favicons.load");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!db_) return false;
+
+    const char* sql = "SELECT data FROM icons WHERE hash = ?;";
+    sqlite3_stmt* stmt;
+    bool found = false;
+
+    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(hash));
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            const void* data = sqlite3_column_blob(stmt, 0);
+            int size = sqlite3_column_bytes(stmt, 0);
+            image.assign(static_cast<const char*>(data), static_cast<size_t>(size));
+            found = true;
+        }
+        sqlite3_finalize(stmt);
+    }
+    return found;
+}
+
+std::vector<std::string> FaviconStore::pages_after(const std::string& after, size_t limit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> pages;
+    if (!db_) return pages;
+
+    const char* sql = "SELECT page_url FROM page_icons WHERE page_url > ? ORDER BY page_url LIMIT ?;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, after.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(limit));
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            pages.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+        }
+        sqlite3_finalize(stmt);
+    }
+    return pages;
+}
+
+void FaviconStore::remove_pages(const std::vector<std::string>& pages) {
+    TSUNAMI_TRACE_SCOPE("favicons.removePages");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!db_ || pages.empty()) return;
+
+    sqlite3_stmt* stmt;
+    sqlite3_exec(db_, "BEGIN;", nullptr, nullptr, nullptr);
+    if (sqlite3_prepare_v2(db_, "DELETE FROM page_icons WHERE page_url = ?;", -1, &stmt, nullptr) == SQLITE_OK) {
+        for (const std::string& page : pages) {
+            sqlite3_bind_text(stmt, 1, page.c_str(), -1, SQLITE_STATIC);
+            sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+    }
+    sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr);
+}
+
+void FaviconStore::remove_orphans() {
+    TSUNAMI_TRACE_SCOPE("favicons.removeOrphans");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!db_) return;
+
+    const char* sql = "DELETE FROM icons WHERE NOT EXISTS "
+                      "(SELECT 1 FROM page_icons WHERE icon_hash = icons.hash);";
+    sqlite3_exec(db_, sql, nullptr, nullptr, nullptr);
+}
+
+void FaviconStore::clear() {
+    TSUNAMI_TRACE_SCOPE("favicons.clear");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!db_) return;
+
+    sqlite3_exec(db_, "DELETE FROM page_icons; DELETE FROM icons;", nullptr, nullptr, nullptr);
+}
+
+} // namespace SeaBrowser
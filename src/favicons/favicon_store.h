@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+
+namespace SeaBrowser {
+
+// Favicons keyed by a hash of their encoded bytes, so the thousands of
+// pages on one site share a single blob. page_icons maps a page URL to
+// the hash of its icon.
+class FaviconStore {
+public:
+    static FaviconStore& instance();
+
+    void init(const std::string& db_path);
+
+    // Stores the encoded image (once per distinct content) and points
+    // page_url at it. Returns the icon hash, or 0 on failure.
+    uint64_t put(const std::string& page_url, const std::string& image);
+
+    // 0 when the page has no stored icon
+    uint64_t icon_for_page(const std::string& page_url);
+    bool load(uint64_t hash, std::string& image);
+
+    // Pages with an icon, in URL order after `after`, for pruning in batches
+    std::vector<std::string> pages_after(const std::string& after, size_t limit);
+    void remove_pages(const std::vector<std::string>& pages);
+    // Drops icons no page refers to any more
+    void remove_orphans();
+    void clear();
+
+    static uint64_t content_hash(const void* data, size_t size);
+
+private:
+    FaviconStore() = default;
+    ~FaviconStore();
+
+    sqlite3* db_ = nullptr;
+    std::mutex mutex_;
+
+    void ensure_table();
+};
+
+} // namespace SeaBrowser
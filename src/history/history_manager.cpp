@@ -1,139 +1,1020 @@
 #include "history_manager.h"
+#include "perf/trace.h"
 #include <iostream>
 #include <chrono>
 #include <filesystem>
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
 
 namespace SeaBrowser {
 
+namespace {
+
+// Lowercased host of an absolute URL; origin_length is the length of the
+// scheme://host[:port] prefix
+std::string site_host(const std::string& url, size_t& origin_length) {
+    size_t begin = url.find("://");
+    if (begin == std::string::npos) return std::string();
+    begin += 3;
+    size_t end = url.find_first_of(":/?#", begin);
+    if (end == std::string::npos) end = url.size();
+    std::string host = url.substr(begin, end - begin);
+    std::transform(host.begin(), host.end(), host.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    origin_length = url.find_first_of("/?#", begin);
+    if (origin_length == std::string::npos) origin_length = url.size();
+    return host;
+}
+
+// site_host(url) in SQL, NULL for URLs without a host, for statements
+// that write visits.host from other columns
+void register_functions(sqlite3* db) {
+    auto site_host_sql = [](sqlite3_context* context, int, sqlite3_value** argv) {
+        const unsigned char* url = sqlite3_value_text(argv[0]);
+        size_t origin_length = 0;
+        std::string host = url ? site_host(reinterpret_cast<const char*>(url), origin_length) : std::string();
+        if (host.empty()) {
+            sqlite3_result_null(context);
+        } else {
+            sqlite3_result_text(context, host.c_str(), static_cast<int>(host.size()), SQLITE_TRANSIENT);
+        }
+    };
+    sqlite3_create_function(db, "site_host", 1, SQLITE_UTF8 | SQLITE_DETERMINISTIC, nullptr,
+                            site_host_sql, nullptr, nullptr);
+}
+
+// Inserts each row select yields into the same table on another
+// connection, column for column. Returns the rows copied, or -1.
+long long copy_rows(sqlite3_stmt* select, sqlite3* to, const std::string& table) {
+    int columns = sqlite3_column_count(select);
+    std::string sql = "INSERT INTO " + table + " VALUES (";
+    for (int i = 0; i < columns; ++i) sql += i ? ", ?" : "?";
+    sql += ");";
+    sqlite3_stmt* insert;
+    if (sqlite3_prepare_v2(to, sql.c_str(), -1, &insert, nullptr) != SQLITE_OK) return -1;
+    
+    long long copied = 0;
+    int rc;
+    while ((rc = sqlite3_step(select)) == SQLITE_ROW) {
+        for (int i = 0; i < columns; ++i) {
+            sqlite3_bind_value(insert, i + 1, sqlite3_column_value(select, i));
+        }
+        if (sqlite3_step(insert) != SQLITE_DONE) break;
+        sqlite3_reset(insert);
+        ++copied;
+    }
+    sqlite3_finalize(insert);
+    return rc == SQLITE_DONE ? copied : -1;
+}
+
+} // namespace
+
 HistoryManager& HistoryManager::instance() {
     static HistoryManager instance;
     return instance;
 }
 
 HistoryManager::~HistoryManager() {
+    abandon_convert();
     if (db_) {
         sqlite3_close(db_);
     }
 }
 
 void HistoryManager::init(const std::string& db_path) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    db_path_ = db_path;
-    
-    // Ensure directory exists
-    auto path = std::filesystem::path(db_path).parent_path();
-    if (!std::filesystem::exists(path)) {
-        std::filesystem::create_directories(path);
-    }
+    TSUNAMI_TRACE_SCOPE("history.init");
+    std::vector<HistoryEvent> added;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        abandon_convert();
+        needs_convert_ = false;
+        if (db_) {
+            sqlite3_close(db_);
+            db_ = nullptr;
+        }
+        db_path_ = db_path;
+        
+        // Ensure directory exists
+        auto path = std::filesystem::path(db_path).parent_path();
+        if (!std::filesystem::exists(path)) {
+            std::filesystem::create_directories(path);
+        }
 
-    if (sqlite3_open(db_path.c_str(), &db_) != SQLITE_OK) {
-        std::cerr << "Failed to open history db: " << sqlite3_errmsg(db_) << std::endl;
-        return;
+        // URI filenames so importers can attach their source read-only
+        if (sqlite3_open_v2(db_path.c_str(), &db_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI,
+                            nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to open history db: " << sqlite3_errmsg(db_) << std::endl;
+            sqlite3_close(db_);
+            db_ = nullptr;
+            return;
+        }
+        register_functions(db_);
+        
+        ensure_table();
+        convert_to_incremental_vacuum();
+        
+        for (const HistoryItem& visit : pending_visits_) {
+            HistoryEvent event{HistoryEvent::Added};
+            if (insert_visit(visit.url, visit.title, visit.timestamp, event)) added.push_back(std::move(event));
+        }
+        pending_visits_.clear();
     }
-    
-    ensure_table();
+    for (const HistoryEvent& event : added) notify(event);
 }
 
 void HistoryManager::ensure_table() {
-    const char* sql = "CREATE TABLE IF NOT EXISTS visits ("
+    // Only takes effect on a new, empty file; see convert_to_incremental_vacuum
+    const char* sql = "PRAGMA auto_vacuum = INCREMENTAL;"
+                      "CREATE TABLE IF NOT EXISTS visits ("
                       "id INTEGER PRIMARY KEY AUTOINCREMENT, "
                       "url TEXT NOT NULL, "
                       "title TEXT, "
-                      "timestamp INTEGER);";
+                      "timestamp INTEGER, "
+                      "host TEXT);"
+                      "CREATE INDEX IF NOT EXISTS idx_visits_timestamp "
+                      "ON visits (timestamp DESC, id DESC);"
+                      "CREATE TABLE IF NOT EXISTS sites ("
+                      "host TEXT PRIMARY KEY, "
+                      "url TEXT NOT NULL, "
+                      "title TEXT, "
+                      "visit_count INTEGER NOT NULL, "
+                      "last_visit INTEGER NOT NULL) WITHOUT ROWID;"
+                      "CREATE INDEX IF NOT EXISTS idx_sites_rank "
+                      "ON sites (visit_count DESC, last_visit DESC);";
                       
     char* err_msg = nullptr;
     if (sqlite3_exec(db_, sql, nullptr, nullptr, &err_msg) != SQLITE_OK) {
         std::cerr << "SQL error: " << err_msg << std::endl;
         sqlite3_free(err_msg);
     }
+    
+    // Databases from before visits.host: fill it in with one UPDATE
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db_, "SELECT host FROM visits LIMIT 0;", -1, &stmt, nullptr) != SQLITE_OK) {
+        TSUNAMI_TRACE_SCOPE("history.addHostColumn");
+        const char* migrate = "BEGIN;"
+                              "ALTER TABLE visits ADD COLUMN host TEXT;"
+                              "UPDATE visits SET host = site_host(url);"
+                              "COMMIT;";
+        if (sqlite3_exec(db_, migrate, nullptr, nullptr, &err_msg) != SQLITE_OK) {
+            std::cerr << "SQL error: " << err_msg << std::endl;
+            sqlite3_free(err_msg);
+            sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        }
+    }
+    sqlite3_finalize(stmt);
+    // The newest visit to a host is one lookup
+    sqlite3_exec(db_, "CREATE INDEX IF NOT EXISTS idx_visits_host ON visits (host, timestamp DESC, id DESC);",
+                 nullptr, nullptr, nullptr);
+    
+    // Databases from before the sites table: aggregate once
+    bool backfill = false;
+    const char* check = "SELECT EXISTS (SELECT 1 FROM visits) AND NOT EXISTS (SELECT 1 FROM sites);";
+    if (sqlite3_prepare_v2(db_, check, -1, &stmt, nullptr) == SQLITE_OK) {
+        backfill = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0);
+        sqlite3_finalize(stmt);
+    }
+    if (backfill) rebuild_sites();
+}
+
+void HistoryManager::rebuild_sites() {
+    TSUNAMI_TRACE_SCOPE("history.rebuildSites");
+    // Caller holds mutex_
+    std::unordered_map<std::string, SiteStats> sites;
+    sqlite3_stmt* stmt;
+    const char* scan = "SELECT url, title, timestamp FROM visits ORDER BY timestamp, id;";
+    if (sqlite3_prepare_v2(db_, scan, -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const char* url = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            if (!url) continue;
+            std::string visit_url = url;
+            size_t origin_length = 0;
+            std::string host = site_host(visit_url, origin_length);
+            if (host.empty()) continue;
+            
+            SiteStats& site = sites[host];
+            const char* title = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            site.url = visit_url.substr(0, origin_length);
+            site.title = title ? title : "";
+            site.visit_count++;
+            site.last_visit = sqlite3_column_int64(stmt, 2);
+        }
+        sqlite3_finalize(stmt);
+    }
+    
+    sqlite3_exec(db_, "BEGIN; DELETE FROM sites;", nullptr, nullptr, nullptr);
+    const char* insert = "INSERT INTO sites (host, url, title, visit_count, last_visit) VALUES (?, ?, ?, ?, ?);";
+    if (sqlite3_prepare_v2(db_, insert, -1, &stmt, nullptr) == SQLITE_OK) {
+        for (const auto& [host, site] : sites) {
+            sqlite3_bind_text(stmt, 1, host.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, site.url.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 3, site.title.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int64(stmt, 4, site.visit_count);
+            sqlite3_bind_int64(stmt, 5, site.last_visit);
+            sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+    }
+    sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr);
 }
 
 void HistoryManager::add_visit(const std::string& url, const std::string& title) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!db_) return;
+    TSUNAMI_TRACE_SCOPE("history.addVisit");
+    HistoryEvent event{HistoryEvent::Added};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Don't add internal pages
+        if (url.find("sea://") == 0 || url.find("tsunami://") == 0) return;
+        
+        long long timestamp = std::chrono::seconds(std::time(NULL)).count();
+        // Start-up opens the history after the first window; init() records
+        // what was visited before then
+        if (!db_) {
+            if (pending_visits_.size() < MAX_PENDING_VISITS) {
+                HistoryItem& visit = pending_visits_.emplace_back();
+                visit.url = url;
+                visit.title = title;
+                visit.timestamp = timestamp;
+            }
+            return;
+        }
+        if (!insert_visit(url, title, timestamp, event)) return;
+    }
+    notify(event);
+}
+
+// Caller holds mutex_. Fills in event's item and site.
+bool HistoryManager::insert_visit(const std::string& url, const std::string& title, long long timestamp,
+                                  HistoryEvent& event) {
+    size_t origin_length = 0;
+    event.site.host = site_host(url, origin_length);
     
-    // Don't add internal pages
-    if (url.find("sea://") == 0) return;
+    const char* sql = "INSERT INTO visits (url, title, timestamp, host) VALUES (?, ?, ?, ?);";
+    sqlite3_stmt* stmt;
+    
+    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+    sqlite3_exec(db_, "BEGIN;", nullptr, nullptr, nullptr);
+    sqlite3_bind_text(stmt, 1, url.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, title.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 3, timestamp);
+    if (!event.site.host.empty()) sqlite3_bind_text(stmt, 4, event.site.host.c_str(), -1, SQLITE_STATIC);
     
-    long long timestamp = std::chrono::seconds(std::time(NULL)).count();
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        sqlite3_exec(db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
     
-    const char* sql = "INSERT INTO visits (url, title, timestamp) VALUES (?, ?, ?);";
+    event.item.id = sqlite3_last_insert_rowid(db_);
+    event.item.url = url;
+    event.item.title = title.empty() ? url : title;
+    event.item.timestamp = timestamp;
+    
+    // Keep the per-site aggregate current so top sites never scan visits
+    if (!event.site.host.empty()) {
+        event.site.url = url.substr(0, origin_length);
+        event.site.title = title;
+        event.site.last_visit = timestamp;
+        const char* upsert = "INSERT INTO sites (host, url, title, visit_count, last_visit) "
+                             "VALUES (?1, ?2, ?3, 1, ?4) ON CONFLICT (host) DO UPDATE SET "
+                             "url = excluded.url, title = excluded.title, "
+                             "visit_count = visit_count + 1, last_visit = excluded.last_visit;";
+        if (sqlite3_prepare_v2(db_, upsert, -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_text(stmt, 1, event.site.host.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, event.site.url.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 3, title.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int64(stmt, 4, timestamp);
+            sqlite3_step(stmt);
+            sqlite3_finalize(stmt);
+        }
+        const char* count = "SELECT visit_count FROM sites WHERE host = ?;";
+        if (sqlite3_prepare_v2(db_, count, -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_text(stmt, 1, event.site.host.c_str(), -1, SQLITE_STATIC);
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                event.site.visit_count = sqlite3_column_int64(stmt, 0);
+            }
+            sqlite3_finalize(stmt);
+        }
+    }
+    sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr);
+    return true;
+}
+
+// Caller holds mutex_. Seeks idx_visits_timestamp, so every page costs
+// the same however deep into the history it starts.
+sqlite3_stmt* HistoryManager::prepare_page(long long before_timestamp, long long before_id,
+                                           int limit, const std::string& filter) {
+    // Untitled visits read as their URL, so callers never see a NULL title
+    const char* sql = filter.empty()
+        ? "SELECT id, url, COALESCE(NULLIF(title, ''), url), timestamp FROM visits "
+          "WHERE (timestamp, id) < (?1, ?2) "
+          "ORDER BY timestamp DESC, id DESC LIMIT ?3;"
+        : "SELECT id, url, COALESCE(NULLIF(title, ''), url), timestamp FROM visits "
+          "WHERE (timestamp, id) < (?1, ?2) "
+          "AND (url LIKE ?4 ESCAPE '\\' OR title LIKE ?4 ESCAPE '\\') "
+          "ORDER BY timestamp DESC, id DESC LIMIT ?3;";
     sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) return nullptr;
     
-    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, url.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 2, title.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_int64(stmt, 3, timestamp);
-        
-        sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+    if (before_id == 0) {
+        before_timestamp = std::numeric_limits<long long>::max();
+        before_id = std::numeric_limits<long long>::max();
+    }
+    sqlite3_bind_int64(stmt, 1, before_timestamp);
+    sqlite3_bind_int64(stmt, 2, before_id);
+    sqlite3_bind_int(stmt, 3, limit);
+    if (!filter.empty()) {
+        // The filter is literal text: its own % and _ must not match anything
+        std::string pattern = "%";
+        for (char c : filter) {
+            if (c == '\\' || c == '%' || c == '_') pattern += '\\';
+            pattern += c;
+        }
+        pattern += '%';
+        sqlite3_bind_text(stmt, 4, pattern.c_str(), -1, SQLITE_TRANSIENT);
     }
+    return stmt;
 }
 
-std::vector<HistoryItem> HistoryManager::get_recent(int limit) {
+std::vector<HistoryItem> HistoryManager::get_page(long long before_timestamp, long long before_id,
+                                                 int limit, const std::string& filter) {
+    TSUNAMI_TRACE_SCOPE("history.getPage");
     std::lock_guard<std::mutex> lock(mutex_);
     std::vector<HistoryItem> items;
     if (!db_) return items;
     
-    const char* sql = "SELECT url, title, timestamp FROM visits ORDER BY timestamp DESC LIMIT ?;";
+    if (sqlite3_stmt* stmt = prepare_page(before_timestamp, before_id, limit, filter)) {
+        items.reserve(limit);
+        for_each_row(stmt, [&](const RowView& row) {
+            HistoryItem& item = items.emplace_back();
+            item.id = row.int64(0);
+            item.url = row.text(1);
+            item.title = row.text(2);
+            item.timestamp = row.int64(3);
+        });
+        sqlite3_finalize(stmt);
+    }
+    
+    return items;
+}
+
+ResultSet HistoryManager::get_page_rows(long long before_timestamp, long long before_id,
+                                        int limit, const std::string& filter) {
+    TSUNAMI_TRACE_SCOPE("history.getPageRows");
+    std::lock_guard<std::mutex> lock(mutex_);
+    ResultSet rows;
+    if (!db_) return rows;
+    
+    if (sqlite3_stmt* stmt = prepare_page(before_timestamp, before_id, limit, filter)) {
+        rows.load(stmt, static_cast<size_t>(std::max(limit, 0)), PAGE_BYTES_PER_ROW);
+        sqlite3_finalize(stmt);
+    }
+    
+    return rows;
+}
+
+std::vector<SiteStats> HistoryManager::get_top_sites(int limit) {
+    TSUNAMI_TRACE_SCOPE("history.getTopSites");
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<SiteStats> sites;
+    if (!db_) return sites;
+    
+    const char* sql = "SELECT host, url, title, visit_count, last_visit FROM sites "
+                      "ORDER BY visit_count DESC, last_visit DESC LIMIT ?;";
     sqlite3_stmt* stmt;
     
     if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) == SQLITE_OK) {
         sqlite3_bind_int(stmt, 1, limit);
+        for_each_row(stmt, [&](const RowView& row) {
+            SiteStats& site = sites.emplace_back();
+            site.host = row.text(0);
+            site.url = row.text(1);
+            site.title = row.text(2);
+            site.visit_count = row.int64(3);
+            site.last_visit = row.int64(4);
+        });
+        sqlite3_finalize(stmt);
+    }
+    
+    return sites;
+}
+
+int HistoryManager::add_listener(HistoryListener listener) {
+    return listeners_.add(std::move(listener));
+}
+
+void HistoryManager::remove_listener(int id) {
+    listeners_.remove(id);
+}
+
+void HistoryManager::notify(const HistoryEvent& event) {
+    listeners_.notify(event);
+}
+
+void HistoryManager::clear_history() {
+    TSUNAMI_TRACE_SCOPE("history.clear");
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!db_) return;
         
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            HistoryItem item;
-            item.url = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            
-            const char* title = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-            item.title = title ? title : item.url;
-            
-            item.timestamp = sqlite3_column_int64(stmt, 2);
-            items.push_back(item);
+        const char* sql = "DELETE FROM visits; DELETE FROM sites;";
+        sqlite3_exec(db_, sql, nullptr, nullptr, nullptr);
+        abandon_convert();
+    }
+    notify({HistoryEvent::Cleared});
+}
+
+void HistoryManager::delete_history_item(const std::string& url) {
+    TSUNAMI_TRACE_SCOPE("history.deleteItem");
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!db_) return;
+        sqlite3_stmt* stmt;
+        
+        // Only the host's visits are read, through the host index
+        size_t origin_length = 0;
+        std::string host = site_host(url, origin_length);
+        long long removed = 0;
+        sqlite3_exec(db_, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr);
+        if (sqlite3_prepare_v2(db_, "DELETE FROM visits WHERE host IS ?2 AND url = ?1;", -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_text(stmt, 1, url.c_str(), -1, SQLITE_STATIC);
+            if (!host.empty()) sqlite3_bind_text(stmt, 2, host.c_str(), -1, SQLITE_STATIC);
+            sqlite3_step(stmt);
+            sqlite3_finalize(stmt);
+            removed = sqlite3_changes(db_);
+        }
+        
+        // Every removed visit is to one host: adjust its count as expiry
+        // does rather than rebuilding the aggregate from every visit
+        if (removed > 0 && !host.empty()) {
+            const char* update = "UPDATE sites SET visit_count = visit_count - ?2 WHERE host = ?1;";
+            if (sqlite3_prepare_v2(db_, update, -1, &stmt, nullptr) == SQLITE_OK) {
+                sqlite3_bind_text(stmt, 1, host.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_int64(stmt, 2, removed);
+                sqlite3_step(stmt);
+                sqlite3_finalize(stmt);
+            }
+            long long remaining = 0;
+            const char* site = "SELECT visit_count FROM sites WHERE host = ?;";
+            if (sqlite3_prepare_v2(db_, site, -1, &stmt, nullptr) == SQLITE_OK) {
+                sqlite3_bind_text(stmt, 1, host.c_str(), -1, SQLITE_STATIC);
+                for_each_row(stmt, [&](const RowView& row) { remaining = row.int64(0); });
+                sqlite3_finalize(stmt);
+            }
+            if (remaining <= 0) {
+                if (sqlite3_prepare_v2(db_, "DELETE FROM sites WHERE host = ?;", -1, &stmt, nullptr) == SQLITE_OK) {
+                    sqlite3_bind_text(stmt, 1, host.c_str(), -1, SQLITE_STATIC);
+                    sqlite3_step(stmt);
+                    sqlite3_finalize(stmt);
+                }
+            } else {
+                // The site's title may have come from a removed visit
+                refresh_site(host);
+            }
         }
+        sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr);
+        if (removed > 0) abandon_convert();
+    }
+    HistoryEvent event{HistoryEvent::Removed};
+    event.item.url = url;
+    notify(event);
+}
+
+std::vector<std::string> HistoryManager::unvisited_sites(const std::vector<std::string>& urls) {
+    TSUNAMI_TRACE_SCOPE("history.unvisitedSites");
+    std::vector<std::string> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!db_) return result;
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db_, "SELECT 1 FROM sites WHERE host = ?;", -1, &stmt, nullptr) != SQLITE_OK) return result;
+    for (const std::string& url : urls) {
+        size_t origin_length = 0;
+        std::string host = site_host(url, origin_length);
+        if (host.empty()) continue;
+        sqlite3_bind_text(stmt, 1, host.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) != SQLITE_ROW) result.push_back(url);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    return result;
+}
+
+// Takes the site's URL, title and last visit from its newest remaining
+// visit, one lookup in the host index
+void HistoryManager::refresh_site(const std::string& host) {
+    // Caller holds mutex_
+    SiteStats site;
+    sqlite3_stmt* stmt;
+    const char* newest = "SELECT url, title, timestamp FROM visits WHERE host = ? "
+                         "ORDER BY timestamp DESC, id DESC LIMIT 1;";
+    if (sqlite3_prepare_v2(db_, newest, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, host.c_str(), -1, SQLITE_STATIC);
+        for_each_row(stmt, [&](const RowView& row) {
+            std::string url(row.text(0));
+            size_t origin_length = 0;
+            site_host(url, origin_length);
+            site.url = url.substr(0, origin_length);
+            site.title = row.text(1);
+            site.last_visit = row.int64(2);
+        });
         sqlite3_finalize(stmt);
     }
+    if (site.url.empty()) return;
     
-    return items;
+    const char* update = "UPDATE sites SET url = ?2, title = ?3, last_visit = ?4 WHERE host = ?1;";
+    if (sqlite3_prepare_v2(db_, update, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, host.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, site.url.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, site.title.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 4, site.last_visit);
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
 }
 
-void HistoryManager::clear_history() {
+// Before anything else uses the history, so the rewrite never makes a
+// page load or a history search wait behind it
+void HistoryManager::convert_to_incremental_vacuum() {
+    TSUNAMI_TRACE_SCOPE("history.convertVacuum");
+    // Caller holds mutex_
+    auto pragma_value = [this](const char* sql) {
+        long long value = 0;
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+            if (sqlite3_step(stmt) == SQLITE_ROW) value = sqlite3_column_int64(stmt, 0);
+            sqlite3_finalize(stmt);
+        }
+        return value;
+    };
+    if (pragma_value("PRAGMA auto_vacuum;") == 2) return;
+    
+    // VACUUM copies the live pages only. A bigger file is copied a batch
+    // at a time by convert_step() instead, and reuses its free pages until then.
+    long long live_pages = pragma_value("PRAGMA page_count;") - pragma_value("PRAGMA freelist_count;");
+    if (live_pages * pragma_value("PRAGMA page_size;") > CONVERT_MAX_LIVE_BYTES) {
+        needs_convert_ = true;
+        return;
+    }
+    
+    std::cerr << "[Tsunami] Converting history to incremental vacuum" << std::endl;
+    char* err_msg = nullptr;
+    if (sqlite3_exec(db_, "PRAGMA auto_vacuum = INCREMENTAL; VACUUM;", nullptr, nullptr, &err_msg) != SQLITE_OK) {
+        std::cerr << "SQL error: " << err_msg << std::endl;
+        sqlite3_free(err_msg);
+    }
+}
+
+void HistoryManager::begin_expiry(const RetentionPolicy& policy) {
+    TSUNAMI_TRACE_SCOPE("history.beginExpiry");
     std::lock_guard<std::mutex> lock(mutex_);
+    expiry_timestamp_ = 0;
+    expiry_id_ = 0;
+    expired_in_pass_ = false;
     if (!db_) return;
     
-    const char* sql = "DELETE FROM visits;";
-    sqlite3_exec(db_, sql, nullptr, nullptr, nullptr);
+    if (policy.max_age_days > 0) {
+        long long now = std::chrono::seconds(std::time(NULL)).count();
+        expiry_timestamp_ = now - static_cast<long long>(policy.max_age_days) * 24 * 60 * 60;
+    }
+    
+    // The oldest visit kept by the row limit; a walk of the timestamp
+    // index, done once per pass rather than per step
+    if (policy.max_visits > 0) {
+        const char* sql = "SELECT timestamp, id FROM visits "
+                          "ORDER BY timestamp DESC, id DESC LIMIT 1 OFFSET ?;";
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_int64(stmt, 1, policy.max_visits - 1);
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                long long timestamp = sqlite3_column_int64(stmt, 0);
+                long long id = sqlite3_column_int64(stmt, 1);
+                if (std::make_pair(timestamp, id) > std::make_pair(expiry_timestamp_, expiry_id_)) {
+                    expiry_timestamp_ = timestamp;
+                    expiry_id_ = id;
+                }
+            }
+            sqlite3_finalize(stmt);
+        }
+    }
 }
 
-void HistoryManager::delete_history_item(const std::string& url) {
+HistoryManager::ExpiryStep HistoryManager::expire_step(int max_rows, int vacuum_pages) {
+    TSUNAMI_TRACE_SCOPE("history.expireStep");
+    ExpiryStep step;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!db_) return step;
+        sqlite3_stmt* stmt;
+        
+        // The batch is read first so the sites aggregate can be adjusted
+        // per host instead of rebuilt from every remaining visit
+        std::unordered_map<std::string, long long> removed_by_host;
+        long long last_timestamp = 0;
+        long long last_id = 0;
+        const char* batch = "SELECT id, url, timestamp FROM visits WHERE (timestamp, id) < (?1, ?2) "
+                            "ORDER BY timestamp, id LIMIT ?3;";
+        sqlite3_exec(db_, "BEGIN;", nullptr, nullptr, nullptr);
+        if (expiry_timestamp_ > 0 && sqlite3_prepare_v2(db_, batch, -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_int64(stmt, 1, expiry_timestamp_);
+            sqlite3_bind_int64(stmt, 2, expiry_id_);
+            sqlite3_bind_int(stmt, 3, max_rows);
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                last_id = sqlite3_column_int64(stmt, 0);
+                const char* url = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+                last_timestamp = sqlite3_column_int64(stmt, 2);
+                size_t origin_length = 0;
+                std::string host = url ? site_host(url, origin_length) : std::string();
+                if (!host.empty()) ++removed_by_host[host];
+                ++step.deleted;
+            }
+            sqlite3_finalize(stmt);
+        }
+        
+        if (step.deleted > 0) {
+            // The same rows: the batch is the oldest ones, and an import's
+            // connection, the only other writer, adds visits only while
+            // holding mutex_
+            const char* remove = "DELETE FROM visits WHERE (timestamp, id) <= (?1, ?2);";
+            if (sqlite3_prepare_v2(db_, remove, -1, &stmt, nullptr) == SQLITE_OK) {
+                sqlite3_bind_int64(stmt, 1, last_timestamp);
+                sqlite3_bind_int64(stmt, 2, last_id);
+                sqlite3_step(stmt);
+                sqlite3_finalize(stmt);
+            }
+            const char* update = "UPDATE sites SET visit_count = visit_count - ?2 WHERE host = ?1;";
+            if (sqlite3_prepare_v2(db_, update, -1, &stmt, nullptr) == SQLITE_OK) {
+                for (const auto& [host, count] : removed_by_host) {
+                    sqlite3_bind_text(stmt, 1, host.c_str(), -1, SQLITE_STATIC);
+                    sqlite3_bind_int64(stmt, 2, count);
+                    sqlite3_step(stmt);
+                    sqlite3_reset(stmt);
+                }
+                sqlite3_finalize(stmt);
+            }
+            sqlite3_exec(db_, "DELETE FROM sites WHERE visit_count <= 0;", nullptr, nullptr, nullptr);
+            expired_in_pass_ = true;
+            abandon_convert();
+        }
+        sqlite3_exec(db_, "COMMIT;", nullptr, nullptr, nullptr);
+        
+        // Free pages, including those left by clearing or deleting history
+        auto pragma_value = [this](const char* sql) {
+            long long value = 0;
+            sqlite3_stmt* pragma;
+            if (sqlite3_prepare_v2(db_, sql, -1, &pragma, nullptr) == SQLITE_OK) {
+                if (sqlite3_step(pragma) == SQLITE_ROW) value = sqlite3_column_int64(pragma, 0);
+                sqlite3_finalize(pragma);
+            }
+            return value;
+        };
+        long long free_before = pragma_value("PRAGMA freelist_count;");
+        long long free_after = free_before;
+        if (free_before > 0) {
+            std::string vacuum = "PRAGMA incremental_vacuum(" + std::to_string(vacuum_pages) + ");";
+            if (sqlite3_prepare_v2(db_, vacuum.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+                while (sqlite3_step(stmt) == SQLITE_ROW) {}
+                sqlite3_finalize(stmt);
+            }
+            free_after = pragma_value("PRAGMA freelist_count;");
+            step.reclaimed_bytes = (free_before - free_after) * pragma_value("PRAGMA page_size;");
+        }
+        
+        // A file not yet converted never shrinks; do not spin on it
+        bool vacuum_stuck = free_after > 0 && free_after == free_before;
+        step.done = step.deleted < max_rows && (free_after == 0 || vacuum_stuck);
+        if (!step.done || !expired_in_pass_) return step;
+        expired_in_pass_ = false;
+    }
+    notify({HistoryEvent::Removed});
+    return step;
+}
+
+bool HistoryManager::convert_step(int max_rows) {
+    TSUNAMI_TRACE_SCOPE("history.convertStep");
     std::lock_guard<std::mutex> lock(mutex_);
-    if (!db_) return;
+    if (!db_ || !needs_convert_) return true;
+    // Tried again on the next call
+    if (!convert_db_ && !start_convert()) return true;
     
-    const char* sql = "DELETE FROM visits WHERE url = ?;";
+    long long copied = -1;
     sqlite3_stmt* stmt;
+    const char* batch = "SELECT * FROM visits WHERE id > ? ORDER BY id LIMIT ?;";
+    sqlite3_exec(convert_db_, "BEGIN;", nullptr, nullptr, nullptr);
+    if (sqlite3_prepare_v2(db_, batch, -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_int64(stmt, 1, converted_id_);
+        sqlite3_bind_int(stmt, 2, max_rows);
+        copied = copy_rows(stmt, convert_db_, "visits");
+        sqlite3_finalize(stmt);
+    }
+    if (copied < 0 || sqlite3_exec(convert_db_, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "Cannot copy history into " << convert_path() << ": " << sqlite3_errmsg(convert_db_) << std::endl;
+        sqlite3_exec(convert_db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        abandon_convert();
+        return true;
+    }
+    if (sqlite3_prepare_v2(convert_db_, "SELECT max(id) FROM visits;", -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) converted_id_ = sqlite3_column_int64(stmt, 0);
+        sqlite3_finalize(stmt);
+    }
+    if (copied == max_rows) return false;
+    // An import has the file open on its own connection; the swap waits
+    // for a later pass, and the visits it adds are copied then
+    if (importers_ > 0) return true;
+    return finish_convert();
+}
+
+// Caller holds mutex_
+bool HistoryManager::start_convert() {
+    std::cerr << "[Tsunami] Converting history to incremental vacuum in the background" << std::endl;
+    std::error_code ec;
+    std::filesystem::remove(convert_path(), ec);
+    std::filesystem::remove(convert_path() + "-journal", ec);
+    if (sqlite3_open_v2(convert_path().c_str(), &convert_db_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                        nullptr) != SQLITE_OK) {
+        std::cerr << "Cannot create " << convert_path() << ": " << sqlite3_errmsg(convert_db_) << std::endl;
+        sqlite3_close(convert_db_);
+        convert_db_ = nullptr;
+        return false;
+    }
+    converted_id_ = 0;
     
-    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, url.c_str(), -1, SQLITE_STATIC);
-        sqlite3_step(stmt);
+    // The history's own schema, tables before their indexes
+    bool ok = sqlite3_exec(convert_db_, "PRAGMA auto_vacuum = INCREMENTAL; BEGIN;", nullptr, nullptr, nullptr) == SQLITE_OK;
+    const char* schema = "SELECT sql FROM sqlite_master WHERE sql IS NOT NULL "
+                         "AND name NOT LIKE 'sqlite_%' ORDER BY rowid;";
+    sqlite3_stmt* stmt;
+    if (ok && sqlite3_prepare_v2(db_, schema, -1, &stmt, nullptr) == SQLITE_OK) {
+        ok = for_each_row(stmt, [this](const RowView& row) {
+            std::string sql(row.text(0));
+            return sqlite3_exec(convert_db_, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+        }) == SQLITE_DONE;
         sqlite3_finalize(stmt);
+    } else {
+        ok = false;
     }
+    if (!ok || sqlite3_exec(convert_db_, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "Cannot create " << convert_path() << ": " << sqlite3_errmsg(convert_db_) << std::endl;
+        abandon_convert();
+        return false;
+    }
+    return true;
 }
 
-void HistoryManager::cleanup_history() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!db_) return;
+// Caller holds mutex_. The sites aggregate changes with every visit, so
+// it is copied whole here rather than in batches; it has a row per host.
+bool HistoryManager::finish_convert() {
+    TSUNAMI_TRACE_SCOPE("history.finishConvert");
+    bool ok = sqlite3_exec(convert_db_, "BEGIN; DELETE FROM sites; DELETE FROM sqlite_sequence;",
+                           nullptr, nullptr, nullptr) == SQLITE_OK;
+    for (const char* table : {"sites", "sqlite_sequence"}) {
+        std::string select = std::string("SELECT * FROM ") + table + ";";
+        sqlite3_stmt* stmt;
+        if (!ok || sqlite3_prepare_v2(db_, select.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            ok = false;
+            break;
+        }
+        ok = copy_rows(stmt, convert_db_, table) >= 0;
+        sqlite3_finalize(stmt);
+    }
+    if (!ok || sqlite3_exec(convert_db_, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "Cannot copy history into " << convert_path() << ": " << sqlite3_errmsg(convert_db_) << std::endl;
+        sqlite3_exec(convert_db_, "ROLLBACK;", nullptr, nullptr, nullptr);
+        abandon_convert();
+        return true;
+    }
+    
+    sqlite3_close(convert_db_);
+    convert_db_ = nullptr;
+    sqlite3_close(db_);
+    db_ = nullptr;
+    std::error_code ec;
+    std::filesystem::rename(convert_path(), db_path_, ec);
+    if (ec) {
+        std::cerr << "Cannot replace " << db_path_ << ": " << ec.message() << std::endl;
+        std::filesystem::remove(convert_path(), ec);
+    } else {
+        needs_convert_ = false;
+    }
+    if (sqlite3_open_v2(db_path_.c_str(), &db_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_URI, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to open history db: " << sqlite3_errmsg(db_) << std::endl;
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return true;
+    }
+    register_functions(db_);
+    return true;
+}
+
+// Caller holds mutex_
+void HistoryManager::abandon_convert() {
+    if (!convert_db_) return;
+    sqlite3_close(convert_db_);
+    convert_db_ = nullptr;
+    converted_id_ = 0;
+    std::error_code ec;
+    std::filesystem::remove(convert_path(), ec);
+    std::filesystem::remove(convert_path() + "-journal", ec);
+}
+
+long long HistoryManager::import_history(const std::string& source_path, ImportFormat format,
+                                        const ImportProgress& progress) {
+    TSUNAMI_TRACE_SCOPE("history.import");
+    std::string db_path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!db_) return -1;
+        db_path = db_path_;
+        ++importers_;
+    }
     
-    // Default retention: 30 days
-    long long threshold = std::chrono::seconds(std::time(NULL)).count() - (30 * 24 * 60 * 60);
+    // A connection of its own: copying from the source touches only it and
+    // a temp table, so neither mutex_ nor the history file is locked then
+    long long added = 0;
+    bool ok = false;
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(db_path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_URI, nullptr) != SQLITE_OK) {
+        std::cerr << "Cannot open history for import: " << sqlite3_errmsg(db) << std::endl;
+    } else {
+        sqlite3_busy_timeout(db, IMPORT_BUSY_TIMEOUT_MS);
+        register_functions(db);
+        long long staged = stage_import(db, source_path, format, progress);
+        ok = staged >= 0 && merge_import(db, staged, progress, added);
+    }
+    sqlite3_close(db);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --importers_;
+    }
     
-    const char* sql = "DELETE FROM visits WHERE timestamp < ?;";
+    // A cancelled merge keeps its finished batches; importing again skips them
+    if (added > 0) notify({HistoryEvent::Imported});
+    return ok ? added : -1;
+}
+
+long long HistoryManager::stage_import(sqlite3* db, const std::string& source_path, ImportFormat format,
+                                      const ImportProgress& progress) {
     sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "ATTACH DATABASE ? AS source;", -1, &stmt, nullptr) != SQLITE_OK) return -1;
+    std::string uri = read_only_uri(source_path);
+    sqlite3_bind_text(stmt, 1, uri.c_str(), -1, SQLITE_STATIC);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "Cannot attach " << source_path << ": " << sqlite3_errmsg(db) << std::endl;
+        return -1;
+    }
+    sqlite3_exec(db, "CREATE TEMP TABLE imported (url TEXT NOT NULL, title TEXT, timestamp INTEGER);",
+                 nullptr, nullptr, nullptr);
     
-    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_int64(stmt, 1, threshold);
-        sqlite3_step(stmt);
+    // Chromium stores microseconds since 1601, Firefox since 1970. Neither
+    // lists hidden URLs (subframes and the like) in its own history; nor do
+    // Firefox's embed (4), download (7), framed link (8) and reload (9)
+    // visits, or type 0, which it never writes for a real visit.
+    const bool chromium = format == ImportFormat::Chromium;
+    const char* range = chromium ? "SELECT min(id), max(id) FROM source.visits;"
+                                 : "SELECT min(id), max(id) FROM source.moz_historyvisits;";
+    const char* copy = chromium
+        ? "INSERT INTO temp.imported (url, title, timestamp) "
+          "SELECT u.url, NULLIF(u.title, ''), v.visit_time / 1000000 - 11644473600 "
+          "FROM source.visits v JOIN source.urls u ON u.id = v.url "
+          "WHERE v.id BETWEEN ?1 AND ?2 AND u.hidden = 0 "
+          "AND (u.url LIKE 'http://%' OR u.url LIKE 'https://%') "
+          "ORDER BY v.visit_time;"
+        : "INSERT INTO temp.imported (url, title, timestamp) "
+          "SELECT p.url, NULLIF(p.title, ''), h.visit_date / 1000000 "
+          "FROM source.moz_historyvisits h JOIN source.moz_places p ON p.id = h.place_id "
+          "WHERE h.id BETWEEN ?1 AND ?2 AND p.hidden = 0 AND h.visit_type NOT IN (0, 4, 7, 8, 9) "
+          "AND (p.url LIKE 'http://%' OR p.url LIKE 'https://%') "
+          "ORDER BY h.visit_date;";
+    
+    long long first = 0;
+    long long last = -1;
+    bool readable = false;
+    if (sqlite3_prepare_v2(db, range, -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            readable = true;
+            first = sqlite3_column_int64(stmt, 0);
+            last = sqlite3_column_type(stmt, 1) == SQLITE_NULL ? first - 1 : sqlite3_column_int64(stmt, 1);
+        }
         sqlite3_finalize(stmt);
     }
+    
+    // Ids are dense enough in both browsers that id ranges make even
+    // batches. Progress counts the copy as the first half of the work.
+    long long staged = 0;
+    bool ok = readable && sqlite3_prepare_v2(db, copy, -1, &stmt, nullptr) == SQLITE_OK;
+    if (ok) {
+        sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+        const long long total = last - first + 1;
+        for (long long begin = first; begin <= last && ok; begin += IMPORT_BATCH) {
+            if (progress && !progress(begin - first, total * 2)) {
+                ok = false;
+                break;
+            }
+            sqlite3_bind_int64(stmt, 1, begin);
+            sqlite3_bind_int64(stmt, 2, std::min(last, begin + IMPORT_BATCH - 1));
+            ok = sqlite3_step(stmt) == SQLITE_DONE;
+            staged += sqlite3_changes(db);
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_exec(db, ok ? "COMMIT;" : "ROLLBACK;", nullptr, nullptr, nullptr);
+    }
+    if (!readable) std::cerr << "Not a readable history file: " << source_path << std::endl;
+    sqlite3_exec(db, "DETACH DATABASE source;", nullptr, nullptr, nullptr);
+    return readable && ok ? staged : -1;
+}
+
+// MERGE_BATCH staged visits per transaction, each holding mutex_ only
+// briefly, so a page load's add_visit or a history search waits for one
+// batch at most
+bool HistoryManager::merge_import(sqlite3* db, long long staged, const ImportProgress& progress,
+                                  long long& added) {
+    const char* skip_known = "DELETE FROM temp.imported WHERE rowid BETWEEN ?1 AND ?2 AND EXISTS "
+                             "(SELECT 1 FROM main.visits m WHERE m.timestamp = imported.timestamp "
+                             "AND m.url = imported.url);";
+    const char* insert = "INSERT INTO main.visits (url, title, timestamp, host) "
+                         "SELECT url, title, timestamp, site_host(url) FROM temp.imported "
+                         "WHERE rowid BETWEEN ?1 AND ?2 "
+                         "ORDER BY rowid;";
+    const char* scan = "SELECT url, title, timestamp FROM temp.imported WHERE rowid BETWEEN ?1 AND ?2 "
+                       "ORDER BY timestamp, rowid;";
+    // The sites aggregate takes each batch's per-host counts, as expiry
+    // does in reverse, instead of a rebuild from every visit
+    const char* upsert = "INSERT INTO main.sites (host, url, title, visit_count, last_visit) "
+                         "VALUES (?1, ?2, ?3, ?4, ?5) ON CONFLICT (host) DO UPDATE SET "
+                         "url = CASE WHEN excluded.last_visit >= last_visit THEN excluded.url ELSE url END, "
+                         "title = CASE WHEN excluded.last_visit >= last_visit THEN excluded.title ELSE title END, "
+                         "visit_count = visit_count + excluded.visit_count, "
+                         "last_visit = max(last_visit, excluded.last_visit);";
+    sqlite3_stmt* skip_stmt = nullptr;
+    sqlite3_stmt* insert_stmt = nullptr;
+    sqlite3_stmt* scan_stmt = nullptr;
+    sqlite3_stmt* upsert_stmt = nullptr;
+    bool ok = sqlite3_prepare_v2(db, skip_known, -1, &skip_stmt, nullptr) == SQLITE_OK &&
+              sqlite3_prepare_v2(db, insert, -1, &insert_stmt, nullptr) == SQLITE_OK &&
+              sqlite3_prepare_v2(db, scan, -1, &scan_stmt, nullptr) == SQLITE_OK &&
+              sqlite3_prepare_v2(db, upsert, -1, &upsert_stmt, nullptr) == SQLITE_OK;
+    
+    for (long long begin = 1; begin <= staged && ok; begin += MERGE_BATCH) {
+        // Progress counts the merge as the second half of the work
+        if (progress && !progress(staged + begin - 1, staged * 2)) {
+            ok = false;
+            break;
+        }
+        long long end = std::min(staged, begin + MERGE_BATCH - 1);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            ok = false;
+            break;
+        }
+        for (sqlite3_stmt* stmt : {skip_stmt, insert_stmt, scan_stmt}) {
+            sqlite3_bind_int64(stmt, 1, begin);
+            sqlite3_bind_int64(stmt, 2, end);
+        }
+        ok = sqlite3_step(skip_stmt) == SQLITE_DONE && sqlite3_step(insert_stmt) == SQLITE_DONE;
+        long long inserted = sqlite3_changes(db);
+        sqlite3_reset(skip_stmt);
+        sqlite3_reset(insert_stmt);
+        
+        std::unordered_map<std::string, SiteStats> sites;
+        if (ok) {
+            ok = for_each_row(scan_stmt, [&](const RowView& row) {
+                std::string url(row.text(0));
+                size_t origin_length = 0;
+                std::string host = site_host(url, origin_length);
+                if (host.empty()) return;
+                SiteStats& site = sites[host];
+                site.url = url.substr(0, origin_length);
+                site.title = row.text(1);
+                site.visit_count++;
+                site.last_visit = row.int64(2);
+            }) == SQLITE_DONE;
+        }
+        sqlite3_reset(scan_stmt);
+        for (const auto& [host, site] : sites) {
+            if (!ok) break;
+            sqlite3_bind_text(upsert_stmt, 1, host.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(upsert_stmt, 2, site.url.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(upsert_stmt, 3, site.title.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int64(upsert_stmt, 4, site.visit_count);
+            sqlite3_bind_int64(upsert_stmt, 5, site.last_visit);
+            ok = sqlite3_step(upsert_stmt) == SQLITE_DONE;
+            sqlite3_reset(upsert_stmt);
+        }
+        sqlite3_exec(db, ok ? "COMMIT;" : "ROLLBACK;", nullptr, nullptr, nullptr);
+        if (ok) added += inserted;
+    }
+    sqlite3_finalize(skip_stmt);
+    sqlite3_finalize(insert_stmt);
+    sqlite3_finalize(scan_stmt);
+    sqlite3_finalize(upsert_stmt);
+    if (ok && progress) ok = progress(staged * 2, staged * 2);
+    return ok;
 }
 
 } // namespace SeaBrowser
@@ -1,37 +1,136 @@
 #pragma once
+#include "history_store.h"
+#include "import/import_source.h"
+#include "storage/listener_list.h"
+#include "storage/result_set.h"
 #include <string>
 #include <vector>
 #include <sqlite3.h>
 #include <mutex>
+#include <functional>
 
 namespace SeaBrowser {
 
-struct HistoryItem {
-    std::string url;
-    std::string title;
-    long long timestamp;
-};
-
-class HistoryManager {
+// The on-disk history of the persistent profile
+class HistoryManager : public HistoryStore {
 public:
     static HistoryManager& instance();
     
     void init(const std::string& db_path);
-    void add_visit(const std::string& url, const std::string& title);
-    std::vector<HistoryItem> get_recent(int limit = 10);
-    void clear_history();
-    void delete_history_item(const std::string& url);
-    void cleanup_history();
+    void add_visit(const std::string& url, const std::string& title) override;
+    // Keyset paging, newest first: rows strictly older than (before_timestamp,
+    // before_id). Pass before_id = 0 for the first page.
+    std::vector<HistoryItem> get_page(long long before_timestamp, long long before_id,
+                                      int limit, const std::string& filter = "") override;
+    // The same page as columns id, url, title (the URL when untitled),
+    // timestamp in one arena, for callers that convert the text anyway
+    ResultSet get_page_rows(long long before_timestamp, long long before_id,
+                            int limit, const std::string& filter = "");
+    
+    // Listeners run on the thread that changed the history, outside the lock
+    int add_listener(HistoryListener listener) override;
+
+    // Most visited sites first; reads the sites aggregate, not the visits
+    std::vector<SiteStats> get_top_sites(int limit);
+
+    void remove_listener(int id) override;
+    void clear_history() override;
+    void delete_history_item(const std::string& url) override;
+
+    // The URLs whose site no visit is to any more; one lookup in the sites
+    // table each. For stores keyed by page, pruning after removals.
+    std::vector<std::string> unvisited_sites(const std::vector<std::string>& urls);
+
+    // Zero turns a limit off
+    struct RetentionPolicy {
+        int max_age_days = 0;
+        long long max_visits = 0;
+    };
+    struct ExpiryStep {
+        int deleted = 0;
+        long long reclaimed_bytes = 0;
+        bool done = true;    // Nothing left to delete or to vacuum
+    };
+
+    // Fixes what the next expiry steps delete: everything older than the
+    // policy's oldest kept visit at this moment
+    void begin_expiry(const RetentionPolicy& policy);
+    // Deletes at most max_rows of the oldest expired visits in one short
+    // transaction, then returns up to vacuum_pages free pages to the file
+    // system. Listeners hear one Removed when a step finishes the pass.
+    ExpiryStep expire_step(int max_rows, int vacuum_pages);
+    // Converts a file init() left without auto_vacuum=INCREMENTAL, too big
+    // for one VACUUM. Each step copies at most max_rows visits into a new
+    // file beside it in one short hold of the lock; the last also copies
+    // the sites and swaps the two files. A visit deleted meanwhile starts
+    // the copy over. True once there is nothing left to convert.
+    bool convert_step(int max_rows);
+
+    // Copies every http(s) visit from a Chromium History or Firefox
+    // places.sqlite file, attached read-only to a connection of its own,
+    // with INSERT ... SELECT in batches of IMPORT_BATCH source visits
+    // inside one transaction into a temp table. The copies then move into
+    // the history MERGE_BATCH at a time, each batch a short transaction
+    // under the history lock. Visits already present are skipped. Call off
+    // the UI thread. Returns visits added, or -1 if the source could not
+    // be read or progress cancelled.
+    static constexpr long long IMPORT_BATCH = 100000;
+    static constexpr long long MERGE_BATCH = 5000;
+    long long import_history(const std::string& source_path, ImportFormat format,
+                             const ImportProgress& progress);
 
 private:
+    // Arena sizing hint for get_page_rows: a URL and a title
+    static constexpr size_t PAGE_BYTES_PER_ROW = 128;
+    // init() converts files from before auto_vacuum=INCREMENTAL with one
+    // VACUUM only while this much data is live: about 150k visits, a
+    // rewrite of a couple of hundred milliseconds. Bigger ones are left to
+    // convert_step().
+    static constexpr long long CONVERT_MAX_LIVE_BYTES = 16LL * 1024 * 1024;
+    static constexpr int IMPORT_BUSY_TIMEOUT_MS = 5000;
+    // Visits add_visit() holds for init(); any beyond are dropped
+    static constexpr size_t MAX_PENDING_VISITS = 256;
+
     HistoryManager() = default;
-    ~HistoryManager();
+    ~HistoryManager() override;
     
     sqlite3* db_ = nullptr;
     std::string db_path_;
     std::mutex mutex_;
     
+    ListenerList<const HistoryEvent&> listeners_;
+    std::vector<HistoryItem> pending_visits_;   // Before init()
+    
+    // Visits strictly before (timestamp, id) are expired
+    long long expiry_timestamp_ = 0;
+    long long expiry_id_ = 0;
+    bool expired_in_pass_ = false;
+    
+    // The file convert_step() copies into, open while a copy is under way;
+    // visits up to converted_id_ are in it
+    bool needs_convert_ = false;
+    sqlite3* convert_db_ = nullptr;
+    long long converted_id_ = 0;
+    // Imports in progress; each has the file open on a connection of its own
+    int importers_ = 0;
+    
     void ensure_table();
+    bool insert_visit(const std::string& url, const std::string& title, long long timestamp,
+                      HistoryEvent& event);
+    sqlite3_stmt* prepare_page(long long before_timestamp, long long before_id,
+                               int limit, const std::string& filter);
+    void rebuild_sites();
+    void refresh_site(const std::string& host);
+    void convert_to_incremental_vacuum();
+    std::string convert_path() const { return db_path_ + ".convert"; }
+    bool start_convert();
+    bool finish_convert();
+    void abandon_convert();
+    // Rows copied into temp.imported, or -1
+    long long stage_import(sqlite3* db, const std::string& source_path, ImportFormat format,
+                           const ImportProgress& progress);
+    bool merge_import(sqlite3* db, long long staged, const ImportProgress& progress, long long& added);
+    void notify(const HistoryEvent& event);
 };
 
 } // namespace SeaBrowser
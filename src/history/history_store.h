@@ -0,0 +1,53 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SeaBrowser {
+
+struct HistoryItem {
+    long long id = 0;
+    std::string url;
+    std::string title;
+    long long timestamp = 0;
+};
+
+// Per-site aggregate of the visits table, kept up to date on every visit
+struct SiteStats {
+    std::string host;
+    std::string url;     // Origin, e.g. https://example.com
+    std::string title;   // Title of the latest visit
+    long long visit_count = 0;
+    long long last_visit = 0;
+};
+
+struct HistoryEvent {
+    enum Type { Added, Removed, Cleared, Imported };
+    Type type = Added;
+    HistoryItem item{};   // Set for Added; for Removed, url when one URL was deleted
+    SiteStats site{};     // Set for Added: the visited site after this visit
+};
+
+using HistoryListener = std::function<void(const HistoryEvent&)>;
+
+// What windows and pages need from a history backend. HistoryManager is
+// the on-disk one; private windows record into a MemoryHistoryStore.
+class HistoryStore {
+public:
+    virtual ~HistoryStore() = default;
+
+    virtual void add_visit(const std::string& url, const std::string& title) = 0;
+    // Keyset paging, newest first: rows strictly older than (before_timestamp,
+    // before_id). Pass before_id = 0 for the first page.
+    virtual std::vector<HistoryItem> get_page(long long before_timestamp, long long before_id,
+                                              int limit, const std::string& filter = "") = 0;
+    virtual void delete_history_item(const std::string& url) = 0;
+    virtual void clear_history() = 0;
+
+    // Listeners run on the thread that changed the history, outside the lock
+    virtual int add_listener(HistoryListener listener) = 0;
+    // Waits for a call to that listener in progress on another thread
+    virtual void remove_listener(int id) = 0;
+};
+
+} // namespace SeaBrowser
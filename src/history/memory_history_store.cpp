@@ -0,0 +1,115 @@
+#include "memory_history_store.h"
+#include "perf/trace.h"
+#include <algorithm>
+#include <ctime>
+#include <string_view>
+
+namespace SeaBrowser {
+
+namespace {
+
+char ascii_lower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+// Same matching as SQLite's LIKE '%filter%': ASCII case-insensitive
+bool contains(std::string_view text, std::string_view needle) {
+    if (needle.empty()) return true;
+    auto it = std::search(text.begin(), text.end(), needle.begin(), needle.end(),
+                          [](char a, char b) { return ascii_lower(a) == ascii_lower(b); });
+    return it != text.end();
+}
+
+} // namespace
+
+MemoryHistoryStore::MemoryHistoryStore(std::pmr::memory_resource* upstream)
+    : arena_(INITIAL_ARENA_BYTES, upstream)
+    , visits_(&arena_)
+{
+}
+
+void MemoryHistoryStore::add_visit(const std::string& url, const std::string& title) {
+    TSUNAMI_TRACE_SCOPE("history.memory.addVisit");
+    if (url.find("sea://") == 0 || url.find("tsunami://") == 0) return;
+
+    HistoryEvent event{HistoryEvent::Added};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Kept non-decreasing so id order is also (timestamp, id) order
+        long long timestamp = static_cast<long long>(std::time(nullptr));
+        if (!visits_.empty()) timestamp = std::max(timestamp, visits_.back().timestamp);
+
+        const std::string& shown = title.empty() ? url : title;
+        Visit& visit = visits_.emplace_back(Visit{next_id_++, timestamp,
+                                                  std::pmr::string(url.data(), url.size(), &arena_),
+                                                  std::pmr::string(shown.data(), shown.size(), &arena_)});
+        event.item.id = visit.id;
+        event.item.url = url;
+        event.item.title = shown;
+        event.item.timestamp = timestamp;
+    }
+    notify(event);
+}
+
+std::vector<HistoryItem> MemoryHistoryStore::get_page(long long before_timestamp, long long before_id,
+                                                      int limit, const std::string& filter) {
+    (void)before_timestamp;   // Implied by before_id, see add_visit()
+    std::vector<HistoryItem> items;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto end = visits_.end();
+    if (before_id != 0) {
+        end = std::lower_bound(visits_.begin(), visits_.end(), before_id,
+                               [](const Visit& visit, long long id) { return visit.id < id; });
+    }
+    for (auto it = std::make_reverse_iterator(end);
+         it != visits_.rend() && static_cast<int>(items.size()) < limit; ++it) {
+        if (!contains(it->url, filter) && !contains(it->title, filter)) continue;
+        items.push_back({it->id, std::string(it->url), std::string(it->title), it->timestamp});
+    }
+    return items;
+}
+
+void MemoryHistoryStore::delete_history_item(const std::string& url) {
+    size_t removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t before = visits_.size();
+        visits_.erase(std::remove_if(visits_.begin(), visits_.end(),
+                                     [&url](const Visit& visit) { return std::string_view(visit.url) == url; }),
+                      visits_.end());
+        removed = before - visits_.size();
+    }
+    if (removed > 0) {
+        HistoryEvent event{HistoryEvent::Removed};
+        event.item.url = url;
+        notify(event);
+    }
+}
+
+void MemoryHistoryStore::clear_history() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        visits_.clear();
+    }
+    notify({HistoryEvent::Cleared});
+}
+
+size_t MemoryHistoryStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return visits_.size();
+}
+
+int MemoryHistoryStore::add_listener(HistoryListener listener) {
+    return listeners_.add(std::move(listener));
+}
+
+void MemoryHistoryStore::remove_listener(int id) {
+    listeners_.remove(id);
+}
+
+void MemoryHistoryStore::notify(const HistoryEvent& event) {
+    listeners_.notify(event);
+}
+
+} // namespace SeaBrowser
@@ -0,0 +1,58 @@
+#pragma once
+#include "history_store.h"
+#include "storage/listener_list.h"
+#include <deque>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SeaBrowser {
+
+// History that never leaves memory, for private windows. Every visit is
+// bump-allocated from one arena, so recording one is an append with no
+// I/O, and destroying the store hands the whole session back at once.
+// Deletions do not return memory to the arena; a private session is short
+// and deletions in one are rare.
+class MemoryHistoryStore : public HistoryStore {
+public:
+    static constexpr size_t INITIAL_ARENA_BYTES = 64 * 1024;
+
+    explicit MemoryHistoryStore(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    ~MemoryHistoryStore() override = default;
+
+    MemoryHistoryStore(const MemoryHistoryStore&) = delete;
+    MemoryHistoryStore& operator=(const MemoryHistoryStore&) = delete;
+
+    void add_visit(const std::string& url, const std::string& title) override;
+    std::vector<HistoryItem> get_page(long long before_timestamp, long long before_id,
+                                      int limit, const std::string& filter = "") override;
+    void delete_history_item(const std::string& url) override;
+    void clear_history() override;
+
+    int add_listener(HistoryListener listener) override;
+    void remove_listener(int id) override;
+
+    size_t size() const;
+
+private:
+    struct Visit {
+        long long id;
+        long long timestamp;
+        std::pmr::string url;
+        std::pmr::string title;
+    };
+
+    void notify(const HistoryEvent& event);
+
+    mutable std::mutex mutex_;
+    // Declared before the visits so it outlives them
+    std::pmr::monotonic_buffer_resource arena_;
+    std::pmr::deque<Visit> visits_;   // Oldest first; ids only grow
+    long long next_id_ = 1;
+
+    ListenerList<const HistoryEvent&> listeners_;
+};
+
+} // namespace SeaBrowser
@@ -0,0 +1,146 @@
+#include "top_sites.h"
+#include "perf/trace.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace SeaBrowser {
+
+namespace {
+
+bool ranks_before(const SiteStats& a, const SiteStats& b) {
+    if (a.visit_count != b.visit_count) return a.visit_count > b.visit_count;
+    return a.last_visit > b.last_visit;
+}
+
+void append_json_string(std::string& out, const std::string& value) {
+    out += '"';
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            // Keeps the payload safe to embed in a <script> block
+            case '<': out += "\\u003c"; break;
+            default:
+                if (c < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+TopSites& TopSites::instance() {
+    static TopSites instance;
+    return instance;
+}
+
+void TopSites::init() {
+    TSUNAMI_TRACE_SCOPE("topSites.init");
+    if (!history_listener_) {
+        history_listener_ = HistoryManager::instance().add_listener(
+            [this](const HistoryEvent& event) { on_history_event(event); });
+    }
+    reload();
+    notify();
+}
+
+void TopSites::reload() {
+    std::vector<SiteStats> ranked = HistoryManager::instance().get_top_sites(CANDIDATE_COUNT);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ranked_ = std::move(ranked);
+    publish();
+}
+
+void TopSites::on_history_event(const HistoryEvent& event) {
+    if (event.type != HistoryEvent::Added) {
+        // Counts went down; the candidates may no longer be the top ranks
+        reload();
+        notify();
+        return;
+    }
+    if (event.site.host.empty()) return;
+
+    bool changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        changed = apply_visit(event.site);
+    }
+    if (changed) notify();
+}
+
+bool TopSites::apply_visit(const SiteStats& site) {
+    // Caller holds mutex_. Returns whether the visible tiles changed.
+    auto tile_end = [this]() {
+        return ranked_.begin() + std::min<size_t>(ranked_.size(), TILE_COUNT);
+    };
+    auto it = std::find_if(ranked_.begin(), ranked_.end(),
+                           [&](const SiteStats& s) { return s.host == site.host; });
+    bool was_tile = it < tile_end();
+
+    if (it != ranked_.end()) {
+        *it = site;
+    } else if (ranked_.size() < static_cast<size_t>(CANDIDATE_COUNT)) {
+        ranked_.push_back(site);
+        it = ranked_.end() - 1;
+    } else if (ranks_before(site, ranked_.back())) {
+        ranked_.back() = site;
+        it = ranked_.end() - 1;
+    } else {
+        return false;
+    }
+
+    // Only this entry moved, and only upwards
+    auto target = std::upper_bound(ranked_.begin(), it, *it, ranks_before);
+    std::rotate(target, it, it + 1);
+
+    if (!was_tile && target >= tile_end()) return false;
+    publish();
+    return true;
+}
+
+void TopSites::publish() {
+    // Caller holds mutex_
+    std::string json = "[";
+    size_t count = std::min<size_t>(ranked_.size(), TILE_COUNT);
+    for (size_t i = 0; i < count; ++i) {
+        const SiteStats& site = ranked_[i];
+        if (i) json += ',';
+        json += "{\"url\":";
+        append_json_string(json, site.url);
+        json += ",\"title\":";
+        append_json_string(json, site.title.empty() ? site.host : site.title);
+        json += ",\"host\":";
+        append_json_string(json, site.host);
+        json += ",\"visits\":" + std::to_string(site.visit_count) + "}";
+    }
+    json += "]";
+    json_ = std::make_shared<const std::string>(std::move(json));
+}
+
+std::shared_ptr<const std::string> TopSites::json() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return json_;
+}
+
+int TopSites::add_listener(std::function<void()> listener) {
+    return listeners_.add(std::move(listener));
+}
+
+void TopSites::remove_listener(int id) {
+    listeners_.remove(id);
+}
+
+void TopSites::notify() {
+    listeners_.notify();
+}
+
+} // namespace SeaBrowser
@@ -0,0 +1,53 @@
+#pragma once
+#include "history_manager.h"
+#include "storage/listener_list.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SeaBrowser {
+
+// Most visited sites, kept in memory and updated from HistoryManager
+// events. A visit carries its site's new count, so the ranking changes
+// without a query; only deletions reload from the sites table. The JSON
+// handed to new tab pages is rebuilt when the visible tiles change.
+class TopSites {
+public:
+    static constexpr int TILE_COUNT = 8;
+    // Extra ranks held so a deleted tile is replaced without a query
+    static constexpr int CANDIDATE_COUNT = 32;
+
+    static TopSites& instance();
+
+    // Call after HistoryManager::init
+    void init();
+
+    // [{"url":..,"title":..,"host":..,"visits":..}, ...], best first
+    std::shared_ptr<const std::string> json() const;
+
+    // Listeners run on the thread that changed the history
+    int add_listener(std::function<void()> listener);
+    void remove_listener(int id);
+
+    // Applies one history event; public so benchmarks can drive it
+    void on_history_event(const HistoryEvent& event);
+
+private:
+    TopSites() = default;
+
+    void reload();
+    bool apply_visit(const SiteStats& site);
+    void publish();
+    void notify();
+
+    mutable std::mutex mutex_;
+    std::vector<SiteStats> ranked_;
+    std::shared_ptr<const std::string> json_ = std::make_shared<const std::string>("[]");
+    int history_listener_ = 0;
+
+    ListenerList<> listeners_;
+};
+
+} // namespace SeaBrowser
@@ -0,0 +1,223 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * browser_importer.cpp - History and bookmarks from Chromium and Firefox profiles
+ */
+
+#include "browser_importer.h"
+#include "history/history_manager.h"
+#include "bookmarks/bookmarks_manager.h"
+#include "perf/trace.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <sqlite3.h>
+#include <algorithm>
+
+namespace Tsunami {
+
+namespace {
+
+// Chromium timestamps count microseconds from 1601-01-01
+constexpr qint64 CHROMIUM_EPOCH_OFFSET = 11644473600LL;
+
+struct ChromiumBrowser {
+    const char* name;
+    const char* directory;   // Under the platform's base directory
+};
+
+#if defined(Q_OS_WIN)
+constexpr ChromiumBrowser CHROMIUM_BROWSERS[] = {
+    {"Chrome", "Google/Chrome/User Data"},
+    {"Chromium", "Chromium/User Data"},
+    {"Brave", "BraveSoftware/Brave-Browser/User Data"},
+    {"Edge", "Microsoft/Edge/User Data"},
+};
+#elif defined(Q_OS_MACOS)
+constexpr ChromiumBrowser CHROMIUM_BROWSERS[] = {
+    {"Chrome", "Google/Chrome"},
+    {"Chromium", "Chromium"},
+    {"Brave", "BraveSoftware/Brave-Browser"},
+    {"Edge", "Microsoft Edge"},
+};
+#else
+constexpr ChromiumBrowser CHROMIUM_BROWSERS[] = {
+    {"Chrome", "google-chrome"},
+    {"Chromium", "chromium"},
+    {"Brave", "BraveSoftware/Brave-Browser"},
+    {"Edge", "microsoft-edge"},
+    {"Vivaldi", "vivaldi"},
+};
+#endif
+
+QString chromiumBase() {
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+    return QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation);
+#else
+    // %LOCALAPPDATA% on Windows, ~/Library/Application Support on macOS
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation);
+#endif
+}
+
+QString firefoxBase() {
+#if defined(Q_OS_WIN)
+    return QDir::homePath() + "/AppData/Roaming/Mozilla/Firefox";
+#elif defined(Q_OS_MACOS)
+    return QDir::homePath() + "/Library/Application Support/Firefox";
+#else
+    return QDir::homePath() + "/.mozilla/firefox";
+#endif
+}
+
+// Copies a database and its write-ahead log, then folds the log into the
+// copy so it can be attached read-only without a -shm file
+QString snapshot(const QString& source, const QDir& target) {
+    QString copy = target.filePath(QFileInfo(source).fileName());
+    if (!QFile::copy(source, copy)) return QString();
+    if (QFile::exists(source + "-wal") && QFile::copy(source + "-wal", copy + "-wal")) {
+        sqlite3* db = nullptr;
+        if (sqlite3_open(copy.toUtf8().constData(), &db) == SQLITE_OK) {
+            sqlite3_exec(db, "PRAGMA journal_mode = DELETE;", nullptr, nullptr, nullptr);
+        }
+        sqlite3_close(db);
+    }
+    return copy;
+}
+
+void collectChromiumBookmarks(const QJsonObject& node, const QString& folder,
+                              std::vector<SeaBrowser::Bookmark>& out) {
+    for (const QJsonValue& value : node["children"].toArray()) {
+        QJsonObject child = value.toObject();
+        if (child["type"].toString() == "folder") {
+            collectChromiumBookmarks(child, child["name"].toString(), out);
+            continue;
+        }
+        QString url = child["url"].toString();
+        if (!url.startsWith("http://") && !url.startsWith("https://")) continue;
+        SeaBrowser::Bookmark bookmark;
+        bookmark.date_added = child["date_added"].toString().toLongLong() / 1000000 - CHROMIUM_EPOCH_OFFSET;
+        bookmark.url = url.toStdString();
+        QString title = child["name"].toString();
+        bookmark.title = (title.isEmpty() ? url : title).toStdString();
+        bookmark.folder = folder.toStdString();
+        bookmark.id = std::to_string(bookmark.date_added) + bookmark.url;
+        out.push_back(std::move(bookmark));
+    }
+}
+
+long long importChromiumBookmarks(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+    QJsonObject roots = QJsonDocument::fromJson(file.readAll()).object()["roots"].toObject();
+    std::vector<SeaBrowser::Bookmark> bookmarks;
+    collectChromiumBookmarks(roots["bookmark_bar"].toObject(), "Bookmarks Bar", bookmarks);
+    collectChromiumBookmarks(roots["other"].toObject(), "Other Bookmarks", bookmarks);
+    collectChromiumBookmarks(roots["synced"].toObject(), "Mobile Bookmarks", bookmarks);
+    return SeaBrowser::BookmarksManager::instance().import_bookmarks(bookmarks);
+}
+
+} // namespace
+
+QList<BrowserImporter::Source> BrowserImporter::detectSources() {
+    QList<Source> sources;
+    QString base = chromiumBase();
+    for (const ChromiumBrowser& browser : CHROMIUM_BROWSERS) {
+        QDir dir(base + "/" + browser.directory);
+        if (!dir.exists()) continue;
+        QStringList profiles = dir.entryList({"Default", "Profile *"}, QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString& profile : profiles) {
+            if (!QFile::exists(dir.filePath(profile + "/History"))) continue;
+            sources.append({QString("%1 (%2)").arg(browser.name, profile), dir.filePath(profile),
+                            SeaBrowser::ImportFormat::Chromium});
+        }
+    }
+
+    QString firefox = firefoxBase();
+    QSettings ini(firefox + "/profiles.ini", QSettings::IniFormat);
+    for (const QString& group : ini.childGroups()) {
+        if (!group.startsWith("Profile")) continue;
+        ini.beginGroup(group);
+        QString path = ini.value("Path").toString();
+        if (ini.value("IsRelative", 1).toInt()) path = firefox + "/" + path;
+        QString name = ini.value("Name", group).toString();
+        ini.endGroup();
+        if (!QFile::exists(path + "/places.sqlite")) continue;
+        sources.append({QString("Firefox (%1)").arg(name), path, SeaBrowser::ImportFormat::Firefox});
+    }
+    return sources;
+}
+
+BrowserImporter::BrowserImporter(QObject* parent) : QObject(parent) {
+    worker_.setMaxThreadCount(1);
+}
+
+BrowserImporter::~BrowserImporter() {
+    cancel();
+    worker_.waitForDone();
+}
+
+void BrowserImporter::cancel() {
+    cancelled_->store(true);
+}
+
+void BrowserImporter::start(const Source& source) {
+    if (running_) return;
+    running_ = true;
+    cancelled_->store(false);
+
+    // The destructor waits for the worker, so this outlives it
+    auto cancelled = cancelled_;
+    worker_.start([this, source, cancelled]() {
+        TSUNAMI_TRACE_SCOPE("import.profile");
+        auto fail = [this](const QString& message) {
+            QMetaObject::invokeMethod(this, [this, message]() {
+                running_ = false;
+                emit failed(message);
+            }, Qt::QueuedConnection);
+        };
+
+        QTemporaryDir temp;
+        if (!temp.isValid()) return fail("Cannot create a temporary directory");
+        QDir profile(source.profile_path);
+        QDir target(temp.path());
+        bool chromium = source.format == SeaBrowser::ImportFormat::Chromium;
+
+        QString history = snapshot(profile.filePath(chromium ? "History" : "places.sqlite"), target);
+        if (history.isEmpty()) return fail("Cannot read the profile's history");
+
+        // History is nearly all of the work; bookmarks take the last 5%
+        int last_percent = -1;
+        auto report = [this, cancelled, &last_percent](long long done, long long total) {
+            int percent = total > 0 ? static_cast<int>(done * 95 / total) : 95;
+            if (percent != last_percent) {
+                last_percent = percent;
+                QMetaObject::invokeMethod(this, [this, percent]() { emit progress(percent); },
+                                          Qt::QueuedConnection);
+            }
+            return !*cancelled;
+        };
+        long long visits = SeaBrowser::HistoryManager::instance().import_history(
+            history.toStdString(), source.format, report);
+        if (*cancelled) return fail("Import cancelled");
+        if (visits < 0) return fail("The profile's history could not be imported");
+
+        long long bookmarks = chromium
+            ? importChromiumBookmarks(profile.filePath("Bookmarks"))
+            : SeaBrowser::BookmarksManager::instance().import_firefox_bookmarks(history.toStdString());
+
+        QMetaObject::invokeMethod(this, [this, visits, bookmarks]() {
+            running_ = false;
+            // BookmarksManager's cache belongs to this thread
+            if (bookmarks > 0) SeaBrowser::BookmarksManager::instance().load();
+            emit progress(100);
+            emit finished(visits, std::max(0LL, bookmarks));
+        }, Qt::QueuedConnection);
+    });
+}
+
+} // namespace Tsunami
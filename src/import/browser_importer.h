@@ -0,0 +1,52 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * browser_importer.h - History and bookmarks from Chromium and Firefox profiles
+ */
+
+#pragma once
+
+#include "import/import_source.h"
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+namespace Tsunami {
+
+// Imports another browser's profile on a worker thread. The profile's
+// databases are copied to a temporary directory first, so a browser that
+// is still running (and holds its files locked) can be imported from;
+// the copies are then attached read-only and merged in bulk by
+// HistoryManager and BookmarksManager. Cancelling rolls the history back.
+class BrowserImporter : public QObject {
+    Q_OBJECT
+public:
+    struct Source {
+        QString name;           // "Chromium (Default)", "Firefox (default-release)"
+        QString profile_path;
+        SeaBrowser::ImportFormat format;
+    };
+
+    // Profiles of installed Chromium-based browsers and Firefox
+    static QList<Source> detectSources();
+
+    explicit BrowserImporter(QObject* parent = nullptr);
+    ~BrowserImporter() override;
+
+    void start(const Source& source);
+    void cancel();
+
+signals:
+    void progress(int percent);
+    void finished(qint64 visits, qint64 bookmarks);
+    void failed(const QString& message);
+
+private:
+    QThreadPool worker_;
+    std::shared_ptr<std::atomic<bool>> cancelled_ = std::make_shared<std::atomic<bool>>(false);
+    bool running_ = false;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,35 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * import_source.h - Types shared by the history and bookmark importers
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace SeaBrowser {
+
+enum class ImportFormat { Chromium, Firefox };
+
+// Called between batches with rows done so far; returning false cancels
+using ImportProgress = std::function<bool(long long done, long long total)>;
+
+// A file: URI that ATTACH opens read-only. The attaching connection must
+// have been opened with SQLITE_OPEN_URI.
+inline std::string read_only_uri(const std::string& path) {
+    static const char HEX[] = "0123456789ABCDEF";
+    std::string uri = "file:";
+    for (unsigned char c : path) {
+        if (c == '%' || c == '?' || c == '#' || c == ' ' || c == '\'') {
+            uri += '%';
+            uri += HEX[c >> 4];
+            uri += HEX[c & 15];
+        } else {
+            uri += static_cast<char>(c);
+        }
+    }
+    return uri + "?mode=ro";
+}
+
+} // namespace SeaBrowser
@@ -0,0 +1,126 @@
+/*
+ * Tsunami Browser - Performance tracing
+ * process_memory.cpp - Per-process memory figures from /proc
+ */
+
+#include "perf/process_memory.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <dirent.h>
+#endif
+
+namespace Tsunami {
+
+#ifdef __linux__
+
+namespace {
+
+// "Pss:  1234 kB" -> bytes, for the keys smaps_rollup and status share
+bool parseKb(const char* line, const char* key, uint64_t& value) {
+    size_t length = std::strlen(key);
+    if (std::strncmp(line, key, length) != 0) return false;
+    value = std::strtoull(line + length, nullptr, 10) * 1024;
+    return true;
+}
+
+// comm may contain spaces and parentheses; the ppid follows the last ')'
+bool readStat(int pid, std::string& name, int& ppid) {
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    FILE* file = std::fopen(path, "r");
+    if (!file) return false;
+    char buffer[512];
+    size_t size = std::fread(buffer, 1, sizeof(buffer) - 1, file);
+    std::fclose(file);
+    buffer[size] = '\0';
+
+    char* open = std::strchr(buffer, '(');
+    char* close = std::strrchr(buffer, ')');
+    if (!open || !close || close < open) return false;
+    name.assign(open + 1, close);
+    char state;
+    return std::sscanf(close + 1, " %c %d", &state, &ppid) == 2;
+}
+
+} // namespace
+
+bool read_process_memory(int pid, ProcessMemory& memory) {
+    memory = ProcessMemory{};
+    memory.pid = pid;
+    if (!readStat(pid, memory.name, memory.ppid)) return false;
+
+    char path[64];
+    char line[256];
+    // One pass over the mappings, summed by the kernel (Linux 4.14+)
+    std::snprintf(path, sizeof(path), "/proc/%d/smaps_rollup", pid);
+    if (FILE* file = std::fopen(path, "r")) {
+        uint64_t clean = 0;
+        uint64_t dirty = 0;
+        while (std::fgets(line, sizeof(line), file)) {
+            parseKb(line, "Rss:", memory.rss_bytes) || parseKb(line, "Pss:", memory.pss_bytes) ||
+                parseKb(line, "Private_Clean:", clean) || parseKb(line, "Private_Dirty:", dirty) ||
+                parseKb(line, "Swap:", memory.swap_bytes);
+        }
+        std::fclose(file);
+        memory.private_bytes = clean + dirty;
+        return true;
+    }
+
+    // Older kernels, or another user's process: status has RSS only
+    std::snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    FILE* file = std::fopen(path, "r");
+    if (!file) return false;
+    while (std::fgets(line, sizeof(line), file)) {
+        parseKb(line, "VmRSS:", memory.rss_bytes) || parseKb(line, "VmSwap:", memory.swap_bytes);
+    }
+    std::fclose(file);
+    memory.pss_bytes = memory.rss_bytes;
+    return true;
+}
+
+std::vector<int> descendant_pids(int root) {
+    std::unordered_map<int, std::vector<int>> children;
+    if (DIR* dir = opendir("/proc")) {
+        std::string name;
+        while (dirent* entry = readdir(dir)) {
+            int pid = std::atoi(entry->d_name);
+            int ppid = 0;
+            if (pid > 0 && readStat(pid, name, ppid)) children[ppid].push_back(pid);
+        }
+        closedir(dir);
+    }
+
+    std::vector<int> result;
+    std::vector<int> pending{root};
+    while (!pending.empty()) {
+        int pid = pending.back();
+        pending.pop_back();
+        auto it = children.find(pid);
+        if (it == children.end()) continue;
+        for (int child : it->second) {
+            result.push_back(child);
+            pending.push_back(child);
+        }
+    }
+    return result;
+}
+
+#else
+
+bool read_process_memory(int pid, ProcessMemory& memory) {
+    memory = ProcessMemory{};
+    memory.pid = pid;
+    return false;
+}
+
+std::vector<int> descendant_pids(int) {
+    return {};
+}
+
+#endif
+
+} // namespace Tsunami
@@ -0,0 +1,31 @@
+/*
+ * Tsunami Browser - Performance tracing
+ * process_memory.h - Per-process memory figures from /proc
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Tsunami {
+
+struct ProcessMemory {
+    int pid = 0;
+    int ppid = 0;
+    std::string name;            // comm, e.g. "QtWebEngineProc"
+    uint64_t rss_bytes = 0;      // Counts shared pages in every process mapping them
+    uint64_t pss_bytes = 0;      // Shared pages split between their users; sums correctly
+    uint64_t private_bytes = 0;  // Freed if the process exits
+    uint64_t swap_bytes = 0;
+};
+
+// Linux only; elsewhere these find nothing. Each call reads a few small
+// /proc files, so callers run them off the UI thread.
+bool read_process_memory(int pid, ProcessMemory& memory);
+// Every process below root, e.g. the zygote, GPU and renderer processes
+// QtWebEngine starts. Walks /proc once.
+std::vector<int> descendant_pids(int root);
+
+} // namespace Tsunami
@@ -0,0 +1,221 @@
+/*
+ * Tsunami Browser - Performance tracing
+ * task_sampler.cpp - Background CPU and memory sampling of browser processes
+ */
+
+#include "perf/task_sampler.h"
+#include "perf/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Tsunami {
+
+namespace {
+
+#ifdef __linux__
+
+// procfs regenerates the file on every read from offset 0
+ssize_t readAgain(int fd, char* buffer, size_t capacity) {
+    if (fd < 0 || lseek(fd, 0, SEEK_SET) < 0) return -1;
+    ssize_t size = read(fd, buffer, capacity - 1);
+    if (size <= 0) return -1;
+    buffer[size] = '\0';
+    return size;
+}
+
+int openProc(int pid, const char* file) {
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/%s", pid, file);
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+// utime + stime, fields 14 and 15; comm (field 2) may contain spaces
+bool parseCpuTicks(const char* stat, uint64_t& ticks) {
+    const char* p = std::strrchr(stat, ')');
+    if (!p) return false;
+    ++p;
+    // state is field 3: skip it and the ten fields up to utime
+    for (int field = 3; field < 14; ++field) {
+        while (*p == ' ') ++p;
+        while (*p && *p != ' ') ++p;
+        if (!*p) return false;
+    }
+    char* end = nullptr;
+    uint64_t utime = std::strtoull(p, &end, 10);
+    uint64_t stime = std::strtoull(end, &end, 10);
+    ticks = utime + stime;
+    return true;
+}
+
+#endif
+
+} // namespace
+
+TaskSampler::TaskSampler() {
+#ifdef __linux__
+    ticks_per_second_ = sysconf(_SC_CLK_TCK);
+    page_size_ = sysconf(_SC_PAGESIZE);
+#endif
+}
+
+TaskSampler::~TaskSampler() {
+    stop();
+    for (size_t i = 0; i < slot_count_; ++i) close_slot(slots_[i]);
+}
+
+void TaskSampler::start() {
+    if (thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+    }
+    thread_ = std::thread(&TaskSampler::run, this);
+}
+
+void TaskSampler::stop() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+}
+
+void TaskSampler::set_pids(const int* pids, size_t count) {
+    count = std::min(count, MAX_PROCESSES);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count == wanted_count_ && std::equal(pids, pids + count, wanted_.begin())) return;
+    std::copy(pids, pids + count, wanted_.begin());
+    wanted_count_ = count;
+    wanted_changed_ = true;
+}
+
+size_t TaskSampler::snapshot(TaskSample* out, size_t capacity) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = std::min(capacity, published_count_);
+    std::copy(published_.begin(), published_.begin() + count, out);
+    return count;
+}
+
+void TaskSampler::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        lock.unlock();
+        uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        sample_once(now);
+        lock.lock();
+        wake_.wait_for(lock, std::chrono::milliseconds(INTERVAL_MS), [this]() { return stopping_; });
+    }
+}
+
+// Brings the slots in line with set_pids(), keeping the open files and
+// CPU baseline of every process that stays
+void TaskSampler::reconcile() {
+    std::array<int, MAX_PROCESSES> wanted;
+    size_t wanted_count;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!wanted_changed_) return;
+        wanted = wanted_;
+        wanted_count = wanted_count_;
+        wanted_changed_ = false;
+    }
+
+    std::array<Slot, MAX_PROCESSES> next;
+    for (size_t i = 0; i < wanted_count; ++i) {
+        auto kept = std::find_if(slots_.begin(), slots_.begin() + slot_count_,
+                                 [pid = wanted[i]](const Slot& slot) { return slot.pid == pid; });
+        if (kept != slots_.begin() + slot_count_) {
+            next[i] = *kept;
+            kept->pid = 0;   // Moved; not closed below
+            kept->stat_fd = kept->statm_fd = kept->smaps_fd = -1;
+        } else {
+            open_slot(next[i], wanted[i]);
+        }
+    }
+    for (size_t i = 0; i < slot_count_; ++i) close_slot(slots_[i]);
+    slots_ = next;
+    slot_count_ = wanted_count;
+    pss_cursor_ = 0;
+}
+
+void TaskSampler::sample_once(uint64_t now_ns) {
+    TSUNAMI_TRACE_SCOPE("tasks.sample");
+    reconcile();
+    size_t pss_slot = slot_count_ ? pss_cursor_++ % slot_count_ : 0;
+    for (size_t i = 0; i < slot_count_; ++i) sample_slot(slots_[i], now_ns, i == pss_slot);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < slot_count_; ++i) published_[i] = slots_[i].sample;
+    published_count_ = slot_count_;
+}
+
+void TaskSampler::open_slot(Slot& slot, int pid) {
+    slot = Slot{};
+    slot.pid = pid;
+    slot.sample.pid = pid;
+#ifdef __linux__
+    slot.stat_fd = openProc(pid, "stat");
+    slot.statm_fd = openProc(pid, "statm");
+    slot.smaps_fd = openProc(pid, "smaps_rollup");
+#endif
+}
+
+void TaskSampler::close_slot(Slot& slot) {
+#ifdef __linux__
+    for (int fd : {slot.stat_fd, slot.statm_fd, slot.smaps_fd}) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+    slot.stat_fd = slot.statm_fd = slot.smaps_fd = -1;
+}
+
+void TaskSampler::sample_slot(Slot& slot, uint64_t now_ns, bool read_pss) {
+#ifdef __linux__
+    char buffer[2048];
+    uint64_t ticks = 0;
+    // A process that exited keeps failing here until set_pids() drops it
+    if (readAgain(slot.stat_fd, buffer, sizeof(buffer)) < 0 || !parseCpuTicks(buffer, ticks)) {
+        slot.sample.alive = false;
+        slot.sample.cpu_percent = 0;
+        return;
+    }
+    if (slot.sampled_ns && now_ns > slot.sampled_ns && ticks >= slot.cpu_ticks) {
+        double cpu_seconds = static_cast<double>(ticks - slot.cpu_ticks) / ticks_per_second_;
+        double wall_seconds = static_cast<double>(now_ns - slot.sampled_ns) / 1e9;
+        slot.sample.cpu_percent = 100.0 * cpu_seconds / wall_seconds;
+    }
+    slot.cpu_ticks = ticks;
+    slot.sampled_ns = now_ns;
+    slot.sample.alive = true;
+
+    // "size resident shared ..." in pages
+    if (readAgain(slot.statm_fd, buffer, sizeof(buffer)) > 0) {
+        char* end = nullptr;
+        std::strtoull(buffer, &end, 10);
+        slot.sample.rss_bytes = std::strtoull(end, nullptr, 10) * static_cast<uint64_t>(page_size_);
+    }
+
+    if (read_pss && readAgain(slot.smaps_fd, buffer, sizeof(buffer)) > 0) {
+        if (const char* pss = std::strstr(buffer, "\nPss:")) {
+            slot.sample.pss_bytes = std::strtoull(pss + 5, nullptr, 10) * 1024;
+        }
+    }
+#else
+    (void)slot;
+    (void)now_ns;
+    (void)read_pss;
+#endif
+}
+
+} // namespace Tsunami
@@ -0,0 +1,93 @@
+/*
+ * Tsunami Browser - Performance tracing
+ * task_sampler.h - Background CPU and memory sampling of browser processes
+ */
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace Tsunami {
+
+struct TaskSample {
+    int pid = 0;
+    bool alive = false;
+    double cpu_percent = 0;    // Of one core, over the last interval
+    uint64_t rss_bytes = 0;    // Every tick, from statm
+    uint64_t pss_bytes = 0;    // Refreshed round-robin, one process per tick
+};
+
+// Samples a fixed set of processes once per interval on its own thread:
+// /proc/<pid>/stat for CPU time and statm for RSS, kept open and re-read
+// from offset 0, plus smaps_rollup for one process per tick, since the
+// kernel walks every mapping to produce it. Slots and read buffers are
+// fixed-size, so a steady state allocates nothing and a tick costs the
+// same however long the browser has run. Linux only; elsewhere the
+// samples stay dead.
+class TaskSampler {
+public:
+    static constexpr size_t MAX_PROCESSES = 64;
+    static constexpr int INTERVAL_MS = 1000;
+
+    TaskSampler();
+    ~TaskSampler();
+
+    TaskSampler(const TaskSampler&) = delete;
+    TaskSampler& operator=(const TaskSampler&) = delete;
+
+    void start();
+    void stop();
+    bool running() const { return thread_.joinable(); }
+
+    // The processes to sample from the next tick; beyond MAX_PROCESSES
+    // are ignored. A process kept from one call to the next keeps its
+    // CPU baseline.
+    void set_pids(const int* pids, size_t count);
+    // Latest samples, in set_pids() order; returns how many were copied
+    size_t snapshot(TaskSample* out, size_t capacity) const;
+
+    // One tick on the calling thread; public for benchmarks
+    void sample_once(uint64_t now_ns);
+
+private:
+    struct Slot {
+        int pid = 0;
+        int stat_fd = -1;
+        int statm_fd = -1;
+        int smaps_fd = -1;
+        uint64_t cpu_ticks = 0;
+        uint64_t sampled_ns = 0;
+        TaskSample sample;
+    };
+
+    void run();
+    void reconcile();
+    void sample_slot(Slot& slot, uint64_t now_ns, bool read_pss);
+    static void open_slot(Slot& slot, int pid);
+    static void close_slot(Slot& slot);
+
+    // Sampler thread only
+    std::array<Slot, MAX_PROCESSES> slots_;
+    size_t slot_count_ = 0;
+    size_t pss_cursor_ = 0;
+    long ticks_per_second_ = 100;
+    long page_size_ = 4096;
+
+    // Shared with the UI thread under mutex_
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::array<int, MAX_PROCESSES> wanted_{};
+    size_t wanted_count_ = 0;
+    bool wanted_changed_ = false;
+    std::array<TaskSample, MAX_PROCESSES> published_{};
+    size_t published_count_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,195 @@
+/*
+ * Tsunami Browser - Performance tracing
+ * trace.cpp - Ring buffers, Chrome trace export and latency percentiles
+ */
+
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+
+namespace Tsunami {
+
+namespace {
+
+thread_local uint32_t t_sample_counter = 0;
+thread_local void* t_buffer = nullptr;
+thread_local bool t_exited = false;
+
+double percentile(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)] / 1000.0;
+}
+
+void append_json_string(std::string& out, const char* text) {
+    out += '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out += '\\';
+        out += *c;
+    }
+    out += '"';
+}
+
+} // namespace
+
+Tracer& Tracer::instance() {
+    static Tracer instance;
+    return instance;
+}
+
+uint64_t Tracer::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::set_sample_interval(uint32_t interval) {
+    sample_interval_.store(std::max<uint32_t>(interval, 1), std::memory_order_relaxed);
+}
+
+bool Tracer::should_sample() {
+    uint32_t interval = sample_interval_.load(std::memory_order_relaxed);
+    return interval <= 1 || (++t_sample_counter % interval) == 0;
+}
+
+Tracer::ThreadBuffer* Tracer::local_buffer() {
+    if (t_buffer) return static_cast<ThreadBuffer*>(t_buffer);
+    // Spans closed by other thread_local destructors after the ring went back
+    if (t_exited) return nullptr;
+
+    // On thread exit the ring goes on the free list for the next new thread,
+    // which carries on writing where it left off: readers still see the dead
+    // thread's events until they are overwritten, under the same id, the way
+    // the OS reuses thread ids
+    struct Release {
+        ~Release() {
+            t_exited = true;
+            if (!t_buffer) return;
+            Tracer& tracer = Tracer::instance();
+            std::lock_guard<std::mutex> lock(tracer.registry_mutex_);
+            tracer.free_buffers_.push_back(static_cast<ThreadBuffer*>(t_buffer));
+            t_buffer = nullptr;
+        }
+    };
+    thread_local Release release;
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    if (!free_buffers_.empty()) {
+        t_buffer = free_buffers_.back();
+        free_buffers_.pop_back();
+        return static_cast<ThreadBuffer*>(t_buffer);
+    }
+    // Buffers are never freed, so readers never race with thread exit
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->thread_id = static_cast<uint32_t>(buffers_.size() + 1);
+    t_buffer = buffer.get();
+    buffers_.push_back(std::move(buffer));
+    return static_cast<ThreadBuffer*>(t_buffer);
+}
+
+void Tracer::record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+    if (!enabled() || end_ns < start_ns) return;
+
+    ThreadBuffer* buffer = local_buffer();
+    if (!buffer) return;
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    Slot& slot = buffer->slots[head % RING_CAPACITY];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.duration_ns.store(end_ns - start_ns, std::memory_order_relaxed);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+std::vector<TraceEvent> Tracer::snapshot() const {
+    std::vector<TraceEvent> events;
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    for (const auto& buffer : buffers_) {
+        uint64_t end = buffer->head.load(std::memory_order_acquire);
+        uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        uint64_t begin = end > RING_CAPACITY ? end - RING_CAPACITY : 0;
+        begin = std::max(begin, tail);
+
+        size_t first = events.size();
+        for (uint64_t i = begin; i < end; ++i) {
+            const Slot& slot = buffer->slots[i % RING_CAPACITY];
+            TraceEvent event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.start_ns = slot.start_ns.load(std::memory_order_relaxed);
+            event.duration_ns = slot.duration_ns.load(std::memory_order_relaxed);
+            event.thread_id = buffer->thread_id;
+            events.push_back(event);
+        }
+
+        // The owner kept writing while we copied. Anything it may have
+        // lapped, including the slot it is writing right now, is stale.
+        uint64_t now_head = buffer->head.load(std::memory_order_acquire);
+        uint64_t valid_from = now_head + 1 > RING_CAPACITY ? now_head + 1 - RING_CAPACITY : 0;
+        if (valid_from > begin) {
+            size_t stale = static_cast<size_t>(std::min(valid_from, end) - begin);
+            events.erase(events.begin() + first, events.begin() + first + stale);
+        }
+    }
+
+    std::sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.start_ns < b.start_ns;
+    });
+    return events;
+}
+
+std::vector<TraceStats> Tracer::stats() const {
+    std::map<std::string, std::vector<uint64_t>> durations;
+    for (const TraceEvent& event : snapshot()) {
+        if (event.name) durations[event.name].push_back(event.duration_ns);
+    }
+
+    std::vector<TraceStats> result;
+    result.reserve(durations.size());
+    for (auto& [name, values] : durations) {
+        std::sort(values.begin(), values.end());
+        TraceStats stats;
+        stats.name = name;
+        stats.count = values.size();
+        stats.p50_us = percentile(values, 0.50);
+        stats.p95_us = percentile(values, 0.95);
+        stats.p99_us = percentile(values, 0.99);
+        stats.max_us = values.back() / 1000.0;
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+std::string Tracer::export_chrome_json() const {
+    std::vector<TraceEvent> events = snapshot();
+
+    std::string json;
+    json.reserve(events.size() * 96 + 64);
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    char buffer[128];
+    bool first = true;
+    for (const TraceEvent& event : events) {
+        if (!event.name) continue;
+        if (!first) json += ',';
+        first = false;
+        json += "{\"name\":";
+        append_json_string(json, event.name);
+        std::snprintf(buffer, sizeof(buffer),
+            ",\"cat\":\"tsunami\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+            event.start_ns / 1000.0, event.duration_ns / 1000.0, event.thread_id);
+        json += buffer;
+    }
+
+    json += "]}";
+    return json;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    for (const auto& buffer : buffers_) {
+        buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+} // namespace Tsunami
@@ -0,0 +1,129 @@
+/*
+ * Tsunami Browser - Performance tracing
+ * trace.h - Scoped spans recorded into per-thread ring buffers
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Tsunami {
+
+struct TraceEvent {
+    const char* name = nullptr;   // Must point at a string literal
+    uint64_t start_ns = 0;
+    uint64_t duration_ns = 0;
+    uint32_t thread_id = 0;
+};
+
+struct TraceStats {
+    std::string name;
+    uint64_t count = 0;
+    double p50_us = 0;
+    double p95_us = 0;
+    double p99_us = 0;
+    double max_us = 0;
+};
+
+// Process-wide tracer. Each recording thread owns a fixed-size ring buffer
+// that only it writes to, so recording is a handful of relaxed stores and
+// never takes a lock. Readers (export, stats) copy the rings and drop any
+// slot the owning thread may have overwritten while it was being copied.
+// An exited thread's ring is handed to the next thread that records, so
+// pool threads coming and going do not grow the tracer.
+class Tracer {
+public:
+    static constexpr size_t RING_CAPACITY = 4096;  // Events kept per thread
+
+    static Tracer& instance();
+    static uint64_t now_ns();
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    // Record one out of every `interval` spans per thread (1 = record all)
+    uint32_t sample_interval() const { return sample_interval_.load(std::memory_order_relaxed); }
+    void set_sample_interval(uint32_t interval);
+    bool should_sample();
+
+    void record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+    std::vector<TraceEvent> snapshot() const;
+    std::vector<TraceStats> stats() const;
+    std::string export_chrome_json() const;
+    void clear();
+
+private:
+    struct Slot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start_ns{0};
+        std::atomic<uint64_t> duration_ns{0};
+    };
+
+    struct ThreadBuffer {
+        uint32_t thread_id = 0;
+        std::atomic<uint64_t> head{0};    // Total events ever written
+        std::atomic<uint64_t> tail{0};    // Events before this index are cleared
+        Slot slots[RING_CAPACITY];
+    };
+
+    Tracer() = default;
+    ThreadBuffer* local_buffer();
+
+    std::atomic<bool> enabled_{true};
+    std::atomic<uint32_t> sample_interval_{1};
+
+    mutable std::mutex registry_mutex_;   // Guards the two lists below, never taken on record
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    std::vector<ThreadBuffer*> free_buffers_;   // Rings of exited threads
+};
+
+class ScopedTrace {
+public:
+    explicit ScopedTrace(const char* name)
+        : name_(name)
+        , start_ns_(0)
+    {
+        Tracer& tracer = Tracer::instance();
+        if (tracer.enabled() && tracer.should_sample()) {
+            start_ns_ = Tracer::now_ns();
+        }
+    }
+
+    ~ScopedTrace() {
+        if (start_ns_) {
+            Tracer::instance().record(name_, start_ns_, Tracer::now_ns());
+        }
+    }
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_ns_;
+};
+
+} // namespace Tsunami
+
+// Instrumentation macros. Without TSUNAMI_TRACING they expand to nothing, so
+// instrumented call sites cost nothing in builds that disable tracing.
+#define TSUNAMI_TRACE_CONCAT_INNER(a, b) a##b
+#define TSUNAMI_TRACE_CONCAT(a, b) TSUNAMI_TRACE_CONCAT_INNER(a, b)
+
+#ifdef TSUNAMI_TRACING
+#define TSUNAMI_TRACE_SCOPE(name) \
+    ::Tsunami::ScopedTrace TSUNAMI_TRACE_CONCAT(tsunami_trace_, __LINE__)(name)
+#define TSUNAMI_TRACE_NOW() ::Tsunami::Tracer::now_ns()
+#define TSUNAMI_TRACE_SPAN(name, start_ns, end_ns) \
+    ::Tsunami::Tracer::instance().record(name, start_ns, end_ns)
+#else
+#define TSUNAMI_TRACE_SCOPE(name) do {} while (0)
+#define TSUNAMI_TRACE_NOW() uint64_t(0)
+#define TSUNAMI_TRACE_SPAN(name, start_ns, end_ns) do {} while (0)
+#endif
@@ -0,0 +1,190 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * cache_manager.cpp - HTTP cache quota, statistics and clearing
+ */
+
+#include "cache_manager.h"
+#include "settings/settings.h"
+#include "perf/trace.h"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QWebEngineProfile>
+#include <algorithm>
+#include <climits>
+#include <iostream>
+
+namespace Tsunami {
+
+namespace {
+
+struct DirSize {
+    qint64 bytes = 0;
+    qint64 files = 0;
+};
+
+constexpr QDir::Filters ALL_FILES = QDir::Files | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot;
+
+DirSize measure(const QString& path, const std::atomic<bool>& stopping) {
+    DirSize size;
+    QDirIterator it(path, ALL_FILES, QDirIterator::Subdirectories);
+    while (it.hasNext() && !stopping) {
+        it.next();
+        size.bytes += it.fileInfo().size();
+        ++size.files;
+    }
+    return size;
+}
+
+// File by file so an exit can interrupt it; the rest goes next start
+void removeTree(const QString& path, const std::atomic<bool>& stopping) {
+    QStringList files;
+    QDirIterator it(path, ALL_FILES, QDirIterator::Subdirectories);
+    while (it.hasNext()) files.append(it.next());
+    for (const QString& file : files) {
+        if (stopping) return;
+        QFile::remove(file);
+    }
+    // Only empty directories are left
+    QDir(path).removeRecursively();
+}
+
+} // namespace
+
+CacheManager& CacheManager::instance() {
+    static CacheManager instance;
+    return instance;
+}
+
+CacheManager::CacheManager() : QObject(nullptr) {
+    worker_.setMaxThreadCount(1);
+    trim_timer_.setInterval(TRIM_INTERVAL_MS);
+    trim_timer_.setTimerType(Qt::VeryCoarseTimer);
+    connect(&trim_timer_, &QTimer::timeout, this, &CacheManager::refreshStats);
+    connect(&Settings::instance(), &Settings::settingsChanged, this, &CacheManager::onSettingsChanged);
+}
+
+CacheManager::~CacheManager() {
+    stopping_->store(true);
+    worker_.waitForDone();
+}
+
+QString CacheManager::trashPath() const {
+    return cache_path_ + "-trash";
+}
+
+QString CacheManager::markerPath() const {
+    return cache_path_ + ".clear-pending";
+}
+
+qint64 CacheManager::quotaBytes() const {
+    return static_cast<qint64>(Settings::instance().getCacheSizeMb()) * 1024 * 1024;
+}
+
+void CacheManager::init(const QString& cache_path, const QString& storage_path) {
+    cache_path_ = cache_path;
+    storage_path_ = storage_path;
+    // Nothing has the cache open yet, so this rename cannot fail for that
+    if (QFile::exists(markerPath()) && moveToTrash(cache_path_)) {
+        QFile::remove(markerPath());
+    }
+}
+
+void CacheManager::configure(QWebEngineProfile* profile) {
+    profile_ = profile;
+    profile->setHttpCacheType(QWebEngineProfile::DiskHttpCache);
+    profile->setHttpCacheMaximumSize(static_cast<int>(std::min<qint64>(quotaBytes(), INT_MAX)));
+}
+
+// A rename within one directory is O(1) however large the cache is
+bool CacheManager::moveToTrash(const QString& path) {
+    if (path.isEmpty() || !QFileInfo::exists(path)) return true;
+    QDir().mkpath(trashPath());
+    QString target = trashPath() + "/" + QString::number(QDateTime::currentMSecsSinceEpoch());
+    return QDir().rename(path, target);
+}
+
+void CacheManager::startMaintenance() {
+    emptyTrash();
+    refreshStats();
+    trim_timer_.start();
+}
+
+void CacheManager::emptyTrash() {
+    QString trash = trashPath();
+    if (cache_path_.isEmpty() || !QFileInfo::exists(trash)) return;
+    auto stopping = stopping_;
+    worker_.start([trash, stopping]() {
+        TSUNAMI_TRACE_SCOPE("cache.emptyTrash");
+        removeTree(trash, *stopping);
+    });
+}
+
+void CacheManager::refreshStats() {
+    if (measuring_ || cache_path_.isEmpty()) return;
+    measuring_ = true;
+
+    QString cache = cache_path_;
+    QString storage = storage_path_;
+    QString trash = trashPath();
+    auto stopping = stopping_;
+    worker_.start([this, cache, storage, trash, stopping]() {
+        TSUNAMI_TRACE_SCOPE("cache.measure");
+        Stats stats;
+        DirSize cache_size = measure(cache, *stopping);
+        stats.cache_bytes = cache_size.bytes;
+        stats.cache_files = cache_size.files;
+        stats.storage_bytes = measure(storage, *stopping).bytes;
+        stats.trash_bytes = measure(trash, *stopping).bytes;
+        if (*stopping) return;
+        QMetaObject::invokeMethod(this, [this, stats]() { onMeasured(stats); }, Qt::QueuedConnection);
+    });
+}
+
+void CacheManager::onMeasured(const Stats& measured) {
+    measuring_ = false;
+    stats_ = measured;
+    stats_.quota_bytes = quotaBytes();
+    stats_.measured = true;
+    emit statsUpdated();
+
+    if (profile_ && stats_.cache_bytes > stats_.quota_bytes * TRIM_SLACK) {
+        std::cerr << "[Tsunami] HTTP cache at " << stats_.cache_bytes / (1024 * 1024)
+                  << " MB is over its quota; clearing" << std::endl;
+        clearCache();
+    }
+}
+
+// Chromium clears on its own threads; measure again once it has had time
+void CacheManager::clearCache() {
+    if (!profile_) return;
+    profile_->clearHttpCache();
+    QTimer::singleShot(2000, this, &CacheManager::refreshStats);
+}
+
+void CacheManager::onSettingsChanged() {
+    if (!profile_) return;
+    int quota = static_cast<int>(std::min<qint64>(quotaBytes(), INT_MAX));
+    if (profile_->httpCacheMaximumSize() != quota) {
+        profile_->setHttpCacheMaximumSize(quota);
+        refreshStats();
+    }
+}
+
+void CacheManager::shutdown() {
+    stopping_->store(true);
+    trim_timer_.stop();
+    if (!Settings::instance().getAutoClearCache() || cache_path_.isEmpty()) return;
+
+    // Where an open directory cannot be renamed (Windows), the next start
+    // does it before anything opens the cache
+    if (!moveToTrash(cache_path_)) {
+        QFile marker(markerPath());
+        if (marker.open(QIODevice::WriteOnly)) marker.close();
+    }
+}
+
+} // namespace Tsunami
@@ -0,0 +1,89 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * cache_manager.h - HTTP cache quota, statistics and clearing
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+
+class QWebEngineProfile;
+
+namespace Tsunami {
+
+// Sizes the profile's disk cache from the cache_size_mb setting and keeps
+// it honest. Chromium evicts within that limit by itself; a periodic
+// measurement on a worker thread catches the cases it does not (a lowered
+// quota, an index lost in a crash) and clears the cache when it is well
+// over. Directory walks and deletes never run on the UI thread.
+//
+// Clearing on exit does not delete anything while the browser shuts down:
+// the cache directory is renamed into a trash directory, or marked for
+// that on the next start where renaming an open directory fails, and the
+// trash is deleted in the background after the next start's first paint.
+class CacheManager : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int TRIM_INTERVAL_MS = 30 * 60 * 1000;
+    // Chromium stays under its limit on its own; the cache directory also
+    // holds smaller side caches, so only a clear overshoot counts
+    static constexpr double TRIM_SLACK = 1.5;
+
+    struct Stats {
+        qint64 cache_bytes = 0;
+        qint64 cache_files = 0;
+        qint64 storage_bytes = 0;    // Cookies, local storage, IndexedDB, service workers
+        qint64 trash_bytes = 0;      // Cleared caches not yet deleted
+        qint64 quota_bytes = 0;
+        bool measured = false;
+    };
+
+    static CacheManager& instance();
+
+    // Before the profile is created; finishes a clear left pending by the
+    // last session
+    void init(const QString& cache_path, const QString& storage_path);
+    void configure(QWebEngineProfile* profile);
+    // Deferred start-up work: delete the trash, measure, start trimming
+    void startMaintenance();
+
+    qint64 quotaBytes() const;
+    const Stats& stats() const { return stats_; }
+    void refreshStats();   // statsUpdated() follows
+    void clearCache();
+
+    // From Application::run once the event loop has quit
+    void shutdown();
+
+signals:
+    void statsUpdated();
+
+private:
+    CacheManager();
+    ~CacheManager() override;
+
+    QString trashPath() const;
+    QString markerPath() const;
+    bool moveToTrash(const QString& path);
+    void emptyTrash();
+    void onMeasured(const Stats& stats);
+    void onSettingsChanged();
+
+    QString cache_path_;
+    QString storage_path_;
+    QPointer<QWebEngineProfile> profile_;
+    Stats stats_;
+    QThreadPool worker_;
+    QTimer trim_timer_;
+    bool measuring_ = false;
+    // Lets a long delete stop between files when the browser exits
+    std::shared_ptr<std::atomic<bool>> stopping_ = std::make_shared<std::atomic<bool>>(false);
+};
+
+} // namespace Tsunami
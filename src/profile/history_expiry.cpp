@@ -0,0 +1,107 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * history_expiry.cpp - Background history retention and file shrinking
+ */
+
+#include "history_expiry.h"
+#include "history/history_manager.h"
+#include "settings/settings.h"
+#include "perf/trace.h"
+#include <QThread>
+#include <iostream>
+
+namespace Tsunami {
+
+HistoryExpiry& HistoryExpiry::instance() {
+    static HistoryExpiry instance;
+    return instance;
+}
+
+HistoryExpiry::HistoryExpiry() : QObject(nullptr) {
+    worker_.setMaxThreadCount(1);
+    pass_timer_.setInterval(PASS_INTERVAL_MS);
+    pass_timer_.setTimerType(Qt::VeryCoarseTimer);
+    connect(&pass_timer_, &QTimer::timeout, this, &HistoryExpiry::runPass);
+
+    Settings& settings = Settings::instance();
+    max_age_days_ = settings.getHistoryRetentionDays();
+    max_visits_ = settings.getHistoryMaxVisits();
+    connect(&settings, &Settings::settingsChanged, this, &HistoryExpiry::onSettingsChanged);
+}
+
+HistoryExpiry::~HistoryExpiry() {
+    stopping_->store(true);
+    worker_.waitForDone();
+}
+
+void HistoryExpiry::start() {
+    runPass();
+    pass_timer_.start();
+}
+
+void HistoryExpiry::runPass() {
+    if (running_) {
+        // Settings changed mid-pass: go again with the new limits
+        rerun_ = true;
+        return;
+    }
+    running_ = true;
+
+    SeaBrowser::HistoryManager::RetentionPolicy policy;
+    policy.max_age_days = max_age_days_;
+    policy.max_visits = max_visits_;
+    auto stopping = stopping_;
+    worker_.start([this, policy, stopping]() {
+        TSUNAMI_TRACE_SCOPE("historyExpiry.pass");
+        auto& history = SeaBrowser::HistoryManager::instance();
+        // Still runs with no limits set, to vacuum what clearing left
+        history.begin_expiry(policy);
+
+        Report report;
+        while (!*stopping) {
+            auto step = history.expire_step(BATCH_ROWS, VACUUM_PAGES);
+            report.visits_removed += step.deleted;
+            report.bytes_reclaimed += step.reclaimed_bytes;
+            if (step.done) break;
+            QThread::msleep(STEP_PAUSE_MS);
+        }
+        while (!*stopping && !history.convert_step(CONVERT_ROWS)) {
+            QThread::msleep(STEP_PAUSE_MS);
+        }
+        if (*stopping) return;
+        QMetaObject::invokeMethod(this, [this, report]() { onPassFinished(report); }, Qt::QueuedConnection);
+    });
+}
+
+void HistoryExpiry::onPassFinished(const Report& report) {
+    running_ = false;
+    last_report_ = report;
+    if (report.visits_removed > 0 || report.bytes_reclaimed > 0) {
+        std::cerr << "[Tsunami] History expiry removed " << report.visits_removed << " visits and reclaimed "
+                  << report.bytes_reclaimed / 1024 << " KB" << std::endl;
+    }
+    emit passFinished();
+    if (rerun_) {
+        rerun_ = false;
+        runPass();
+    }
+}
+
+void HistoryExpiry::onSettingsChanged() {
+    Settings& settings = Settings::instance();
+    int max_age_days = settings.getHistoryRetentionDays();
+    int max_visits = settings.getHistoryMaxVisits();
+    if (max_age_days == max_age_days_ && max_visits == max_visits_) return;
+    max_age_days_ = max_age_days;
+    max_visits_ = max_visits;
+    // Nothing to do before start(); its first pass reads these
+    if (pass_timer_.isActive()) runPass();
+}
+
+void HistoryExpiry::shutdown() {
+    stopping_->store(true);
+    pass_timer_.stop();
+    worker_.waitForDone();
+}
+
+} // namespace Tsunami
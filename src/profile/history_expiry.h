@@ -0,0 +1,69 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * history_expiry.h - Background history retention and file shrinking
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+
+namespace Tsunami {
+
+// Applies the history retention settings (an age, a number of visits or
+// both) to the on-disk history. A pass runs on a worker thread in small
+// steps: each deletes a few hundred of the oldest expired visits in its
+// own transaction and hands some free pages back with an incremental
+// vacuum, then pauses, so a visit recorded meanwhile waits for one step
+// at most and the file shrinks as it goes. A file too big for start-up to
+// convert to incremental vacuum is then copied over, CONVERT_ROWS visits
+// a step. Passes run after start-up, then every PASS_INTERVAL_MS and when
+// the settings change.
+class HistoryExpiry : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int PASS_INTERVAL_MS = 60 * 60 * 1000;
+    static constexpr int BATCH_ROWS = 500;
+    static constexpr int VACUUM_PAGES = 256;
+    static constexpr int CONVERT_ROWS = 2000;
+    static constexpr int STEP_PAUSE_MS = 50;
+
+    struct Report {
+        qint64 visits_removed = 0;
+        qint64 bytes_reclaimed = 0;
+    };
+
+    static HistoryExpiry& instance();
+
+    // Deferred start-up work, after HistoryManager::init
+    void start();
+    const Report& lastReport() const { return last_report_; }
+
+    // From Application::run once the event loop has quit
+    void shutdown();
+
+signals:
+    void passFinished();   // lastReport() is current
+
+private:
+    HistoryExpiry();
+    ~HistoryExpiry() override;
+
+    void runPass();
+    void onPassFinished(const Report& report);
+    void onSettingsChanged();
+
+    QThreadPool worker_;
+    QTimer pass_timer_;
+    Report last_report_;
+    bool running_ = false;
+    bool rerun_ = false;
+    int max_age_days_ = 0;
+    int max_visits_ = 0;
+    std::shared_ptr<std::atomic<bool>> stopping_ = std::make_shared<std::atomic<bool>>(false);
+};
+
+} // namespace Tsunami
@@ -0,0 +1,69 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * private_session.cpp - Off-the-record profile and memory-only storage for private windows
+ */
+
+#include "private_session.h"
+#include "history/history_manager.h"
+#include "history/memory_history_store.h"
+#include "perf/trace.h"
+#include <QCoreApplication>
+#include <QTimer>
+#include <QWebEnginePage>
+#include <QWebEngineProfile>
+
+namespace Tsunami {
+
+PrivateSession& PrivateSession::instance() {
+    static PrivateSession instance;
+    return instance;
+}
+
+PrivateSession::PrivateSession() : QObject(nullptr) {
+}
+
+PrivateSession::~PrivateSession() = default;
+
+QWebEngineProfile* PrivateSession::profile() {
+    if (profile_) return profile_;
+    TSUNAMI_TRACE_SCOPE("profile.createPrivate");
+    // No storage name: off the record, nothing is written to disk. The
+    // application deletes it if the event loop ends before teardown() runs.
+    profile_ = new QWebEngineProfile(QCoreApplication::instance());
+    profile_->setHttpCacheType(QWebEngineProfile::MemoryHttpCache);
+    profile_->setPersistentCookiesPolicy(QWebEngineProfile::NoPersistentCookies);
+    return profile_;
+}
+
+SeaBrowser::HistoryStore& PrivateSession::history() {
+    if (!history_) history_ = std::make_unique<SeaBrowser::MemoryHistoryStore>();
+    return *history_;
+}
+
+void PrivateSession::attach(QObject* window) {
+    ++windows_;
+    connect(window, &QObject::destroyed, this, [this]() {
+        // Its pages and bridges are deleted with it; tear down once the
+        // event loop is back, unless another private window opened first
+        if (--windows_ == 0) QTimer::singleShot(0, this, &PrivateSession::teardown);
+    });
+}
+
+void PrivateSession::teardown() {
+    if (windows_ > 0) return;
+    TSUNAMI_TRACE_SCOPE("profile.privateTeardown");
+    // One arena release, however long the session was
+    history_.reset();
+    if (profile_) {
+        profile_->deleteLater();
+        profile_ = nullptr;
+    }
+}
+
+SeaBrowser::HistoryStore& PrivateSession::historyFor(const QWebEnginePage* page) {
+    PrivateSession& session = instance();
+    if (page && session.profile_ && page->profile() == session.profile_) return session.history();
+    return SeaBrowser::HistoryManager::instance();
+}
+
+} // namespace Tsunami
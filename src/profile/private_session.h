@@ -0,0 +1,57 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * private_session.h - Off-the-record profile and memory-only storage for private windows
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <memory>
+
+class QWebEngineProfile;
+class QWebEnginePage;
+
+namespace SeaBrowser {
+class HistoryStore;
+class MemoryHistoryStore;
+}
+
+namespace Tsunami {
+
+// Everything private windows share: one off-the-record profile (cookies,
+// cache and site storage in memory) and the in-memory history they record
+// into. Created with the first private window; when the last one closes,
+// the profile is deleted and the history's arena is released in one go,
+// so nothing of the session survives it, on disk or in memory.
+//
+// Bookmarks are explicit saves and go to the normal bookmarks, as in other
+// browsers.
+class PrivateSession : public QObject {
+    Q_OBJECT
+public:
+    static PrivateSession& instance();
+
+    // Both valid between the first attach() and the last window closing
+    QWebEngineProfile* profile();
+    SeaBrowser::HistoryStore& history();
+
+    // Private windows call this once; the session ends when all are destroyed
+    void attach(QObject* window);
+    bool isActive() const { return windows_ > 0; }
+
+    // The history a page's visits and tsunami://history belong to
+    static SeaBrowser::HistoryStore& historyFor(const QWebEnginePage* page);
+
+private:
+    PrivateSession();
+    ~PrivateSession() override;
+
+    void teardown();
+
+    int windows_ = 0;
+    QPointer<QWebEngineProfile> profile_;
+    std::unique_ptr<SeaBrowser::MemoryHistoryStore> history_;
+};
+
+} // namespace Tsunami
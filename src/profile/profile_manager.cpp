@@ -0,0 +1,40 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * profile_manager.cpp - The persistent web profile shared by all tabs
+ */
+
+#include "profile_manager.h"
+#include "profile/cache_manager.h"
+#include "perf/trace.h"
+#include <QCoreApplication>
+#include <QWebEngineProfile>
+
+namespace Tsunami {
+
+ProfileManager& ProfileManager::instance() {
+    static ProfileManager instance;
+    return instance;
+}
+
+ProfileManager::ProfileManager() : QObject(nullptr) {
+}
+
+void ProfileManager::init(const QString& storage_path, const QString& cache_path) {
+    storage_path_ = storage_path;
+    cache_path_ = cache_path;
+}
+
+QWebEngineProfile* ProfileManager::defaultProfile() {
+    if (profile_) return profile_;
+    TSUNAMI_TRACE_SCOPE("profile.create");
+
+    // Parented to the application so it outlives every page
+    profile_ = new QWebEngineProfile(QStringLiteral("Default"), QCoreApplication::instance());
+    if (!storage_path_.isEmpty()) profile_->setPersistentStoragePath(storage_path_);
+    if (!cache_path_.isEmpty()) profile_->setCachePath(cache_path_);
+    profile_->setPersistentCookiesPolicy(QWebEngineProfile::AllowPersistentCookies);
+    CacheManager::instance().configure(profile_);
+    return profile_;
+}
+
+} // namespace Tsunami
@@ -0,0 +1,34 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * profile_manager.h - The persistent web profile shared by all tabs
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+class QWebEngineProfile;
+
+namespace Tsunami {
+
+// Qt 6's default profile is off the record: no disk cache, no persistent
+// cookies. Tabs use this named, on-disk profile instead. It is created on
+// first use, after init() has set where it keeps its data and cache.
+class ProfileManager : public QObject {
+    Q_OBJECT
+public:
+    static ProfileManager& instance();
+
+    void init(const QString& storage_path, const QString& cache_path);
+    QWebEngineProfile* defaultProfile();
+
+private:
+    ProfileManager();
+
+    QString storage_path_;
+    QString cache_path_;
+    QWebEngineProfile* profile_ = nullptr;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,252 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * auto_reload.cpp - Periodic tab reloads driven by one timer wheel
+ */
+
+#include "auto_reload.h"
+#include "settings/settings.h"
+#include "web_view.h"
+#include "perf/trace.h"
+#include <QEvent>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QWebEngineProfile>
+#include <QWebEngineView>
+#include <algorithm>
+
+namespace Tsunami {
+
+namespace {
+
+const char* const KEY_PROPERTY = "tsunamiReloadKey";
+
+} // namespace
+
+AutoReloadScheduler& AutoReloadScheduler::instance() {
+    static AutoReloadScheduler instance;
+    return instance;
+}
+
+AutoReloadScheduler::AutoReloadScheduler()
+    : QObject(nullptr)
+    , wakeup_(new QTimer(this))
+{
+    clock_.start();
+    wakeup_->setSingleShot(true);
+    wakeup_->setTimerType(Qt::CoarseTimer);
+    connect(wakeup_, &QTimer::timeout, this, &AutoReloadScheduler::onTick);
+
+    Settings& settings = Settings::instance();
+    enabled_ = settings.getAutoReload();
+    check_changes_ = settings.getAutoReloadCheckChanges();
+    interval_ = std::max(1, settings.getAutoReloadInterval());
+    connect(&settings, &Settings::settingsChanged, this, &AutoReloadScheduler::onSettingsChanged);
+}
+
+uint64_t AutoReloadScheduler::nowTick() const {
+    return static_cast<uint64_t>(clock_.elapsed() / TICK_MS);
+}
+
+// Spreads tabs over the first quarter of the interval; the multiplier
+// scatters consecutive keys
+uint64_t AutoReloadScheduler::phaseTicks(quint64 key) const {
+    uint64_t spread = std::max(1, interval_ / 4);
+    return (key * 2654435761u) % spread;
+}
+
+void AutoReloadScheduler::watch(QWebEngineView* view) {
+    quint64 key = next_key_++;
+    entries_.insert(key, Entry{view});
+    view->setProperty(KEY_PROPERTY, key);
+    view->installEventFilter(this);
+
+    // Deadlines run from the end of the last load, whoever started it
+    connect(view, &QWebEngineView::loadFinished, this, [this, key]() {
+        auto it = entries_.find(key);
+        if (it == entries_.end()) return;
+        it->due = false;
+        if (enabled_) arm(key, interval_);
+    });
+    connect(view, &QObject::destroyed, this, [this, key]() {
+        auto it = entries_.find(key);
+        if (it == entries_.end()) return;
+        if (it->timer) wheel_.cancel(it->timer);
+        entries_.erase(it);
+    });
+
+    if (enabled_) arm(key, interval_ + phaseTicks(key));
+}
+
+void AutoReloadScheduler::arm(quint64 key, uint64_t delay_ticks) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return;
+    if (it->timer) wheel_.cancel(it->timer);
+
+    uint64_t now = nowTick();
+    // Catch the wheel up first so the deadline is measured from now
+    if (wheel_.now() < now) {
+        wheel_.advance(now, expired_);
+    }
+    it->timer = wheel_.schedule(now + delay_ticks, key);
+    scheduleWakeup();
+}
+
+void AutoReloadScheduler::armAll() {
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        arm(it.key(), interval_ + phaseTicks(it.key()));
+    }
+}
+
+void AutoReloadScheduler::disarmAll() {
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->timer) wheel_.cancel(it->timer);
+        it->timer = 0;
+        it->due = false;
+    }
+    expired_.clear();
+    wakeup_->stop();
+}
+
+void AutoReloadScheduler::scheduleWakeup() {
+    // arm() caught the wheel up and something expired on the way
+    if (!expired_.empty()) {
+        wakeup_->start(0);
+        return;
+    }
+    std::optional<uint64_t> wakeup = wheel_.next_wakeup();
+    if (!wakeup) {
+        wakeup_->stop();
+        return;
+    }
+    qint64 delay = static_cast<qint64>(*wakeup) * TICK_MS - clock_.elapsed();
+    wakeup_->start(static_cast<int>(std::clamp<qint64>(delay, 0, 24 * 3600 * 1000)));
+}
+
+void AutoReloadScheduler::onTick() {
+    TSUNAMI_TRACE_SCOPE("autoReload.tick");
+    // arm() may have advanced the wheel already; keep what it expired
+    wheel_.advance(nowTick(), expired_);
+    std::vector<uint64_t> expired;
+    expired.swap(expired_);
+
+    int started = 0;
+    for (uint64_t key : expired) {
+        auto it = entries_.find(key);
+        if (it == entries_.end()) continue;
+        it->timer = 0;
+        if (started >= MAX_RELOADS_PER_TICK) {
+            // Over the cap: queue behind this tick's reloads
+            arm(key, 1 + (started++ - MAX_RELOADS_PER_TICK) / MAX_RELOADS_PER_TICK);
+            continue;
+        }
+        if (fire(key)) ++started;
+    }
+    scheduleWakeup();
+}
+
+// True when a reload or change check was started
+bool AutoReloadScheduler::fire(quint64 key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end() || !enabled_) return false;
+
+    QWebEngineView* view = it->view;
+    if (!view) return false;
+    QUrl url = view->url();
+    // Internal pages are never reloaded; navigating away re-arms the tab
+    if (url.isEmpty() || WebView::isInternalUrl(url)) return false;
+
+    if (!view->isVisible() || view->page()->lifecycleState() != QWebEnginePage::LifecycleState::Active) {
+        it->due = true;
+        return false;
+    }
+
+    if (check_changes_ && (url.scheme() == "http" || url.scheme() == "https")) {
+        checkForChanges(key);
+    } else {
+        reload(key);
+    }
+    return true;
+}
+
+void AutoReloadScheduler::reload(quint64 key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end() || !it->view) return;
+    it->view->reload();
+    // Fallback in case the load never reports finished
+    arm(key, interval_);
+}
+
+// A HEAD request with the validators from the previous check. Only a 304,
+// or a 200 with the same ETag / Last-Modified, skips the reload; anything
+// the check cannot vouch for falls back to reloading.
+void AutoReloadScheduler::checkForChanges(quint64 key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->checking) return;
+
+    if (!network_) network_ = new QNetworkAccessManager(this);
+    QWebEngineView* view = it->view;
+    QNetworkRequest request(view->url());
+    request.setHeader(QNetworkRequest::UserAgentHeader, view->page()->profile()->httpUserAgent());
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    if (!it->etag.isEmpty()) request.setRawHeader("If-None-Match", it->etag);
+    if (!it->last_modified.isEmpty()) request.setRawHeader("If-Modified-Since", it->last_modified);
+
+    it->checking = true;
+    QNetworkReply* reply = network_->head(request);
+    connect(reply, &QNetworkReply::finished, this, [this, key, reply]() {
+        reply->deleteLater();
+        auto it = entries_.find(key);
+        if (it == entries_.end()) return;
+        it->checking = false;
+        if (!enabled_) return;
+
+        int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        QByteArray etag = reply->rawHeader("ETag");
+        QByteArray last_modified = reply->rawHeader("Last-Modified");
+
+        bool unchanged = status == 304;
+        if (status == 200 && (!etag.isEmpty() || !last_modified.isEmpty())) {
+            unchanged = etag == it->etag && last_modified == it->last_modified;
+            it->etag = etag;
+            it->last_modified = last_modified;
+        }
+
+        if (unchanged) {
+            arm(key, interval_);
+        } else {
+            reload(key);
+        }
+    });
+}
+
+bool AutoReloadScheduler::eventFilter(QObject* obj, QEvent* event) {
+    if (event->type() == QEvent::Show) {
+        quint64 key = obj->property(KEY_PROPERTY).toULongLong();
+        auto it = entries_.find(key);
+        if (it != entries_.end() && it->due) {
+            it->due = false;
+            // Through the wheel, so the per-tick cap applies
+            arm(key, 1);
+        }
+    }
+    return QObject::eventFilter(obj, event);
+}
+
+void AutoReloadScheduler::onSettingsChanged() {
+    Settings& settings = Settings::instance();
+    bool enabled = settings.getAutoReload();
+    int interval = std::max(1, settings.getAutoReloadInterval());
+    check_changes_ = settings.getAutoReloadCheckChanges();
+    if (enabled == enabled_ && interval == interval_) return;
+
+    enabled_ = enabled;
+    interval_ = interval;
+    if (enabled_) {
+        armAll();
+    } else {
+        disarmAll();
+    }
+}
+
+} // namespace Tsunami
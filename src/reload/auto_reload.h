@@ -0,0 +1,81 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * auto_reload.h - Periodic tab reloads driven by one timer wheel
+ */
+
+#pragma once
+
+#include "reload/timer_wheel.h"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <vector>
+
+class QNetworkAccessManager;
+class QWebEngineView;
+
+namespace Tsunami {
+
+// Reloads every watched tab auto_reload_interval seconds after its last
+// load finished. All deadlines share one TimerWheel and one QTimer that
+// sleeps until the wheel's next wakeup, rather than one timer per tab.
+// Hidden and discarded tabs are not reloaded; they are marked due and
+// reload as soon as they are shown. Deadlines get a per-tab phase offset
+// and at most MAX_RELOADS_PER_TICK reloads start in any one second, so a
+// restored session of dashboards does not reload in one burst.
+class AutoReloadScheduler : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int TICK_MS = 1000;
+    static constexpr int MAX_RELOADS_PER_TICK = 2;
+
+    static AutoReloadScheduler& instance();
+
+    void watch(QWebEngineView* view);
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* event) override;
+
+private slots:
+    void onTick();
+    void onSettingsChanged();
+
+private:
+    struct Entry {
+        QPointer<QWebEngineView> view;
+        TimerWheel::TimerId timer = 0;
+        QByteArray etag;
+        QByteArray last_modified;
+        bool due = false;        // Expired while hidden
+        bool checking = false;   // HEAD request in flight
+    };
+
+    AutoReloadScheduler();
+
+    uint64_t nowTick() const;
+    uint64_t phaseTicks(quint64 key) const;
+    void arm(quint64 key, uint64_t delay_ticks);
+    void armAll();
+    void disarmAll();
+    void scheduleWakeup();
+    bool fire(quint64 key);
+    void reload(quint64 key);
+    void checkForChanges(quint64 key);
+
+    TimerWheel wheel_;
+    QHash<quint64, Entry> entries_;
+    quint64 next_key_ = 1;
+    QElapsedTimer clock_;
+    QTimer* wakeup_ = nullptr;
+    QNetworkAccessManager* network_ = nullptr;
+    std::vector<uint64_t> expired_;
+
+    bool enabled_ = false;
+    bool check_changes_ = false;
+    int interval_ = 30;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,140 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * crash_recovery.cpp - Reloading tabs whose renderer crashed or was killed
+ */
+
+#include "crash_recovery.h"
+#include "perf/trace.h"
+#include <QEvent>
+#include <QTimer>
+#include <QWebEngineProfile>
+#include <QWebEngineView>
+#include <iostream>
+
+namespace Tsunami {
+
+namespace {
+
+const char* const KEY_PROPERTY = "tsunamiCrashKey";
+constexpr int SIGKILL_NUMBER = 9;
+
+const char* causeName(CrashRecovery::Cause cause) {
+    switch (cause) {
+    case CrashRecovery::Cause::OutOfMemory: return "killed, likely out of memory";
+    case CrashRecovery::Cause::EndedByUser: return "ended from the task manager";
+    default: return "crashed";
+    }
+}
+
+} // namespace
+
+const char* const CrashRecovery::ENDED_PROPERTY = "tsunamiEndedByUser";
+
+CrashRecovery& CrashRecovery::instance() {
+    static CrashRecovery instance;
+    return instance;
+}
+
+CrashRecovery::CrashRecovery() : QObject(nullptr) {
+}
+
+void CrashRecovery::watch(QWebEngineView* view) {
+    quint64 key = next_key_++;
+    Entry entry{view};
+    entry.retry = new QTimer(view);
+    entry.retry->setSingleShot(true);
+    connect(entry.retry, &QTimer::timeout, this, [this, key]() { recover(key); });
+    entries_.insert(key, entry);
+    view->setProperty(KEY_PROPERTY, key);
+    view->installEventFilter(this);
+
+    connect(view->page(), &QWebEnginePage::renderProcessTerminated, this,
+            [this, key](QWebEnginePage::RenderProcessTerminationStatus status, int exit_code) {
+                onTerminated(key, status, exit_code);
+            });
+    connect(view, &QObject::destroyed, this, [this, key]() { entries_.remove(key); });
+}
+
+// Chromium reports the kernel's OOM killer, and any other SIGKILL, as a
+// kill; a renderer that hits its V8 heap limit aborts and shows as a crash
+CrashRecovery::Cause CrashRecovery::classify(QWebEnginePage::RenderProcessTerminationStatus status,
+                                             int exit_code) {
+    if (status == QWebEnginePage::KilledTerminationStatus || exit_code == SIGKILL_NUMBER ||
+        exit_code == 128 + SIGKILL_NUMBER) {
+        return Cause::OutOfMemory;
+    }
+    return Cause::Crash;
+}
+
+void CrashRecovery::onTerminated(quint64 key, QWebEnginePage::RenderProcessTerminationStatus status,
+                                 int exit_code) {
+    // Also emitted when a page is closed or discarded
+    if (status == QWebEnginePage::NormalTerminationStatus) return;
+    auto it = entries_.find(key);
+    if (it == entries_.end() || !it->view) return;
+    QWebEngineView* view = it->view;
+
+    Cause cause = classify(status, exit_code);
+    if (view->property(ENDED_PROPERTY).toBool()) {
+        view->setProperty(ENDED_PROPERTY, QVariant());
+        cause = Cause::EndedByUser;
+    }
+
+    QUrl url = view->url();
+    bool off_the_record = view->page()->profile()->isOffTheRecord();
+    std::cerr << "[Tsunami] Renderer " << causeName(cause) << " (exit code " << exit_code << ")"
+              << (off_the_record ? "" : " on " + url.host().toStdString()) << std::endl;
+    if (cause == Cause::EndedByUser) {
+        it->retry->stop();
+        it->pending = false;
+        return;
+    }
+
+    if (!off_the_record && !url.host().isEmpty()) {
+        SiteCrashes& site = sites_[url.host()];
+        if (cause == Cause::OutOfMemory) {
+            ++site.oom_kills;
+        } else {
+            ++site.crashes;
+        }
+    }
+
+    if (it->last_crash.isValid() && it->last_crash.elapsed() > STABLE_MS) it->streak = 0;
+    it->last_crash.start();
+    if (++it->streak > MAX_ATTEMPTS) {
+        it->retry->stop();
+        it->pending = false;
+        return;
+    }
+
+    if (view->isVisible()) {
+        it->retry->start(BASE_DELAY_MS << (it->streak - 1));
+        return;
+    }
+    // A discarded page loads again by itself when it is next shown; where
+    // Chromium refuses, the Show event reloads it instead
+    view->page()->setLifecycleState(QWebEnginePage::LifecycleState::Discarded);
+    it->pending = view->page()->lifecycleState() != QWebEnginePage::LifecycleState::Discarded;
+}
+
+void CrashRecovery::recover(quint64 key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end() || !it->view) return;
+    TSUNAMI_TRACE_SCOPE("crashRecovery.reload");
+    it->pending = false;
+    it->view->reload();
+}
+
+bool CrashRecovery::eventFilter(QObject* obj, QEvent* event) {
+    if (event->type() == QEvent::Show) {
+        quint64 key = obj->property(KEY_PROPERTY).toULongLong();
+        auto it = entries_.find(key);
+        if (it != entries_.end() && it->pending) {
+            it->pending = false;
+            it->retry->start(0);
+        }
+    }
+    return QObject::eventFilter(obj, event);
+}
+
+} // namespace Tsunami
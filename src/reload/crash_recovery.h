@@ -0,0 +1,74 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * crash_recovery.h - Reloading tabs whose renderer crashed or was killed
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QWebEnginePage>
+
+class QTimer;
+class QWebEngineView;
+
+namespace Tsunami {
+
+// Without this a renderer that crashes, or that the kernel kills for
+// memory, leaves its tabs blank until the user reloads each one. A
+// visible tab is reloaded after a delay that doubles with each crash in a
+// row (a streak ends once the tab has stayed up for STABLE_MS), and is
+// left alone after MAX_ATTEMPTS so a page that always crashes does not
+// loop. A hidden tab is discarded instead and loads again when shown, so
+// an out-of-memory kill of a shared renderer costs one reload, not one
+// per tab. A renderer ended from tsunami://tasks is not reloaded.
+class CrashRecovery : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int BASE_DELAY_MS = 1000;
+    static constexpr int MAX_ATTEMPTS = 5;
+    static constexpr qint64 STABLE_MS = 60 * 1000;
+
+    enum class Cause { Crash, OutOfMemory, EndedByUser };
+
+    struct SiteCrashes {
+        int crashes = 0;
+        int oom_kills = 0;
+    };
+
+    static CrashRecovery& instance();
+    // Set on a view just before its renderer is ended on purpose
+    static const char* const ENDED_PROPERTY;
+
+    void watch(QWebEngineView* view);
+
+    // Counts for this session; private tabs are not recorded
+    SiteCrashes siteCrashes(const QString& host) const { return sites_.value(host); }
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* event) override;
+
+private:
+    struct Entry {
+        QPointer<QWebEngineView> view;
+        QTimer* retry = nullptr;
+        QElapsedTimer last_crash;
+        int streak = 0;
+        bool pending = false;    // Hidden and not discarded; reload when shown
+    };
+
+    CrashRecovery();
+
+    static Cause classify(QWebEnginePage::RenderProcessTerminationStatus status, int exit_code);
+    void onTerminated(quint64 key, QWebEnginePage::RenderProcessTerminationStatus status, int exit_code);
+    void recover(quint64 key);
+
+    QHash<quint64, Entry> entries_;
+    QHash<QString, SiteCrashes> sites_;
+    quint64 next_key_ = 1;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,165 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * timer_wheel.cpp - Hierarchical timer wheel for per-tab deadlines
+ */
+
+#include "timer_wheel.h"
+#include <algorithm>
+#include <bit>
+
+namespace Tsunami {
+
+namespace {
+
+constexpr uint64_t levelMask(int level) {
+    return (uint64_t(1) << (TimerWheel::SLOT_BITS * level)) - 1;
+}
+
+} // namespace
+
+TimerWheel::TimerWheel(uint64_t now) : now_(now) {
+    heads_.fill(NIL);
+}
+
+TimerWheel::TimerId TimerWheel::schedule(uint64_t deadline, uint64_t key) {
+    uint32_t index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back(Node{});
+        nodes_[index].generation = 1;
+    }
+
+    Node& node = nodes_[index];
+    // The current tick has already been processed
+    node.deadline = std::max(deadline, now_ + 1);
+    node.key = key;
+    place(index);
+    ++size_;
+    return (uint64_t(node.generation) << 32) | index;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    uint32_t index = static_cast<uint32_t>(id);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (index >= nodes_.size()) return false;
+    Node& node = nodes_[index];
+    if (node.slot == NIL || node.generation != generation) return false;
+    unlink(index);
+    release(index);
+    return true;
+}
+
+void TimerWheel::place(uint32_t index) {
+    const Node& node = nodes_[index];
+    uint64_t delta = node.deadline - now_;
+    uint64_t deadline = node.deadline;
+    if (delta >= MAX_SPAN) {
+        // Parked in the top level; it is re-placed on every cascade until
+        // it comes within range
+        deadline = now_ + MAX_SPAN - 1;
+        delta = MAX_SPAN - 1;
+    }
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta > levelMask(level + 1)) ++level;
+    uint32_t slot = static_cast<uint32_t>((deadline >> (SLOT_BITS * level)) & (SLOTS - 1));
+    link(index, level * SLOTS + slot);
+}
+
+void TimerWheel::link(uint32_t index, uint32_t slot) {
+    Node& node = nodes_[index];
+    node.slot = slot;
+    node.prev = NIL;
+    node.next = heads_[slot];
+    if (node.next != NIL) nodes_[node.next].prev = index;
+    heads_[slot] = index;
+    occupied_[slot / SLOTS] |= uint64_t(1) << (slot % SLOTS);
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.slot] = node.next;
+    }
+    if (node.next != NIL) nodes_[node.next].prev = node.prev;
+    if (heads_[node.slot] == NIL) {
+        occupied_[node.slot / SLOTS] &= ~(uint64_t(1) << (node.slot % SLOTS));
+    }
+    node.slot = NIL;
+}
+
+void TimerWheel::release(uint32_t index) {
+    // A stale id must not cancel whatever reuses the node
+    ++nodes_[index].generation;
+    free_.push_back(index);
+    --size_;
+}
+
+void TimerWheel::cascade(int level) {
+    uint32_t slot = level * SLOTS + static_cast<uint32_t>((now_ >> (SLOT_BITS * level)) & (SLOTS - 1));
+    uint32_t index = heads_[slot];
+    heads_[slot] = NIL;
+    occupied_[level] &= ~(uint64_t(1) << (slot % SLOTS));
+    while (index != NIL) {
+        uint32_t next = nodes_[index].next;
+        place(index);
+        index = next;
+    }
+}
+
+void TimerWheel::tick(std::vector<uint64_t>& expired) {
+    ++now_;
+    for (int level = LEVELS - 1; level > 0; --level) {
+        if ((now_ & levelMask(level)) == 0) cascade(level);
+    }
+
+    uint32_t slot = static_cast<uint32_t>(now_ & (SLOTS - 1));
+    uint32_t index = heads_[slot];
+    heads_[slot] = NIL;
+    occupied_[0] &= ~(uint64_t(1) << slot);
+    while (index != NIL) {
+        uint32_t next = nodes_[index].next;
+        nodes_[index].slot = NIL;
+        expired.push_back(nodes_[index].key);
+        release(index);
+        index = next;
+    }
+}
+
+std::optional<uint64_t> TimerWheel::next_wakeup() const {
+    if (size_ == 0) return std::nullopt;
+
+    std::optional<uint64_t> wakeup;
+    if (occupied_[0]) {
+        int start = static_cast<int>((now_ + 1) & (SLOTS - 1));
+        uint64_t rotated = std::rotr(occupied_[0], start);
+        wakeup = now_ + 1 + static_cast<uint64_t>(std::countr_zero(rotated));
+    }
+
+    bool upper = std::any_of(occupied_.begin() + 1, occupied_.end(), [](uint64_t bits) { return bits != 0; });
+    if (upper) {
+        uint64_t next_cascade = (now_ | levelMask(1)) + 1;
+        if (!wakeup || next_cascade < *wakeup) wakeup = next_cascade;
+    }
+    return wakeup;
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<uint64_t>& expired) {
+    while (now_ < now) {
+        // Skip straight over ticks with nothing to fire or cascade
+        std::optional<uint64_t> wakeup = next_wakeup();
+        if (!wakeup || *wakeup > now) {
+            now_ = now;
+            return;
+        }
+        now_ = *wakeup - 1;
+        tick(expired);
+    }
+}
+
+} // namespace Tsunami
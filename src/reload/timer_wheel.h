@@ -0,0 +1,71 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * timer_wheel.h - Hierarchical timer wheel for per-tab deadlines
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Tsunami {
+
+// Four levels of 64 slots. Scheduling and cancelling are O(1); a timer is
+// touched again only when its level rolls over and cascades it one level
+// down, so thousands of long deadlines cost nothing between expiries.
+// Ticks are abstract; the caller decides what one tick means.
+class TimerWheel {
+public:
+    using TimerId = uint64_t;   // 0 is never a valid id
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr int LEVELS = 4;
+    static constexpr uint64_t MAX_SPAN = uint64_t(1) << (SLOT_BITS * LEVELS);
+
+    explicit TimerWheel(uint64_t now = 0);
+
+    // Deadlines at or before the current tick fire on the next advance()
+    TimerId schedule(uint64_t deadline, uint64_t key);
+    bool cancel(TimerId id);
+
+    // Moves time forward to `now`, appending the keys of expired timers in
+    // deadline order
+    void advance(uint64_t now, std::vector<uint64_t>& expired);
+
+    // Earliest tick at which advance() can have work to do: the next
+    // level-0 expiry or the next cascade, whichever is sooner
+    std::optional<uint64_t> next_wakeup() const;
+
+    uint64_t now() const { return now_; }
+    size_t size() const { return size_; }
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node {
+        uint64_t deadline = 0;
+        uint64_t key = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t slot = NIL;        // level * SLOTS + index, NIL when free
+        uint32_t generation = 0;
+    };
+
+    void place(uint32_t index);
+    void link(uint32_t index, uint32_t slot);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(int level);
+    void tick(std::vector<uint64_t>& expired);
+
+    uint64_t now_;
+    size_t size_ = 0;
+    std::array<uint32_t, SLOTS * LEVELS> heads_;
+    std::array<uint64_t, LEVELS> occupied_ = {};   // One bit per non-empty slot
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,119 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * scheme_handler.cpp - tsunami:// internal page scheme implementation
+ */
+
+#include "scheme_handler.h"
+#include "application.h"
+#include "perf/trace.h"
+#include "favicons/favicon_service.h"
+#include "thumbnails/thumbnail_cache.h"
+#include <QWebEngineUrlScheme>
+#include <QWebEngineProfile>
+#include <QFile>
+#include <QBuffer>
+#include <QUrlQuery>
+
+namespace Tsunami {
+
+namespace {
+
+// Only internal pages and the browser itself may ask for stored favicons
+// and snapshots: whether one loads would tell any web page which sites
+// were visited, and a snapshot would show what was on them
+bool fromInternalPage(const QWebEngineUrlRequestJob* job) {
+    QUrl initiator = job->initiator();
+    return initiator.isEmpty() || initiator.scheme() == QLatin1String(SchemeHandler::schemeName());
+}
+
+} // namespace
+
+SchemeHandler::SchemeHandler(QObject* parent)
+    : QWebEngineUrlSchemeHandler(parent)
+{
+}
+
+void SchemeHandler::registerScheme() {
+    QWebEngineUrlScheme scheme(schemeName());
+    scheme.setSyntax(QWebEngineUrlScheme::Syntax::Host);
+    scheme.setFlags(QWebEngineUrlScheme::SecureScheme |
+                    QWebEngineUrlScheme::LocalAccessAllowed);
+    QWebEngineUrlScheme::registerScheme(scheme);
+}
+
+void SchemeHandler::install(QWebEngineProfile* profile) {
+    if (!profile || profile->urlSchemeHandler(schemeName())) return;
+    profile->installUrlSchemeHandler(schemeName(), new SchemeHandler(profile));
+}
+
+void SchemeHandler::requestStarted(QWebEngineUrlRequestJob* job) {
+    TSUNAMI_TRACE_SCOPE("scheme.request");
+
+    QString page = job->requestUrl().host();
+    if (page == QLatin1String("favicon")) {
+        serveFavicon(job);
+        return;
+    }
+    if (page == QLatin1String("thumbnail")) {
+        serveThumbnail(job);
+        return;
+    }
+    if (page.isEmpty() || page.contains('/') || page.contains("..")) {
+        job->fail(QWebEngineUrlRequestJob::UrlInvalid);
+        return;
+    }
+
+    QString path = Application::get_resource_path("pages/" + page + ".html");
+    if (path.isEmpty()) {
+        job->fail(QWebEngineUrlRequestJob::UrlNotFound);
+        return;
+    }
+
+    QFile* file = new QFile(path, job);
+    if (!file->open(QIODevice::ReadOnly)) {
+        job->fail(QWebEngineUrlRequestJob::RequestFailed);
+        return;
+    }
+    job->reply("text/html", file);
+}
+
+// tsunami://favicon?url=<page url>: the stored icon, read off the UI thread
+void SchemeHandler::serveFavicon(QWebEngineUrlRequestJob* job) {
+    if (!fromInternalPage(job)) {
+        job->fail(QWebEngineUrlRequestJob::RequestDenied);
+        return;
+    }
+    QUrl page_url(QUrlQuery(job->requestUrl()).queryItemValue("url", QUrl::FullyDecoded));
+    FaviconService::instance().fetchEncoded(page_url, job, [job](const QByteArray& png) {
+        if (png.isEmpty()) {
+            job->fail(QWebEngineUrlRequestJob::UrlNotFound);
+            return;
+        }
+        QBuffer* buffer = new QBuffer(job);
+        buffer->setData(png);
+        buffer->open(QIODevice::ReadOnly);
+        job->reply("image/png", buffer);
+    });
+}
+
+// tsunami://thumbnail?url=<page url>: the last snapshot of that page
+void SchemeHandler::serveThumbnail(QWebEngineUrlRequestJob* job) {
+    if (!fromInternalPage(job)) {
+        job->fail(QWebEngineUrlRequestJob::RequestDenied);
+        return;
+    }
+    QUrl page_url(QUrlQuery(job->requestUrl()).queryItemValue("url", QUrl::FullyDecoded));
+    ThumbnailCache::instance().fetchEncoded(page_url, job,
+        [job](const QByteArray& data, const QByteArray& mime_type) {
+            if (data.isEmpty()) {
+                job->fail(QWebEngineUrlRequestJob::UrlNotFound);
+                return;
+            }
+            QBuffer* buffer = new QBuffer(job);
+            buffer->setData(data);
+            buffer->open(QIODevice::ReadOnly);
+            job->reply(mime_type, buffer);
+        });
+}
+
+} // namespace Tsunami
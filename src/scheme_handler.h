@@ -0,0 +1,36 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * scheme_handler.h - tsunami:// internal page scheme
+ */
+
+#pragma once
+
+#include <QWebEngineUrlSchemeHandler>
+#include <QWebEngineUrlRequestJob>
+#include <QByteArray>
+
+class QWebEngineProfile;
+
+namespace Tsunami {
+
+// Serves tsunami://<page> from data/pages/<page>.html, and stored favicons
+// and tab snapshots from tsunami://favicon?url= and tsunami://thumbnail?url=
+class SchemeHandler : public QWebEngineUrlSchemeHandler {
+    Q_OBJECT
+public:
+    explicit SchemeHandler(QObject* parent = nullptr);
+
+    static QByteArray schemeName() { return QByteArrayLiteral("tsunami"); }
+
+    // Must run before the QApplication is constructed
+    static void registerScheme();
+    static void install(QWebEngineProfile* profile);
+
+    void requestStarted(QWebEngineUrlRequestJob* job) override;
+
+private:
+    void serveFavicon(QWebEngineUrlRequestJob* job);
+    void serveThumbnail(QWebEngineUrlRequestJob* job);
+};
+
+} // namespace Tsunami
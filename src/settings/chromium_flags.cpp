@@ -0,0 +1,78 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * chromium_flags.cpp - Process model and memory settings passed to Chromium
+ */
+
+#include "settings/chromium_flags.h"
+#include "settings/settings.h"
+#include <QByteArray>
+
+namespace Tsunami {
+
+namespace {
+
+constexpr char FLAGS_VARIABLE[] = "QTWEBENGINE_CHROMIUM_FLAGS";
+
+// Switches that choose a process model; any one of them set by hand
+// replaces the setting
+const char* const PROCESS_MODEL_SWITCHES[] = {
+    "--site-per-process", "--process-per-site", "--process-per-tab", "--single-process",
+};
+
+QString switchName(const QString& flag) {
+    int equals = flag.indexOf('=');
+    return equals < 0 ? flag : flag.left(equals);
+}
+
+bool isProcessModel(const QString& name) {
+    for (const char* model : PROCESS_MODEL_SWITCHES) {
+        if (name == QLatin1String(model)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+QStringList ChromiumFlags::fromSettings(const Settings& settings) {
+    QStringList flags;
+    // Site-per-process is Chromium's default on desktop
+    if (settings.getProcessModel() == QLatin1String("process-per-site")) {
+        flags << QStringLiteral("--process-per-site");
+    }
+    // A soft limit: Chromium still separates sites it must isolate
+    if (settings.getRendererProcessLimit() > 0) {
+        flags << QStringLiteral("--renderer-process-limit=%1").arg(settings.getRendererProcessLimit());
+    }
+    if (settings.getJsHeapLimitMb() > 0) {
+        flags << QStringLiteral("--js-flags=--max-old-space-size=%1").arg(settings.getJsHeapLimitMb());
+    }
+    return flags;
+}
+
+void ChromiumFlags::apply(const Settings& settings) {
+    QStringList existing = QString::fromLocal8Bit(qgetenv(FLAGS_VARIABLE)).split(' ', Qt::SkipEmptyParts);
+    bool model_set = false;
+    QStringList set_names;
+    for (const QString& flag : existing) {
+        QString name = switchName(flag);
+        model_set = model_set || isProcessModel(name);
+        set_names << name;
+    }
+
+    QStringList flags;
+    for (const QString& flag : fromSettings(settings)) {
+        QString name = switchName(flag);
+        if (set_names.contains(name) || (model_set && isProcessModel(name))) continue;
+        flags << flag;
+    }
+    if (flags.isEmpty()) return;
+
+    flags += existing;
+    qputenv(FLAGS_VARIABLE, flags.join(' ').toLocal8Bit());
+}
+
+QString ChromiumFlags::effective() {
+    return QString::fromLocal8Bit(qgetenv(FLAGS_VARIABLE));
+}
+
+} // namespace Tsunami
@@ -0,0 +1,28 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * chromium_flags.h - Process model and memory settings passed to Chromium
+ */
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+namespace Tsunami {
+
+class Settings;
+
+// Chromium reads QTWEBENGINE_CHROMIUM_FLAGS once, when the first profile
+// is created, so these settings apply from the next start. Flags already
+// in the environment win over the settings, so a wrapper script or a
+// packager's defaults are never silently overridden.
+class ChromiumFlags {
+public:
+    static QStringList fromSettings(const Settings& settings);
+    // Before the first profile or page exists
+    static void apply(const Settings& settings);
+    // The flags Chromium was started with
+    static QString effective();
+};
+
+} // namespace Tsunami
@@ -1,4 +1,5 @@
 #include "settings.h"
+#include "perf/trace.h"
 #include <QtCore/QStandardPaths>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
@@ -25,6 +26,7 @@ QString Settings::getConfigPath() const {
 }
 
 void Settings::load() {
+    TSUNAMI_TRACE_SCOPE("settings.load");
     QString path = getConfigPath();
     QFile file(path);
     
@@ -66,15 +68,23 @@ void Settings::load() {
     block_fingerprinting_ = obj["block_fingerprinting"].toBool(true);
     disable_webrtc_ = obj["disable_webrtc"].toBool(false);
     auto_clear_cache_ = obj["auto_clear_cache"].toBool(false);
+    cache_size_mb_ = obj["cache_size_mb"].toInt(512);
+    history_retention_days_ = obj["history_retention_days"].toInt(90);
+    history_max_visits_ = obj["history_max_visits"].toInt(0);
     zoom_level_ = obj["zoom_level"].toInt(100);
     show_bookmarks_bar_ = obj["show_bookmarks_bar"].toBool(false);
     auto_reload_ = obj["auto_reload"].toBool(false);
     auto_reload_interval_ = obj["auto_reload_interval"].toInt(30);
+    auto_reload_check_changes_ = obj["auto_reload_check_changes"].toBool(false);
+    process_model_ = obj["process_model"].toString("site-per-process");
+    renderer_process_limit_ = obj["renderer_process_limit"].toInt(0);
+    js_heap_limit_mb_ = obj["js_heap_limit_mb"].toInt(0);
     
     qDebug() << "Settings loaded from:" << path;
 }
 
 void Settings::save() {
+    TSUNAMI_TRACE_SCOPE("settings.save");
     QJsonObject obj;
     obj["theme"] = theme_;
     obj["dark_mode"] = dark_mode_;
@@ -91,10 +101,17 @@ void Settings::save() {
     obj["block_fingerprinting"] = block_fingerprinting_;
     obj["disable_webrtc"] = disable_webrtc_;
     obj["auto_clear_cache"] = auto_clear_cache_;
+    obj["cache_size_mb"] = cache_size_mb_;
+    obj["history_retention_days"] = history_retention_days_;
+    obj["history_max_visits"] = history_max_visits_;
     obj["zoom_level"] = zoom_level_;
     obj["show_bookmarks_bar"] = show_bookmarks_bar_;
     obj["auto_reload"] = auto_reload_;
     obj["auto_reload_interval"] = auto_reload_interval_;
+    obj["auto_reload_check_changes"] = auto_reload_check_changes_;
+    obj["process_model"] = process_model_;
+    obj["renderer_process_limit"] = renderer_process_limit_;
+    obj["js_heap_limit_mb"] = js_heap_limit_mb_;
     
     QJsonDocument doc(obj);
     
@@ -104,7 +121,6 @@ void Settings::save() {
     if (file.open(QIODevice::WriteOnly)) {
         file.write(doc.toJson(QJsonDocument::Indented));
         file.close();
-        qDebug() << "Settings saved to:" << path;
     } else {
         qWarning() << "Cannot write settings file:" << path;
     }
@@ -126,10 +142,17 @@ void Settings::reset() {
     block_fingerprinting_ = true;
     disable_webrtc_ = false;
     auto_clear_cache_ = false;
+    cache_size_mb_ = 512;
+    history_retention_days_ = 90;
+    history_max_visits_ = 0;
     zoom_level_ = 100;
     show_bookmarks_bar_ = false;
     auto_reload_ = false;
     auto_reload_interval_ = 30;
+    auto_reload_check_changes_ = false;
+    process_model_ = "site-per-process";
+    renderer_process_limit_ = 0;
+    js_heap_limit_mb_ = 0;
     save();
     emit settingsChanged();
 }
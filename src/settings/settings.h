@@ -32,10 +32,18 @@ public:
     bool getBlockFingerprinting() const { return block_fingerprinting_; }
     bool getDisableWebRTC() const { return disable_webrtc_; }
     bool getAutoClearCache() const { return auto_clear_cache_; }
+    int getCacheSizeMb() const { return cache_size_mb_; }
+    int getHistoryRetentionDays() const { return history_retention_days_; }
+    int getHistoryMaxVisits() const { return history_max_visits_; }
     int getZoomLevel() const { return zoom_level_; }
     bool getShowBookmarksBar() const { return show_bookmarks_bar_; }
     bool getAutoReload() const { return auto_reload_; }
     int getAutoReloadInterval() const { return auto_reload_interval_; }
+    bool getAutoReloadCheckChanges() const { return auto_reload_check_changes_; }
+    // Renderer process model; read once at start-up, see ChromiumFlags
+    QString getProcessModel() const { return process_model_; }
+    int getRendererProcessLimit() const { return renderer_process_limit_; }
+    int getJsHeapLimitMb() const { return js_heap_limit_mb_; }
 
     // Setters
     void setTheme(const QString& theme) { theme_ = theme; save(); emit settingsChanged(); }
@@ -53,10 +61,17 @@ public:
     void setBlockFingerprinting(bool block) { block_fingerprinting_ = block; save(); emit settingsChanged(); }
     void setDisableWebRTC(bool disable) { disable_webrtc_ = disable; save(); emit settingsChanged(); }
     void setAutoClearCache(bool clear) { auto_clear_cache_ = clear; save(); }
+    void setCacheSizeMb(int size) { cache_size_mb_ = size; save(); emit settingsChanged(); }
+    void setHistoryRetentionDays(int days) { history_retention_days_ = days; save(); emit settingsChanged(); }
+    void setHistoryMaxVisits(int visits) { history_max_visits_ = visits; save(); emit settingsChanged(); }
     void setZoomLevel(int zoom) { zoom_level_ = zoom; save(); emit settingsChanged(); }
     void setShowBookmarksBar(bool show) { show_bookmarks_bar_ = show; save(); emit settingsChanged(); }
     void setAutoReload(bool reload) { auto_reload_ = reload; save(); emit settingsChanged(); }
     void setAutoReloadInterval(int interval) { auto_reload_interval_ = interval; save(); emit settingsChanged(); }
+    void setAutoReloadCheckChanges(bool check) { auto_reload_check_changes_ = check; save(); emit settingsChanged(); }
+    void setProcessModel(const QString& model) { process_model_ = model; save(); }
+    void setRendererProcessLimit(int limit) { renderer_process_limit_ = limit; save(); }
+    void setJsHeapLimitMb(int size) { js_heap_limit_mb_ = size; save(); }
 
 signals:
     void settingsChanged();
@@ -84,10 +99,17 @@ private:
     bool block_fingerprinting_ = true;
     bool disable_webrtc_ = false;
     bool auto_clear_cache_ = false;
+    int cache_size_mb_ = 512;
+    int history_retention_days_ = 90;   // 0: keep forever
+    int history_max_visits_ = 0;        // 0: no limit
     int zoom_level_ = 100;
     bool show_bookmarks_bar_ = false;
     bool auto_reload_ = false;
     int auto_reload_interval_ = 30;
+    bool auto_reload_check_changes_ = false;
+    QString process_model_ = "site-per-process";
+    int renderer_process_limit_ = 0;   // 0: Chromium decides
+    int js_heap_limit_mb_ = 0;         // 0: V8's default
 };
 
 } // namespace Tsunami
@@ -1,5 +1,6 @@
 #include "settings_dialog.h"
 #include "settings/settings.h"
+#include "ui/theme_engine.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -18,6 +19,41 @@
 
 namespace Tsunami {
 
+namespace {
+
+QString buildSettingsStyle(bool isDark, const QString& accent) {
+    Q_UNUSED(accent)
+    QString bgColor = isDark ? "#0f172a" : "#ffffff";
+    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
+    QString inputBg = isDark ? "#1e293b" : "#ffffff";
+    QString borderColor = isDark ? "#334155" : "#cbd5e1";
+    QString accentColor = "#3b82f6";
+    
+    return QString(R"(
+        QWidget#settingsContent { background-color: %1; }
+        QLabel#settingsTitle { font-size: 24px; font-weight: bold; color: %5; }
+        QLabel#sectionHeader { font-size: 16px; font-weight: bold; color: %5; margin-top: 16px; }
+        QLabel#themeLabel { color: %2; }
+        QLabel#fieldLabel { color: %2; min-width: 80px; }
+        QLabel#zoomValue { color: %2; min-width: 50px; }
+        QComboBox#themeCombo { padding: 8px 12px; border: 1px solid %4; border-radius: 6px; background: %3; color: %2; min-width: 150px; }
+        QLineEdit#textField, QSpinBox#textField { padding: 8px 12px; border: 1px solid %4; border-radius: 6px; background: %3; color: %2; }
+        QCheckBox { color: %2; spacing: 8px; }
+        QCheckBox::indicator { width: 18px; height: 18px; border-radius: 4px; border: 1px solid %4; background: %3; }
+        QCheckBox::indicator:checked { background: %5; border-color: %5; }
+        QRadioButton { color: %2; spacing: 8px; }
+        QRadioButton::indicator { width: 18px; height: 18px; border-radius: 9px; border: 1px solid %4; background: %3; }
+        QRadioButton::indicator:checked { background: %5; border-color: %5; }
+        QSlider::groove:horizontal { height: 6px; background: %4; border-radius: 3px; }
+        QSlider::handle:horizontal { background: %5; width: 18px; margin: -6px 0; border-radius: 4px; }
+        QWidget#buttonBar { background-color: %1; border-top: 1px solid %4; }
+        QPushButton#secondaryButton { padding: 10px 24px; border: 1px solid %4; border-radius: 6px; background: %3; color: %2; }
+        QPushButton#saveButton { padding: 10px 24px; background: %5; color: white; border: none; border-radius: 6px; }
+    )").arg(bgColor, textColor, inputBg, borderColor, accentColor);
+}
+
+} // namespace
+
 SettingsDialog::SettingsDialog(QWidget* parent)
     : QDialog(parent)
 {
@@ -26,13 +62,9 @@ SettingsDialog::SettingsDialog(QWidget* parent)
     resize(900, 600);
     setModal(true);
     
-    bool isDark = Settings::instance().getDarkMode();
-    
-    QString bgColor = isDark ? "#0f172a" : "#ffffff";
-    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
-    QString inputBg = isDark ? "#1e293b" : "#ffffff";
-    QString borderColor = isDark ? "#334155" : "#cbd5e1";
-    QString accentColor = "#3b82f6";
+    // One stylesheet on the dialog, built once per theme, instead of a
+    // separate style sheet (and style proxy) on every child widget
+    ThemeEngine::instance().apply(this, "settings", buildSettingsStyle);
     
     QVBoxLayout* main_layout = new QVBoxLayout(this);
     main_layout->setContentsMargins(0, 0, 0, 0);
@@ -48,7 +80,7 @@ SettingsDialog::SettingsDialog(QWidget* parent)
     
     // Content widget
     QWidget* content_widget = new QWidget();
-    content_widget->setStyleSheet(QString("background-color: %1;").arg(bgColor));
+    content_widget->setObjectName("settingsContent");
     scroll_area->setWidget(content_widget);
     
     QVBoxLayout* content_layout = new QVBoxLayout(content_widget);
@@ -57,17 +89,17 @@ SettingsDialog::SettingsDialog(QWidget* parent)
     
     // Title
     QLabel* title = new QLabel("Settings");
-    title->setStyleSheet(QString("font-size: 24px; font-weight: bold; color: %1;").arg(accentColor));
+    title->setObjectName("settingsTitle");
     content_layout->addWidget(title);
     
     // Theme
     QLabel* theme_label = new QLabel("Theme:");
-    theme_label->setStyleSheet(QString("color: %1;").arg(textColor));
+    theme_label->setObjectName("themeLabel");
     theme_combo_ = new QComboBox();
     theme_combo_->addItem("Dark", "dark");
     theme_combo_->addItem("Light", "light");
     theme_combo_->addItem("System", "system");
-    theme_combo_->setStyleSheet(QString("padding: 8px 12px; border: 1px solid %1; border-radius: 6px; background: %2; color: %3; min-width: 150px;").arg(borderColor, inputBg, textColor));
+    theme_combo_->setObjectName("themeCombo");
     
     QHBoxLayout* theme_row = new QHBoxLayout();
     theme_row->addWidget(theme_label);
@@ -77,7 +109,7 @@ SettingsDialog::SettingsDialog(QWidget* parent)
     
     // Privacy Section
     QLabel* privacy_header = new QLabel("Privacy & Security");
-    privacy_header->setStyleSheet(QString("font-size: 16px; font-weight: bold; color: %1; margin-top: 16px;").arg(accentColor));
+    privacy_header->setObjectName("sectionHeader");
     content_layout->addWidget(privacy_header);
     
     QGridLayout* privacy_grid = new QGridLayout();
@@ -86,124 +118,137 @@ SettingsDialog::SettingsDialog(QWidget* parent)
     privacy_grid->setHorizontalSpacing(16);
     privacy_grid->setVerticalSpacing(8);
     
-    QString checkbox_style = QString("QCheckBox { color: %1; spacing: 8px; } QCheckBox::indicator { width: 18px; height: 18px; border-radius: 4px; border: 1px solid %2; background: %3; } QCheckBox::indicator:checked { background: %4; border-color: %4; }").arg(textColor, borderColor, inputBg, accentColor);
-    
     block_trackers_ = new QCheckBox("Block Trackers");
     block_trackers_->setChecked(true);
-    block_trackers_->setStyleSheet(checkbox_style);
     privacy_grid->addWidget(block_trackers_, 0, 0);
     
     block_ads_ = new QCheckBox("Block Ads");
     block_ads_->setChecked(true);
-    block_ads_->setStyleSheet(checkbox_style);
     privacy_grid->addWidget(block_ads_, 0, 1);
     
     https_only_ = new QCheckBox("HTTPS Only");
-    https_only_->setStyleSheet(checkbox_style);
     privacy_grid->addWidget(https_only_, 1, 0);
     
     do_not_track_ = new QCheckBox("Do Not Track");
     do_not_track_->setChecked(true);
-    do_not_track_->setStyleSheet(checkbox_style);
     privacy_grid->addWidget(do_not_track_, 1, 1);
     
     block_third_party_cookies_ = new QCheckBox("Block Third-Party Cookies");
     block_third_party_cookies_->setChecked(true);
-    block_third_party_cookies_->setStyleSheet(checkbox_style);
     privacy_grid->addWidget(block_third_party_cookies_, 2, 0);
     
     block_fingerprinting_ = new QCheckBox("Block Fingerprinting");
     block_fingerprinting_->setChecked(true);
-    block_fingerprinting_->setStyleSheet(checkbox_style);
     privacy_grid->addWidget(block_fingerprinting_, 2, 1);
     
     disable_webrtc_ = new QCheckBox("Disable WebRTC");
-    disable_webrtc_->setStyleSheet(checkbox_style);
     privacy_grid->addWidget(disable_webrtc_, 3, 0);
     
     content_layout->addLayout(privacy_grid);
     
+    QHBoxLayout* retention_row = new QHBoxLayout();
+    QLabel* retention_label = new QLabel("Keep history for (days):");
+    retention_label->setObjectName("fieldLabel");
+    retention_row->addWidget(retention_label);
+    history_retention_ = new QSpinBox();
+    history_retention_->setRange(0, 3650);
+    history_retention_->setSpecialValueText("Forever");
+    history_retention_->setObjectName("textField");
+    retention_row->addWidget(history_retention_);
+    retention_row->addStretch();
+    content_layout->addLayout(retention_row);
+    
+    QHBoxLayout* max_visits_row = new QHBoxLayout();
+    QLabel* max_visits_label = new QLabel("Maximum history entries:");
+    max_visits_label->setObjectName("fieldLabel");
+    max_visits_row->addWidget(max_visits_label);
+    history_max_visits_ = new QSpinBox();
+    history_max_visits_->setRange(0, 10000000);
+    history_max_visits_->setSingleStep(10000);
+    history_max_visits_->setSpecialValueText("No limit");
+    history_max_visits_->setObjectName("textField");
+    max_visits_row->addWidget(history_max_visits_);
+    max_visits_row->addStretch();
+    content_layout->addLayout(max_visits_row);
+    
     // Search Engine Section
     QLabel* search_header = new QLabel("Search Engine");
-    search_header->setStyleSheet(QString("font-size: 16px; font-weight: bold; color: %1; margin-top: 16px;").arg(accentColor));
+    search_header->setObjectName("sectionHeader");
     content_layout->addWidget(search_header);
     
-    QString radio_style = QString("QRadioButton { color: %1; spacing: 8px; } QRadioButton::indicator { width: 18px; height: 18px; border-radius: 9px; border: 1px solid %2; background: %3; } QRadioButton::indicator:checked { background: %4; border-color: %4; }").arg(textColor, borderColor, inputBg, accentColor);
-    
     search_group_ = new QButtonGroup(this);
     
     QRadioButton* duckduckgo_radio = new QRadioButton("DuckDuckGo");
-    duckduckgo_radio->setStyleSheet(radio_style);
     search_group_->addButton(duckduckgo_radio, 0);
     content_layout->addWidget(duckduckgo_radio);
     
     QRadioButton* brave_radio = new QRadioButton("Brave Search");
-    brave_radio->setStyleSheet(radio_style);
     search_group_->addButton(brave_radio, 1);
     content_layout->addWidget(brave_radio);
     
     QRadioButton* google_radio = new QRadioButton("Google");
-    google_radio->setStyleSheet(radio_style);
     search_group_->addButton(google_radio, 2);
     content_layout->addWidget(google_radio);
     
     // Startup Section
     QLabel* startup_header = new QLabel("Startup");
-    startup_header->setStyleSheet(QString("font-size: 16px; font-weight: bold; color: %1; margin-top: 16px;").arg(accentColor));
+    startup_header->setObjectName("sectionHeader");
     content_layout->addWidget(startup_header);
     
     QHBoxLayout* homepage_row = new QHBoxLayout();
     QLabel* homepage_label = new QLabel("Homepage:");
-    homepage_label->setStyleSheet(QString("color: %1; min-width: 80px;").arg(textColor));
+    homepage_label->setObjectName("fieldLabel");
     homepage_row->addWidget(homepage_label);
     homepage_edit_ = new QLineEdit();
     homepage_edit_->setPlaceholderText("about:blank");
-    homepage_edit_->setStyleSheet(QString("padding: 8px 12px; border: 1px solid %1; border-radius: 6px; background: %2; color: %3;").arg(borderColor, inputBg, textColor));
+    homepage_edit_->setObjectName("textField");
     homepage_edit_->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
     homepage_row->addWidget(homepage_edit_);
     content_layout->addLayout(homepage_row);
     
     restore_tabs_ = new QCheckBox("Restore tabs from last session");
     restore_tabs_->setChecked(true);
-    restore_tabs_->setStyleSheet(checkbox_style);
     content_layout->addWidget(restore_tabs_);
     
     auto_reload_ = new QCheckBox("Auto-reload pages");
-    auto_reload_->setStyleSheet(checkbox_style);
     content_layout->addWidget(auto_reload_);
     
     QHBoxLayout* reload_row = new QHBoxLayout();
     QLabel* reload_label = new QLabel("Interval:");
-    reload_label->setStyleSheet(QString("color: %1; min-width: 80px;").arg(textColor));
+    reload_label->setObjectName("fieldLabel");
     reload_row->addWidget(reload_label);
     auto_reload_interval_ = new QSpinBox();
     auto_reload_interval_->setRange(5, 3600);
     auto_reload_interval_->setValue(30);
     auto_reload_interval_->setEnabled(false);
-    auto_reload_interval_->setStyleSheet(QString("padding: 8px 12px; border: 1px solid %1; border-radius: 6px; background: %2; color: %3;").arg(borderColor, inputBg, textColor));
+    auto_reload_interval_->setObjectName("textField");
     reload_row->addWidget(auto_reload_interval_);
     reload_row->addStretch();
     content_layout->addLayout(reload_row);
     
+    auto_reload_check_changes_ = new QCheckBox("Only reload when the page has changed");
+    auto_reload_check_changes_->setEnabled(false);
+    content_layout->addWidget(auto_reload_check_changes_);
+    
     connect(auto_reload_, &QCheckBox::toggled, auto_reload_interval_, &QSpinBox::setEnabled);
+    connect(auto_reload_, &QCheckBox::toggled, auto_reload_check_changes_, &QCheckBox::setEnabled);
     
     // Advanced Section
     QLabel* advanced_header = new QLabel("Advanced");
-    advanced_header->setStyleSheet(QString("font-size: 16px; font-weight: bold; color: %1; margin-top: 16px;").arg(accentColor));
+    advanced_header->setObjectName("sectionHeader");
     content_layout->addWidget(advanced_header);
     
     QHBoxLayout* zoom_row = new QHBoxLayout();
     QLabel* zoom_label = new QLabel("Zoom:");
-    zoom_label->setStyleSheet(QString("color: %1; min-width: 80px;").arg(textColor));
+    zoom_label->setObjectName("fieldLabel");
     zoom_row->addWidget(zoom_label);
     zoom_level_ = new QSlider(Qt::Horizontal);
     zoom_level_->setRange(25, 200);
     zoom_level_->setValue(100);
-    zoom_level_->setStyleSheet(QString("QSlider::groove:horizontal { height: 6px; background: %1; border-radius: 3px; } QSlider::handle:horizontal { background: %2; width: 18px; margin: -6px 0; border-radius: 4px; }").arg(borderColor, accentColor));
     zoom_level_->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
     zoom_row->addWidget(zoom_level_);
     zoom_label_ = new QLabel("100%");
-    zoom_label_->setStyleSheet(QString("color: %1; min-width: 50px;").arg(textColor));
+    zoom_label_->setObjectName("zoomValue");
     zoom_row->addWidget(zoom_label_);
     content_layout->addLayout(zoom_row);
     
@@ -212,36 +257,94 @@ SettingsDialog::SettingsDialog(QWidget* parent)
     });
     
     show_bookmarks_bar_ = new QCheckBox("Show bookmarks bar");
-    show_bookmarks_bar_->setStyleSheet(checkbox_style);
     content_layout->addWidget(show_bookmarks_bar_);
     
     auto_clear_cache_ = new QCheckBox("Auto-clear cache on exit");
-    auto_clear_cache_->setStyleSheet(checkbox_style);
     content_layout->addWidget(auto_clear_cache_);
     
+    QHBoxLayout* cache_row = new QHBoxLayout();
+    QLabel* cache_label = new QLabel("Cache size (MB):");
+    cache_label->setObjectName("fieldLabel");
+    cache_row->addWidget(cache_label);
+    cache_size_ = new QSpinBox();
+    cache_size_->setRange(64, 8192);
+    cache_size_->setSingleStep(64);
+    cache_size_->setValue(512);
+    cache_size_->setObjectName("textField");
+    cache_row->addWidget(cache_size_);
+    cache_row->addStretch();
+    content_layout->addLayout(cache_row);
+    
+    // Performance Section
+    QLabel* performance_header = new QLabel("Performance");
+    performance_header->setObjectName("sectionHeader");
+    content_layout->addWidget(performance_header);
+    
+    QHBoxLayout* process_row = new QHBoxLayout();
+    QLabel* process_label = new QLabel("Processes:");
+    process_label->setObjectName("fieldLabel");
+    process_row->addWidget(process_label);
+    process_model_combo_ = new QComboBox();
+    process_model_combo_->addItem("One per site (most isolated)", "site-per-process");
+    process_model_combo_->addItem("Shared by tabs of the same site", "process-per-site");
+    process_model_combo_->setObjectName("textField");
+    process_row->addWidget(process_model_combo_);
+    process_row->addStretch();
+    content_layout->addLayout(process_row);
+    
+    QHBoxLayout* limit_row = new QHBoxLayout();
+    QLabel* limit_label = new QLabel("Renderer process limit:");
+    limit_label->setObjectName("fieldLabel");
+    limit_row->addWidget(limit_label);
+    renderer_limit_ = new QSpinBox();
+    renderer_limit_->setRange(0, 64);
+    renderer_limit_->setSpecialValueText("No limit");
+    renderer_limit_->setObjectName("textField");
+    limit_row->addWidget(renderer_limit_);
+    limit_row->addStretch();
+    content_layout->addLayout(limit_row);
+    
+    QHBoxLayout* heap_row = new QHBoxLayout();
+    QLabel* heap_label = new QLabel("JavaScript heap limit (MB):");
+    heap_label->setObjectName("fieldLabel");
+    heap_row->addWidget(heap_label);
+    js_heap_limit_ = new QSpinBox();
+    js_heap_limit_->setRange(0, 8192);
+    js_heap_limit_->setSingleStep(128);
+    js_heap_limit_->setSpecialValueText("Default");
+    js_heap_limit_->setObjectName("textField");
+    heap_row->addWidget(js_heap_limit_);
+    heap_row->addStretch();
+    content_layout->addLayout(heap_row);
+    
+    QLabel* restart_note = new QLabel("Process settings apply after a restart. See tsunami://memory for their effect.");
+    restart_note->setObjectName("fieldLabel");
+    restart_note->setWordWrap(true);
+    content_layout->addWidget(restart_note);
+    
     content_layout->addStretch();
     
     // Button Row
     QWidget* button_container = new QWidget();
-    button_container->setStyleSheet(QString("background-color: %1; border-top: 1px solid %2;").arg(bgColor, borderColor));
+    button_container->setObjectName("buttonBar");
     QHBoxLayout* button_layout = new QHBoxLayout(button_container);
     button_layout->setContentsMargins(24, 16, 24, 16);
     button_layout->setSpacing(12);
     
     QPushButton* reset_btn = new QPushButton("Reset");
-    reset_btn->setStyleSheet(QString("padding: 10px 24px; border: 1px solid %1; border-radius: 6px; background: %2; color: %3;").arg(borderColor, inputBg, textColor));
+    reset_btn->setObjectName("secondaryButton");
     connect(reset_btn, &QPushButton::clicked, this, &SettingsDialog::resetSettings);
     button_layout->addWidget(reset_btn);
     
     button_layout->addStretch();
     
     QPushButton* cancel_btn = new QPushButton("Cancel");
-    cancel_btn->setStyleSheet(QString("padding: 10px 24px; border: 1px solid %1; border-radius: 6px; background: %2; color: %3;").arg(borderColor, inputBg, textColor));
+    cancel_btn->setObjectName("secondaryButton");
     connect(cancel_btn, &QPushButton::clicked, this, &QDialog::reject);
     button_layout->addWidget(cancel_btn);
     
     QPushButton* save_btn = new QPushButton("Save");
-    save_btn->setStyleSheet(QString("padding: 10px 24px; background: %1; color: white; border: none; border-radius: 6px;").arg(accentColor));
+    save_btn->setObjectName("saveButton");
     connect(save_btn, &QPushButton::clicked, this, &SettingsDialog::saveSettings);
     connect(save_btn, &QPushButton::clicked, this, &QDialog::accept);
     button_layout->addWidget(save_btn);
@@ -265,6 +368,8 @@ void SettingsDialog::loadSettings() {
     block_third_party_cookies_->setChecked(settings.getBlockThirdPartyCookies());
     block_fingerprinting_->setChecked(settings.getBlockFingerprinting());
     disable_webrtc_->setChecked(settings.getDisableWebRTC());
+    history_retention_->setValue(settings.getHistoryRetentionDays());
+    history_max_visits_->setValue(settings.getHistoryMaxVisits());
     
     QString searchEngine = settings.getSearchEngine();
     int search_id = 0;
@@ -277,11 +382,18 @@ void SettingsDialog::loadSettings() {
     restore_tabs_->setChecked(settings.getRestoreTabs());
     auto_reload_->setChecked(settings.getAutoReload());
     auto_reload_interval_->setValue(settings.getAutoReloadInterval());
+    auto_reload_check_changes_->setChecked(settings.getAutoReloadCheckChanges());
     
     zoom_level_->setValue(settings.getZoomLevel());
     zoom_label_->setText(QString::number(settings.getZoomLevel()) + "%");
     show_bookmarks_bar_->setChecked(settings.getShowBookmarksBar());
     auto_clear_cache_->setChecked(settings.getAutoClearCache());
+    cache_size_->setValue(settings.getCacheSizeMb());
+    
+    int process_index = process_model_combo_->findData(settings.getProcessModel());
+    process_model_combo_->setCurrentIndex(process_index >= 0 ? process_index : 0);
+    renderer_limit_->setValue(settings.getRendererProcessLimit());
+    js_heap_limit_->setValue(settings.getJsHeapLimitMb());
 }
 
 void SettingsDialog::saveSettings() {
@@ -298,6 +410,8 @@ void SettingsDialog::saveSettings() {
     settings.setBlockThirdPartyCookies(block_third_party_cookies_->isChecked());
     settings.setBlockFingerprinting(block_fingerprinting_->isChecked());
     settings.setDisableWebRTC(disable_webrtc_->isChecked());
+    settings.setHistoryRetentionDays(history_retention_->value());
+    settings.setHistoryMaxVisits(history_max_visits_->value());
     
     int search_id = search_group_->checkedId();
     QString searchEngine = "duckduckgo";
@@ -309,10 +423,15 @@ void SettingsDialog::saveSettings() {
     settings.setRestoreTabs(restore_tabs_->isChecked());
     settings.setAutoReload(auto_reload_->isChecked());
     settings.setAutoReloadInterval(auto_reload_interval_->value());
+    settings.setAutoReloadCheckChanges(auto_reload_check_changes_->isChecked());
     
     settings.setZoomLevel(zoom_level_->value());
     settings.setShowBookmarksBar(show_bookmarks_bar_->isChecked());
     settings.setAutoClearCache(auto_clear_cache_->isChecked());
+    settings.setCacheSizeMb(cache_size_->value());
+    settings.setProcessModel(process_model_combo_->currentData().toString());
+    settings.setRendererProcessLimit(renderer_limit_->value());
+    settings.setJsHeapLimitMb(js_heap_limit_->value());
     
     settings.save();
 }
@@ -37,14 +37,21 @@ private:
     QCheckBox* block_third_party_cookies_ = nullptr;
     QCheckBox* block_fingerprinting_ = nullptr;
     QCheckBox* disable_webrtc_ = nullptr;
+    QSpinBox* history_retention_ = nullptr;
+    QSpinBox* history_max_visits_ = nullptr;
     QCheckBox* restore_tabs_ = nullptr;
     QCheckBox* auto_reload_ = nullptr;
     QLineEdit* homepage_edit_ = nullptr;
     QSpinBox* auto_reload_interval_ = nullptr;
+    QCheckBox* auto_reload_check_changes_ = nullptr;
     QSlider* zoom_level_ = nullptr;
     QLabel* zoom_label_ = nullptr;
     QCheckBox* show_bookmarks_bar_ = nullptr;
     QCheckBox* auto_clear_cache_ = nullptr;
+    QSpinBox* cache_size_ = nullptr;
+    QComboBox* process_model_combo_ = nullptr;
+    QSpinBox* renderer_limit_ = nullptr;
+    QSpinBox* js_heap_limit_ = nullptr;
     
 public slots:
     static void showDialog(QWidget* parent = nullptr);
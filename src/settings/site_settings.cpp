@@ -0,0 +1,212 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * site_settings.cpp - Per-site zoom and content settings
+ */
+
+#include "settings/site_settings.h"
+#include "blocking/filter_data.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace Tsunami {
+
+namespace {
+
+constexpr char STORE_MAGIC[8] = {'T', 'S', 'U', 'S', 'I', 'T', 'E', 'S'};
+constexpr uint32_t STORE_VERSION = 1;
+
+struct StoreHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t rule_count;
+};
+
+// Followed by host_length bytes of host name
+struct StoreRecord {
+    int16_t zoom;
+    int8_t javascript;
+    int8_t images;
+    int8_t autoplay;
+    int8_t webgl;
+    uint16_t host_length;
+};
+
+bool sameHost(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(),
+                      [](char x, char y) { return ascii_lower(x) == ascii_lower(y); });
+}
+
+void inherit(SiteToggle& field, SiteToggle parent) {
+    if (field == SiteToggle::Default) field = parent;
+}
+
+SiteToggle toggleFrom(int8_t value) {
+    return value < 0 ? SiteToggle::Default : value ? SiteToggle::Allow : SiteToggle::Block;
+}
+
+} // namespace
+
+SiteSettingsStore& SiteSettingsStore::instance() {
+    static SiteSettingsStore instance;
+    return instance;
+}
+
+void SiteSettingsStore::init(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = path;
+    load();
+}
+
+const SiteSettingsStore::Rule* SiteSettingsStore::find(std::string_view host, uint64_t hash) const {
+    auto it = rules_.find(hash);
+    return it != rules_.end() && sameHost(it->second.host, host) ? &it->second : nullptr;
+}
+
+SiteSettings SiteSettingsStore::lookup(std::string_view host) const {
+    SiteSettings merged;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (rules_.empty()) return merged;
+
+    // "a.b.example.com", then "b.example.com", "example.com", "com"
+    while (!host.empty()) {
+        if (const Rule* rule = find(host, hash_domain(host))) {
+            const SiteSettings& settings = rule->settings;
+            if (merged.zoom == 0) merged.zoom = settings.zoom;
+            inherit(merged.javascript, settings.javascript);
+            inherit(merged.images, settings.images);
+            inherit(merged.autoplay, settings.autoplay);
+            inherit(merged.webgl, settings.webgl);
+        }
+        size_t dot = host.find('.');
+        if (dot == std::string_view::npos) break;
+        host.remove_prefix(dot + 1);
+    }
+    return merged;
+}
+
+SiteSettings SiteSettingsStore::rule(std::string_view host) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Rule* rule = find(host, hash_domain(host));
+    return rule ? rule->settings : SiteSettings{};
+}
+
+void SiteSettingsStore::set(std::string_view host, const SiteSettings& settings) {
+    if (host.empty()) return;
+    uint64_t hash = hash_domain(host);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (settings.isDefault()) {
+        if (!find(host, hash)) return;
+        rules_.erase(hash);
+    } else {
+        Rule& rule = rules_[hash];
+        rule.host.assign(host);
+        std::transform(rule.host.begin(), rule.host.end(), rule.host.begin(), ascii_lower);
+        rule.settings = settings;
+    }
+    save();
+}
+
+void SiteSettingsStore::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rules_.clear();
+    save();
+}
+
+std::vector<std::pair<std::string, SiteSettings>> SiteSettingsStore::rules() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<std::string, SiteSettings>> result;
+    result.reserve(rules_.size());
+    for (const auto& [hash, rule] : rules_) result.emplace_back(rule.host, rule.settings);
+    std::sort(result.begin(), result.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    return result;
+}
+
+size_t SiteSettingsStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rules_.size();
+}
+
+void SiteSettingsStore::load() {
+    std::ifstream in(path_, std::ios::binary);
+    if (!in) return;
+
+    StoreHeader header{};
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0 ||
+        header.version != STORE_VERSION) {
+        return;
+    }
+
+    // Each rule takes at least a record's bytes; a count the file cannot
+    // hold is corrupt, and must not size the map
+    std::error_code error;
+    uint64_t file_size = std::filesystem::file_size(path_, error);
+    if (error || header.rule_count > (file_size - sizeof(header)) / sizeof(StoreRecord)) {
+        std::cerr << "[Tsunami] Ignoring corrupt site settings " << path_ << std::endl;
+        return;
+    }
+
+    std::unordered_map<uint64_t, Rule> rules;
+    rules.reserve(header.rule_count);
+    for (uint32_t i = 0; i < header.rule_count && in; ++i) {
+        StoreRecord record;
+        in.read(reinterpret_cast<char*>(&record), sizeof(record));
+        std::string host(in ? record.host_length : 0, '\0');
+        in.read(host.data(), static_cast<std::streamsize>(host.size()));
+        if (!in) break;
+
+        Rule rule{std::move(host), {}};
+        rule.settings.zoom = record.zoom;
+        rule.settings.javascript = toggleFrom(record.javascript);
+        rule.settings.images = toggleFrom(record.images);
+        rule.settings.autoplay = toggleFrom(record.autoplay);
+        rule.settings.webgl = toggleFrom(record.webgl);
+        uint64_t hash = hash_domain(rule.host);
+        rules[hash] = std::move(rule);
+    }
+    if (!in) {
+        std::cerr << "[Tsunami] Ignoring truncated site settings " << path_ << std::endl;
+        return;
+    }
+    rules_ = std::move(rules);
+}
+
+void SiteSettingsStore::save() const {
+    if (path_.empty()) return;
+
+    StoreHeader header{};
+    std::memcpy(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+    header.version = STORE_VERSION;
+    header.rule_count = static_cast<uint32_t>(rules_.size());
+
+    // Same write-then-rename as the HTTPS upgrade cache
+    std::string temp_path = path_ + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) return;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& [hash, rule] : rules_) {
+            StoreRecord record{rule.settings.zoom,
+                               static_cast<int8_t>(rule.settings.javascript),
+                               static_cast<int8_t>(rule.settings.images),
+                               static_cast<int8_t>(rule.settings.autoplay),
+                               static_cast<int8_t>(rule.settings.webgl),
+                               static_cast<uint16_t>(rule.host.size())};
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            out.write(rule.host.data(), static_cast<std::streamsize>(rule.host.size()));
+        }
+        if (!out) return;
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path_, error);
+    if (error) {
+        std::cerr << "[Tsunami] Failed to save site settings: " << error.message() << std::endl;
+    }
+}
+
+} // namespace Tsunami
@@ -0,0 +1,74 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * site_settings.h - Per-site zoom and content settings
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Tsunami {
+
+enum class SiteToggle : int8_t {
+    Default = -1,   // Inherit from a parent domain or the global setting
+    Block = 0,
+    Allow = 1
+};
+
+struct SiteSettings {
+    int16_t zoom = 0;   // Percent; 0 inherits
+    SiteToggle javascript = SiteToggle::Default;
+    SiteToggle images = SiteToggle::Default;
+    SiteToggle autoplay = SiteToggle::Default;
+    SiteToggle webgl = SiteToggle::Default;
+
+    bool isDefault() const {
+        return zoom == 0 && javascript == SiteToggle::Default && images == SiteToggle::Default &&
+               autoplay == SiteToggle::Default && webgl == SiteToggle::Default;
+    }
+};
+
+// Rules keyed by host. A rule for "example.com" also covers its
+// subdomains; lookup() hashes the host and each parent domain once and
+// merges field by field, the most specific rule winning. That is a handful
+// of hash probes per navigation however many rules there are. The rules
+// persist as a small binary table, rewritten on every change.
+class SiteSettingsStore {
+public:
+    static SiteSettingsStore& instance();
+
+    void init(const std::string& path);
+
+    SiteSettings lookup(std::string_view host) const;
+    // The rule stored for exactly this host, without inheritance
+    SiteSettings rule(std::string_view host) const;
+    void set(std::string_view host, const SiteSettings& settings);   // Default settings remove the rule
+    void clear();
+
+    std::vector<std::pair<std::string, SiteSettings>> rules() const;
+    size_t size() const;
+
+private:
+    SiteSettingsStore() = default;
+
+    struct Rule {
+        std::string host;
+        SiteSettings settings;
+    };
+
+    const Rule* find(std::string_view host, uint64_t hash) const;
+    void load();
+    void save() const;
+
+    std::string path_;
+    std::unordered_map<uint64_t, Rule> rules_;   // Host hash -> rule
+    mutable std::mutex mutex_;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,166 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * single_instance.cpp - Forwards later launches to the running browser
+ */
+
+#include "single_instance.h"
+#include "perf/trace.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QStandardPaths>
+#include <QThread>
+#include <algorithm>
+#include <iostream>
+
+namespace Tsunami {
+
+namespace {
+
+// A command line is a few KB; anything larger is not a launch
+constexpr qint64 MAX_MESSAGE_BYTES = 1024 * 1024;
+
+} // namespace
+
+SingleInstance::SingleInstance(QObject* parent)
+    : QObject(parent)
+{
+    batch_timer_.setSingleShot(true);
+    batch_timer_.setInterval(BATCH_DELAY_MS);
+    connect(&batch_timer_, &QTimer::timeout, this, &SingleInstance::flush);
+}
+
+SingleInstance::~SingleInstance() = default;
+
+// Per user and data directory, so separate profiles run separately
+QString SingleInstance::serverName() {
+    QByteArray key = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation).toUtf8();
+    QByteArray hash = QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex().left(16);
+    return QStringLiteral("tsunami-") + QString::fromLatin1(hash);
+}
+
+SingleInstance::Request SingleInstance::parseArguments(const QStringList& arguments,
+                                                       const QString& working_dir) {
+    Request request;
+    for (int i = 1; i < arguments.size(); ++i) {
+        const QString& arg = arguments[i];
+        if (arg == QLatin1String("--new-window")) {
+            request.new_window = true;
+        } else if (arg == QLatin1String("--private") || arg == QLatin1String("--incognito")) {
+            request.private_window = true;
+        } else if (!arg.startsWith(QLatin1String("--"))) {
+            QUrl url = QUrl::fromUserInput(arg, working_dir, QUrl::AssumeLocalFile);
+            if (url.isValid()) request.urls.append(url);
+        }
+        // Other flags are for this process only, e.g. --startup-trace
+    }
+    return request;
+}
+
+bool SingleInstance::start(const QStringList& arguments) {
+    TSUNAMI_TRACE_SCOPE("singleInstance.start");
+    lock_ = std::make_unique<QLockFile>(QDir::temp().filePath(serverName() + ".lock"));
+    // Stale only when the owning process is gone, never by age
+    lock_->setStaleLockTime(0);
+    if (!lock_->tryLock(0)) {
+        if (lock_->error() == QLockFile::LockFailedError) {
+            if (!forward(arguments)) {
+                std::cerr << "[Tsunami] Another instance holds the profile but does not answer" << std::endl;
+            }
+            lock_.reset();
+            return false;
+        }
+        // Unwritable temp directory: run without single-instance handling
+        std::cerr << "[Tsunami] Could not create the instance lock file" << std::endl;
+        return true;
+    }
+
+    // The lock proves no primary is running, so a socket file is left over
+    // from a crash
+    QLocalServer::removeServer(serverName());
+    server_ = new QLocalServer(this);
+    server_->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(server_, &QLocalServer::newConnection, this, &SingleInstance::onNewConnection);
+    if (!server_->listen(serverName())) {
+        std::cerr << "[Tsunami] Instance server: " << server_->errorString().toStdString() << std::endl;
+    }
+    return true;
+}
+
+bool SingleInstance::forward(const QStringList& arguments) {
+    TSUNAMI_TRACE_SCOPE("singleInstance.forward");
+    QLocalSocket socket;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    // A primary that has just taken the lock may not be listening yet
+    for (;;) {
+        socket.connectToServer(serverName());
+        if (socket.waitForConnected(100)) break;
+        if (elapsed.elapsed() >= CONNECT_TIMEOUT_MS) return false;
+        QThread::msleep(20);
+    }
+
+    QByteArray message;
+    QDataStream out(&message, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << QDir::currentPath() << arguments;
+    socket.write(message);
+    bool written = socket.waitForBytesWritten(CONNECT_TIMEOUT_MS);
+    socket.disconnectFromServer();
+    if (socket.state() != QLocalSocket::UnconnectedState) socket.waitForDisconnected(CONNECT_TIMEOUT_MS);
+    return written;
+}
+
+void SingleInstance::onNewConnection() {
+    while (QLocalSocket* socket = server_->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { receive(socket); });
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        receive(socket);
+    }
+}
+
+void SingleInstance::receive(QLocalSocket* socket) {
+    if (socket->bytesAvailable() > MAX_MESSAGE_BYTES) {
+        socket->abort();
+        return;
+    }
+
+    QDataStream in(socket);
+    in.setVersion(QDataStream::Qt_6_0);
+    in.startTransaction();
+    QString working_dir;
+    QStringList arguments;
+    in >> working_dir >> arguments;
+    // Not all of it yet; readyRead brings the rest
+    if (!in.commitTransaction()) return;
+    socket->disconnectFromServer();
+
+    Request request = parseArguments(arguments, working_dir);
+    // A plain relaunch, as from a dock or launcher, asks for a window
+    if (request.urls.isEmpty()) request.new_window = true;
+    pending_.append(request);
+    if (!batch_timer_.isActive()) batch_timer_.start();
+}
+
+// Launches that arrive together, e.g. a file manager opening a selection,
+// become one request per kind of window
+void SingleInstance::flush() {
+    QList<Request> merged;
+    for (const Request& request : std::as_const(pending_)) {
+        auto it = std::find_if(merged.begin(), merged.end(), [&request](const Request& other) {
+            return other.new_window == request.new_window && other.private_window == request.private_window;
+        });
+        if (it == merged.end()) {
+            merged.append(request);
+        } else {
+            it->urls += request.urls;
+        }
+    }
+    pending_.clear();
+    for (const Request& request : std::as_const(merged)) emit openRequested(request);
+}
+
+} // namespace Tsunami
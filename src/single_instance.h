@@ -0,0 +1,68 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * single_instance.h - Forwards later launches to the running browser
+ */
+
+#pragma once
+
+#include <QList>
+#include <QLockFile>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <QUrl>
+#include <memory>
+
+class QLocalServer;
+class QLocalSocket;
+
+namespace Tsunami {
+
+// One browser process per user data directory. The first launch holds a
+// lock file and listens on a local socket; a later launch finds the lock
+// taken, sends its command line to that socket and exits before it opens
+// any settings, databases or Chromium. The running browser batches what
+// arrives within a few milliseconds into one openRequested() per kind of
+// window, so a burst of links opens as tabs of one window.
+class SingleInstance : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int CONNECT_TIMEOUT_MS = 1000;
+    static constexpr int BATCH_DELAY_MS = 20;
+
+    struct Request {
+        QList<QUrl> urls;
+        bool new_window = false;
+        bool private_window = false;
+    };
+
+    // URLs, file paths (relative to working_dir), --new-window and --private
+    static Request parseArguments(const QStringList& arguments, const QString& working_dir);
+
+    explicit SingleInstance(QObject* parent = nullptr);
+    ~SingleInstance() override;
+
+    // True when this process is the primary instance and now listens.
+    // Otherwise the arguments went to the primary (or could not) and this
+    // process should exit.
+    bool start(const QStringList& arguments);
+
+signals:
+    void openRequested(const Tsunami::SingleInstance::Request& request);
+
+private slots:
+    void onNewConnection();
+    void flush();
+
+private:
+    static QString serverName();
+    bool forward(const QStringList& arguments);
+    void receive(QLocalSocket* socket);
+
+    std::unique_ptr<QLockFile> lock_;
+    QLocalServer* server_ = nullptr;
+    QList<Request> pending_;
+    QTimer batch_timer_;
+};
+
+} // namespace Tsunami
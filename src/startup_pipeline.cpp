@@ -0,0 +1,160 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * startup_pipeline.cpp - Deferred startup work and cold-start milestones
+ */
+
+#include "startup_pipeline.h"
+#include "perf/trace.h"
+#include <QApplication>
+#include <QWidget>
+#include <QEvent>
+#include <QFile>
+#include <iostream>
+#include <cstdio>
+
+namespace Tsunami {
+
+namespace {
+
+// Captured during static initialisation, before main() runs
+const quint64 g_process_start_ns = Tracer::now_ns();
+
+const char* milestoneName(int milestone) {
+    static const char* names[] = {
+        "process-start",
+        "application-ready",
+        "window-shown",
+        "first-paint",
+        "first-tab",
+        "interactive",
+        "deferred-done"
+    };
+    return names[milestone];
+}
+
+} // namespace
+
+StartupPipeline& StartupPipeline::instance() {
+    static StartupPipeline instance;
+    return instance;
+}
+
+StartupPipeline::StartupPipeline() : QObject(nullptr) {
+    marks_[ProcessStart] = g_process_start_ns;
+}
+
+double StartupPipeline::elapsedMs(Milestone milestone) const {
+    if (!marks_[milestone]) return -1;
+    return (marks_[milestone] - marks_[ProcessStart]) / 1e6;
+}
+
+void StartupPipeline::mark(Milestone milestone) {
+    if (marks_[milestone]) return;
+    marks_[milestone] = Tracer::now_ns();
+    TSUNAMI_TRACE_SPAN(milestoneName(milestone), marks_[ProcessStart], marks_[milestone]);
+    emit milestoneReached(milestone);
+
+    if (milestone == FirstPaint) {
+        startDeferredTasks();
+    }
+    if (reached(Interactive) && reached(DeferredDone)) {
+        dumpTrace();
+    }
+}
+
+void StartupPipeline::defer(const char* name, std::function<void()> task) {
+    tasks_.push_back({name, std::move(task)});
+    if (tasks_started_ && !idle_timer_->isActive()) {
+        idle_timer_->start();
+    }
+}
+
+void StartupPipeline::watchFirstPaint(QWidget* window) {
+    paint_window_ = window;
+    qApp->installEventFilter(this);
+
+    // Never hold deferred work hostage to a window that does not paint
+    // (minimised start, offscreen platform)
+    QTimer::singleShot(3000, this, [this]() { mark(FirstPaint); });
+}
+
+bool StartupPipeline::eventFilter(QObject* obj, QEvent* event) {
+    if (event->type() == QEvent::Paint && paint_window_) {
+        QWidget* widget = qobject_cast<QWidget*>(obj);
+        if (widget && widget->window() == paint_window_) {
+            qApp->removeEventFilter(this);
+            paint_window_ = nullptr;
+            // Let this paint finish before deferred work starts
+            QTimer::singleShot(0, this, [this]() { mark(FirstPaint); });
+        }
+    }
+    return QObject::eventFilter(obj, event);
+}
+
+void StartupPipeline::startDeferredTasks() {
+    if (tasks_started_) return;
+    tasks_started_ = true;
+
+    idle_timer_ = new QTimer(this);
+    idle_timer_->setSingleShot(true);
+    idle_timer_->setInterval(0);
+    connect(idle_timer_, &QTimer::timeout, this, &StartupPipeline::runNextTask);
+    idle_timer_->start();
+}
+
+void StartupPipeline::runNextTask() {
+    if (tasks_.empty()) {
+        mark(DeferredDone);
+        return;
+    }
+
+    Task task = std::move(tasks_.front());
+    tasks_.pop_front();
+
+    quint64 start = Tracer::now_ns();
+    task.run();
+    quint64 end = Tracer::now_ns();
+    timings_.append({task.name, start, end});
+    TSUNAMI_TRACE_SPAN(task.name, start, end);
+
+    // One task per pass so queued input and paint events run in between
+    idle_timer_->start();
+}
+
+void StartupPipeline::enableTrace(const QString& output_path) {
+    trace_enabled_ = true;
+    trace_path_ = output_path;
+}
+
+void StartupPipeline::dumpTrace() {
+    if (!trace_enabled_ || trace_dumped_) return;
+    trace_dumped_ = true;
+
+    char line[160];
+    std::cerr << "[Tsunami] Startup trace (ms since process start)" << std::endl;
+    for (int m = ApplicationReady; m < MilestoneCount; ++m) {
+        std::snprintf(line, sizeof(line), "  %-22s %9.2f",
+                      milestoneName(m), elapsedMs(static_cast<Milestone>(m)));
+        std::cerr << line << std::endl;
+    }
+    std::cerr << "[Tsunami] Deferred tasks (start, duration)" << std::endl;
+    for (const TaskTiming& timing : timings_) {
+        std::snprintf(line, sizeof(line), "  %-22s %9.2f %9.2f", timing.name,
+                      (timing.start_ns - marks_[ProcessStart]) / 1e6,
+                      (timing.end_ns - timing.start_ns) / 1e6);
+        std::cerr << line << std::endl;
+    }
+
+#ifdef TSUNAMI_TRACING
+    if (!trace_path_.isEmpty()) {
+        QFile file(trace_path_);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(QByteArray::fromStdString(Tracer::instance().export_chrome_json()));
+            file.close();
+            std::cerr << "[Tsunami] Chrome trace written to " << trace_path_.toStdString() << std::endl;
+        }
+    }
+#endif
+}
+
+} // namespace Tsunami
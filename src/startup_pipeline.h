@@ -0,0 +1,84 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * startup_pipeline.h - Deferred startup work and cold-start milestones
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <deque>
+#include <functional>
+
+class QWidget;
+
+namespace Tsunami {
+
+// Keeps the critical path to first paint short. Work that the first frame
+// does not need is queued with defer() and run one task per event loop pass
+// once the window has painted, so input is never blocked for long.
+class StartupPipeline : public QObject {
+    Q_OBJECT
+public:
+    enum Milestone {
+        ProcessStart,
+        ApplicationReady,
+        WindowShown,
+        FirstPaint,
+        FirstTab,
+        Interactive,
+        DeferredDone,
+        MilestoneCount
+    };
+
+    static StartupPipeline& instance();
+
+    void mark(Milestone milestone);   // Only the first mark of each milestone counts
+    bool reached(Milestone milestone) const { return marks_[milestone] != 0; }
+    double elapsedMs(Milestone milestone) const;
+
+    void defer(const char* name, std::function<void()> task);
+    void watchFirstPaint(QWidget* window);
+
+    // --startup-trace[=path]: dump milestones once the browser is interactive
+    void enableTrace(const QString& output_path);
+
+signals:
+    void milestoneReached(int milestone);
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* event) override;
+
+private slots:
+    void runNextTask();
+
+private:
+    StartupPipeline();
+    void startDeferredTasks();
+    void dumpTrace();
+
+    struct Task {
+        const char* name;
+        std::function<void()> run;
+    };
+
+    struct TaskTiming {
+        const char* name;
+        quint64 start_ns;
+        quint64 end_ns;
+    };
+
+    quint64 marks_[MilestoneCount] = {};
+    std::deque<Task> tasks_;
+    QVector<TaskTiming> timings_;
+    QTimer* idle_timer_ = nullptr;
+    QWidget* paint_window_ = nullptr;
+    bool tasks_started_ = false;
+    bool trace_enabled_ = false;
+    bool trace_dumped_ = false;
+    QString trace_path_;
+};
+
+} // namespace Tsunami
@@ -0,0 +1,76 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * listener_list.h - Change listeners shared by the history, bookmark and download stores
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SeaBrowser {
+
+// Listeners run on whichever thread calls notify(), outside the list's
+// lock, so one may add or remove listeners, itself included. Once
+// remove() returns, that listener is not running on any thread and never
+// runs again: an object may remove its listener in its destructor even
+// while another thread is notifying.
+template <typename... Args>
+class ListenerList {
+public:
+    using Listener = std::function<void(Args...)>;
+
+    int add(Listener listener) {
+        auto entry = std::make_shared<Entry>();
+        entry->listener = std::move(listener);
+        std::lock_guard<std::mutex> lock(mutex_);
+        entry->id = next_id_++;
+        entries_.push_back(std::move(entry));
+        return entries_.back()->id;
+    }
+
+    void remove(int id) {
+        std::shared_ptr<Entry> entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = std::find_if(entries_.begin(), entries_.end(),
+                                   [id](const auto& e) { return e->id == id; });
+            if (it == entries_.end()) return;
+            entry = std::move(*it);
+            entries_.erase(it);
+        }
+        // Waits out a call in progress on another thread; recursive so a
+        // listener can remove itself
+        std::lock_guard<std::recursive_mutex> running(entry->running);
+        entry->removed = true;
+    }
+
+    void notify(Args... args) const {
+        std::vector<std::shared_ptr<Entry>> entries;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            entries = entries_;
+        }
+        for (const auto& entry : entries) {
+            std::lock_guard<std::recursive_mutex> running(entry->running);
+            if (!entry->removed) entry->listener(args...);
+        }
+    }
+
+private:
+    struct Entry {
+        int id = 0;
+        Listener listener;
+        std::recursive_mutex running;
+        bool removed = false;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<Entry>> entries_;
+    int next_id_ = 1;
+};
+
+} // namespace SeaBrowser
@@ -0,0 +1,68 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * result_set.cpp - Arena-backed SQLite query results and a streaming row cursor
+ */
+
+#include "storage/result_set.h"
+#include <cstring>
+
+namespace SeaBrowser {
+
+bool ResultSet::load(sqlite3_stmt* stmt, size_t expected_rows, size_t expected_bytes_per_row) {
+    arena_.clear();
+    cells_.clear();
+    columns_ = static_cast<size_t>(sqlite3_column_count(stmt));
+    if (columns_ == 0) return sqlite3_step(stmt) == SQLITE_DONE;
+    cells_.reserve(expected_rows * columns_);
+    arena_.reserve(expected_rows * expected_bytes_per_row);
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        for (size_t column = 0; column < columns_; ++column) {
+            int index = static_cast<int>(column);
+            Cell cell;
+            cell.type = sqlite3_column_type(stmt, index);
+            switch (cell.type) {
+            case SQLITE_INTEGER:
+                cell.integer = sqlite3_column_int64(stmt, index);
+                break;
+            case SQLITE_FLOAT:
+                cell.real = sqlite3_column_double(stmt, index);
+                break;
+            case SQLITE_TEXT:
+            case SQLITE_BLOB: {
+                // sqlite3_column_bytes after the pointer, as SQLite requires
+                const void* data = cell.type == SQLITE_TEXT
+                    ? static_cast<const void*>(sqlite3_column_text(stmt, index))
+                    : sqlite3_column_blob(stmt, index);
+                cell.length = static_cast<uint32_t>(sqlite3_column_bytes(stmt, index));
+                cell.offset = arena_.size();
+                if (cell.length) {
+                    arena_.resize(arena_.size() + cell.length);
+                    std::memcpy(arena_.data() + cell.offset, data, cell.length);
+                }
+                break;
+            }
+            default:
+                break;
+            }
+            cells_.push_back(cell);
+        }
+    }
+    return rc == SQLITE_DONE;
+}
+
+std::string_view ResultSet::text(size_t row, size_t column) const {
+    const Cell& value = cell(row, column);
+    if (value.type != SQLITE_TEXT && value.type != SQLITE_BLOB) return std::string_view();
+    return std::string_view(arena_.data() + value.offset, value.length);
+}
+
+long long ResultSet::int64(size_t row, size_t column) const {
+    const Cell& value = cell(row, column);
+    if (value.type == SQLITE_INTEGER) return value.integer;
+    if (value.type == SQLITE_FLOAT) return static_cast<long long>(value.real);
+    return 0;
+}
+
+} // namespace SeaBrowser
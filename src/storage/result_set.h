@@ -0,0 +1,92 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * result_set.h - Arena-backed SQLite query results and a streaming row cursor
+ */
+
+#pragma once
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace SeaBrowser {
+
+// One column of the row a statement is positioned on. NULL text reads as
+// an empty view rather than a null pointer.
+class RowView {
+public:
+    explicit RowView(sqlite3_stmt* stmt) : stmt_(stmt) {}
+
+    std::string_view text(int column) const {
+        const char* data = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, column));
+        if (!data) return std::string_view();
+        return std::string_view(data, static_cast<size_t>(sqlite3_column_bytes(stmt_, column)));
+    }
+    long long int64(int column) const { return sqlite3_column_int64(stmt_, column); }
+    bool is_null(int column) const { return sqlite3_column_type(stmt_, column) == SQLITE_NULL; }
+
+private:
+    sqlite3_stmt* stmt_;
+};
+
+// Steps stmt to the end, handing each row to visit without copying it.
+// Views are only valid during the call. A visitor returning bool stops
+// the walk by returning false. Returns the last sqlite3_step() result:
+// SQLITE_DONE when every row was read.
+template <typename Visitor>
+int for_each_row(sqlite3_stmt* stmt, Visitor&& visit) {
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        RowView row(stmt);
+        if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, const RowView&>, bool>) {
+            if (!visit(static_cast<const RowView&>(row))) break;
+        } else {
+            visit(static_cast<const RowView&>(row));
+        }
+    }
+    return rc;
+}
+
+// Every row of a query, kept after the statement is finalized. Text and
+// blobs are copied back to back into one arena and cells hold offsets
+// into it, so a result costs two growing buffers rather than a string per
+// column per row; with load()'s size hints it is usually two allocations.
+class ResultSet {
+public:
+    // Replaces the contents with every remaining row of stmt. False if a
+    // step failed; the rows read before it are kept.
+    bool load(sqlite3_stmt* stmt, size_t expected_rows = 0, size_t expected_bytes_per_row = 0);
+
+    size_t size() const { return columns_ ? cells_.size() / columns_ : 0; }
+    bool empty() const { return cells_.empty(); }
+    size_t columns() const { return columns_; }
+    size_t arena_bytes() const { return arena_.size(); }
+
+    // Views into the arena; valid until the next load() or destruction
+    std::string_view text(size_t row, size_t column) const;
+    long long int64(size_t row, size_t column) const;
+    bool is_null(size_t row, size_t column) const { return cell(row, column).type == SQLITE_NULL; }
+
+private:
+    struct Cell {
+        int type = SQLITE_NULL;
+        uint32_t length = 0;      // Text and blobs
+        union {
+            uint64_t offset;      // Into arena_, text and blobs
+            long long integer;
+            double real;
+        };
+        Cell() : offset(0) {}
+    };
+
+    const Cell& cell(size_t row, size_t column) const { return cells_[row * columns_ + column]; }
+
+    std::vector<char> arena_;
+    std::vector<Cell> cells_;
+    size_t columns_ = 0;
+};
+
+} // namespace SeaBrowser
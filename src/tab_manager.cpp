@@ -5,6 +5,8 @@
 
 #include "tab_manager.h"
 #include "web_view.h"
+#include "profile/profile_manager.h"
+#include <QWebEnginePage>
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QPushButton>
@@ -25,6 +27,7 @@ TabManager::~TabManager() {
 
 void TabManager::createTab(const QString& url) {
     auto web_view = new QWebEngineView();
+    web_view->setPage(new QWebEnginePage(ProfileManager::instance().defaultProfile(), web_view));
     WebView::setupPage(web_view->page());
     
     auto tab_widget = new QWidget();
@@ -0,0 +1,316 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * thumbnail_cache.cpp - Tab snapshots in a size-capped on-disk LRU cache
+ */
+
+#include "thumbnails/thumbnail_cache.h"
+#include "history/history_manager.h"
+#include "perf/trace.h"
+#include <QBuffer>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QImageWriter>
+#include <QPixmap>
+#include <QPointer>
+#include <QSaveFile>
+#include <QTimer>
+#include <QWidget>
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace Tsunami {
+
+ThumbnailCache& ThumbnailCache::instance() {
+    static ThumbnailCache instance;
+    return instance;
+}
+
+ThumbnailCache::ThumbnailCache()
+    : QObject(nullptr)
+{
+    pool_.setMaxThreadCount(2);
+
+    // WebP is a third the size of PNG for page snapshots, but its plugin
+    // is optional in Qt builds
+    format_ = QImageWriter::supportedImageFormats().contains("webp") ? "webp" : "png";
+
+    // Expiry removes visits in many small steps; prune once they settle
+    prune_timer_ = new QTimer(this);
+    prune_timer_->setSingleShot(true);
+    prune_timer_->setInterval(PRUNE_DELAY_MS);
+    connect(prune_timer_, &QTimer::timeout, this, &ThumbnailCache::prune);
+}
+
+ThumbnailCache::~ThumbnailCache() {
+    pool_.waitForDone();
+}
+
+void ThumbnailCache::init(const QString& dir, qint64 byte_budget) {
+    dir_ = dir;
+    budget_ = byte_budget;
+    QDir().mkpath(dir_);
+    pool_.start([this]() { scan(); });
+
+    if (!history_listener_) {
+        history_listener_ = SeaBrowser::HistoryManager::instance().add_listener(
+            [this](const SeaBrowser::HistoryEvent& event) {
+                QMetaObject::invokeMethod(this, [this, event]() { onHistoryEvent(event); },
+                                          Qt::QueuedConnection);
+            });
+    }
+}
+
+QString ThumbnailCache::pageKey(const QUrl& url) {
+    return url.adjusted(QUrl::RemoveFragment | QUrl::StripTrailingSlash).toString();
+}
+
+quint64 ThumbnailCache::keyHash(const QString& key) {
+    QByteArray bytes = key.toUtf8();
+    quint64 hash = 0xcbf29ce484222325ull;
+    for (char c : bytes) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+QString ThumbnailCache::filePath(quint64 hash) const {
+    return dir_ + QString("/%1.").arg(hash, 16, 16, QChar('0')) + QString::fromLatin1(format_);
+}
+
+// One "hash url" line per capture; later lines win
+QString ThumbnailCache::keyLogPath() const {
+    return dir_ + "/keys.log";
+}
+
+void ThumbnailCache::scan() {
+    TSUNAMI_TRACE_SCOPE("thumbnails.scan");
+    struct File {
+        quint64 hash;
+        qint64 size;
+        qint64 modified;
+    };
+    std::vector<File> files;
+    QString suffix = "." + QString::fromLatin1(format_);
+    const QFileInfoList infos = QDir(dir_).entryInfoList({"*" + suffix}, QDir::Files);
+    for (const QFileInfo& info : infos) {
+        bool ok = false;
+        quint64 hash = info.completeBaseName().toULongLong(&ok, 16);
+        if (ok) files.push_back({hash, info.size(), info.lastModified().toMSecsSinceEpoch()});
+    }
+    std::sort(files.begin(), files.end(),
+              [](const File& a, const File& b) { return a.modified > b.modified; });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    QHash<quint64, QString> urls;
+    QFile log(keyLogPath());
+    if (log.open(QIODevice::ReadOnly)) {
+        while (!log.atEnd()) {
+            QString line = QString::fromUtf8(log.readLine()).trimmed();
+            qsizetype space = line.indexOf(' ');
+            bool ok = false;
+            quint64 hash = line.left(space).toULongLong(&ok, 16);
+            if (ok && space > 0) urls.insert(hash, line.mid(space + 1));
+        }
+        log.close();
+    }
+
+    // Captures that landed while scanning are newer than anything on disk
+    for (const File& file : files) {
+        if (entries_.count(file.hash)) continue;
+        lru_.push_back(file.hash);
+        entries_[file.hash] = {file.size, std::prev(lru_.end()), urls.value(file.hash)};
+        total_bytes_ += file.size;
+    }
+    evict();
+
+    // Compacted to the live entries, so the log stays about one line each
+    QSaveFile compacted(keyLogPath());
+    if (compacted.open(QIODevice::WriteOnly)) {
+        for (const auto& [hash, entry] : entries_) {
+            if (entry.url.isEmpty()) continue;
+            compacted.write(QString("%1 %2\n").arg(hash, 16, 16, QChar('0')).arg(entry.url).toUtf8());
+        }
+        compacted.commit();
+    }
+}
+
+void ThumbnailCache::capture(QWidget* view, const QUrl& page_url) {
+    if (!view || !view->isVisible() || dir_.isEmpty()) return;
+    if (page_url.scheme() != "http" && page_url.scheme() != "https") return;
+
+    QString key = pageKey(page_url);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    auto last = last_capture_ms_.constFind(key);
+    if (last != last_capture_ms_.constEnd() && now - *last < MIN_CAPTURE_INTERVAL_MS) return;
+    if (last_capture_ms_.size() > 1024) last_capture_ms_.clear();
+    last_capture_ms_.insert(key, now);
+
+    TSUNAMI_TRACE_SCOPE("thumbnails.grab");
+    // Reads back the last composited frame; nothing is re-rendered
+    QImage frame = view->grab().toImage();
+    if (frame.isNull()) return;
+
+    // Looked up in the history as visited, without the fragment
+    QString url = page_url.adjusted(QUrl::RemoveFragment).toString();
+    pool_.start([this, key, url, page_url, frame]() {
+        TSUNAMI_TRACE_SCOPE("thumbnails.encode");
+        // Fill the tile and keep the top of the page, where the content starts
+        QImage scaled = frame.scaled(THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT,
+                                     Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+        scaled = scaled.copy((scaled.width() - THUMBNAIL_WIDTH) / 2, 0, THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT);
+
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        if (!scaled.save(&buffer, format_.constData(), 80)) return;
+
+        store(keyHash(key), url, data);
+        QMetaObject::invokeMethod(this, [this, page_url]() { emit thumbnailUpdated(page_url); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+void ThumbnailCache::store(quint64 hash, const QString& url, const QByteArray& data) {
+    QSaveFile file(filePath(hash));
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(hash);
+    bool logged = it != entries_.end() && it->second.url == url;
+    if (it != entries_.end()) {
+        total_bytes_ -= it->second.size;
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+    }
+    if (!logged) {
+        QFile log(keyLogPath());
+        if (log.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            log.write(QString("%1 %2\n").arg(hash, 16, 16, QChar('0')).arg(url).toUtf8());
+        }
+    }
+    lru_.push_front(hash);
+    entries_[hash] = {data.size(), lru_.begin(), url};
+    total_bytes_ += data.size();
+    evict();
+}
+
+void ThumbnailCache::evict() {
+    // Caller holds mutex_
+    while (total_bytes_ > budget_ && !lru_.empty()) {
+        remove(lru_.back());
+    }
+}
+
+void ThumbnailCache::remove(quint64 hash) {
+    // Caller holds mutex_; the key log keeps the line until the next start
+    auto it = entries_.find(hash);
+    if (it == entries_.end()) return;
+    total_bytes_ -= it->second.size;
+    lru_.erase(it->second.lru);
+    entries_.erase(it);
+    QFile::remove(filePath(hash));
+}
+
+void ThumbnailCache::clear() {
+    last_capture_ms_.clear();
+    pool_.start([this]() {
+        TSUNAMI_TRACE_SCOPE("thumbnails.clear");
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [hash, entry] : entries_) {
+            QFile::remove(filePath(hash));
+        }
+        entries_.clear();
+        lru_.clear();
+        total_bytes_ = 0;
+        QFile::remove(keyLogPath());
+    });
+}
+
+void ThumbnailCache::onHistoryEvent(const SeaBrowser::HistoryEvent& event) {
+    if (event.type == SeaBrowser::HistoryEvent::Cleared) {
+        prune_timer_->stop();
+        clear();
+    } else if (event.type == SeaBrowser::HistoryEvent::Removed && !event.item.url.empty()) {
+        // A deleted URL takes its page's thumbnail with it
+        QString key = pageKey(QUrl(QString::fromStdString(event.item.url)));
+        last_capture_ms_.remove(key);
+        quint64 hash = keyHash(key);
+        pool_.start([this, hash]() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            remove(hash);
+        });
+    } else if (event.type == SeaBrowser::HistoryEvent::Removed) {
+        // An expiry pass; several in a row are pruned once
+        prune_timer_->start();
+    }
+}
+
+// Deletes thumbnails of pages on sites no visit is to any more,
+// PRUNE_BATCH at a time so captures and fetches never wait on the lock
+// for long
+void ThumbnailCache::prune() {
+    pool_.start([this]() {
+        TSUNAMI_TRACE_SCOPE("thumbnails.prune");
+        std::vector<std::pair<quint64, QString>> pages;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& [hash, entry] : entries_) {
+                if (!entry.url.isEmpty()) pages.emplace_back(hash, entry.url);
+            }
+        }
+        auto& history = SeaBrowser::HistoryManager::instance();
+        for (size_t begin = 0; begin < pages.size(); begin += PRUNE_BATCH) {
+            size_t end = std::min(pages.size(), begin + PRUNE_BATCH);
+            std::vector<std::string> urls;
+            std::unordered_map<std::string, quint64> hashes;
+            for (size_t i = begin; i < end; ++i) {
+                urls.push_back(pages[i].second.toStdString());
+                hashes[urls.back()] = pages[i].first;
+            }
+            std::vector<std::string> gone = history.unvisited_sites(urls);
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const std::string& url : gone) remove(hashes[url]);
+        }
+    });
+}
+
+bool ThumbnailCache::touch(quint64 hash) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(hash);
+    if (it == entries_.end()) return false;
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    return true;
+}
+
+QString ThumbnailCache::cachedPath(const QUrl& page_url) const {
+    quint64 hash = keyHash(pageKey(page_url));
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.count(hash) ? filePath(hash) : QString();
+}
+
+void ThumbnailCache::fetchEncoded(const QUrl& page_url, QObject* context,
+                                  std::function<void(const QByteArray&, const QByteArray&)> done) {
+    quint64 hash = keyHash(pageKey(page_url));
+    QPointer<QObject> guard(context);
+    pool_.start([this, hash, guard, done = std::move(done)]() {
+        QByteArray data;
+        if (touch(hash)) {
+            QString path = filePath(hash);
+            QFile file(path);
+            if (file.open(QIODevice::ReadOnly)) data = file.readAll();
+            // Recency is kept on disk for the next start's scan
+            std::error_code ec;
+            std::filesystem::last_write_time(path.toStdString(),
+                                             std::filesystem::file_time_type::clock::now(), ec);
+        }
+        QByteArray mime = mimeType();
+        QMetaObject::invokeMethod(this, [guard, done, data, mime]() {
+            if (guard) done(data, mime);
+        }, Qt::QueuedConnection);
+    });
+}
+
+} // namespace Tsunami
@@ -0,0 +1,107 @@
+/*
+ * Tsunami Browser - Qt6 WebEngine Browser
+ * thumbnail_cache.h - Tab snapshots in a size-capped on-disk LRU cache
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QUrl>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+class QTimer;
+class QWidget;
+
+namespace SeaBrowser {
+struct HistoryEvent;
+}
+
+namespace Tsunami {
+
+// Downscaled snapshots of pages for new-tab tiles and tab hover previews.
+// The UI thread only grabs the frame the view has already composited;
+// scaling, encoding and file I/O run on the pool. Files are evicted least
+// recently used first once the cache exceeds its byte budget, and the
+// recency order survives restarts through the files' modification times.
+// A deleted URL's thumbnail goes with it. Each capture appends its page
+// URL to a key log, compacted on start, so after an expiry pass the
+// thumbnails of sites left with no visit can be found and deleted.
+class ThumbnailCache : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int THUMBNAIL_WIDTH = 320;
+    static constexpr int THUMBNAIL_HEIGHT = 200;
+    static constexpr qint64 DEFAULT_BUDGET = 32 * 1024 * 1024;
+    static constexpr qint64 MIN_CAPTURE_INTERVAL_MS = 10000;
+    static constexpr int PRUNE_BATCH = 500;
+    static constexpr int PRUNE_DELAY_MS = 5000;
+
+    static ThumbnailCache& instance();
+
+    void init(const QString& dir, qint64 byte_budget = DEFAULT_BUDGET);
+
+    // No-op for hidden views and for pages captured moments ago
+    void capture(QWidget* view, const QUrl& page_url);
+
+    // Path of the cached file, or empty; does not touch the disk
+    QString cachedPath(const QUrl& page_url) const;
+
+    // Encoded image for tsunami://thumbnail, delivered on the UI thread
+    void fetchEncoded(const QUrl& page_url, QObject* context,
+                      std::function<void(const QByteArray& data, const QByteArray& mime_type)> done);
+
+    QByteArray mimeType() const { return "image/" + format_; }
+
+    // Deletes every thumbnail, on the pool
+    void clear();
+
+signals:
+    void thumbnailUpdated(const QUrl& page_url);
+
+private:
+    ThumbnailCache();
+    ~ThumbnailCache() override;
+
+    struct Entry {
+        qint64 size;
+        std::list<quint64>::iterator lru;
+        QString url;   // Empty for files captured before the key log
+    };
+
+    static QString pageKey(const QUrl& url);
+    static quint64 keyHash(const QString& key);
+    QString filePath(quint64 hash) const;
+    QString keyLogPath() const;
+
+    void scan();
+    void store(quint64 hash, const QString& url, const QByteArray& data);
+    bool touch(quint64 hash);
+    void evict();
+    void remove(quint64 hash);
+    void onHistoryEvent(const SeaBrowser::HistoryEvent& event);
+    void prune();
+
+    QThreadPool pool_;
+    QString dir_;
+    QByteArray format_;
+    qint64 budget_ = DEFAULT_BUDGET;
+
+    // Shared with the pool; front of lru_ is the most recently used
+    mutable std::mutex mutex_;
+    std::list<quint64> lru_;
+    std::unordered_map<quint64, Entry> entries_;
+    qint64 total_bytes_ = 0;
+
+    QHash<QString, qint64> last_capture_ms_;   // UI thread only
+    QTimer* prune_timer_ = nullptr;
+    int history_listener_ = 0;
+};
+
+} // namespace Tsunami
@@ -1,5 +1,6 @@
 #include "bookmarks_window.h"
-#include "../settings/settings.h"
+#include "theme_engine.h"
+#include "../favicons/favicon_service.h"
 #include <QTableWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -12,6 +13,81 @@
 
 namespace Tsunami {
 
+namespace {
+
+QString buildBookmarksStyle(bool isDark, const QString& accentColor) {
+    QString bgColor = isDark ? "#030712" : "#f0f9ff";
+    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
+    QString inputBg = isDark ? "#1e293b" : "#ffffff";
+    QString borderColor = isDark ? "#1e293b" : "#bfdbfe";
+    QString headerBg = isDark ? "#0f172a" : "#dbeafe";
+    QString headerText = isDark ? "#64748b" : "#3b82f6";
+
+    QString style = QString(R"(
+        QDialog {
+            background-color: %1;
+            color: %2;
+        }
+    )").arg(bgColor, textColor);
+    style += QString(R"(
+        QLabel#dialogTitle { font-size: 20px; font-weight: 600; color: %1; }
+    )").arg(accentColor);
+    style += QString(R"(
+        QLineEdit#searchEdit {
+            background-color: %1;
+            color: %2;
+            border: 1px solid %3;
+            border-radius: 8px;
+            padding: 8px 12px;
+        }
+    )").arg(inputBg, textColor, borderColor);
+    style += QString(R"(
+        QPushButton#addButton {
+            background-color: %1;
+            color: white;
+            border: none;
+            border-radius: 8px;
+            padding: 8px 16px;
+            font-weight: 600;
+        }
+    )").arg(accentColor);
+    style += QString(R"(
+        QPushButton#deleteButton {
+            background-color: rgba(239, 68, 68, 0.15);
+            color: #dc2626;
+            border: 1px solid rgba(239, 68, 68, 0.3);
+            border-radius: 8px;
+            padding: 8px 16px;
+            font-weight: 600;
+        }
+    )");
+    style += QString(R"(
+        QTableWidget#bookmarksTable {
+            background-color: %1;
+            border: 1px solid %2;
+            border-radius: 8px;
+            color: %3;
+            font-size: 13px;
+        }
+        QTableWidget#bookmarksTable::item {
+            padding: 10px 12px;
+            border-bottom: 1px solid %2;
+        }
+        #bookmarksTable QHeaderView::section {
+            background-color: %4;
+            color: %5;
+            padding: 10px 12px;
+            font-weight: 600;
+            font-size: 12px;
+            text-transform: uppercase;
+            border-bottom: 1px solid %2;
+        }
+    )").arg(inputBg, borderColor, textColor, headerBg, headerText);
+    return style;
+}
+
+} // namespace
+
 BookmarksWindow::BookmarksWindow(QWidget* parent)
     : QDialog(parent)
 {
@@ -26,19 +102,23 @@ BookmarksWindow::BookmarksWindow(QWidget* parent)
 
     QHBoxLayout* header_layout = new QHBoxLayout();
     title_ = new QLabel("Bookmarks");
+    title_->setObjectName("dialogTitle");
     header_layout->addWidget(title_);
     header_layout->addStretch();
 
     search_edit_ = new QLineEdit();
+    search_edit_->setObjectName("searchEdit");
     search_edit_->setPlaceholderText("Search bookmarks...");
     search_edit_->setFixedWidth(200);
     header_layout->addWidget(search_edit_);
 
     add_btn_ = new QPushButton("Add Bookmark");
+    add_btn_->setObjectName("addButton");
     connect(add_btn_, &QPushButton::clicked, this, &BookmarksWindow::onAddBookmark);
     header_layout->addWidget(add_btn_);
 
     delete_btn_ = new QPushButton("Delete");
+    delete_btn_->setObjectName("deleteButton");
     connect(delete_btn_, &QPushButton::clicked, this, &BookmarksWindow::onDeleteBookmark);
     header_layout->addWidget(delete_btn_);
 
@@ -55,86 +135,22 @@ BookmarksWindow::BookmarksWindow(QWidget* parent)
     main_layout->addWidget(table_);
 
     applyTheme();
-    connect(&Settings::instance(), &Settings::settingsChanged, this, &BookmarksWindow::applyTheme);
+    connect(&ThemeEngine::instance(), &ThemeEngine::themeChanged, this, &BookmarksWindow::applyTheme);
+    connect(&FaviconService::instance(), &FaviconService::iconsLoaded, this, &BookmarksWindow::refreshIcons);
 }
 
 void BookmarksWindow::applyTheme() {
-    QString accentColor = Settings::instance().getAccentColor();
-    if (accentColor.isEmpty()) accentColor = "#60a5fa";
-
-    bool isDark = Settings::instance().getDarkMode();
-
-    QString bgColor = isDark ? "#030712" : "#f0f9ff";
-    QString titleColor = isDark ? "#e2e8f0" : "#1e40af";
-    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
-    QString inputBg = isDark ? "#1e293b" : "#ffffff";
-    QString borderColor = isDark ? "#1e293b" : "#bfdbfe";
-    QString headerBg = isDark ? "#0f172a" : "#dbeafe";
-    QString headerText = isDark ? "#64748b" : "#3b82f6";
-
-    title_->setStyleSheet(QString("font-size: 20px; font-weight: 600; color: %1;").arg(accentColor));
-
-    search_edit_->setStyleSheet(QString(R"(
-        QLineEdit {
-            background-color: %1;
-            color: %2;
-            border: 1px solid %3;
-            border-radius: 8px;
-            padding: 8px 12px;
-        }
-    )").arg(inputBg, textColor, borderColor));
-
-    add_btn_->setStyleSheet(QString(R"(
-        QPushButton {
-            background-color: %1;
-            color: white;
-            border: none;
-            border-radius: 8px;
-            padding: 8px 16px;
-            font-weight: 600;
-        }
-    )").arg(accentColor));
-
-    delete_btn_->setStyleSheet(QString(R"(
-        QPushButton {
-            background-color: rgba(239, 68, 68, 0.15);
-            color: #dc2626;
-            border: 1px solid rgba(239, 68, 68, 0.3);
-            border-radius: 8px;
-            padding: 8px 16px;
-            font-weight: 600;
-        }
-    )"));
-
-    table_->setStyleSheet(QString(R"(
-        QTableWidget {
-            background-color: %1;
-            border: 1px solid %2;
-            border-radius: 8px;
-            color: %3;
-            font-size: 13px;
-        }
-        QTableWidget::item {
-            padding: 10px 12px;
-            border-bottom: 1px solid %2;
-        }
-        QHeaderView::section {
-            background-color: %4;
-            color: %5;
-            padding: 10px 12px;
-            font-weight: 600;
-            font-size: 12px;
-            text-transform: uppercase;
-            border-bottom: 1px solid %2;
-        }
-    )").arg(inputBg, borderColor, textColor, headerBg, headerText));
+    ThemeEngine::instance().apply(this, "bookmarks", buildBookmarksStyle);
+}
 
-    setStyleSheet(QString(R"(
-        QDialog {
-            background-color: %1;
-            color: %2;
+void BookmarksWindow::refreshIcons() {
+    for (int row = 0; row < table_->rowCount(); ++row) {
+        QTableWidgetItem* title = table_->item(row, 0);
+        QTableWidgetItem* url = table_->item(row, 1);
+        if (title && url && title->icon().isNull()) {
+            title->setIcon(FaviconService::instance().icon(QUrl(url->text())));
         }
-    )").arg(bgColor, textColor));
+    }
 }
 
 void BookmarksWindow::onAddBookmark() {
@@ -142,7 +158,8 @@ void BookmarksWindow::onAddBookmark() {
     if (!url.isEmpty()) {
         int row = table_->rowCount();
         table_->insertRow(row);
-        table_->setItem(row, 0, new QTableWidgetItem(url.split("/").last()));
+        table_->setItem(row, 0, new QTableWidgetItem(FaviconService::instance().icon(QUrl(url)),
+                                                     url.split("/").last()));
         table_->setItem(row, 1, new QTableWidgetItem(url));
         table_->setItem(row, 2, new QTableWidgetItem("General"));
     }
@@ -21,6 +21,7 @@ private slots:
     void onAddBookmark();
     void onDeleteBookmark();
     void onItemDoubleClicked(QTableWidgetItem* item);
+    void refreshIcons();
 
 private:
     QLabel* title_;
@@ -0,0 +1,193 @@
+#include "downloads_model.h"
+#include <QApplication>
+#include <QLocale>
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOptionProgressBar>
+
+namespace Tsunami {
+
+namespace {
+
+QString stateText(const SeaBrowser::Download& download) {
+    switch (download.state) {
+        case SeaBrowser::DownloadState::InProgress: return QStringLiteral("Downloading");
+        case SeaBrowser::DownloadState::Completed: return QStringLiteral("Completed");
+        case SeaBrowser::DownloadState::Failed: return QStringLiteral("Failed");
+        case SeaBrowser::DownloadState::Cancelled: return QStringLiteral("Cancelled");
+        case SeaBrowser::DownloadState::Paused: return QStringLiteral("Paused");
+    }
+    return QString();
+}
+
+bool isActive(SeaBrowser::DownloadState state) {
+    return state == SeaBrowser::DownloadState::InProgress || state == SeaBrowser::DownloadState::Paused;
+}
+
+} // namespace
+
+DownloadsModel::DownloadsModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+    listener_id_ = SeaBrowser::DownloadsManager::instance().add_listener(
+        [this](const SeaBrowser::DownloadEvent& event) { onDownloadEvent(event); });
+}
+
+DownloadsModel::~DownloadsModel() {
+    SeaBrowser::DownloadsManager::instance().remove_listener(listener_id_);
+}
+
+int DownloadsModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : rows_.size();
+}
+
+int DownloadsModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant DownloadsModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+    switch (section) {
+        case NameColumn: return QStringLiteral("Name");
+        case StatusColumn: return QStringLiteral("Status");
+        case SizeColumn: return QStringLiteral("Size");
+        case LocationColumn: return QStringLiteral("Location");
+    }
+    return QVariant();
+}
+
+QVariant DownloadsModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rows_.size()) return QVariant();
+    const SeaBrowser::Download& download = rows_.at(index.row());
+
+    switch (role) {
+        case IdRole: return QString::fromStdString(download.id);
+        case PathRole: return QString::fromStdString(download.path);
+        case StateRole: return static_cast<int>(download.state);
+        case ProgressRole:
+            if (download.total_bytes == 0) return -1.0;
+            return double(download.received_bytes) / double(download.total_bytes);
+        case Qt::DisplayRole:
+        case Qt::ToolTipRole:
+            break;
+        default:
+            return QVariant();
+    }
+
+    switch (index.column()) {
+        case NameColumn:
+            return QString::fromStdString(download.filename);
+        case StatusColumn:
+            if (download.state == SeaBrowser::DownloadState::Failed && !download.error_message.empty()) {
+                return stateText(download) + ": " + QString::fromStdString(download.error_message);
+            }
+            return stateText(download);
+        case SizeColumn: {
+            QLocale locale;
+            if (isActive(download.state) && download.total_bytes > 0) {
+                return locale.formattedDataSize(download.received_bytes) + " / " +
+                       locale.formattedDataSize(download.total_bytes);
+            }
+            return download.total_bytes ? locale.formattedDataSize(download.total_bytes) : QString();
+        }
+        case LocationColumn:
+            return QString::fromStdString(download.path);
+    }
+    return QVariant();
+}
+
+bool DownloadsModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() &&
+           static_cast<size_t>(rows_.size()) < SeaBrowser::DownloadsManager::instance().count();
+}
+
+void DownloadsModel::fetchMore(const QModelIndex& parent) {
+    if (parent.isValid()) return;
+
+    auto page = SeaBrowser::DownloadsManager::instance().get_page(rows_.size(), PAGE_SIZE);
+    if (page.empty()) return;
+
+    beginInsertRows(QModelIndex(), rows_.size(), rows_.size() + static_cast<int>(page.size()) - 1);
+    for (auto& download : page) {
+        rows_.append(std::move(download));
+    }
+    endInsertRows();
+}
+
+void DownloadsModel::reload() {
+    beginResetModel();
+    rows_.clear();
+    endResetModel();
+}
+
+int DownloadsModel::rowOf(const std::string& id) const {
+    for (int row = 0; row < rows_.size(); ++row) {
+        if (rows_.at(row).id == id) return row;
+    }
+    return -1;
+}
+
+void DownloadsModel::onDownloadEvent(const SeaBrowser::DownloadEvent& event) {
+    auto& manager = SeaBrowser::DownloadsManager::instance();
+
+    switch (event.type) {
+        case SeaBrowser::DownloadEvent::Added: {
+            const SeaBrowser::Download* download = manager.get_download(event.id);
+            if (!download) return;
+            beginInsertRows(QModelIndex(), 0, 0);
+            rows_.prepend(*download);
+            endInsertRows();
+            break;
+        }
+        case SeaBrowser::DownloadEvent::Updated:
+        case SeaBrowser::DownloadEvent::Progress: {
+            int row = rowOf(event.id);
+            const SeaBrowser::Download* download = manager.get_download(event.id);
+            if (row < 0 || !download) return;
+            rows_[row] = *download;
+            emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+            break;
+        }
+        case SeaBrowser::DownloadEvent::Removed: {
+            int row = rowOf(event.id);
+            if (row < 0) return;
+            beginRemoveRows(QModelIndex(), row, row);
+            rows_.remove(row);
+            endRemoveRows();
+            break;
+        }
+        case SeaBrowser::DownloadEvent::Reset:
+            reload();
+            break;
+    }
+}
+
+void DownloadProgressDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
+                                     const QModelIndex& index) const {
+    if (index.column() != DownloadsModel::StatusColumn) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    auto state = static_cast<SeaBrowser::DownloadState>(index.data(DownloadsModel::StateRole).toInt());
+    double progress = index.data(DownloadsModel::ProgressRole).toDouble();
+    if (!isActive(state) || progress < 0) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    QStyleOptionProgressBar bar;
+    bar.rect = option.rect.adjusted(8, 8, -8, -8);
+    bar.minimum = 0;
+    bar.maximum = 1000;
+    bar.progress = static_cast<int>(progress * 1000);
+    bar.text = index.data(Qt::DisplayRole).toString();
+    bar.textVisible = true;
+    bar.state = option.state;
+
+    const QWidget* widget = option.widget;
+    QStyle* style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ProgressBar, &bar, painter, widget);
+}
+
+} // namespace Tsunami
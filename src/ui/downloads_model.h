@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QStyledItemDelegate>
+#include <QVector>
+#include "../downloads/downloads_manager.h"
+
+namespace Tsunami {
+
+// Table model over DownloadsManager. Rows are fetched in pages and kept in
+// sync through the manager's change events, so a progress tick repaints a
+// single row instead of rebuilding the table.
+class DownloadsModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { NameColumn, StatusColumn, SizeColumn, LocationColumn, ColumnCount };
+    enum Role {
+        IdRole = Qt::UserRole + 1,
+        PathRole,
+        StateRole,
+        ProgressRole    // 0..1, or -1 when the size is unknown
+    };
+
+    static constexpr int PAGE_SIZE = 128;
+
+    explicit DownloadsModel(QObject* parent = nullptr);
+    ~DownloadsModel() override;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+public slots:
+    void reload();
+
+private:
+    int rowOf(const std::string& id) const;
+    void onDownloadEvent(const SeaBrowser::DownloadEvent& event);
+
+    QVector<SeaBrowser::Download> rows_;
+    int listener_id_ = 0;
+};
+
+// Draws a progress bar in the status column of active downloads
+class DownloadProgressDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option,
+               const QModelIndex& index) const override;
+};
+
+} // namespace Tsunami
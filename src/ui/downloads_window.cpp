@@ -1,6 +1,7 @@
 #include "downloads_window.h"
-#include "../settings/settings.h"
-#include <QTableWidget>
+#include "theme_engine.h"
+#include "downloads_model.h"
+#include <QTableView>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -10,57 +11,15 @@
 #include <QStyle>
 #include <QMessageBox>
 #include <QDir>
+#include <QDesktopServices>
+#include <QUrl>
 #include <QHeaderView>
 
 namespace Tsunami {
 
-DownloadsWindow::DownloadsWindow(QWidget* parent)
-    : QDialog(parent)
-{
-    setWindowTitle("Downloads - Tsunami");
-    setMinimumSize(700, 500);
-    resize(800, 550);
-
-    QVBoxLayout* main_layout = new QVBoxLayout(this);
-    main_layout->setContentsMargins(16, 16, 16, 16);
-    main_layout->setSpacing(12);
-
-    QHBoxLayout* header_layout = new QHBoxLayout();
-    title_ = new QLabel("Downloads");
-    header_layout->addWidget(title_);
-    header_layout->addStretch();
-
-    open_folder_btn_ = new QPushButton("Open Folder");
-    connect(open_folder_btn_, &QPushButton::clicked, this, &DownloadsWindow::onOpenFolder);
-
-    clear_btn_ = new QPushButton("Clear Completed");
-    connect(clear_btn_, &QPushButton::clicked, this, &DownloadsWindow::onClearCompleted);
-
-    header_layout->addWidget(open_folder_btn_);
-    header_layout->addWidget(clear_btn_);
-    main_layout->addLayout(header_layout);
-
-    table_ = new QTableWidget(0, 4);
-    table_->setObjectName("downloadsTable");
-    table_->setHorizontalHeaderLabels(QStringList() << "Name" << "Status" << "Size" << "Location");
-    table_->horizontalHeader()->setStretchLastSection(true);
-    table_->verticalHeader()->setVisible(false);
-    table_->setSelectionBehavior(QAbstractItemView::SelectRows);
-    table_->setAlternatingRowColors(true);
-    connect(table_, &QTableWidget::itemActivated, this, &DownloadsWindow::onItemActivated);
-
-    main_layout->addWidget(table_);
-
-    applyTheme();
-    connect(&Settings::instance(), &Settings::settingsChanged, this, &DownloadsWindow::applyTheme);
-}
-
-void DownloadsWindow::applyTheme() {
-    QString accentColor = Settings::instance().getAccentColor();
-    if (accentColor.isEmpty()) accentColor = "#60a5fa";
-
-    bool isDark = Settings::instance().getDarkMode();
+namespace {
 
+QString buildDownloadsStyle(bool isDark, const QString& accentColor) {
     QString bgColor = isDark ? "#030712" : "#f0f9ff";
     QString titleColor = isDark ? "#e2e8f0" : "#1e40af";
     QString textColor = isDark ? "#e2e8f0" : "#1e293b";
@@ -70,10 +29,20 @@ void DownloadsWindow::applyTheme() {
     QString headerText = isDark ? "#64748b" : "#3b82f6";
     QString selectedBg = isDark ? "rgba(96, 165, 250, 0.2)" : "#bfdbfe";
 
-    title_->setStyleSheet(QString("font-size: 20px; font-weight: 600; color: %1;").arg(titleColor));
-
-    open_folder_btn_->setStyleSheet(QString(R"(
-        QPushButton {
+    QString style = QString(R"(
+        QDialog {
+            background-color: %1;
+            color: %2;
+        }
+        QLabel {
+            color: %2;
+        }
+    )").arg(bgColor, textColor);
+    style += QString(R"(
+        QLabel#dialogTitle { font-size: 20px; font-weight: 600; color: %1; }
+    )").arg(titleColor);
+    style += QString(R"(
+        QPushButton#openFolderButton {
             background-color: %1;
             color: white;
             border: none;
@@ -82,13 +51,12 @@ void DownloadsWindow::applyTheme() {
             font-weight: 600;
             font-size: 13px;
         }
-        QPushButton:hover {
+        QPushButton#openFolderButton:hover {
             opacity: 0.9;
         }
-    )").arg(accentColor));
-
-    clear_btn_->setStyleSheet(QString(R"(
-        QPushButton {
+    )").arg(accentColor);
+    style += QString(R"(
+        QPushButton#clearButton {
             background-color: rgba(239, 68, 68, 0.15);
             color: #dc2626;
             border: 1px solid rgba(239, 68, 68, 0.3);
@@ -97,13 +65,12 @@ void DownloadsWindow::applyTheme() {
             font-weight: 600;
             font-size: 13px;
         }
-        QPushButton:hover {
+        QPushButton#clearButton:hover {
             background-color: rgba(239, 68, 68, 0.25);
         }
-    )"));
-
-    table_->setStyleSheet(QString(R"(
-        QTableWidget {
+    )");
+    style += QString(R"(
+        QTableView#downloadsTable {
             background-color: %1;
             border: 1px solid %2;
             border-radius: 8px;
@@ -111,14 +78,14 @@ void DownloadsWindow::applyTheme() {
             color: %3;
             font-size: 13px;
         }
-        QTableWidget::item {
+        QTableView#downloadsTable::item {
             padding: 10px 12px;
             border-bottom: 1px solid %2;
         }
-        QTableWidget::item:selected {
+        QTableView#downloadsTable::item:selected {
             background-color: %4;
         }
-        QHeaderView::section {
+        #downloadsTable QHeaderView::section {
             background-color: %5;
             color: %6;
             padding: 10px 12px;
@@ -127,42 +94,96 @@ void DownloadsWindow::applyTheme() {
             text-transform: uppercase;
             border-bottom: 1px solid %2;
         }
-        QScrollBar:vertical {
+        #downloadsTable QScrollBar:vertical {
             background: %1;
             width: 10px;
         }
-        QScrollBar::handle:vertical {
+        #downloadsTable QScrollBar::handle:vertical {
             background: %7;
             border-radius: 5px;
             min-height: 20px;
         }
-        QScrollBar::handle:vertical:hover {
+        #downloadsTable QScrollBar::handle:vertical:hover {
             background: %8;
         }
     )").arg(inputBg, borderColor, textColor, selectedBg, headerBg, headerText,
-           isDark ? "#334155" : "#93c5fd", isDark ? "#475569" : "#60a5fa"));
+           isDark ? "#334155" : "#93c5fd", isDark ? "#475569" : "#60a5fa");
+    return style;
+}
 
-    setStyleSheet(QString(R"(
-        QDialog {
-            background-color: %1;
-            color: %2;
-        }
-        QLabel {
-            color: %2;
-        }
-    )").arg(bgColor, textColor));
+} // namespace
+
+DownloadsWindow::DownloadsWindow(QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Downloads - Tsunami");
+    setMinimumSize(700, 500);
+    resize(800, 550);
+
+    QVBoxLayout* main_layout = new QVBoxLayout(this);
+    main_layout->setContentsMargins(16, 16, 16, 16);
+    main_layout->setSpacing(12);
+
+    QHBoxLayout* header_layout = new QHBoxLayout();
+    title_ = new QLabel("Downloads");
+    title_->setObjectName("dialogTitle");
+    header_layout->addWidget(title_);
+    header_layout->addStretch();
+
+    open_folder_btn_ = new QPushButton("Open Folder");
+    open_folder_btn_->setObjectName("openFolderButton");
+    connect(open_folder_btn_, &QPushButton::clicked, this, &DownloadsWindow::onOpenFolder);
+
+    clear_btn_ = new QPushButton("Clear Completed");
+    clear_btn_->setObjectName("clearButton");
+    connect(clear_btn_, &QPushButton::clicked, this, &DownloadsWindow::onClearCompleted);
+
+    header_layout->addWidget(open_folder_btn_);
+    header_layout->addWidget(clear_btn_);
+    main_layout->addLayout(header_layout);
+
+    model_ = new DownloadsModel(this);
+
+    table_ = new QTableView();
+    table_->setObjectName("downloadsTable");
+    table_->setModel(model_);
+    table_->horizontalHeader()->setStretchLastSection(true);
+    table_->setColumnWidth(DownloadsModel::NameColumn, 240);
+    table_->setColumnWidth(DownloadsModel::StatusColumn, 180);
+    table_->setColumnWidth(DownloadsModel::SizeColumn, 140);
+    table_->verticalHeader()->setVisible(false);
+    table_->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    table_->verticalHeader()->setDefaultSectionSize(40);
+    table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table_->setAlternatingRowColors(true);
+    table_->setWordWrap(false);
+    table_->setItemDelegate(new DownloadProgressDelegate(table_));
+    connect(table_, &QTableView::activated, this, &DownloadsWindow::onItemActivated);
+
+    main_layout->addWidget(table_);
+
+    applyTheme();
+    connect(&ThemeEngine::instance(), &ThemeEngine::themeChanged, this, &DownloadsWindow::applyTheme);
+}
+
+void DownloadsWindow::applyTheme() {
+    ThemeEngine::instance().apply(this, "downloads", buildDownloadsStyle);
 }
 
 void DownloadsWindow::onOpenFolder() {
-    QMessageBox::information(this, "Downloads", "Opening downloads folder...");
+    QDesktopServices::openUrl(QUrl::fromLocalFile(
+        QString::fromStdString(SeaBrowser::DownloadsManager::instance().downloads_folder())));
 }
 
 void DownloadsWindow::onClearCompleted() {
-    QMessageBox::information(this, "Downloads", "Clearing completed downloads...");
+    SeaBrowser::DownloadsManager::instance().clear_completed();
 }
 
-void DownloadsWindow::onItemActivated(QTableWidgetItem* item) {
-    Q_UNUSED(item)
+void DownloadsWindow::onItemActivated(const QModelIndex& index) {
+    auto state = static_cast<SeaBrowser::DownloadState>(index.data(DownloadsModel::StateRole).toInt());
+    if (state == SeaBrowser::DownloadState::Completed) {
+        QDesktopServices::openUrl(QUrl::fromLocalFile(index.data(DownloadsModel::PathRole).toString()));
+    }
 }
 
 } // namespace Tsunami
@@ -4,13 +4,15 @@
 #include <QDialog>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QTableWidget>
+#include <QTableView>
 #include <QPushButton>
 #include <QLabel>
 #include <QHeaderView>
 
 namespace Tsunami {
 
+class DownloadsModel;
+
 class DownloadsWindow : public QDialog {
     Q_OBJECT
 public:
@@ -20,11 +22,12 @@ public:
 private slots:
     void onOpenFolder();
     void onClearCompleted();
-    void onItemActivated(QTableWidgetItem* item);
+    void onItemActivated(const QModelIndex& index);
 
 private:
     QLabel* title_;
-    QTableWidget* table_;
+    QTableView* table_;
+    DownloadsModel* model_;
     QPushButton* open_folder_btn_;
     QPushButton* clear_btn_;
 };
@@ -1,5 +1,5 @@
 #include "extensions_window.h"
-#include "../settings/settings.h"
+#include "theme_engine.h"
 #include <QListWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -13,6 +13,74 @@
 
 namespace Tsunami {
 
+namespace {
+
+QString buildExtensionsStyle(bool isDark, const QString& accentColor) {
+    QString bgColor = isDark ? "#030712" : "#f0f9ff";
+    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
+    QString inputBg = isDark ? "#1e293b" : "#ffffff";
+    QString borderColor = isDark ? "#1e293b" : "#bfdbfe";
+
+    QString style = QString(R"(
+        QDialog {
+            background-color: %1;
+            color: %2;
+        }
+        QCheckBox {
+            color: %2;
+            spacing: 8px;
+        }
+        QCheckBox::indicator {
+            width: 16px;
+            height: 16px;
+            border-radius: 4px;
+            border: 1px solid %4;
+            background: %3;
+        }
+        QCheckBox::indicator:checked {
+            background: %5;
+            border-color: %5;
+        }
+    )").arg(bgColor, textColor, inputBg, borderColor, accentColor);
+    style += QString(R"(
+        QLabel#dialogTitle { font-size: 20px; font-weight: 600; color: %1; }
+    )").arg(accentColor);
+    style += QString(R"(
+        QCheckBox#devModeCheck { color: %1; font-size: 13px; }
+    )").arg(isDark ? "#94a3b8" : "#64748b");
+    style += QString(R"(
+        QPushButton#importButton {
+            background-color: %1;
+            color: white;
+            border: none;
+            border-radius: 8px;
+            padding: 8px 16px;
+            font-weight: 600;
+        }
+    )").arg(accentColor);
+    style += QString(R"(
+        QListWidget#extensionsList {
+            background-color: %1;
+            border: 1px solid %2;
+            border-radius: 8px;
+            color: %3;
+        }
+        QListWidget#extensionsList::item {
+            padding: 12px 16px;
+            border-bottom: 1px solid %2;
+        }
+        QListWidget#extensionsList::item:selected {
+            background-color: %4;
+        }
+    )").arg(inputBg, borderColor, textColor, isDark ? "rgba(96, 165, 250, 0.15)" : "#bfdbfe");
+    style += QString(R"(
+        QLabel#infoLabel { font-size: 12px; color: %1; }
+    )").arg(isDark ? "#64748b" : "#64748b");
+    return style;
+}
+
+} // namespace
+
 ExtensionsWindow::ExtensionsWindow(QWidget* parent)
     : QDialog(parent)
 {
@@ -27,14 +95,17 @@ ExtensionsWindow::ExtensionsWindow(QWidget* parent)
 
     QHBoxLayout* header_layout = new QHBoxLayout();
     title_ = new QLabel("Extensions");
+    title_->setObjectName("dialogTitle");
     header_layout->addWidget(title_);
     header_layout->addStretch();
 
     dev_mode_check_ = new QCheckBox("Developer Mode");
+    dev_mode_check_->setObjectName("devModeCheck");
     connect(dev_mode_check_, &QCheckBox::toggled, this, &ExtensionsWindow::onDeveloperModeToggled);
     header_layout->addWidget(dev_mode_check_);
 
     import_btn_ = new QPushButton("Import Chrome Extensions");
+    import_btn_->setObjectName("importButton");
     connect(import_btn_, &QPushButton::clicked, this, &ExtensionsWindow::onImportChromeExtensions);
     header_layout->addWidget(import_btn_);
 
@@ -61,80 +132,15 @@ ExtensionsWindow::ExtensionsWindow(QWidget* parent)
     main_layout->addWidget(list_);
 
     info_ = new QLabel("Import Chrome extensions by clicking the button above. Tsunami supports Chrome extension imports.");
+    info_->setObjectName("infoLabel");
     main_layout->addWidget(info_);
 
     applyTheme();
-    connect(&Settings::instance(), &Settings::settingsChanged, this, &ExtensionsWindow::applyTheme);
+    connect(&ThemeEngine::instance(), &ThemeEngine::themeChanged, this, &ExtensionsWindow::applyTheme);
 }
 
 void ExtensionsWindow::applyTheme() {
-    QString accentColor = Settings::instance().getAccentColor();
-    if (accentColor.isEmpty()) accentColor = "#60a5fa";
-
-    bool isDark = Settings::instance().getDarkMode();
-
-    QString bgColor = isDark ? "#030712" : "#f0f9ff";
-    QString titleColor = isDark ? "#e2e8f0" : "#1e40af";
-    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
-    QString inputBg = isDark ? "#1e293b" : "#ffffff";
-    QString borderColor = isDark ? "#1e293b" : "#bfdbfe";
-    QString headerBg = isDark ? "#0f172a" : "#dbeafe";
-    QString headerText = isDark ? "#64748b" : "#3b82f6";
-
-    title_->setStyleSheet(QString("font-size: 20px; font-weight: 600; color: %1;").arg(accentColor));
-
-    dev_mode_check_->setStyleSheet(QString("color: %1; font-size: 13px;").arg(isDark ? "#94a3b8" : "#64748b"));
-
-    import_btn_->setStyleSheet(QString(R"(
-        QPushButton {
-            background-color: %1;
-            color: white;
-            border: none;
-            border-radius: 8px;
-            padding: 8px 16px;
-            font-weight: 600;
-        }
-    )").arg(accentColor));
-
-    list_->setStyleSheet(QString(R"(
-        QListWidget {
-            background-color: %1;
-            border: 1px solid %2;
-            border-radius: 8px;
-            color: %3;
-        }
-        QListWidget::item {
-            padding: 12px 16px;
-            border-bottom: 1px solid %2;
-        }
-        QListWidget::item:selected {
-            background-color: %4;
-        }
-    )").arg(inputBg, borderColor, textColor, isDark ? "rgba(96, 165, 250, 0.15)" : "#bfdbfe"));
-
-    info_->setStyleSheet(QString("font-size: 12px; color: %1;").arg(isDark ? "#64748b" : "#64748b"));
-
-    setStyleSheet(QString(R"(
-        QDialog {
-            background-color: %1;
-            color: %2;
-        }
-        QCheckBox {
-            color: %2;
-            spacing: 8px;
-        }
-        QCheckBox::indicator {
-            width: 16px;
-            height: 16px;
-            border-radius: 4px;
-            border: 1px solid %4;
-            background: %3;
-        }
-        QCheckBox::indicator:checked {
-            background: %5;
-            border-color: %5;
-        }
-    )").arg(bgColor, textColor, inputBg, borderColor, accentColor));
+    ThemeEngine::instance().apply(this, "extensions", buildExtensionsStyle);
 }
 
 void ExtensionsWindow::onImportChromeExtensions() {
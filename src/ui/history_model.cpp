@@ -0,0 +1,188 @@
+#include "history_model.h"
+#include "../history/history_manager.h"
+#include "../perf/trace.h"
+#include "../favicons/favicon_service.h"
+#include <QDateTime>
+#include <QLocale>
+
+namespace Tsunami {
+
+namespace {
+
+QString formatVisit(qint64 timestamp) {
+    return QLocale().toString(QDateTime::fromSecsSinceEpoch(timestamp), QLocale::ShortFormat);
+}
+
+} // namespace
+
+HistoryModel::HistoryModel(QObject* parent)
+    : QAbstractTableModel(parent)
+    , pages_(CACHED_PAGES)
+{
+    // History can change on any thread; hop to ours before touching rows
+    listener_id_ = SeaBrowser::HistoryManager::instance().add_listener(
+        [this](const SeaBrowser::HistoryEvent& event) {
+            QMetaObject::invokeMethod(this, [this, event]() { onHistoryEvent(event); },
+                                      Qt::QueuedConnection);
+        });
+    connect(&FaviconService::instance(), &FaviconService::iconsLoaded, this, &HistoryModel::onIconsLoaded);
+}
+
+HistoryModel::~HistoryModel() {
+    SeaBrowser::HistoryManager::instance().remove_listener(listener_id_);
+}
+
+int HistoryModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(keys_.size());
+}
+
+int HistoryModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant HistoryModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+    switch (section) {
+        case TitleColumn: return QStringLiteral("Title");
+        case UrlColumn: return QStringLiteral("URL");
+        case VisitedColumn: return QStringLiteral("Visited");
+    }
+    return QVariant();
+}
+
+QVariant HistoryModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+    if (role != Qt::DisplayRole && role != Qt::ToolTipRole && role != UrlRole &&
+        role != Qt::DecorationRole) return QVariant();
+    if (role == Qt::DecorationRole && index.column() != TitleColumn) return QVariant();
+
+    const Page* rows = page(index.row() / PAGE_SIZE);
+    int offset = index.row() % PAGE_SIZE;
+    if (!rows || offset >= rows->size()) return QVariant();
+
+    const Row& row = rows->at(offset);
+    if (role == UrlRole) return row.url;
+    // Only asked for painted rows, so icons load as the view scrolls
+    if (role == Qt::DecorationRole) return FaviconService::instance().icon(QUrl(row.url));
+    switch (index.column()) {
+        case TitleColumn: return row.title;
+        case UrlColumn: return row.url;
+        case VisitedColumn: return row.visited;
+    }
+    return QVariant();
+}
+
+QUrl HistoryModel::urlAt(int row) const {
+    return QUrl(data(index(row, UrlColumn), UrlRole).toString());
+}
+
+HistoryModel::Page HistoryModel::makePage(const SeaBrowser::ResultSet& visits) {
+    // Straight from the arena to QString, with no std::string in between
+    auto text = [&visits](size_t row, size_t column) {
+        std::string_view view = visits.text(row, column);
+        return QString::fromUtf8(view.data(), static_cast<qsizetype>(view.size()));
+    };
+    Page rows;
+    rows.reserve(static_cast<int>(visits.size()));
+    for (size_t i = 0; i < visits.size(); ++i) {
+        rows.append({text(i, 2), text(i, 1), formatVisit(visits.int64(i, 3))});
+    }
+    return rows;
+}
+
+const HistoryModel::Page* HistoryModel::page(int index) const {
+    if (Page* cached = pages_.object(index)) return cached;
+
+    TSUNAMI_TRACE_SCOPE("historyModel.loadPage");
+    // The key of the last row on the previous page anchors this one
+    qint64 before_timestamp = 0;
+    qint64 before_id = 0;
+    if (index > 0) {
+        const Key& anchor = keys_[static_cast<size_t>(index) * PAGE_SIZE - 1];
+        before_timestamp = anchor.timestamp;
+        before_id = anchor.id;
+    }
+
+    auto visits = SeaBrowser::HistoryManager::instance().get_page_rows(
+        before_timestamp, before_id, PAGE_SIZE, filter_.toStdString());
+    Page* rows = new Page(makePage(visits));
+    pages_.insert(index, rows);
+    return rows;
+}
+
+bool HistoryModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() && !at_end_;
+}
+
+void HistoryModel::fetchMore(const QModelIndex& parent) {
+    if (parent.isValid() || at_end_) return;
+
+    TSUNAMI_TRACE_SCOPE("historyModel.fetchMore");
+    qint64 before_timestamp = 0;
+    qint64 before_id = 0;
+    if (!keys_.empty()) {
+        before_timestamp = keys_.back().timestamp;
+        before_id = keys_.back().id;
+    }
+
+    auto visits = SeaBrowser::HistoryManager::instance().get_page_rows(
+        before_timestamp, before_id, PAGE_SIZE, filter_.toStdString());
+    if (static_cast<int>(visits.size()) < PAGE_SIZE) at_end_ = true;
+    if (visits.empty()) return;
+
+    int first = static_cast<int>(keys_.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(visits.size()) - 1);
+    for (size_t i = 0; i < visits.size(); ++i) {
+        keys_.push_back({visits.int64(i, 3), visits.int64(i, 0)});
+    }
+    // Rows just fetched are usually the ones about to be painted
+    if (first % PAGE_SIZE == 0) {
+        pages_.insert(first / PAGE_SIZE, new Page(makePage(visits)));
+    }
+    endInsertRows();
+}
+
+void HistoryModel::setFilter(const QString& filter) {
+    if (filter == filter_) return;
+    filter_ = filter;
+    reload();
+}
+
+void HistoryModel::reload() {
+    beginResetModel();
+    keys_.clear();
+    pages_.clear();
+    at_end_ = false;
+    endResetModel();
+}
+
+void HistoryModel::onIconsLoaded() {
+    // The view repaints only the rows it shows
+    if (!keys_.empty()) {
+        emit dataChanged(index(0, TitleColumn), index(rowCount() - 1, TitleColumn), {Qt::DecorationRole});
+    }
+}
+
+void HistoryModel::onHistoryEvent(const SeaBrowser::HistoryEvent& event) {
+    if (event.type != SeaBrowser::HistoryEvent::Added) {
+        reload();
+        return;
+    }
+
+    const auto& item = event.item;
+    if (!filter_.isEmpty()) {
+        QString url = QString::fromStdString(item.url);
+        QString title = QString::fromStdString(item.title);
+        if (!url.contains(filter_, Qt::CaseInsensitive) && !title.contains(filter_, Qt::CaseInsensitive)) {
+            return;
+        }
+    }
+
+    // A new visit is the newest row; page boundaries shift by one
+    beginInsertRows(QModelIndex(), 0, 0);
+    keys_.push_front({item.timestamp, item.id});
+    pages_.clear();
+    endInsertRows();
+}
+
+} // namespace Tsunami
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QString>
+#include <QUrl>
+#include <QVector>
+#include <deque>
+#include <vector>
+
+namespace SeaBrowser {
+class ResultSet;
+struct HistoryEvent;
+}
+
+namespace Tsunami {
+
+// Table model over the visits table. fetchMore() walks the history with
+// keyset pagination and keeps only the (timestamp, id) key of each row;
+// titles and URLs live in a small page cache that is refilled on demand,
+// so scrolling through a million visits holds a bounded amount of text.
+class HistoryModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { TitleColumn, UrlColumn, VisitedColumn, ColumnCount };
+    enum Role { UrlRole = Qt::UserRole + 1 };
+
+    static constexpr int PAGE_SIZE = 256;
+    static constexpr int CACHED_PAGES = 32;
+
+    explicit HistoryModel(QObject* parent = nullptr);
+    ~HistoryModel() override;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    void setFilter(const QString& filter);
+    QUrl urlAt(int row) const;
+
+public slots:
+    void reload();
+
+private:
+    struct Key {
+        qint64 timestamp;
+        qint64 id;
+    };
+
+    struct Row {
+        QString title;
+        QString url;
+        QString visited;
+    };
+
+    using Page = QVector<Row>;
+
+    const Page* page(int index) const;
+    static Page makePage(const SeaBrowser::ResultSet& visits);
+    void onHistoryEvent(const SeaBrowser::HistoryEvent& event);
+    void onIconsLoaded();
+
+    std::deque<Key> keys_;
+    mutable QCache<int, Page> pages_;
+    QString filter_;
+    bool at_end_ = false;
+    int listener_id_ = 0;
+};
+
+} // namespace Tsunami
@@ -1,6 +1,10 @@
 #include "history_window.h"
-#include "../settings/settings.h"
-#include <QTableWidget>
+#include "theme_engine.h"
+#include "history_model.h"
+#include "../history/history_manager.h"
+#include <QTableView>
+#include <QStyledItemDelegate>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -11,6 +15,71 @@
 
 namespace Tsunami {
 
+namespace {
+
+QString buildHistoryStyle(bool isDark, const QString& accentColor) {
+    QString bgColor = isDark ? "#030712" : "#f0f9ff";
+    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
+    QString inputBg = isDark ? "#1e293b" : "#ffffff";
+    QString borderColor = isDark ? "#1e293b" : "#bfdbfe";
+    QString headerBg = isDark ? "#0f172a" : "#dbeafe";
+    QString headerText = isDark ? "#64748b" : "#3b82f6";
+
+    QString style = QString(R"(
+        QDialog {
+            background-color: %1;
+            color: %2;
+        }
+    )").arg(bgColor, textColor);
+    style += QString(R"(
+        QLabel#dialogTitle { font-size: 20px; font-weight: 600; color: %1; }
+    )").arg(accentColor);
+    style += QString(R"(
+        QLineEdit#searchEdit {
+            background-color: %1;
+            color: %2;
+            border: 1px solid %3;
+            border-radius: 8px;
+            padding: 8px 12px;
+        }
+    )").arg(inputBg, textColor, borderColor);
+    style += QString(R"(
+        QPushButton#clearButton {
+            background-color: rgba(239, 68, 68, 0.15);
+            color: #dc2626;
+            border: 1px solid rgba(239, 68, 68, 0.3);
+            border-radius: 8px;
+            padding: 8px 16px;
+            font-weight: 600;
+        }
+    )");
+    style += QString(R"(
+        QTableView#historyTable {
+            background-color: %1;
+            border: 1px solid %2;
+            border-radius: 8px;
+            color: %3;
+            font-size: 13px;
+        }
+        QTableView#historyTable::item {
+            padding: 10px 12px;
+            border-bottom: 1px solid %2;
+        }
+        #historyTable QHeaderView::section {
+            background-color: %4;
+            color: %5;
+            padding: 10px 12px;
+            font-weight: 600;
+            font-size: 12px;
+            text-transform: uppercase;
+            border-bottom: 1px solid %2;
+        }
+    )").arg(inputBg, borderColor, textColor, headerBg, headerText);
+    return style;
+}
+
+} // namespace
+
 HistoryWindow::HistoryWindow(QWidget* parent)
     : QDialog(parent)
 {
@@ -25,131 +94,76 @@ HistoryWindow::HistoryWindow(QWidget* parent)
 
     QHBoxLayout* header_layout = new QHBoxLayout();
     title_ = new QLabel("History");
+    title_->setObjectName("dialogTitle");
     header_layout->addWidget(title_);
     header_layout->addStretch();
 
     search_edit_ = new QLineEdit();
+    search_edit_->setObjectName("searchEdit");
     search_edit_->setPlaceholderText("Search history...");
     search_edit_->setFixedWidth(200);
     header_layout->addWidget(search_edit_);
 
+    // Filter once typing pauses rather than on every keystroke
+    search_timer_ = new QTimer(this);
+    search_timer_->setSingleShot(true);
+    search_timer_->setInterval(200);
+    connect(search_edit_, &QLineEdit::textChanged, search_timer_, qOverload<>(&QTimer::start));
+    connect(search_timer_, &QTimer::timeout, this, [this]() {
+        model_->setFilter(search_edit_->text().trimmed());
+    });
+
     clear_btn_ = new QPushButton("Clear All");
+    clear_btn_->setObjectName("clearButton");
     connect(clear_btn_, &QPushButton::clicked, this, &HistoryWindow::onClearHistory);
     header_layout->addWidget(clear_btn_);
 
     main_layout->addLayout(header_layout);
 
-    table_ = new QTableWidget(10, 3);
+    model_ = new HistoryModel(this);
+
+    table_ = new QTableView();
     table_->setObjectName("historyTable");
-    table_->setHorizontalHeaderLabels(QStringList() << "Title" << "URL" << "Visited");
+    table_->setModel(model_);
     table_->horizontalHeader()->setStretchLastSection(true);
+    table_->setColumnWidth(HistoryModel::TitleColumn, 260);
+    table_->setColumnWidth(HistoryModel::UrlColumn, 320);
     table_->setSelectionBehavior(QAbstractItemView::SelectRows);
     table_->setAlternatingRowColors(true);
+    table_->setWordWrap(false);
+    table_->setTextElideMode(Qt::ElideRight);
+    table_->setItemDelegate(new QStyledItemDelegate(table_));
 
-    QStringList sampleHistory = {
-        "New Tab - Tsunami|tsunami://newtab|Just now",
-        "Sea Software|https://seasoftware.dev|2 hours ago",
-        "GitHub|https://github.com|Yesterday",
-        "DuckDuckGo|https://duckduckgo.com|2 days ago"
-    };
-
-    for (int i = 0; i < sampleHistory.size(); ++i) {
-        QStringList parts = sampleHistory[i].split("|");
-        for (int j = 0; j < parts.size(); ++j) {
-            QTableWidgetItem* item = new QTableWidgetItem(parts[j]);
-            table_->setItem(i, j, item);
-        }
-    }
+    // Uniform row heights: the view never measures rows, so scrolling cost
+    // does not depend on how much history has been fetched
+    table_->verticalHeader()->setVisible(false);
+    table_->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    table_->verticalHeader()->setDefaultSectionSize(36);
 
-    connect(table_, &QTableWidget::itemDoubleClicked, this, &HistoryWindow::onItemDoubleClicked);
+    connect(table_, &QTableView::doubleClicked, this, &HistoryWindow::onItemDoubleClicked);
     main_layout->addWidget(table_);
 
     applyTheme();
-    connect(&Settings::instance(), &Settings::settingsChanged, this, &HistoryWindow::applyTheme);
+    connect(&ThemeEngine::instance(), &ThemeEngine::themeChanged, this, &HistoryWindow::applyTheme);
 }
 
 void HistoryWindow::applyTheme() {
-    QString accentColor = Settings::instance().getAccentColor();
-    if (accentColor.isEmpty()) accentColor = "#60a5fa";
-
-    bool isDark = Settings::instance().getDarkMode();
-
-    QString bgColor = isDark ? "#030712" : "#f0f9ff";
-    QString titleColor = isDark ? "#e2e8f0" : "#1e40af";
-    QString textColor = isDark ? "#e2e8f0" : "#1e293b";
-    QString inputBg = isDark ? "#1e293b" : "#ffffff";
-    QString borderColor = isDark ? "#1e293b" : "#bfdbfe";
-    QString headerBg = isDark ? "#0f172a" : "#dbeafe";
-    QString headerText = isDark ? "#64748b" : "#3b82f6";
-
-    title_->setStyleSheet(QString("font-size: 20px; font-weight: 600; color: %1;").arg(accentColor));
-
-    search_edit_->setStyleSheet(QString(R"(
-        QLineEdit {
-            background-color: %1;
-            color: %2;
-            border: 1px solid %3;
-            border-radius: 8px;
-            padding: 8px 12px;
-        }
-    )").arg(inputBg, textColor, borderColor));
-
-    clear_btn_->setStyleSheet(QString(R"(
-        QPushButton {
-            background-color: rgba(239, 68, 68, 0.15);
-            color: #dc2626;
-            border: 1px solid rgba(239, 68, 68, 0.3);
-            border-radius: 8px;
-            padding: 8px 16px;
-            font-weight: 600;
-        }
-    )"));
-
-    table_->setStyleSheet(QString(R"(
-        QTableWidget {
-            background-color: %1;
-            border: 1px solid %2;
-            border-radius: 8px;
-            color: %3;
-            font-size: 13px;
-        }
-        QTableWidget::item {
-            padding: 10px 12px;
-            border-bottom: 1px solid %2;
-        }
-        QHeaderView::section {
-            background-color: %4;
-            color: %5;
-            padding: 10px 12px;
-            font-weight: 600;
-            font-size: 12px;
-            text-transform: uppercase;
-            border-bottom: 1px solid %2;
-        }
-    )").arg(inputBg, borderColor, textColor, headerBg, headerText));
-
-    setStyleSheet(QString(R"(
-        QDialog {
-            background-color: %1;
-            color: %2;
-        }
-    )").arg(bgColor, textColor));
+    ThemeEngine::instance().apply(this, "history", buildHistoryStyle);
 }
 
 void HistoryWindow::onClearHistory() {
     if (QMessageBox::warning(this, "Clear History",
         "Are you sure you want to clear all browsing history?",
         QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes) {
-        table_->setRowCount(0);
+        SeaBrowser::HistoryManager::instance().clear_history();
         QMessageBox::information(this, "History", "Browsing history has been cleared.");
     }
 }
 
-void HistoryWindow::onItemDoubleClicked(QTableWidgetItem* item) {
-    Q_UNUSED(item)
-    int row = table_->currentRow();
-    QTableWidgetItem* urlItem = table_->item(row, 1);
-    if (urlItem) {
+void HistoryWindow::onItemDoubleClicked(const QModelIndex& index) {
+    QUrl url = model_->urlAt(index.row());
+    if (url.isValid()) {
+        emit urlActivated(url);
         accept();
     }
 }
@@ -3,28 +3,37 @@
 #include <QDialog>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QTableWidget>
+#include <QTableView>
 #include <QPushButton>
 #include <QLabel>
 #include <QLineEdit>
 #include <QHeaderView>
+#include <QTimer>
+#include <QUrl>
 
 namespace Tsunami {
 
+class HistoryModel;
+
 class HistoryWindow : public QDialog {
     Q_OBJECT
 public:
     explicit HistoryWindow(QWidget* parent = nullptr);
     void applyTheme();
 
+signals:
+    void urlActivated(const QUrl& url);
+
 private slots:
     void onClearHistory();
-    void onItemDoubleClicked(QTableWidgetItem* item);
+    void onItemDoubleClicked(const QModelIndex& index);
 
 private:
     QLabel* title_;
     QLineEdit* search_edit_;
-    QTableWidget* table_;
+    QTimer* search_timer_;
+    QTableView* table_;
+    HistoryModel* model_;
     QPushButton* clear_btn_;
 };
 
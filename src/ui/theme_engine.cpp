@@ -0,0 +1,91 @@
+#include "theme_engine.h"
+#include "../settings/settings.h"
+#include "../perf/trace.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QWidget>
+
+namespace Tsunami {
+
+namespace {
+
+QString normalizedAccent(const QString& accent) {
+    return accent.isEmpty() ? QStringLiteral("#60a5fa") : accent;
+}
+
+} // namespace
+
+ThemeEngine& ThemeEngine::instance() {
+    static ThemeEngine instance;
+    return instance;
+}
+
+ThemeEngine::ThemeEngine()
+    : QObject(nullptr)
+    , dark_(Settings::instance().getDarkMode())
+    , accent_(normalizedAccent(Settings::instance().getAccentColor()))
+    , icon_dir_(resolveIconDirectory())
+{
+    connect(&Settings::instance(), &Settings::settingsChanged, this, &ThemeEngine::onSettingsChanged);
+}
+
+QString ThemeEngine::resolveIconDirectory() const {
+    const QString appDir = QCoreApplication::applicationDirPath();
+    const QStringList candidates = {
+        appDir + "/data/icons/",
+        appDir + "/../share/tsunami/data/icons/",
+        "/usr/share/tsunami/data/icons/"
+    };
+    for (const QString& dir : candidates) {
+        if (QDir(dir).exists()) return dir;
+    }
+    return candidates.first();
+}
+
+void ThemeEngine::onSettingsChanged() {
+    bool dark = Settings::instance().getDarkMode();
+    QString accent = normalizedAccent(Settings::instance().getAccentColor());
+    if (dark == dark_ && accent == accent_) return;
+
+    dark_ = dark;
+    accent_ = accent;
+    // Entries for other themes stay cached; toggling back costs nothing
+    emit themeChanged();
+}
+
+QString ThemeEngine::styleSheet(const char* surface, StyleBuilder builder) {
+    QString key = QString("%1|%2|%3").arg(QLatin1String(surface), dark_ ? "dark" : "light", accent_);
+    auto it = styles_.constFind(key);
+    if (it != styles_.constEnd()) return it.value();
+
+    TSUNAMI_TRACE_SCOPE("theme.buildStyleSheet");
+    QString style = builder(dark_, accent_);
+    styles_.insert(key, style);
+    return style;
+}
+
+void ThemeEngine::apply(QWidget* widget, const char* surface, StyleBuilder builder) {
+    QString style = styleSheet(surface, builder);
+    if (widget->styleSheet() == style) return;
+
+    TSUNAMI_TRACE_SCOPE("theme.apply");
+    widget->setStyleSheet(style);
+}
+
+QIcon ThemeEngine::icon(const QString& name) {
+    QString key = dark_ ? name + "-white" : name;
+    auto it = icons_.constFind(key);
+    if (it != icons_.constEnd()) return it.value();
+
+    // Fall back to the plain icon when there is no white variant
+    QString path = icon_dir_ + key + ".svg";
+    if (!QFile::exists(path)) {
+        path = icon_dir_ + name + ".svg";
+    }
+    QIcon icon(path);
+    icons_.insert(key, icon);
+    return icon;
+}
+
+} // namespace Tsunami
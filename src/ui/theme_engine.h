@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QIcon>
+#include <QString>
+
+class QWidget;
+
+namespace Tsunami {
+
+// Builds each stylesheet once per (surface, dark mode, accent) and hands out
+// the cached string afterwards. Widgets listen to themeChanged(), which only
+// fires when the dark mode or accent colour really changes, instead of
+// re-polishing on every settingsChanged().
+class ThemeEngine : public QObject {
+    Q_OBJECT
+public:
+    using StyleBuilder = QString (*)(bool dark, const QString& accent);
+
+    static ThemeEngine& instance();
+
+    bool isDark() const { return dark_; }
+    QString accentColor() const { return accent_; }
+
+    QString styleSheet(const char* surface, StyleBuilder builder);
+
+    // Sets the cached stylesheet on the widget unless it already has it
+    void apply(QWidget* widget, const char* surface, StyleBuilder builder);
+
+    // Toolbar icon for the current theme ("-white" variant in dark mode)
+    QIcon icon(const QString& name);
+
+signals:
+    void themeChanged();
+
+private slots:
+    void onSettingsChanged();
+
+private:
+    ThemeEngine();
+    QString resolveIconDirectory() const;
+
+    bool dark_;
+    QString accent_;
+    QString icon_dir_;
+    QHash<QString, QString> styles_;
+    QHash<QString, QIcon> icons_;
+};
+
+} // namespace Tsunami
@@ -1,11 +1,26 @@
 #include "web_view.h"
 #include "settings/settings.h"
+#include "settings/site_settings.h"
+#include "scheme_handler.h"
+#include "bridge/performance_bridge.h"
+#include "bridge/top_sites_bridge.h"
+#include "bridge/history_bridge.h"
+#include "bridge/bookmarks_bridge.h"
+#include "bridge/downloads_bridge.h"
+#include "bridge/cache_bridge.h"
+#include "bridge/memory_bridge.h"
+#include "bridge/tasks_bridge.h"
+#include "blocking/content_blocker.h"
+#include "blocking/cookie_policy.h"
+#include "favicons/favicon_service.h"
+#include "perf/trace.h"
 #include <QWebEngineView>
 #include <QWebEngineProfile>
 #include <QWebEngineScript>
 #include <QWebEngineSettings>
 #include <QWebEnginePage>
 #include <QWebEngineScriptCollection>
+#include <QWebEngineLoadingInfo>
 #include <QWebChannel>
 #include <QFile>
 #include <QFileInfo>
@@ -13,6 +28,7 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QCoreApplication>
+#include <algorithm>
 
 namespace Tsunami {
 
@@ -52,10 +68,56 @@ private slots:
     }
 };
 
+// Only the scheme counts: a local file that merely lives under some
+// data/pages directory must not get the privileged bridges
+bool WebView::isInternalUrl(const QUrl& url) {
+    return url.scheme() == QString::fromLatin1(SchemeHandler::schemeName());
+}
+
+void WebView::applySiteSettings(QWebEnginePage* page, const QUrl& url) {
+    TSUNAMI_TRACE_SCOPE("webview.siteSettings");
+    // Internal pages always get the profile defaults; they need JavaScript
+    SiteSettings site;
+    if (!isInternalUrl(url) && !url.host().isEmpty()) {
+        site = SiteSettingsStore::instance().lookup(url.host().toStdString());
+    }
+
+    QWebEngineSettings* settings = page->settings();
+    auto apply = [settings](QWebEngineSettings::WebAttribute attribute, SiteToggle toggle) {
+        if (toggle == SiteToggle::Default) {
+            settings->resetAttribute(attribute);
+        } else {
+            settings->setAttribute(attribute, toggle == SiteToggle::Allow);
+        }
+    };
+    apply(QWebEngineSettings::JavascriptEnabled, site.javascript);
+    apply(QWebEngineSettings::AutoLoadImages, site.images);
+    apply(QWebEngineSettings::WebGLEnabled, site.webgl);
+    // Chromium's switch is the inverse: a user gesture is required to play
+    if (site.autoplay == SiteToggle::Default) {
+        settings->resetAttribute(QWebEngineSettings::PlaybackRequiresUserGesture);
+    } else {
+        settings->setAttribute(QWebEngineSettings::PlaybackRequiresUserGesture,
+                               site.autoplay == SiteToggle::Block);
+    }
+
+    int zoom = site.zoom ? site.zoom : Settings::instance().getZoomLevel();
+    qreal factor = std::clamp(zoom, 25, 500) / 100.0;
+    if (!qFuzzyCompare(page->zoomFactor(), factor)) page->setZoomFactor(factor);
+}
+
 void WebView::setupPage(QWebEnginePage* page) {
     if (!page) return;
+    TSUNAMI_TRACE_SCOPE("webview.setupPage");
 
     QWebEngineProfile* profile = page->profile();
+    SchemeHandler::install(profile);
+    ContentBlocker::instance().install(page);
+    CookiePolicy::instance().install(profile);
+    if (!profile->isOffTheRecord()) {
+        QObject::connect(page, &QWebEnginePage::iconChanged, &FaviconService::instance(),
+                         [page](const QIcon& icon) { FaviconService::instance().record(page->url(), icon); });
+    }
 
     profile->setHttpUserAgent(
         "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/133.0.0.0 Safari/537.36"
@@ -70,6 +132,15 @@ void WebView::setupPage(QWebEnginePage* page) {
     settings->setAttribute(QWebEngineSettings::DnsPrefetchEnabled, true);
 
     profile->setHttpAcceptLanguage("en-US,en;q=0.9");
+
+    // Applied when a navigation starts so the new document is created with
+    // them, and again on commit for redirects and same-document changes
+    QObject::connect(page, &QWebEnginePage::loadingChanged, page, [page](const QWebEngineLoadingInfo& info) {
+        if (info.status() == QWebEngineLoadingInfo::LoadStartedStatus) applySiteSettings(page, info.url());
+    });
+    QObject::connect(page, &QWebEnginePage::urlChanged, page, [page](const QUrl& url) {
+        applySiteSettings(page, url);
+    });
     
     // Create the bridge object properly parenting it to the page to avoid leaks/crashes
     // But QWebChannel needs a QObject that outlives the page load or is registered properly.
@@ -79,6 +150,14 @@ void WebView::setupPage(QWebEnginePage* page) {
     QWebChannel* channel = new QWebChannel(page);
     SettingsBridge* bridge = new SettingsBridge(channel); // Parent to channel
     channel->registerObject("tsunami", bridge); // Use 'tsunami' to match JS
+    channel->registerObject("performance", new PerformanceBridge(page, channel));
+    channel->registerObject("topSites", new TopSitesBridge(page, channel));
+    channel->registerObject("history", new HistoryBridge(page, channel));
+    channel->registerObject("bookmarks", new BookmarksBridge(page, channel));
+    channel->registerObject("downloads", new DownloadsBridge(page, channel));
+    channel->registerObject("cache", new CacheBridge(page, channel));
+    channel->registerObject("memory", new MemoryBridge(page, channel));
+    channel->registerObject("tasks", new TasksBridge(page, channel));
     page->setWebChannel(channel);
     
     // Inject qwebchannel.js
@@ -118,6 +197,14 @@ void WebView::setupPage(QWebEnginePage* page) {
             
             new QWebChannel(qt.webChannelTransport, function(channel) {
                 window.tsunami = channel.objects.tsunami;
+                window.tsunamiPerformance = channel.objects.performance;
+                window.tsunamiTopSites = channel.objects.topSites;
+                window.tsunamiHistory = channel.objects.history;
+                window.tsunamiBookmarks = channel.objects.bookmarks;
+                window.tsunamiDownloads = channel.objects.downloads;
+                window.tsunamiCache = channel.objects.cache;
+                window.tsunamiMemory = channel.objects.memory;
+                window.tsunamiTasks = channel.objects.tasks;
                 console.log('Tsunami bridge connected');
                 
                 // Notify that bridge is ready
@@ -1,11 +1,15 @@
 #pragma once
 #include <QWebEnginePage>
+#include <QUrl>
 
 namespace Tsunami {
 
 class WebView {
 public:
     static void setupPage(QWebEnginePage* page);
+    static bool isInternalUrl(const QUrl& url);
+    // Per-site zoom and content settings for the document at url
+    static void applySiteSettings(QWebEnginePage* page, const QUrl& url);
 };
 
 } // namespace Tsunami
@@ -0,0 +1,135 @@
+#include "src/blocking/filter_cache.h"
+#include "src/blocking/filter_compiler.h"
+#include "src/blocking/filter_engine.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Tsunami;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+static std::string_view hostOf(std::string_view url) {
+    size_t begin = url.find("://");
+    begin = begin == std::string_view::npos ? 0 : begin + 3;
+    size_t end = url.find_first_of(":/?#", begin);
+    return url.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+}
+
+static bool blocked(const FilterEngine& engine, std::string_view url, std::string_view site_url,
+                    uint32_t type = ResourceScript) {
+    FilterRequest request;
+    request.url = url;
+    request.host = hostOf(url);
+    request.site_url = site_url;
+    request.site_host = hostOf(site_url);
+    request.type = type;
+    request.third_party = FilterEngine::is_third_party(request.host, request.site_host);
+    return engine.match(request).blocked;
+}
+
+static const char* LIST =
+    "! Title: test list\n"
+    "||ads.example.com^\n"
+    "/banner/ad-\n"
+    "||cdn.example.net/track/*.js$script\n"
+    "||widgets.example.org^$third-party\n"
+    "@@||ads.example.com/allowed/\n"
+    "@@||news.example.com^$document\n"
+    "@@||shop.example.com^$elemhide\n"
+    "example.com##.sponsored\n"
+    "/^https?:\\/\\/regex\\./\n";
+
+static void testMatching(const FilterEngine& engine) {
+    const char* site = "https://www.site.com/";
+
+    check(blocked(engine, "https://ads.example.com/x.js", site), "domain rule blocks");
+    check(blocked(engine, "https://sub.ads.example.com/x.js", site), "domain rule blocks subdomains");
+    check(!blocked(engine, "https://notads.example.com/x.js", site), "domain rule stays on label boundary");
+
+    check(blocked(engine, "https://img.site.com/banner/ad-1.png", site, ResourceImage), "substring rule blocks");
+    check(!blocked(engine, "https://img.site.com/banner/hero.png", site, ResourceImage), "substring rule is exact");
+
+    check(blocked(engine, "https://cdn.example.net/track/a/b.js", site), "pattern rule blocks");
+    check(!blocked(engine, "https://cdn.example.net/track/a/b.js", site, ResourceImage),
+          "pattern rule respects $script");
+    check(!blocked(engine, "https://cdn.example.net/other/b.js", site), "pattern rule needs its prefix");
+
+    check(blocked(engine, "https://widgets.example.org/w.js", site), "$third-party blocks cross-site");
+    check(!blocked(engine, "https://widgets.example.org/w.js", "https://example.org/"),
+          "$third-party spares same-site");
+
+    check(!blocked(engine, "https://ads.example.com/allowed/x.js", site), "exception overrides block");
+
+    check(!blocked(engine, "https://ads.example.com/x.js", "https://news.example.com/story"),
+          "$document exception allows the page's requests");
+    check(!blocked(engine, "https://ads.example.com/x.js", "https://m.news.example.com/"),
+          "$document exception covers subdomains");
+    check(!blocked(engine, "https://news.example.com/x.js", site),
+          "$document exception is not a block rule");
+    check(blocked(engine, "https://ads.example.com/x.js", "https://shop.example.com/"),
+          "$elemhide exception does not allow requests");
+
+    check(!blocked(engine, "https://regex.site.com/x.js", site), "regex rules are skipped, not approximated");
+}
+
+int main() {
+    FilterCompiler compiler;
+    compiler.add_list(LIST);
+    const FilterCompileStats stats = compiler.stats();
+    check(stats.exception_rules == 2, "exception rules counted");
+    check(stats.skipped_cosmetic == 2, "element hiding and $elemhide skipped as cosmetic");
+    check(stats.skipped_unsupported == 1, "regex skipped as unsupported");
+
+    CompiledFilters compiled = compiler.compile();
+    const uint64_t key = filter_checksum(LIST, std::strlen(LIST));
+    const std::string image = serialize_filters(compiled, stats, key);
+
+    FilterEngine engine(std::move(compiled));
+    testMatching(engine);
+
+    // Sections are 8 byte aligned relative to the image, so view it from aligned storage
+    auto aligned = [](const std::string& bytes) {
+        std::vector<uint64_t> words((bytes.size() + 7) / 8);
+        std::memcpy(words.data(), bytes.data(), bytes.size());
+        return words;
+    };
+    auto view = [](const std::vector<uint64_t>& words, size_t size, uint64_t source_key,
+                   FilterData& data, FilterCompileStats& loaded) {
+        return view_filters({reinterpret_cast<const std::byte*>(words.data()), size}, source_key, data, loaded);
+    };
+
+    FilterData data;
+    FilterCompileStats loaded;
+    std::vector<uint64_t> good = aligned(image);
+    check(view(good, image.size(), key, data, loaded), "cache round trip loads");
+    check(loaded.pattern_rules == stats.pattern_rules, "cache keeps stats");
+    if (!failures) testMatching(FilterEngine(data, nullptr));
+
+    check(!view(good, image.size(), key + 1, data, loaded), "cache rejects another source key");
+    check(!view(good, image.size() - 8, key, data, loaded), "cache rejects a truncated image");
+    check(!view(good, 16, key, data, loaded), "cache rejects a bare header");
+
+    for (size_t offset : {size_t(0), image.size() / 2, image.size() - 1}) {
+        std::string corrupt = image;
+        corrupt[offset] ^= 0x40;
+        std::vector<uint64_t> words = aligned(corrupt);
+        check(!view(words, corrupt.size(), key, data, loaded), "cache rejects a flipped byte");
+    }
+
+    if (failures) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("all blocking tests passed\n");
+    return 0;
+}
@@ -0,0 +1,249 @@
+/*
+ * Tsunami Browser - Build tools
+ * psl_compile.cpp - Compiles public_suffix_list.dat into a label DAFSA
+ *
+ * Usage: psl_compile <public_suffix_list.dat> <psl_data.inc>
+ *
+ * Rules become a trie over labels read right to left, then identical
+ * subtrees are merged, which turns the trie into a minimal acyclic
+ * automaton. Each node's edges are sorted by the FNV-1a hash of their
+ * label so lookups binary-search integers, not strings. Internationalised
+ * rules are emitted in both their UTF-8 and punycode (xn--) spellings.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum NodeFlags : uint8_t {
+    NodeSuffix = 1,      // The labels so far are a public suffix
+    NodeWildcard = 2,    // *.<labels so far>
+    NodeException = 4    // !<labels so far>
+};
+
+struct TrieNode {
+    uint8_t flags = 0;
+    std::map<std::string, int> children;
+};
+
+std::vector<TrieNode> trie(1);
+
+// Must match label_hash() in src/blocking/public_suffix.cpp
+uint32_t label_hash(const std::string& label) {
+    uint32_t hash = 2166136261u;
+    for (char c : label) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+std::vector<uint32_t> utf8_decode(const std::string& text) {
+    std::vector<uint32_t> out;
+    for (size_t i = 0; i < text.size();) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        int length = c < 0x80 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+        uint32_t code = length == 1 ? c : c & (0xff >> (length + 1));
+        for (int k = 1; k < length && i + k < text.size(); ++k) {
+            code = (code << 6) | (static_cast<unsigned char>(text[i + k]) & 0x3f);
+        }
+        out.push_back(code);
+        i += length;
+    }
+    return out;
+}
+
+// RFC 3492
+std::string punycode(const std::vector<uint32_t>& input) {
+    const uint32_t base = 36, tmin = 1, tmax = 26, skew = 38, damp = 700;
+    auto digit = [](uint32_t d) { return static_cast<char>(d < 26 ? 'a' + d : '0' + d - 26); };
+    auto adapt = [&](uint32_t delta, uint32_t points, bool first) {
+        delta = first ? delta / damp : delta / 2;
+        delta += delta / points;
+        uint32_t k = 0;
+        while (delta > ((base - tmin) * tmax) / 2) {
+            delta /= base - tmin;
+            k += base;
+        }
+        return k + (base - tmin + 1) * delta / (delta + skew);
+    };
+
+    std::string output;
+    for (uint32_t c : input) {
+        if (c < 0x80) output += static_cast<char>(c);
+    }
+    uint32_t basic = static_cast<uint32_t>(output.size());
+    uint32_t handled = basic;
+    if (basic) output += '-';
+
+    uint32_t n = 128, delta = 0, bias = 72;
+    while (handled < input.size()) {
+        uint32_t m = UINT32_MAX;
+        for (uint32_t c : input) {
+            if (c >= n) m = std::min(m, c);
+        }
+        delta += (m - n) * (handled + 1);
+        n = m;
+        for (uint32_t c : input) {
+            if (c < n) ++delta;
+            if (c != n) continue;
+            uint32_t q = delta;
+            for (uint32_t k = base;; k += base) {
+                uint32_t t = k <= bias ? tmin : (k >= bias + tmax ? tmax : k - bias);
+                if (q < t) break;
+                output += digit(t + (q - t) % (base - t));
+                q = (q - t) / (base - t);
+            }
+            output += digit(q);
+            bias = adapt(delta, handled + 1, handled == basic);
+            delta = 0;
+            ++handled;
+        }
+        ++delta;
+        ++n;
+    }
+    return "xn--" + output;
+}
+
+std::vector<std::string> split_labels(const std::string& rule) {
+    std::vector<std::string> labels;
+    std::stringstream stream(rule);
+    std::string label;
+    while (std::getline(stream, label, '.')) labels.push_back(label);
+    return labels;
+}
+
+void add_rule(std::vector<std::string> labels, uint8_t flag) {
+    int node = 0;
+    for (auto it = labels.rbegin(); it != labels.rend(); ++it) {
+        auto child = trie[node].children.find(*it);
+        if (child == trie[node].children.end()) {
+            int next = static_cast<int>(trie.size());
+            trie[node].children[*it] = next;
+            trie.emplace_back();
+            node = next;
+        } else {
+            node = child->second;
+        }
+    }
+    trie[node].flags |= flag;
+}
+
+void add_line(const std::string& rule) {
+    bool exception = rule[0] == '!';
+    std::string body = exception ? rule.substr(1) : rule;
+    bool wildcard = body.compare(0, 2, "*.") == 0;
+    if (wildcard) body = body.substr(2);
+
+    uint8_t flag = exception ? NodeException : wildcard ? NodeWildcard : NodeSuffix;
+    std::vector<std::string> labels = split_labels(body);
+    add_rule(labels, flag);
+
+    bool ascii = std::all_of(body.begin(), body.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+    if (!ascii) {
+        for (std::string& label : labels) {
+            std::vector<uint32_t> code_points = utf8_decode(label);
+            if (std::any_of(code_points.begin(), code_points.end(), [](uint32_t c) { return c >= 0x80; })) {
+                label = punycode(code_points);
+            }
+        }
+        add_rule(labels, flag);
+    }
+}
+
+struct Output {
+    std::string labels;
+    std::map<std::string, uint32_t> label_offsets;
+    std::vector<std::string> nodes;        // "edge_begin, edge_count, flags"
+    std::vector<std::string> edges;        // "label_hash, label_offset, label_length, target"
+    std::map<std::string, uint32_t> canonical;
+};
+
+uint32_t label_offset(Output& out, const std::string& label) {
+    auto it = out.label_offsets.find(label);
+    if (it != out.label_offsets.end()) return it->second;
+    uint32_t offset = static_cast<uint32_t>(out.labels.size());
+    out.labels += label;
+    out.label_offsets[label] = offset;
+    return offset;
+}
+
+// Post-order: children are emitted before their parent, and a node whose
+// flags and children equal an emitted one reuses its id
+uint32_t emit(Output& out, int node) {
+    std::vector<std::pair<std::string, uint32_t>> children;
+    for (const auto& [label, child] : trie[node].children) {
+        children.emplace_back(label, emit(out, child));
+    }
+    std::sort(children.begin(), children.end(), [](const auto& a, const auto& b) {
+        return std::make_pair(label_hash(a.first), a.first) < std::make_pair(label_hash(b.first), b.first);
+    });
+
+    std::string signature = std::to_string(trie[node].flags);
+    for (const auto& [label, id] : children) signature += "|" + label + ":" + std::to_string(id);
+    auto existing = out.canonical.find(signature);
+    if (existing != out.canonical.end()) return existing->second;
+
+    uint32_t edge_begin = static_cast<uint32_t>(out.edges.size());
+    for (const auto& [label, id] : children) {
+        out.edges.push_back(std::to_string(label_hash(label)) + "u, " + std::to_string(label_offset(out, label)) +
+                            ", " + std::to_string(label.size()) + ", " + std::to_string(id));
+    }
+    uint32_t id = static_cast<uint32_t>(out.nodes.size());
+    out.nodes.push_back(std::to_string(edge_begin) + ", " + std::to_string(children.size()) + ", " +
+                        std::to_string(trie[node].flags));
+    out.canonical[signature] = id;
+    return id;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "usage: psl_compile <public_suffix_list.dat> <psl_data.inc>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "psl_compile: cannot read " << argv[1] << std::endl;
+        return 1;
+    }
+
+    size_t rules = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t end = line.find_first_of(" \t\r");
+        std::string rule = line.substr(0, end);
+        if (rule.empty() || rule.compare(0, 2, "//") == 0) continue;
+        add_line(rule);
+        ++rules;
+    }
+
+    Output out;
+    uint32_t root = emit(out, 0);
+
+    std::ofstream inc(argv[2]);
+    inc << "// Generated by tools/psl_compile.cpp from public_suffix_list.dat. Do not edit.\n";
+    inc << "// " << rules << " rules, " << trie.size() << " trie nodes merged into " << out.nodes.size() << ".\n\n";
+    inc << "constexpr uint32_t PSL_ROOT = " << root << ";\n\n";
+
+    // A byte list rather than a string literal: MSVC caps literals at 64 KB
+    inc << "constexpr unsigned char PSL_LABELS[] = {";
+    for (size_t i = 0; i < out.labels.size(); ++i) {
+        inc << (i % 24 ? " " : "\n    ") << static_cast<int>(static_cast<unsigned char>(out.labels[i])) << ",";
+    }
+    inc << "\n};\n\nconstexpr PslNode PSL_NODES[] = {\n";
+    for (const std::string& node : out.nodes) inc << "    {" << node << "},\n";
+    inc << "};\n\nconstexpr PslEdge PSL_EDGES[] = {\n";
+    for (const std::string& edge : out.edges) inc << "    {" << edge << "},\n";
+    inc << "};\n";
+    return inc ? 0 : 1;
+}